@@ -126,6 +126,7 @@ export class HedgeSystemCore {
     
     // 両建て管理初期化
     this.hedgeManager = new HedgeManager();
+    this.wsServer.setHedgeManager(this.hedgeManager);
     
     // アクション同期初期化
     this.actionSync = new ActionSync(this.wsServer);
@@ -6,6 +6,7 @@ import {
   ExecutionType
 } from '@repo/shared-types';
 import { amplifyClient, getCurrentUserId, listOpenPositions } from './amplify-client';
+import { WSExposureSummary, WSPnLUpdateEvent, WSSymbolSpec, WSSymbolSpecsEvent } from './types';
 
 // ========================================
 // 型定義・インターフェース
@@ -79,6 +80,12 @@ export class HedgeManager {
   private currentUserId?: string;
   private monitoredAccounts: Set<string> = new Set();
   private lastAnalysis: Map<string, HedgeAnalysis> = new Map();
+  // EAハートビートで届く最新のネットエクスポージャー（DLLが約定ごとに差分更新した値）
+  private liveExposure: Map<string, WSExposureSummary> = new Map();
+  // 口座ごとの通貨ペア仕様（EAのDLLから接続ごとに共有される）
+  private symbolSpecs: Map<string, Map<string, WSSymbolSpec>> = new Map();
+  // 口座ごとのポジション評価損益（MT5 チケット → 口座通貨建ての損益。EAのDLLの PNL_UPDATE）
+  private livePnL: Map<string, Map<string, number>> = new Map();
   private isMonitoring = false;
   private analysisInterval: NodeJS.Timeout | null = null;
   
@@ -150,6 +157,8 @@ export class HedgeManager {
     
     this.monitoredAccounts.clear();
     this.lastAnalysis.clear();
+    this.liveExposure.clear();
+    this.livePnL.clear();
     
     console.log('🛑 Hedge monitoring stopped');
   }
@@ -196,13 +205,14 @@ export class HedgeManager {
     // シンボル別ネットポジション計算
     const netPositions = this.calculateNetPositions(positions);
     
-    // 両建て状況分析
-    const totalNetExposure = this.calculateTotalNetExposure(netPositions);
-    const hedgeRatio = this.calculateHedgeRatio(netPositions);
+    // 両建て状況分析（ハートビート受信済みの口座はDLLの値を優先し、全ポジションの再集計を省く）
+    const exposure = this.liveExposure.get(accountId);
+    const totalNetExposure = exposure ? exposure.netVolume : this.calculateTotalNetExposure(netPositions);
+    const hedgeRatio = exposure ? exposure.hedgeRatio : this.calculateHedgeRatio(netPositions);
     const isFullyHedged = hedgeRatio > 0.95; // 95%以上ヘッジされていれば完全ヘッジとみなす
     
     // 最適化提案生成
-    const suggestions = this.generateHedgeSuggestions(netPositions, hedgeRatio);
+    const suggestions = this.generateHedgeSuggestions(accountId, netPositions, hedgeRatio);
     
     return {
       accountId,
@@ -214,6 +224,66 @@ export class HedgeManager {
     };
   }
 
+  /**
+   * EAハートビートのネットエクスポージャー反映
+   * 定期分析を待たずに最新の分析結果のエクスポージャー・ヘッジ比率を更新する
+   */
+  applyExposureSnapshot(accountId: string, exposure: WSExposureSummary): void {
+    if (!this.monitoredAccounts.has(accountId)) return;
+
+    this.liveExposure.set(accountId, exposure);
+
+    const analysis = this.lastAnalysis.get(accountId) || this.createEmptyAnalysis(accountId);
+    const netVolumes = new Map(exposure.symbols.map(entry => [entry.symbol, entry]));
+
+    analysis.totalNetExposure = exposure.netVolume;
+    analysis.hedgeRatio = exposure.hedgeRatio;
+    analysis.isFullyHedged = exposure.hedgeRatio > 0.95;
+    analysis.netPositions.forEach(net => {
+      const entry = netVolumes.get(net.symbol);
+      net.totalBuyVolume = entry ? entry.longVolume : 0;
+      net.totalSellVolume = entry ? entry.shortVolume : 0;
+      net.netVolume = entry ? entry.netVolume : 0;
+    });
+
+    this.lastAnalysis.set(accountId, analysis);
+    this.stats.hedgedAccounts = Array.from(this.lastAnalysis.values()).filter(a => a.isFullyHedged).length;
+  }
+
+  /**
+   * 口座の同期し直し（EAのイベントに欠落があり再送もできない場合）
+   * DLLから受け取った途中の値を捨て、ポジションから分析し直す
+   */
+  async resyncAccount(accountId: string): Promise<void> {
+    this.liveExposure.delete(accountId);
+    this.livePnL.delete(accountId);
+    if (!this.monitoredAccounts.has(accountId)) return;
+
+    const analysis = await this.analyzeAccountHedge(accountId);
+    this.lastAnalysis.set(accountId, analysis);
+  }
+
+  /**
+   * 通貨ペア仕様の反映（full の場合は置き換え、それ以外は差分を上書き）
+   */
+  applySymbolSpecs(event: WSSymbolSpecsEvent): void {
+    let specs = this.symbolSpecs.get(event.accountId);
+    if (!specs || event.full) {
+      specs = new Map();
+      this.symbolSpecs.set(event.accountId, specs);
+    }
+    event.specs.forEach(spec => specs!.set(spec.symbol, spec));
+  }
+
+  /**
+   * 評価損益の反映（保有中の全ポジションの値が届くため置き換え）
+   */
+  applyPnLUpdate(event: WSPnLUpdateEvent): void {
+    const pnl = new Map<string, number>();
+    event.positions.forEach(position => pnl.set(String(position.ticket), position.pnl + position.swap));
+    this.livePnL.set(event.accountId, pnl);
+  }
+
   /**
    * ネットポジション計算（シンボル別）
    */
@@ -291,7 +361,7 @@ export class HedgeManager {
   /**
    * ヘッジ提案生成
    */
-  private generateHedgeSuggestions(netPositions: NetPosition[], hedgeRatio: number): HedgeSuggestion[] {
+  private generateHedgeSuggestions(accountId: string, netPositions: NetPosition[], hedgeRatio: number): HedgeSuggestion[] {
     const suggestions: HedgeSuggestion[] = [];
     
     // ヘッジ比率が低い場合の提案
@@ -308,7 +378,7 @@ export class HedgeManager {
             volume: hedgeVolume,
             reason: `Net ${net.netVolume > 0 ? 'long' : 'short'} exposure of ${Math.abs(net.netVolume)} lots`,
             priority: Math.abs(net.netVolume) > 1.0 ? 'HIGH' : 'MEDIUM',
-            estimatedMarginImpact: this.estimateMarginImpact(net.symbol, hedgeVolume)
+            estimatedMarginImpact: this.estimateMarginImpact(accountId, net.symbol, hedgeVolume)
           });
         }
       });
@@ -325,7 +395,7 @@ export class HedgeManager {
           volume: excessVolume * 0.5, // 半分を整理提案
           reason: `Excessive hedge volume: ${excessVolume} lots can be reduced`,
           priority: 'LOW',
-          estimatedMarginImpact: -this.estimateMarginImpact(net.symbol, excessVolume * 0.5)
+          estimatedMarginImpact: -this.estimateMarginImpact(accountId, net.symbol, excessVolume * 0.5)
         });
       }
     });
@@ -530,20 +600,18 @@ export class HedgeManager {
   }
 
   /**
-   * 未実現損益計算（簡易版）
+   * 未実現損益計算
    */
   private calculateUnrealizedPnL(positions: Position[]): number {
-    // 簡易実装：実際はリアルタイム価格で計算する必要がある
     return positions.reduce((sum, p) => sum + this.calculatePositionPnL(p), 0);
   }
 
   /**
-   * ポジション損益計算
+   * ポジション損益計算（EAのDLLが送信した最新の評価損益。未受信・未約定は0）
    */
   private calculatePositionPnL(position: Position): number {
-    // 簡易実装：現在価格がないため0を返す
-    // 実際の実装では現在価格と約定価格の差から計算
-    return 0;
+    if (!position.mtTicket) return 0;
+    return this.livePnL.get(position.accountId)?.get(position.mtTicket) ?? 0;
   }
 
   /**
@@ -567,9 +635,10 @@ export class HedgeManager {
   /**
    * マージン影響見積もり
    */
-  private estimateMarginImpact(symbol: Symbol, volume: number): number {
-    // 簡易実装：シンボルとボリュームから推定
-    const baseMargin = 1000; // 1ロットあたりのベースマージン
+  private estimateMarginImpact(accountId: string, symbol: Symbol, volume: number): number {
+    // EAから共有された1ロットの必要証拠金を使用（未受信の場合のみ概算）
+    const spec = this.symbolSpecs.get(accountId)?.get(symbol);
+    const baseMargin = spec && spec.marginPerLot > 0 ? spec.marginPerLot : 1000;
     return volume * baseMargin;
   }
 
@@ -8,6 +8,7 @@ interface PriceData {
   spread?: number;
 }
 import { TrailEngine } from './trail-engine';
+import { WSOpportunityEvent, WSPriceAlertEvent, WSPriceStatsEvent } from './types';
 
 export interface PriceStatistics {
   symbol: string;
@@ -17,12 +18,17 @@ export interface PriceStatistics {
   maxSpread: number;
   avgPrice: number;
   volatility: number;
+  shortVolatility?: number;
+  high?: number;
+  low?: number;
+  ewma?: number;
+  tickRate?: number;
   lastUpdate: Date;
 }
 
 export interface PriceAlert {
   symbol: string;
-  type: 'significant_move' | 'wide_spread' | 'stale_price' | 'volatility_spike';
+  type: 'significant_move' | 'wide_spread' | 'stale_price' | 'volatility_spike' | 'level_cross' | 'spread_opportunity';
   message: string;
   timestamp: Date;
   value: number;
@@ -40,10 +46,14 @@ export interface PriceUpdate {
 
 export class PriceMonitor {
   private priceData: Map<string, PriceData> = new Map();
-  private priceHistory: Map<string, PriceData[]> = new Map();
+  private previousPriceData: Map<string, PriceData> = new Map();
+  // 統計はDLLの PRICE_STATS（直近1024ティックのストリーミング集計）から受け取る
   private priceStats: Map<string, PriceStatistics> = new Map();
   private alerts: PriceAlert[] = [];
-  private maxHistorySize = 1000;
+  // 開いている口座間スプレッドの機会（symbol|売り口座|買い口座 → 最新の OPPORTUNITY）
+  private opportunities: Map<string, WSOpportunityEvent> = new Map();
+  // 組ごとに反映済みの最大の通番（OPEN / CLOSED の到着順が前後した場合の古い通知を捨てる）
+  private opportunitySequences: Map<string, number> = new Map();
   private maxAlertsSize = 100;
   private subscribers: Map<string, ((price: number) => void)[]> = new Map();
   private trailEngine?: TrailEngine;
@@ -165,26 +175,90 @@ export class PriceMonitor {
   updatePrice(priceData: PriceData): void {
     const previousPrice = this.priceData.get(priceData.symbol);
     
-    // 現在価格の更新
+    // 現在価格の更新（直前の価格は大幅変動の判定用に1件だけ保持）
+    if (previousPrice) {
+      this.previousPriceData.set(priceData.symbol, previousPrice);
+    }
     this.priceData.set(priceData.symbol, priceData);
     
-    // 価格履歴の更新
-    this.updatePriceHistory(priceData);
-    
-    // 統計情報の更新
-    this.updatePriceStatistics(priceData);
-    
     // アラートチェック
     this.checkPriceAlerts(priceData, previousPrice);
   }
   
-  getCurrentPrice(symbol: string): PriceData | null {
-    return this.priceData.get(symbol) || null;
+  /**
+   * DLLからの価格統計（PRICE_STATS）の反映
+   */
+  applyPriceStats(event: WSPriceStatsEvent): void {
+    const stats: PriceStatistics = {
+      symbol: event.symbol,
+      count: event.ticks,
+      avgSpread: event.spreadMean,
+      minSpread: event.spreadMin,
+      maxSpread: event.spreadMax,
+      avgPrice: event.mean,
+      volatility: event.volatility,
+      shortVolatility: event.shortVolatility,
+      high: event.high,
+      low: event.low,
+      ewma: event.ewma,
+      tickRate: event.tickRate,
+      lastUpdate: new Date(event.timestamp)
+    };
+    
+    this.priceStats.set(event.symbol, stats);
+    this.checkVolatilitySpike(stats);
   }
   
-  getPriceHistory(symbol: string, count?: number): PriceData[] {
-    const history = this.priceHistory.get(symbol) || [];
-    return count ? history.slice(-count) : [...history];
+  /**
+   * DLLの価格アラート発火（PRICE_ALERT）の反映
+   * 水準の判定はDLL側で行われ、到達した水準のみ通知される
+   */
+  applyPriceAlert(event: WSPriceAlertEvent): void {
+    this.addAlerts([{
+      symbol: event.symbol,
+      type: 'level_cross',
+      message: `Price ${event.direction === 'ABOVE' ? 'rose above' : 'fell below'} ${event.level} (${event.alertId})`,
+      timestamp: new Date(event.timestamp),
+      value: event.price,
+      threshold: event.level
+    }]);
+  }
+  
+  /**
+   * DLLの口座間スプレッドの機会（OPPORTUNITY）の反映
+   * 判定（費用控除・ヒステリシス・持続時間）はDLL側で行われ、開始と終了のみ通知される
+   * 到着順は前後しうるため、組ごとに sequence が反映済みより小さい通知は捨てる
+   */
+  applyOpportunity(event: WSOpportunityEvent): void {
+    const key = `${event.symbol}|${event.sellAccountId}|${event.buyAccountId}`;
+    const lastSequence = this.opportunitySequences.get(key);
+    if (lastSequence !== undefined && event.sequence <= lastSequence) {
+      return;
+    }
+    this.opportunitySequences.set(key, event.sequence);
+    if (event.state === 'OPEN') {
+      this.opportunities.set(key, event);
+      this.addAlerts([{
+        symbol: event.symbol,
+        type: 'spread_opportunity',
+        message: `Sell ${event.sellAccountId} @ ${event.sellBid} / buy ${event.buyAccountId} @ ${event.buyAsk} ` +
+          `(net ${event.netSpread}, gross ${event.grossSpread})`,
+        timestamp: new Date(event.timestamp),
+        value: event.netSpread,
+        threshold: event.threshold
+      }]);
+    } else {
+      this.opportunities.delete(key);
+    }
+  }
+
+  getOpportunities(symbol?: string): WSOpportunityEvent[] {
+    const opportunities = Array.from(this.opportunities.values());
+    return symbol ? opportunities.filter(opportunity => opportunity.symbol === symbol) : opportunities;
+  }
+
+  getCurrentPrice(symbol: string): PriceData | null {
+    return this.priceData.get(symbol) || null;
   }
   
   getPriceStatistics(symbol: string): PriceStatistics | null {
@@ -195,31 +269,16 @@ export class PriceMonitor {
     return Array.from(this.priceStats.values());
   }
   
-  calculateVolatility(symbol: string, periods: number = 20): number {
-    const history = this.getPriceHistory(symbol, periods);
-    if (history.length < 2) return 0;
-    
-    const prices = history.map(h => (h.bid + h.ask) / 2);
-    const returns = [];
-    
-    for (let i = 1; i < prices.length; i++) {
-      returns.push(Math.log(prices[i] / prices[i - 1]));
-    }
-    
-    if (returns.length === 0) return 0;
-    
-    const mean = returns.reduce((sum, ret) => sum + ret, 0) / returns.length;
-    const variance = returns.reduce((sum, ret) => sum + Math.pow(ret - mean, 2), 0) / returns.length;
-    
-    return Math.sqrt(variance * 252); // 年間ボラティリティ
+  getVolatility(symbol: string): number {
+    return this.priceStats.get(symbol)?.volatility ?? 0;
   }
   
   isSignificantPriceMove(symbol: string, threshold?: number): boolean {
     const moveThreshold = threshold || this.alertSettings.significantMoveThreshold;
-    const history = this.getPriceHistory(symbol, 2);
-    if (history.length < 2) return false;
+    const prev = this.previousPriceData.get(symbol);
+    const current = this.priceData.get(symbol);
+    if (!prev || !current) return false;
     
-    const [prev, current] = history.slice(-2);
     const prevMid = (prev.bid + prev.ask) / 2;
     const currentMid = (current.bid + current.ask) / 2;
     
@@ -248,61 +307,23 @@ export class PriceMonitor {
     return (price.spread || 0) / midPrice > spreadThreshold;
   }
   
-  private updatePriceHistory(priceData: PriceData): void {
-    const history = this.priceHistory.get(priceData.symbol) || [];
-    history.push(priceData);
-    
-    if (history.length > this.maxHistorySize) {
-      history.shift();
-    }
-    
-    this.priceHistory.set(priceData.symbol, history);
-  }
-  
-  private updatePriceStatistics(priceData: PriceData): void {
-    const currentStats = this.priceStats.get(priceData.symbol);
-    const history = this.priceHistory.get(priceData.symbol) || [];
-    
-    if (history.length === 0) return;
-    
-    const spreads = history.map(h => h.spread || 0).filter(s => s > 0);
-    const prices = history.map(h => (h.bid + h.ask) / 2);
-    
-    const stats: PriceStatistics = {
-      symbol: priceData.symbol,
-      count: history.length,
-      avgSpread: spreads.length > 0 ? spreads.reduce((sum, s) => (sum || 0) + (s || 0), 0) / spreads.length : 0,
-      minSpread: spreads.length > 0 ? Math.min(...spreads) : 0,
-      maxSpread: spreads.length > 0 ? Math.max(...spreads) : 0,
-      avgPrice: prices.reduce((sum, p) => (sum || 0) + (p || 0), 0) / prices.length,
-      volatility: this.calculateVolatility(priceData.symbol),
-      lastUpdate: priceData.timestamp || new Date()
-    };
-    
-    this.priceStats.set(priceData.symbol, stats);
-  }
-  
   private checkPriceAlerts(priceData: PriceData, previousPrice?: PriceData): void {
     const alerts: PriceAlert[] = [];
     
     // 大幅な価格変動チェック
-    if (this.isSignificantPriceMove(priceData.symbol)) {
-      const history = this.getPriceHistory(priceData.symbol, 2);
-      if (history.length >= 2) {
-        const [prev, current] = history.slice(-2);
-        const prevMid = (prev.bid + prev.ask) / 2;
-        const currentMid = (current.bid + current.ask) / 2;
-        const change = Math.abs(currentMid - prevMid) / prevMid;
-        
-        alerts.push({
-          symbol: priceData.symbol,
-          type: 'significant_move',
-          message: `Significant price move detected: ${(change * 100).toFixed(3)}%`,
-          timestamp: priceData.timestamp || new Date(),
-          value: change,
-          threshold: this.alertSettings.significantMoveThreshold
-        });
-      }
+    if (previousPrice && this.isSignificantPriceMove(priceData.symbol)) {
+      const prevMid = (previousPrice.bid + previousPrice.ask) / 2;
+      const currentMid = (priceData.bid + priceData.ask) / 2;
+      const change = Math.abs(currentMid - prevMid) / prevMid;
+      
+      alerts.push({
+        symbol: priceData.symbol,
+        type: 'significant_move',
+        message: `Significant price move detected: ${(change * 100).toFixed(3)}%`,
+        timestamp: priceData.timestamp || new Date(),
+        value: change,
+        threshold: this.alertSettings.significantMoveThreshold
+      });
     }
     
     // 広いスプレッドチェック
@@ -320,22 +341,27 @@ export class PriceMonitor {
       });
     }
     
-    // ボラティリティスパイクチェック
-    const currentVolatility = this.calculateVolatility(priceData.symbol, 10);
-    const averageVolatility = this.calculateVolatility(priceData.symbol, 100);
+    this.addAlerts(alerts);
+  }
+  
+  // ボラティリティスパイクチェック（直近16ティック vs 直近1024ティック）
+  private checkVolatilitySpike(stats: PriceStatistics): void {
+    const currentVolatility = stats.shortVolatility ?? 0;
+    const averageVolatility = stats.volatility;
     
     if (averageVolatility > 0 && currentVolatility > averageVolatility * this.alertSettings.volatilitySpikeThreshold) {
-      alerts.push({
-        symbol: priceData.symbol,
+      this.addAlerts([{
+        symbol: stats.symbol,
         type: 'volatility_spike',
-        message: `Volatility spike detected: ${currentVolatility.toFixed(4)} vs avg ${averageVolatility.toFixed(4)}`,
-        timestamp: priceData.timestamp ?? new Date(),
+        message: `Volatility spike detected: ${currentVolatility.toExponential(3)} vs avg ${averageVolatility.toExponential(3)}`,
+        timestamp: stats.lastUpdate,
         value: currentVolatility,
         threshold: averageVolatility * this.alertSettings.volatilitySpikeThreshold
-      });
+      }]);
     }
-    
-    // アラートを追加
+  }
+  
+  private addAlerts(alerts: PriceAlert[]): void {
     this.alerts.push(...alerts);
     
     // アラート履歴のサイズ制限
@@ -420,10 +446,10 @@ export class PriceMonitor {
   // デバッグ用メソッド
   clearHistory(symbol?: string): void {
     if (symbol) {
-      this.priceHistory.delete(symbol);
+      this.previousPriceData.delete(symbol);
       this.priceStats.delete(symbol);
     } else {
-      this.priceHistory.clear();
+      this.previousPriceData.clear();
       this.priceStats.clear();
     }
   }
@@ -55,10 +55,25 @@ export enum WSMessageType {
   PONG = 'PONG',
   OPEN = 'OPEN',
   CLOSE = 'CLOSE',
+  MODIFY = 'MODIFY',
   OPENED = 'OPENED',
   CLOSED = 'CLOSED',
   STOPPED = 'STOPPED',
-  ERROR = 'ERROR'
+  ERROR = 'ERROR',
+  COMMAND_ACK = 'COMMAND_ACK',
+  COMMAND_EXPIRED = 'COMMAND_EXPIRED',
+  COMMAND_REJECTED = 'COMMAND_REJECTED',
+  COMMAND_RELEASED = 'COMMAND_RELEASED',
+  LEG_DISPATCHED = 'LEG_DISPATCHED',
+  EXECUTION_STATS = 'EXECUTION_STATS',
+  PRICE_STATS = 'PRICE_STATS',
+  PRICE_ALERT_SET = 'PRICE_ALERT_SET',
+  PRICE_ALERT_CANCEL = 'PRICE_ALERT_CANCEL',
+  PRICE_ALERT = 'PRICE_ALERT',
+  OPPORTUNITY = 'OPPORTUNITY',
+  MARGIN_WARNING = 'MARGIN_WARNING',
+  SYMBOL_SPECS = 'SYMBOL_SPECS',
+  PNL_UPDATE = 'PNL_UPDATE'
 }
 
 export interface WSMessage {
@@ -91,13 +106,26 @@ export interface WSOpenCommand extends WSCommand {
   side: 'BUY' | 'SELL';
   volume: number;
   trailWidth?: number;
+  pairedLeg?: WSPairedLeg;  // 約定後に続けて発注する対のレッグ（同じ端末の口座ならEA DLLが直接発注する）
   metadata?: {
     strategyId?: string;
     executionType?: ExecutionType;
     timestamp: string;
+    executeAt?: string;     // 実行予定時刻（ISO 8601）。EA DLLが保留し、この時刻にEAへ渡す
   };
 }
 
+export interface WSPairedLeg {
+  commandId?: string;
+  accountId: string;
+  positionId: string;
+  actionId?: string;
+  symbol: Symbol;
+  side: 'BUY' | 'SELL';
+  volume: number;
+  ttlMs?: number;
+}
+
 export interface WSCloseCommand extends WSCommand {
   type: WSMessageType.CLOSE;
   positionId: string;
@@ -107,6 +135,7 @@ export interface WSCloseCommand extends WSCommand {
   metadata?: {
     executionType?: ExecutionType;
     timestamp: string;
+    executeAt?: string;     // 実行予定時刻（ISO 8601）
   };
 }
 
@@ -116,6 +145,23 @@ export interface WSModifyStopCommand extends WSCommand {
   stopLoss: number;
 }
 
+/**
+ * SL/TP 変更コマンド
+ * ticket または positionId で対象を指定し、省略した項目は EA 側で現状維持となる（0 で解除）
+ * 同一ポジションへの未処理の MODIFY は EA DLL で最新の1件にまとめられる
+ */
+export interface WSModifyCommand extends WSCommand {
+  type: WSMessageType.MODIFY;
+  positionId?: string;
+  ticket?: number;
+  stopLoss?: number;
+  takeProfit?: number;
+  metadata?: {
+    ttlMs?: number;
+    timestamp: string;
+  };
+}
+
 export interface WSOpenedEvent extends WSEvent {
   type: WSMessageType.OPENED;
   positionId: string;
@@ -123,6 +169,12 @@ export interface WSOpenedEvent extends WSEvent {
   price: number;
   time: string;
   mtTicket?: string;
+  symbol?: string;
+  volume?: number;
+  requestedPrice?: number;
+  slippagePoints?: number;
+  fillLatencyUs?: number;
+  submitToFillUs?: number;
 }
 
 export interface WSClosedEvent extends WSEvent {
@@ -132,6 +184,12 @@ export interface WSClosedEvent extends WSEvent {
   profit: number;
   time: string;
   mtTicket?: string;
+  symbol?: string;
+  volume?: number;
+  requestedPrice?: number;
+  slippagePoints?: number;
+  fillLatencyUs?: number;
+  submitToFillUs?: number;
 }
 
 export interface WSStoppedEvent extends WSEvent {
@@ -142,6 +200,82 @@ export interface WSStoppedEvent extends WSEvent {
   reason: string;
 }
 
+/**
+ * コマンド受領ACK（EA DLLが受信・デコード直後に返す。実行結果は OPENED/CLOSED で別途通知）
+ */
+export interface WSCommandAckEvent extends WSEvent {
+  type: WSMessageType.COMMAND_ACK;
+  commandType: 'OPEN' | 'CLOSE' | 'MODIFY';
+  commandId?: string;
+  commandTimestamp?: string;
+  receivedAtUs: number;
+  queueDepth: number;
+}
+
+/**
+ * コマンド期限切れ通知（TTL超過でEA DLLが実行前に破棄した）
+ */
+export interface WSCommandExpiredEvent extends WSEvent {
+  type: WSMessageType.COMMAND_EXPIRED;
+  commandType: 'OPEN' | 'CLOSE' | 'MODIFY';
+  commandId?: string;
+  commandTimestamp?: string;
+  ageMs: number;
+  ttlMs: number;
+  stage: 'receive' | 'dequeue' | 'schedule';  // schedule: 実行予定時刻から TTL を過ぎた
+}
+
+/**
+ * 発注前リスクチェックでの拒否通知（EA DLLが上限を超える OPEN をEAに渡さずに破棄した）
+ */
+export type RiskRejectReason =
+  | 'INVALID_ORDER'
+  | 'INVALID_VOLUME'
+  | 'MAX_LOT'
+  | 'SYMBOL_EXPOSURE'
+  | 'ACCOUNT_EXPOSURE'
+  | 'ORDER_RATE'
+  | 'MARGIN_HEADROOM';
+
+export interface WSCommandRejectedEvent extends WSEvent {
+  type: WSMessageType.COMMAND_REJECTED;
+  commandType: 'OPEN';
+  commandId?: string;
+  symbol: string;
+  volume: number;
+  reason: RiskRejectReason;
+  limit: number;            // 超えた上限
+  value: number;            // 発注後の値
+}
+
+/**
+ * 実行予定時刻つきコマンドをEAに渡した通知（口座間の同時実行の揃い具合の確認用）
+ */
+export interface WSCommandReleasedEvent extends WSEvent {
+  type: WSMessageType.COMMAND_RELEASED;
+  commandType: 'OPEN' | 'CLOSE' | 'MODIFY';
+  commandId?: string;
+  executeAt: string;
+  releasedAt: string;       // EAに渡した時刻（サーバー時刻に換算）
+  skewUs: number;           // 渡した時刻 - 実行予定時刻（マイクロ秒、正なら遅れ）
+  clockOffsetUs: number;    // EA DLLのクロックスキュー推定値（ローカル - サーバー）
+  scheduledUs: number;      // 受信から渡すまでの保留時間
+}
+
+/**
+ * 対のレッグの扱いの通知（主レッグの OPENED の直後に届く）
+ * LOCAL: EA DLLが直接発注 / PEER: 同一ホストの別の端末のDLLへ共有メモリで直接渡した
+ * UPSTREAM: 対象口座が同じホストにない（または共有メモリで渡せなかった）ため Hedge System が送信する
+ * REJECTED: DLLの期限・リスクチェックで破棄（COMMAND_EXPIRED / COMMAND_REJECTED も届く）/ CANCELLED: 主レッグが約定しなかった
+ */
+export interface WSLegDispatchedEvent extends WSEvent {
+  type: WSMessageType.LEG_DISPATCHED;
+  route: 'LOCAL' | 'PEER' | 'UPSTREAM' | 'REJECTED' | 'CANCELLED';
+  reason?: 'NOT_LOCAL' | 'PEER_BUSY' | 'PRIMARY_REJECTED' | 'PRIMARY_TIMEOUT';
+  dispatchUs: number;       // 主レッグの約定処理から対のレッグをキューに入れるまで（LOCAL / PEER のみ）
+  leg: WSPairedLeg;
+}
+
 export interface WSErrorEvent extends WSEvent {
   type: WSMessageType.ERROR;
   positionId?: string;
@@ -149,6 +283,223 @@ export interface WSErrorEvent extends WSEvent {
   errorCode?: string;
 }
 
+// 約定品質の区間集計（symbol 省略時は口座全体）。ヘッジレッグの口座選択に使用
+export interface WSExecutionStatsEvent extends WSMessage {
+  type: WSMessageType.EXECUTION_STATS;
+  accountId: string;
+  symbol?: string;
+  intervalMs: number;
+  fills: number;
+  rejects: number;
+  rejectRate: number;
+  slippageMean: number;
+  slippageP50: number;
+  slippageP90: number;
+  slippageP99: number;
+  slippageMax: number;
+  latencyP50Us: number;
+  latencyP90Us: number;
+  latencyP99Us: number;
+  latencyMaxUs: number;
+}
+
+// EAハートビートの spread フィールド（直近の時間窓のスプレッド統計、ポイント）
+export interface WSSpreadStats {
+  symbol: string;
+  windowMs: number;
+  count: number;
+  current: number;
+  mean: number;
+  min: number;
+  p50: number;
+  p90: number;
+  p99: number;
+  max: number;
+}
+
+// EAハートビートの commandWait フィールド（DLLのコマンドキューの待ち時間、接続以降の累計、マイクロ秒）
+export interface WSCommandWaitStats {
+  commands: number;
+  throttled: number;            // 口座・通貨ペアのレート上限で待たされたコマンド数
+  meanWaitUs: number;
+  maxWaitUs: number;
+  throttledMeanWaitUs: number;
+  pending: number;
+  scheduled: number;            // 実行予定時刻待ちのコマンド数
+}
+
+// 証拠金維持率の段階の変化（DLLがティックごとに推定し、水準を越えた時点で即時送信）
+export type MarginSeverity = 'NORMAL' | 'WARNING' | 'CRITICAL' | 'MARGIN_CALL' | 'STOP_OUT';
+
+export interface WSMarginWarningEvent extends WSMessage {
+  type: WSMessageType.MARGIN_WARNING;
+  accountId: string;
+  severity: MarginSeverity;
+  previousSeverity: MarginSeverity;
+  marginLevel: number;      // %
+  threshold: number;        // 越えた水準（%）
+  equity: number;
+  margin: number;
+  freeMargin: number;
+  stopOutLevel: number;     // %（0 はブローカーが金額指定）
+  equityToStopOut: number;  // ストップアウトまでの有効証拠金の余裕
+}
+
+// 通貨ペア仕様（EAがDLLに一括登録した SymbolInfo の値。接続ごとに全件、以降は変化分のみ）
+export interface WSSymbolSpec {
+  symbol: string;
+  digits: number;
+  point: number;
+  tickSize: number;
+  tickValue: number;        // 1ロット・1ティックあたりの口座通貨額
+  contractSize: number;
+  volumeMin: number;
+  volumeStep: number;
+  volumeMax: number;
+  marginPerLot: number;     // 1ロットの必要証拠金（口座通貨）
+  marginHedged: number;
+  baseCurrency?: string;
+  profitCurrency?: string;
+  marginCurrency?: string;
+}
+
+export interface WSSymbolSpecsEvent extends WSMessage {
+  type: WSMessageType.SYMBOL_SPECS;
+  accountId: string;
+  version: number;
+  full: boolean;            // true: 全件（置き換え）, false: 差分
+  specs: WSSymbolSpec[];
+}
+
+// 評価損益（DLLがティックごとに全ポジションを差分評価し、変化があった区間だけ定期送信）
+export interface WSPositionPnL {
+  ticket: number;           // MT5 のポジションID
+  symbol: string;
+  volume: number;
+  currentPrice: number;     // 買いは bid、売りは ask
+  pnl: number;              // 口座通貨（決済通貨から仲値で換算）
+  swap: number;
+  converted: boolean;       // false: 価格・換算レート不足で pnl は 0
+}
+
+export interface WSPnLUpdateEvent extends WSMessage {
+  type: WSMessageType.PNL_UPDATE;
+  accountId: string;
+  currency: string;
+  balance: number;
+  equity: number;           // balance + credit + floatingPnl + swap + 確定損益
+  floatingPnl: number;
+  swap: number;
+  unconverted: number;
+  positions: WSPositionPnL[];
+}
+
+// EAハートビートの exposure フィールド（DLLが約定ごとに差分更新する口座のネットエクスポージャー）
+export interface WSExposureSymbol {
+  symbol: string;
+  longVolume: number;
+  shortVolume: number;
+  netVolume: number;        // 買い - 売り（符号付き）
+  longNotional: number;     // ロット × 建値
+  shortNotional: number;
+}
+
+export interface WSExposureSummary {
+  grossVolume: number;      // Σ(買い + 売り)
+  netVolume: number;        // Σ|買い - 売り|
+  hedgeRatio: number;       // 1 - netVolume / grossVolume
+  symbols: WSExposureSymbol[];
+}
+
+// DLLが直近1024ティックから算出する価格統計（生の価格履歴の代わりに定期送信される）
+export interface WSPriceStatsEvent extends WSMessage {
+  type: WSMessageType.PRICE_STATS;
+  symbol: string;
+  ticks: number;
+  bid: number;
+  ask: number;
+  ewma: number;
+  mean: number;
+  high: number;
+  low: number;
+  spreadMean: number;
+  spreadMin: number;
+  spreadMax: number;
+  volatility: number;       // ティック対数リターンの標準偏差
+  shortVolatility: number;  // 直近16ティックの同上
+  tickRate: number;         // ティック / 秒
+}
+
+// 価格アラートの登録（DLLが水準をソート済みの配列で保持し、到達時のみ PRICE_ALERT を返す）
+export interface WSPriceAlertSetCommand extends WSMessage {
+  type: WSMessageType.PRICE_ALERT_SET;
+  alertId: string;
+  symbol: string;
+  level: number;
+  direction?: 'ABOVE' | 'BELOW';  // 省略時は現在値との比較で決定
+}
+
+export interface WSPriceAlertCancelCommand extends WSMessage {
+  type: WSMessageType.PRICE_ALERT_CANCEL;
+  alertId: string;
+}
+
+export interface WSPriceAlertEvent extends WSMessage {
+  type: WSMessageType.PRICE_ALERT;
+  alertId: string;
+  symbol: string;
+  direction: 'ABOVE' | 'BELOW';
+  level: number;
+  price: number;
+  tickTimeMsc?: number;
+}
+
+// 口座間スプレッドの機会（DLLが手数料・スワップ控除後の正味スプレッドで判定し、開始と終了を1回ずつ通知）
+export interface WSOpportunityEvent extends WSMessage {
+  type: WSMessageType.OPPORTUNITY;
+  state: 'OPEN' | 'CLOSED';
+  symbol: string;
+  sellAccountId: string;
+  buyAccountId: string;
+  sellBid: number;
+  buyAsk: number;
+  grossSpread: number;
+  netSpread: number;
+  peakNetSpread: number;
+  threshold: number;
+  durationMs: number;
+  sequence: number;   // 送信元の DLL での通番（同じ組でこれより小さい通知は古い）
+}
+
+// ゲートウェイ（HedgeSystemGateway）経由の口座のフレーム。1本の接続に複数口座が乗るため、上り・下りとも口座IDで包む
+export interface WSAccountFrame {
+  type: 'ACCOUNT_FRAME';
+  accountId: string;
+  message: any;
+}
+
+// EA DLLの送信シーケンス（seq）の再送。DLLは接続ごとに STREAM_RESUME を送り、サーバーは欠落分を RESEND_FROM で要求する
+export interface WSStreamResumeEvent {
+  type: 'STREAM_RESUME';
+  accountId: string;
+  oldestSeq: number;  // 再送リングに残っている最古のシーケンス
+  lastSeq: number;    // 送信済みの最大のシーケンス（0 なら未送信）
+}
+
+export interface WSResendFromCommand {
+  type: 'RESEND_FROM';
+  accountId: string;
+  seq: number;
+}
+
+// 要求したシーケンスが再送リングに残っていない（サーバーは口座の状態を同期し直す）
+export interface WSResendUnavailableEvent {
+  type: 'RESEND_UNAVAILABLE';
+  requestedSeq: number;
+  oldestSeq: number;
+  lastSeq: number;
+}
+
 export interface WSPriceEvent extends WSEvent {
   type: WSMessageType.INFO; // PRICE は INFO に統合
   symbol: string;
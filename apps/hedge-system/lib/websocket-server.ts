@@ -9,6 +9,21 @@ import {
   WSClosedEvent,
   WSStoppedEvent,
   WSErrorEvent,
+  WSCommandAckEvent,
+  WSCommandExpiredEvent,
+  WSCommandRejectedEvent,
+  WSCommandReleasedEvent,
+  WSLegDispatchedEvent,
+  WSPriceStatsEvent,
+  WSPriceAlertEvent,
+  WSOpportunityEvent,
+  WSMarginWarningEvent,
+  WSSymbolSpecsEvent,
+  WSPnLUpdateEvent,
+  WSAccountFrame,
+  WSStreamResumeEvent,
+  WSResendFromCommand,
+  WSResendUnavailableEvent,
   WSPriceEvent,
   WSPongMessage,
   WSOpenCommand,
@@ -16,11 +31,13 @@ import {
   WSModifyStopCommand,
   RealtimePosition, 
   RealtimeAccount,
+  WSExposureSummary,
   ExecutionType,
   Symbol
 } from './types';
 import { amplifyClient } from './amplify-client';
 import { PriceMonitor, PriceUpdate } from './price-monitor';
+import { HedgeManager } from './hedge-manager';
 
 // ========================================
 // 型定義・インターフェース
@@ -85,7 +102,15 @@ export class WebSocketServer {
   private eventUnsubscribe?: () => void;
   private onMessageHandler?: (message: WSEvent, clientId: string) => Promise<void>;
   private priceMonitor?: PriceMonitor;
+  private hedgeManager?: HedgeManager;
   private config?: WSServerConfig;
+
+  // ゲートウェイ経由の口座ID → ゲートウェイの接続ID（ACCOUNT_FRAME の受信で学習）
+  private gatewayAccounts = new Map<string, string>();
+  // 直接接続の接続ID → 口座ID（STREAM_RESUME の受信で学習）
+  private clientAccounts = new Map<string, string>();
+  // 口座ごとの EA DLL の送信シーケンスの受信状況
+  private streams = new Map<string, { lastSeq: number; gapFrom: number; gapTo: number }>();
   
   // 統計情報
   private stats = {
@@ -250,6 +275,12 @@ export class WebSocketServer {
           break;
         case 'disconnection':
           console.log(`🔌 EA disconnected: ${payload.clientId}`);
+          this.clientAccounts.delete(payload.clientId);
+          for (const [accountId, gatewayId] of this.gatewayAccounts) {
+            if (gatewayId === payload.clientId) {
+              this.gatewayAccounts.delete(accountId);
+            }
+          }
           break;
         case 'message':
           this.handleMessage(payload.message, payload.clientId);
@@ -274,7 +305,136 @@ export class WebSocketServer {
   async handleMessage(rawMessage: string, clientId: string): Promise<void> {
     try {
       const message = JSON.parse(rawMessage);
+      await this.unwrapMessage(message, clientId);
       
+    } catch (error) {
+      await this.handleMessageError(error as Error, clientId, rawMessage);
+    }
+  }
+
+  /**
+   * エンベロープの展開
+   * - BATCH: EA DLLのマイクロバッチ
+   * - ACCOUNT_FRAME: ゲートウェイが多重化した口座ごとのフレーム（中身が BATCH の場合もある）
+   * 展開後のフレームは送信シーケンス（seq）で重複を捨ててから処理する
+   */
+  private async unwrapMessage(message: any, clientId: string, accountId?: string): Promise<void> {
+    if (message.type === 'BATCH' && Array.isArray(message.messages)) {
+      for (const inner of message.messages) {
+        await this.unwrapMessage(inner, clientId, accountId);
+      }
+      return;
+    }
+
+    if (message.type === 'ACCOUNT_FRAME' && typeof message.accountId === 'string' && message.message) {
+      this.gatewayAccounts.set(message.accountId, clientId);
+      await this.unwrapMessage(message.message, clientId, message.accountId);
+      return;
+    }
+
+    if (message.type === 'STREAM_RESUME') {
+      await this.handleStreamResume(message as WSStreamResumeEvent, clientId, accountId);
+      return;
+    }
+
+    const streamAccountId = accountId ?? this.clientAccounts.get(clientId);
+    if (message.type === 'RESEND_UNAVAILABLE') {
+      if (streamAccountId) {
+        await this.handleResendUnavailable(message as WSResendUnavailableEvent, streamAccountId);
+      }
+      return;
+    }
+
+    if (typeof message.seq === 'number' && streamAccountId && !this.acceptSequence(streamAccountId, message.seq)) {
+      return;
+    }
+
+    await this.handleParsedMessage(message, clientId);
+  }
+
+  // ========================================
+  // 送信シーケンスの再送（EA DLLの seq / STREAM_RESUME / RESEND_FROM）
+  // ========================================
+
+  /**
+   * 受信済みのシーケンス以下のフレーム（再送と送信待ちの重複）を捨てる
+   * 再送を要求した範囲のフレームは、要求後に届いた新しいフレームより後に届いても受け付ける
+   */
+  private acceptSequence(accountId: string, seq: number): boolean {
+    const stream = this.streams.get(accountId);
+    if (!stream) {
+      this.streams.set(accountId, { lastSeq: seq, gapFrom: 0, gapTo: 0 });
+      return true;
+    }
+
+    if (stream.gapFrom > 0 && seq >= stream.gapFrom && seq <= stream.gapTo) {
+      // DLLは要求した位置から順に再送する
+      stream.gapFrom = seq + 1;
+      if (stream.gapFrom > stream.gapTo) {
+        stream.gapFrom = stream.gapTo = 0;
+      }
+      return true;
+    }
+
+    if (seq <= stream.lastSeq) {
+      return false;
+    }
+    stream.lastSeq = seq;
+    return true;
+  }
+
+  /**
+   * 接続ごとの STREAM_RESUME: 受信済みより先まで送られていれば欠落分を RESEND_FROM で要求する
+   * lastSeq が受信済みより小さければDLLが再起動したため、受信状況を数え直す
+   */
+  private async handleStreamResume(event: WSStreamResumeEvent, clientId: string, gatewayAccountId?: string): Promise<void> {
+    const accountId = gatewayAccountId ?? event.accountId;
+    if (!accountId) {
+      console.warn(`⚠️ STREAM_RESUME without account from ${clientId}`);
+      return;
+    }
+    if (!gatewayAccountId) {
+      this.clientAccounts.set(clientId, accountId);
+    }
+
+    const stream = this.streams.get(accountId);
+    if (!stream || event.lastSeq < stream.lastSeq) {
+      // 初回・DLLの再起動・サーバーの再起動（それ以前の欠落は分からないため、ここから数える）
+      this.streams.set(accountId, { lastSeq: event.lastSeq, gapFrom: 0, gapTo: 0 });
+      return;
+    }
+    if (event.lastSeq === stream.lastSeq) {
+      return;
+    }
+
+    const fromSeq = stream.lastSeq + 1;
+    stream.gapFrom = fromSeq;
+    stream.gapTo = event.lastSeq;
+    stream.lastSeq = event.lastSeq;
+    console.log(`🔁 Requesting resend for ${accountId}: seq ${fromSeq}..${event.lastSeq}`);
+
+    const request: WSResendFromCommand = { type: 'RESEND_FROM', accountId, seq: fromSeq };
+    await this.sendCommand(clientId, request as any);
+  }
+
+  /**
+   * 欠落分がDLLの再送リングに残っていない: 再送を諦め、口座の状態を同期し直す
+   */
+  private async handleResendUnavailable(event: WSResendUnavailableEvent, accountId: string): Promise<void> {
+    const stream = this.streams.get(accountId);
+    if (stream) {
+      stream.gapFrom = stream.gapTo = 0;
+      stream.lastSeq = Math.max(stream.lastSeq, event.lastSeq);
+    }
+    console.warn(`⚠️ Resend unavailable for ${accountId} (requested ${event.requestedSeq}, oldest ${event.oldestSeq}), resyncing`);
+    await this.hedgeManager?.resyncAccount(accountId);
+  }
+
+  /**
+   * パース済みメッセージ処理
+   */
+  private async handleParsedMessage(message: any, clientId: string): Promise<void> {
+    try {
       console.log(`📨 Message from ${clientId}: ${message.type || message.event}`, message);
       
       if (this.isDesignCompliantMessage(message)) {
@@ -293,7 +453,7 @@ export class WebSocketServer {
       this.updateMessageStats();
       
     } catch (error) {
-      await this.handleMessageError(error as Error, clientId, rawMessage);
+      await this.handleMessageError(error as Error, clientId, message);
     }
   }
 
@@ -459,6 +619,102 @@ export class WebSocketServer {
     }
   }
 
+  /**
+   * コマンド受領ACK処理（EA側でのキュー滞留状況の把握用）
+   */
+  private handleCommandAck(event: WSCommandAckEvent): void {
+    console.log(`📬 Command ${event.commandType} received by EA: ${event.positionId} (queue depth: ${event.queueDepth})`);
+  }
+
+  /**
+   * コマンド期限切れ処理（古い価格での約定を避けるためEA側で破棄された）
+   */
+  private async handleCommandExpired(event: WSCommandExpiredEvent): Promise<void> {
+    console.warn(`⌛ Command ${event.commandType} expired before execution: ${event.positionId} (age ${event.ageMs}ms > ttl ${event.ttlMs}ms, ${event.stage})`);
+
+    if (event.actionId) {
+      await (amplifyClient as any).models?.Action?.update({
+        id: event.actionId,
+        status: 'FAILED'
+      });
+    }
+  }
+
+  /**
+   * COMMAND_REJECTED 処理（EA DLLの発注前リスクチェックで破棄された OPEN）
+   */
+  private async handleCommandRejected(event: WSCommandRejectedEvent): Promise<void> {
+    console.warn(`🛡️ Command ${event.commandType} rejected by risk gate: ${event.positionId} ` +
+      `${event.symbol} ${event.volume} lots (${event.reason}: ${event.value}, limit ${event.limit})`);
+
+    if (event.actionId) {
+      await (amplifyClient as any).models?.Action?.update({
+        id: event.actionId,
+        status: 'FAILED'
+      });
+    }
+  }
+
+  /**
+   * COMMAND_RELEASED 処理（実行予定時刻つきコマンドがEAに渡された）
+   */
+  private handleCommandReleased(event: WSCommandReleasedEvent): void {
+    console.log(`⏱️ Command ${event.commandType} released at ${event.releasedAt}: ${event.positionId} ` +
+      `(target ${event.executeAt}, skew ${event.skewUs}us, clock offset ${event.clockOffsetUs}us)`);
+  }
+
+  /**
+   * LEG_DISPATCHED 処理（主レッグの約定後の対のレッグの扱い）
+   */
+  private async handleLegDispatched(event: WSLegDispatchedEvent): Promise<void> {
+    const leg = event.leg;
+    switch (event.route) {
+      case 'LOCAL':
+        console.log(`🔗 Paired leg ${leg.positionId} dispatched locally by ${event.accountId} (${event.dispatchUs}us after fill)`);
+        break;
+      case 'PEER':
+        // 同一ホストの別の端末へ共有メモリで渡し済み（送信しない。受け取った端末は COMMAND_ACK を返さない）
+        console.log(`🔗 Paired leg ${leg.positionId} handed to ${leg.accountId} over shared memory (${event.dispatchUs}us after fill)`);
+        break;
+      case 'UPSTREAM': {
+        // 対象口座が別の端末のため、通常どおりこちらから送信する
+        const command = {
+          type: WSMessageType.OPEN,
+          timestamp: new Date().toISOString(),
+          commandId: leg.commandId,
+          accountId: leg.accountId,
+          positionId: leg.positionId,
+          actionId: leg.actionId,
+          symbol: leg.symbol,
+          side: leg.side,
+          volume: leg.volume,
+          ttlMs: leg.ttlMs,
+          metadata: {
+            timestamp: new Date().toISOString()
+          }
+        } as unknown as WSOpenCommand;
+
+        const connectionId = this.getConnectionIdFromAccount(leg.accountId);
+        if (!connectionId || !(await this.sendCommand(connectionId, command))) {
+          console.error(`❌ Failed to forward paired leg ${leg.positionId} to account ${leg.accountId}`);
+        }
+        break;
+      }
+      case 'CANCELLED':
+        console.warn(`⛔ Paired leg ${leg.positionId} cancelled: ${event.reason}`);
+        if (leg.actionId) {
+          await (amplifyClient as any).models?.Action?.update({
+            id: leg.actionId,
+            status: 'FAILED'
+          });
+        }
+        break;
+      case 'REJECTED':
+        console.warn(`🛡️ Paired leg ${leg.positionId} rejected by EA DLL checks`);
+        break;
+    }
+  }
+
   /**
    * ERROR イベント処理
    */
@@ -473,6 +729,23 @@ export class WebSocketServer {
     this.messageStats.errors++;
   }
 
+  /**
+   * MARGIN_WARNING 処理（証拠金維持率の段階の変化）
+   */
+  private handleMarginWarning(event: WSMarginWarningEvent): void {
+    const summary = `${event.accountId}: ${event.previousSeverity} → ${event.severity} ` +
+      `(margin level ${event.marginLevel.toFixed(1)}%, threshold ${event.threshold}%, ` +
+      `${event.equityToStopOut.toFixed(2)} to stop-out)`;
+
+    if (event.severity === 'NORMAL') {
+      console.log(`✅ Margin recovered ${summary}`);
+    } else if (event.severity === 'WARNING') {
+      console.warn(`⚠️ Margin warning ${summary}`);
+    } else {
+      console.error(`🚨 Margin ${event.severity} ${summary}`);
+    }
+  }
+
   // ========================================
   // 設計書準拠メッセージ処理
   // ========================================
@@ -505,6 +778,39 @@ export class WebSocketServer {
       case WSMessageType.ERROR:
         await this.handleErrorEvent(message as WSErrorEvent);
         break;
+      case WSMessageType.COMMAND_ACK:
+        this.handleCommandAck(message as WSCommandAckEvent);
+        break;
+      case WSMessageType.COMMAND_EXPIRED:
+        await this.handleCommandExpired(message as WSCommandExpiredEvent);
+        break;
+      case WSMessageType.COMMAND_REJECTED:
+        await this.handleCommandRejected(message as WSCommandRejectedEvent);
+        break;
+      case WSMessageType.COMMAND_RELEASED:
+        this.handleCommandReleased(message as WSCommandReleasedEvent);
+        break;
+      case WSMessageType.LEG_DISPATCHED:
+        await this.handleLegDispatched(message as WSLegDispatchedEvent);
+        break;
+      case WSMessageType.PRICE_STATS:
+        this.priceMonitor?.applyPriceStats(message as WSPriceStatsEvent);
+        break;
+      case WSMessageType.PRICE_ALERT:
+        this.priceMonitor?.applyPriceAlert(message as WSPriceAlertEvent);
+        break;
+      case WSMessageType.OPPORTUNITY:
+        this.priceMonitor?.applyOpportunity(message as WSOpportunityEvent);
+        break;
+      case WSMessageType.MARGIN_WARNING:
+        this.handleMarginWarning(message as WSMarginWarningEvent);
+        break;
+      case WSMessageType.SYMBOL_SPECS:
+        this.hedgeManager?.applySymbolSpecs(message as WSSymbolSpecsEvent);
+        break;
+      case WSMessageType.PNL_UPDATE:
+        this.hedgeManager?.applyPnLUpdate(message as WSPnLUpdateEvent);
+        break;
       case WSMessageType.PONG:
         // ハートビート応答処理
         console.log(`💓 Heartbeat pong received`);
@@ -534,6 +840,9 @@ export class WebSocketServer {
       switch (message.type) {
         case 'heartbeat':
           console.log(`💓 Heartbeat received from ${clientId}`);
+          if (message.exposure && message.account_id) {
+            this.hedgeManager?.applyExposureSnapshot(message.account_id, message.exposure as WSExposureSummary);
+          }
           break;
           
         default:
@@ -555,7 +864,11 @@ export class WebSocketServer {
    */
   async sendCommand(connectionId: string, command: WSCommand): Promise<boolean> {
     try {
-      const message = JSON.stringify(command);
+      // ゲートウェイ経由の口座宛ては ACCOUNT_FRAME で包み、ゲートウェイが該当端末へ振り分ける
+      const viaGateway = this.gatewayAccounts.get(command.accountId) === connectionId;
+      const message = JSON.stringify(viaGateway
+        ? { type: 'ACCOUNT_FRAME', accountId: command.accountId, message: command } as WSAccountFrame
+        : command);
       
       // TODO: Tauri側にクライアント指定のメッセージ送信機能を実装
       this.stats.totalMessagesSent++;
@@ -838,6 +1151,14 @@ export class WebSocketServer {
     console.log('🔧 PriceMonitor set for WebSocket server');
   }
 
+  /**
+   * HedgeManager設定（ハートビートのネットエクスポージャーを反映）
+   */
+  setHedgeManager(hedgeManager: HedgeManager): void {
+    this.hedgeManager = hedgeManager;
+    console.log('🔧 HedgeManager set for WebSocket server');
+  }
+
   /**
    * メッセージハンドラー設定
    */
@@ -881,6 +1202,10 @@ export class WebSocketServer {
    * アカウントIDから接続ID取得
    */
   private getConnectionIdFromAccount(accountId: string): string | null {
+    const gatewayId = this.gatewayAccounts.get(accountId);
+    if (gatewayId) {
+      return gatewayId;
+    }
     // 実装: アクティブ接続から該当するconnectionIdを検索
     // 非同期処理が必要なため、キャッシュベースの実装が必要
     return `conn_${accountId}`; // 仮実装
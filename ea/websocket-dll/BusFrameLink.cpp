@@ -0,0 +1,100 @@
+#include "BusFrameLink.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+long long SteadyMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+BusFrameLink::BusFrameLink(SharedBus& bus)
+    : m_bus(bus),
+      m_nextFrameId(1),
+      m_droppedFrames(0) {
+}
+
+bool BusFrameLink::Send(int target, const std::string& frame, long long nowUs) {
+    if (frame.size() > UINT32_MAX) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    FragmentHeader header;
+    header.frameId = m_nextFrameId++;
+    header.total = static_cast<uint32_t>(frame.size());
+
+    char fragment[BusMessage::kPayloadSize];
+    size_t offset = 0;
+    do {
+        size_t length = std::min(kFragmentBytes, frame.size() - offset);
+        header.offset = static_cast<uint32_t>(offset);
+        std::memcpy(fragment, &header, sizeof(header));
+        std::memcpy(fragment + sizeof(header), frame.data() + offset, length);
+
+        // 受信側は常に取り出し続けているため、満杯は短時間で解消する前提で待つ
+        long long deadlineUs = SteadyMicros() + kSendRetryUs;
+        while (!m_bus.Send(target, BusMessageKind::Frame, fragment, sizeof(header) + length, nowUs)) {
+            if (SteadyMicros() > deadlineUs) {
+                m_droppedFrames++;
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        offset += length;
+    } while (offset < frame.size());
+    return true;
+}
+
+bool BusFrameLink::Accept(const BusMessage& message, std::string& frame) {
+    if (message.kind != static_cast<uint32_t>(BusMessageKind::Frame) || message.length < sizeof(FragmentHeader)) {
+        return false;
+    }
+
+    FragmentHeader header;
+    std::memcpy(&header, message.payload, sizeof(header));
+    const char* data = message.payload + sizeof(header);
+    size_t length = message.length - sizeof(header);
+    if (static_cast<uint64_t>(header.offset) + length > header.total) {
+        return false;
+    }
+
+    // 1断片で完結するフレームは組み立て用のバッファを経由しない
+    if (header.offset == 0 && length == header.total) {
+        frame.assign(data, length);
+        return true;
+    }
+
+    Partial& partial = m_partials[message.from];
+    if (header.offset == 0) {
+        if (!partial.buffer.empty()) {
+            m_droppedFrames++;
+        }
+        partial.frameId = header.frameId;
+        partial.total = header.total;
+        partial.buffer.clear();
+        partial.buffer.reserve(header.total);
+    } else if (partial.frameId != header.frameId || partial.buffer.size() != header.offset) {
+        // 先頭を取りこぼしたフレームの続き（送信側が途中で諦めた場合など）
+        partial.buffer.clear();
+        return false;
+    }
+
+    partial.buffer.append(data, length);
+    if (partial.buffer.size() < partial.total) {
+        return false;
+    }
+
+    frame.swap(partial.buffer);
+    partial.buffer.clear();
+    return true;
+}
+
+void BusFrameLink::Reset() {
+    m_partials.clear();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#ifndef BUSFRAMELINK_H
+#define BUSFRAMELINK_H
+
+#include "SharedBus.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 共有メモリバス上で任意長のフレーム（WebSocket のテキストフレーム）を受け渡す
+// BusMessage の payload に収まらないフレームは断片に分けて送り、受信側で送信元ごとに組み立て直す。
+// 1プロセス内の送信は直列化するため、同じ送信元の断片は受信リング上で混ざらない
+class BusFrameLink {
+public:
+    // 相手の受信リングが満杯のとき、断片ごとに待つ上限
+    static constexpr long long kSendRetryUs = 2000;
+
+    explicit BusFrameLink(SharedBus& bus);
+
+    // target へフレームを送る（途中で送れなくなった場合は false。受信側は組み立て途中の分を捨てる）
+    bool Send(int target, const std::string& frame, long long nowUs);
+
+    // BusMessageKind::Frame の断片を受け取り、フレームが揃ったら frame に入れて true を返す（受信スレッドのみ）
+    bool Accept(const BusMessage& message, std::string& frame);
+
+    // 参加し直した送信元の組み立て途中の分を捨てる（受信スレッドのみ）
+    void Reset();
+
+    long long DroppedFrames() const { return m_droppedFrames; }
+
+private:
+    struct FragmentHeader {
+        uint64_t frameId;
+        uint32_t offset;
+        uint32_t total;
+    };
+
+    struct Partial {
+        uint64_t frameId = 0;
+        uint32_t total = 0;
+        std::string buffer;
+    };
+
+    static constexpr size_t kFragmentBytes = BusMessage::kPayloadSize - sizeof(FragmentHeader);
+
+    SharedBus& m_bus;
+    std::mutex m_sendMutex;
+    uint64_t m_nextFrameId;
+    std::unordered_map<int, Partial> m_partials;
+    std::atomic<long long> m_droppedFrames;
+};
+
+#endif // BUSFRAMELINK_H
@@ -0,0 +1,46 @@
+#include "ClockSkewEstimator.h"
+#include <algorithm>
+
+void ClockSkewEstimator::Window::Add(int64_t sample) {
+    samples[next] = sample;
+    next = (next + 1) % kWindowSize;
+    count = std::min(count + 1, kWindowSize);
+}
+
+int64_t ClockSkewEstimator::Window::Min() const {
+    return *std::min_element(samples.begin(), samples.begin() + count);
+}
+
+ClockSkewEstimator::ClockSkewEstimator()
+    : m_offsetMicros(0), m_hasEstimate(false) {
+}
+
+void ClockSkewEstimator::AddSample(std::chrono::system_clock::time_point serverTime,
+                                   std::chrono::system_clock::time_point localTime, bool heartbeat) {
+    int64_t sample = std::chrono::duration_cast<std::chrono::microseconds>(localTime - serverTime).count();
+    (heartbeat ? m_heartbeats : m_others).Add(sample);
+
+    // ハートビートの標本がないうちは推定しない（オフセット 0 のまま）
+    if (m_heartbeats.count == 0) {
+        return;
+    }
+
+    int64_t offset = m_heartbeats.Min();
+    if (m_others.count > 0) {
+        offset = std::min(offset, m_others.Min());
+    }
+    m_offsetMicros.store(offset, std::memory_order_relaxed);
+    m_hasEstimate.store(true, std::memory_order_release);
+}
+
+std::chrono::system_clock::time_point ClockSkewEstimator::ToLocal(std::chrono::system_clock::time_point serverTime) const {
+    return serverTime + std::chrono::microseconds(m_offsetMicros.load(std::memory_order_relaxed));
+}
+
+int64_t ClockSkewEstimator::OffsetMicros() const {
+    return m_offsetMicros.load(std::memory_order_relaxed);
+}
+
+bool ClockSkewEstimator::HasEstimate() const {
+    return m_hasEstimate.load(std::memory_order_acquire);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#ifndef CLOCKSKEWESTIMATOR_H
+#define CLOCKSKEWESTIMATOR_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// サーバー時刻とローカル時刻の差（クロックスキュー）推定
+// 受信フレームごとに (ローカル受信時刻 - サーバー送信時刻) を標本とし、直近の標本の最小値を採用する。
+// 最小値には最短の片道遅延が含まれるため、推定値で補正した経過時間は
+// 「最速で届いた場合と比べてどれだけ滞留したか」を表す
+// 推定はハートビート（PING / PONG / HEARTBEAT_ACK）の標本が届いてから有効にし、推定値はハートビートの標本の最小値を
+// 上回らない。再接続後に再送された古いコマンドなどの標本は推定値を下げる方向にしか効かず、
+// 滞留分をオフセットに取り込んで有効期限の判定をすり抜けることはない
+class ClockSkewEstimator {
+public:
+    ClockSkewEstimator();
+
+    // 標本の追加（ioスレッドから呼び出す。heartbeat はハートビートの標本）
+    void AddSample(std::chrono::system_clock::time_point serverTime,
+                   std::chrono::system_clock::time_point localTime, bool heartbeat);
+
+    // サーバー時刻をローカル時刻に換算（任意のスレッドから呼び出し可。推定前は補正しない）
+    std::chrono::system_clock::time_point ToLocal(std::chrono::system_clock::time_point serverTime) const;
+
+    // 現在の推定オフセット（マイクロ秒、ローカル - サーバー）
+    int64_t OffsetMicros() const;
+
+    bool HasEstimate() const;
+
+private:
+    static constexpr size_t kWindowSize = 32;
+
+    struct Window {
+        std::array<int64_t, kWindowSize> samples{};
+        size_t count = 0;
+        size_t next = 0;
+
+        void Add(int64_t sample);
+        int64_t Min() const;
+    };
+
+    Window m_heartbeats;
+    Window m_others;
+    std::atomic<int64_t> m_offsetMicros;
+    std::atomic<bool> m_hasEstimate;
+};
+
+#endif // CLOCKSKEWESTIMATOR_H
@@ -0,0 +1,81 @@
+#include "CommandDecoder.h"
+#include "WireMessages.h"
+
+namespace {
+
+CommandType ParseCommandType(const std::string& name) {
+    if (name == "OPEN" || name == "open") {
+        return CommandType::Open;
+    }
+    if (name == "CLOSE" || name == "close") {
+        return CommandType::Close;
+    }
+    if (name == "MODIFY" || name == "modify" || name == "modify_position") {
+        return CommandType::Modify;
+    }
+    return CommandType::None;
+}
+
+} // namespace
+
+bool DecodeCommand(const std::string& message, DecodedCommand& command) {
+    CommandFrame frame;
+    if (!schema::DecodeJson(message, frame)) {
+        return false;
+    }
+
+    CommandType commandType = ParseCommandType(frame.type);
+    if (commandType == CommandType::None && frame.type == "command") {
+        // レガシー形式: 種別は "command" または "action" フィールド
+        commandType = ParseCommandType(frame.command);
+    }
+
+    if (commandType == CommandType::None) {
+        return false;
+    }
+
+    command = DecodedCommand();
+    command.type = commandType;
+    command.commandId = std::move(frame.commandId);
+    command.accountId = std::move(frame.accountId);
+    command.positionId = std::move(frame.positionId);
+    command.actionId = std::move(frame.actionId);
+    command.symbol = std::move(frame.symbol);
+    command.side = std::move(frame.side);
+    command.volume = frame.volume;
+    command.ticket = frame.ticket;
+    command.stopLoss = frame.stopLoss;
+    command.takeProfit = frame.takeProfit;
+    command.timestamp = !frame.metadata.timestamp.empty() ? std::move(frame.metadata.timestamp) : std::move(frame.timestamp);
+
+    long long ttlMs = frame.metadata.ttlMs > 0 ? frame.metadata.ttlMs : frame.ttlMs;
+    command.ttlMs = ttlMs > 0 ? ttlMs : 0;
+    command.executeAt = !frame.metadata.executeAt.empty() ? std::move(frame.metadata.executeAt) : std::move(frame.executeAt);
+
+    if (commandType == CommandType::Open) {
+        PairedLeg& leg = command.pairedLeg;
+        leg.commandId = std::move(frame.pairedLeg.commandId);
+        leg.accountId = std::move(frame.pairedLeg.accountId);
+        leg.positionId = std::move(frame.pairedLeg.positionId);
+        leg.actionId = std::move(frame.pairedLeg.actionId);
+        leg.symbol = std::move(frame.pairedLeg.symbol);
+        leg.side = std::move(frame.pairedLeg.side);
+        leg.volume = frame.pairedLeg.volume;
+        leg.ttlMs = frame.pairedLeg.ttlMs > 0 ? frame.pairedLeg.ttlMs : 0;
+    }
+
+    return true;
+}
+
+const char* CommandTypeName(CommandType type) {
+    switch (type) {
+        case CommandType::Open:
+            return "OPEN";
+        case CommandType::Close:
+            return "CLOSE";
+        case CommandType::Modify:
+            return "MODIFY";
+        default:
+            return "NONE";
+    }
+}
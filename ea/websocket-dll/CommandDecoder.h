@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef COMMANDDECODER_H
+#define COMMANDDECODER_H
+
+#include "MessageSchema.h"
+#include <string>
+
+// Hedge System → EA コマンドの種別
+enum class CommandType {
+    None,
+    Open,
+    Close,
+    Modify
+};
+
+// OPEN に添えられた対のレッグ（主レッグの約定後、DLLが同じ端末のEAへ直接渡す）
+struct PairedLeg {
+    std::string commandId;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    std::string symbol;
+    std::string side;
+    double volume = 0.0;
+    long long ttlMs = 0;
+
+    bool Present() const { return !accountId.empty() && !positionId.empty(); }
+};
+
+// デコード済みコマンド
+struct DecodedCommand {
+    CommandType type = CommandType::None;
+    std::string commandId;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    std::string symbol;
+    std::string side;
+    double volume = 0.0;
+    long long ticket = 0;              // MODIFY: 対象チケット（0 の場合は positionId で特定）
+    schema::FixedPrice stopLoss;       // MODIFY: 新しいSL（present == false なら現状維持）
+    schema::FixedPrice takeProfit;     // MODIFY: 新しいTP（present == false なら現状維持）
+    std::string timestamp;   // サーバー送信時刻（ISO 8601、metadata.timestamp 優先）
+    long long ttlMs = 0;     // コマンド個別の有効期限（0 の場合は種別ごとの既定値）
+    std::string executeAt;   // 実行予定時刻（ISO 8601、サーバー時刻、metadata.executeAt 優先。空なら即時実行）
+    PairedLeg pairedLeg;     // OPEN: 約定後に続けて発注する対のレッグ（Present() == false ならなし）
+};
+
+// 受信フレームをコマンドとしてデコード（コマンドでない場合は false）
+// フィールド定義は WireMessages.h の CommandFrame を参照
+// 対応フォーマット:
+//   {"type":"OPEN"|"CLOSE"|"MODIFY", ...}
+//   {"type":"command","command"|"action":"open"|"close"|"modify_position", ...}（レガシー）
+bool DecodeCommand(const std::string& message, DecodedCommand& command);
+
+// コマンド種別名（"OPEN" 等）
+const char* CommandTypeName(CommandType type);
+
+#endif // COMMANDDECODER_H
@@ -0,0 +1,159 @@
+#include "CommandScheduler.h"
+#include <algorithm>
+#include <thread>
+
+CommandScheduler::CommandScheduler()
+    : m_cursorTick(0),
+      m_wheelCount(0) {
+}
+
+long long CommandScheduler::NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void CommandScheduler::Schedule(InboundMessage message, long long dueUs, long long nowUs) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_wheelCount == 0) {
+            // 空のホイールはカーソルを現在時刻（過去の予定時刻ならその時刻）まで進めてから使う
+            m_cursorTick = std::min(dueUs, nowUs) / kSlotUs;
+            RefillLocked();
+        }
+
+        Entry entry;
+        entry.dueUs = dueUs;
+        entry.message = std::move(message);
+        InsertLocked(std::move(entry));
+    }
+    m_changed.notify_all();
+}
+
+void CommandScheduler::InsertLocked(Entry entry) {
+    long long tick = entry.dueUs / kSlotUs;
+    if (tick >= m_cursorTick + static_cast<long long>(kSlotCount)) {
+        m_overflow.emplace(entry.dueUs, std::move(entry.message));
+        return;
+    }
+
+    tick = std::max(tick, m_cursorTick);
+    m_slots[static_cast<size_t>(tick % static_cast<long long>(kSlotCount))].push_back(std::move(entry));
+    m_wheelCount++;
+}
+
+void CommandScheduler::RefillLocked() {
+    long long horizonUs = (m_cursorTick + static_cast<long long>(kSlotCount)) * kSlotUs;
+    while (!m_overflow.empty() && m_overflow.begin()->first < horizonUs) {
+        auto it = m_overflow.begin();
+        Entry entry;
+        entry.dueUs = it->first;
+        entry.message = std::move(it->second);
+        m_overflow.erase(it);
+        InsertLocked(std::move(entry));
+    }
+}
+
+bool CommandScheduler::PopDueLocked(long long nowUs, Entry& entry) {
+    long long nowTick = nowUs / kSlotUs;
+
+    while (true) {
+        if (m_wheelCount == 0) {
+            if (m_overflow.empty()) {
+                return false;
+            }
+            // ホイールが空なら次のコマンドの位置（現在時刻を超えない範囲）までカーソルを飛ばす
+            long long target = std::min(m_overflow.begin()->first / kSlotUs, nowTick);
+            m_cursorTick = std::max(m_cursorTick, target);
+            RefillLocked();
+            if (m_wheelCount == 0) {
+                return false;
+            }
+        }
+
+        auto& slot = m_slots[static_cast<size_t>(m_cursorTick % static_cast<long long>(kSlotCount))];
+        if (!slot.empty()) {
+            auto earliest = std::min_element(slot.begin(), slot.end(), [](const Entry& a, const Entry& b) {
+                return a.dueUs < b.dueUs;
+            });
+            if (earliest->dueUs <= nowUs) {
+                entry = std::move(*earliest);
+                if (earliest != slot.end() - 1) {
+                    *earliest = std::move(slot.back());
+                }
+                slot.pop_back();
+                m_wheelCount--;
+                return true;
+            }
+        }
+
+        // 現在時刻のスロットに達したら、残りは同じミリ秒内のまだ早いコマンド
+        if (m_cursorTick >= nowTick) {
+            return false;
+        }
+
+        m_cursorTick++;
+        RefillLocked();
+    }
+}
+
+long long CommandScheduler::EarliestLocked() const {
+    if (m_wheelCount > 0) {
+        for (size_t offset = 0; offset < kSlotCount; ++offset) {
+            const auto& slot = m_slots[static_cast<size_t>((m_cursorTick + static_cast<long long>(offset)) %
+                                                           static_cast<long long>(kSlotCount))];
+            if (slot.empty()) {
+                continue;
+            }
+            long long earliest = slot.front().dueUs;
+            for (const auto& entry : slot) {
+                earliest = std::min(earliest, entry.dueUs);
+            }
+            return earliest;
+        }
+    }
+    return m_overflow.empty() ? -1 : m_overflow.begin()->first;
+}
+
+bool CommandScheduler::WaitNext(long long timeoutUs, InboundMessage& message, long long& dueUs) {
+    long long limitUs = NowMicros() + std::max(0LL, timeoutUs);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        long long nowUs = NowMicros();
+        Entry entry;
+        if (PopDueLocked(nowUs, entry)) {
+            message = std::move(entry.message);
+            dueUs = entry.dueUs;
+            return true;
+        }
+
+        // 期限内に予定時刻を迎えるコマンドがなければ待たない（呼び出し元の EA のスレッドを止めない）
+        long long earliest = EarliestLocked();
+        if (earliest < 0 || earliest > limitUs) {
+            return false;
+        }
+
+        long long remainingUs = earliest - nowUs;
+        if (remainingUs > kSpinUs) {
+            m_changed.wait_until(lock, std::chrono::system_clock::time_point(std::chrono::microseconds(earliest - kSpinUs)));
+            continue;
+        }
+
+        // 予定時刻の直前はロックを離してスピン（追加・取り出しは妨げない）
+        lock.unlock();
+        while (NowMicros() < earliest) {
+            std::this_thread::yield();
+        }
+        lock.lock();
+    }
+}
+
+long long CommandScheduler::NextDueUs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return EarliestLocked();
+}
+
+size_t CommandScheduler::Size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_wheelCount + m_overflow.size();
+}
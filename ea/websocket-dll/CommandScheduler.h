@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef COMMANDSCHEDULER_H
+#define COMMANDSCHEDULER_H
+
+#include "InboundQueue.h"
+#include <array>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// 実行予定時刻つきコマンドの保留（1ms 刻みのタイマーホイール）
+// 予定時刻はローカル時刻（エポックからのマイクロ秒）。ホイールの範囲（kSlotCount ms）より先の
+// コマンドは予定時刻順のオーバーフローに置き、カーソルが近づいた時点でホイールに移す。
+// 予定時刻を過ぎて追加されたコマンドはカーソル位置のスロットに入り、次の取り出しで渡される
+class CommandScheduler {
+public:
+    static const size_t kSlotCount = 1024;
+    static const long long kSlotUs = 1000;
+    // 予定時刻の直前はスリープの分解能（Windows では既定で約 15.6ms）に頼らずスピンで待つ
+    static const long long kSpinUs = 16000;
+
+    CommandScheduler();
+
+    void Schedule(InboundMessage message, long long dueUs, long long nowUs);
+
+    // timeoutUs 以内に予定時刻を迎えるコマンドがあれば予定時刻まで待って取り出す
+    // （timeoutUs == 0 なら予定時刻を過ぎたコマンドのみ）。該当するコマンドがなければ待たずに返す
+    bool WaitNext(long long timeoutUs, InboundMessage& message, long long& dueUs);
+
+    // 次の予定時刻（保留がなければ -1）
+    long long NextDueUs() const;
+
+    size_t Size() const;
+
+    static long long NowMicros();
+
+private:
+    struct Entry {
+        long long dueUs = 0;
+        InboundMessage message;
+    };
+
+    void InsertLocked(Entry entry);
+    void RefillLocked();
+    bool PopDueLocked(long long nowUs, Entry& entry);
+    long long EarliestLocked() const;
+
+    std::array<std::vector<Entry>, kSlotCount> m_slots;
+    std::multimap<long long, InboundMessage> m_overflow;
+    long long m_cursorTick;
+    size_t m_wheelCount;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+};
+
+#endif // COMMANDSCHEDULER_H
@@ -0,0 +1,56 @@
+#include "CommandThrottle.h"
+#include <algorithm>
+
+void CommandThrottle::SetLimits(const ThrottleLimits& limits) {
+    m_limits = limits;
+    // 1件は必ず通せるようにする
+    m_limits.accountBurst = std::max(1.0, limits.accountBurst);
+    m_limits.symbolBurst = std::max(1.0, limits.symbolBurst);
+    m_accounts.clear();
+    m_symbols.clear();
+}
+
+ThrottleResult CommandThrottle::TryAcquire(const std::string& accountId, const std::string& symbol, long long nowUs) {
+    Bucket* account = nullptr;
+    Bucket* pair = nullptr;
+
+    if (m_limits.accountRate > 0.0) {
+        account = &m_accounts[accountId];
+        Refill(*account, m_limits.accountRate, m_limits.accountBurst, nowUs);
+        if (account->tokens < 1.0) {
+            return ThrottleResult::AccountLimited;
+        }
+    }
+    if (m_limits.symbolRate > 0.0 && !symbol.empty()) {
+        pair = &m_symbols[SymbolKey(accountId, symbol)];
+        Refill(*pair, m_limits.symbolRate, m_limits.symbolBurst, nowUs);
+        if (pair->tokens < 1.0) {
+            return ThrottleResult::SymbolLimited;
+        }
+    }
+
+    if (account != nullptr) account->tokens -= 1.0;
+    if (pair != nullptr) pair->tokens -= 1.0;
+    return ThrottleResult::Allowed;
+}
+
+std::string CommandThrottle::SymbolKey(const std::string& accountId, const std::string& symbol) {
+    return accountId + '\x1f' + symbol;
+}
+
+void CommandThrottle::Refill(Bucket& bucket, double rate, double burst, long long nowUs) {
+    if (!bucket.initialized) {
+        bucket.tokens = burst;
+        bucket.lastUs = nowUs;
+        bucket.initialized = true;
+        return;
+    }
+
+    // 時計が戻った場合は補充しない
+    long long elapsedUs = nowUs - bucket.lastUs;
+    if (elapsedUs <= 0) {
+        return;
+    }
+    bucket.tokens = std::min(burst, bucket.tokens + rate * static_cast<double>(elapsedUs) / 1e6);
+    bucket.lastUs = nowUs;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#ifndef COMMANDTHROTTLE_H
+#define COMMANDTHROTTLE_H
+
+#include <string>
+#include <unordered_map>
+
+// コマンドのレート上限（rate は 1秒あたりのコマンド数、0 で無効。burst は連続で通せる数）
+struct ThrottleLimits {
+    double accountRate = 0.0;
+    double accountBurst = 0.0;
+    double symbolRate = 0.0;
+    double symbolBurst = 0.0;
+};
+
+enum class ThrottleResult {
+    Allowed,
+    AccountLimited,
+    SymbolLimited
+};
+
+// 口座ごと・口座 × 通貨ペアごとのトークンバケット
+// 両方のバケットにトークンがある場合のみ1つずつ消費する（片方だけ消費することはない）。
+// スレッドセーフではないため、呼び出し側のロック内で使う
+class CommandThrottle {
+public:
+    void SetLimits(const ThrottleLimits& limits);
+    const ThrottleLimits& Limits() const { return m_limits; }
+    bool Enabled() const { return m_limits.accountRate > 0.0 || m_limits.symbolRate > 0.0; }
+
+    // symbol が空のコマンド（チケット指定の CLOSE 等）は口座のバケットのみ
+    ThrottleResult TryAcquire(const std::string& accountId, const std::string& symbol, long long nowUs);
+
+    static std::string SymbolKey(const std::string& accountId, const std::string& symbol);
+
+private:
+    struct Bucket {
+        double tokens = 0.0;
+        long long lastUs = 0;
+        bool initialized = false;
+    };
+
+    static void Refill(Bucket& bucket, double rate, double burst, long long nowUs);
+
+    ThrottleLimits m_limits;
+    std::unordered_map<std::string, Bucket> m_accounts;
+    std::unordered_map<std::string, Bucket> m_symbols;
+};
+
+#endif // COMMANDTHROTTLE_H
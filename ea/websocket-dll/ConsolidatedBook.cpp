@@ -0,0 +1,235 @@
+#include "ConsolidatedBook.h"
+#include <cstring>
+#include <thread>
+
+ConsolidatedBook::ConsolidatedBook()
+    : m_symbols(new SymbolSlot[kMaxSymbols]) {
+}
+
+ConsolidatedBook::~ConsolidatedBook() = default;
+
+uint64_t ConsolidatedBook::Hash(const char* data, size_t size) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void ConsolidatedBook::WaitReady(const std::atomic<uint32_t>& state) {
+    while (state.load(std::memory_order_acquire) != kReady) {
+        std::this_thread::yield();
+    }
+}
+
+int ConsolidatedBook::Source(const std::string& accountId) {
+    if (accountId.empty() || accountId.size() >= kSourceSize) {
+        return -1;
+    }
+
+    // 先頭から詰めて登録するため、登録済みの口座は空き枠より前にある
+    for (size_t i = 0; i < kMaxSources; i++) {
+        SourceSlot& slot = m_sources[i];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state == kEmpty) {
+            uint32_t expected = kEmpty;
+            if (slot.state.compare_exchange_strong(expected, kClaiming, std::memory_order_acq_rel)) {
+                std::memcpy(slot.name, accountId.c_str(), accountId.size() + 1);
+                slot.state.store(kReady, std::memory_order_release);
+                m_sourceCount.fetch_add(1, std::memory_order_release);
+                return static_cast<int>(i);
+            }
+            state = expected;
+        }
+        if (state == kClaiming) {
+            WaitReady(slot.state);
+        }
+        if (std::strcmp(slot.name, accountId.c_str()) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+std::string ConsolidatedBook::SourceName(int source) const {
+    if (source < 0 || static_cast<size_t>(source) >= kMaxSources ||
+        m_sources[source].state.load(std::memory_order_acquire) != kReady) {
+        return std::string();
+    }
+    return std::string(m_sources[source].name);
+}
+
+int ConsolidatedBook::Lookup(const std::string& symbol, bool insert) {
+    if (symbol.empty() || symbol.size() >= kSymbolSize) {
+        return -1;
+    }
+
+    size_t mask = kMaxSymbols - 1;
+    size_t start = static_cast<size_t>(Hash(symbol.data(), symbol.size())) & mask;
+    for (size_t i = 0; i < kMaxSymbols; i++) {
+        size_t index = (start + i) & mask;
+        SymbolSlot& slot = m_symbols[index];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state == kEmpty) {
+            if (!insert) {
+                return -1;
+            }
+            uint32_t expected = kEmpty;
+            if (slot.state.compare_exchange_strong(expected, kClaiming, std::memory_order_acq_rel)) {
+                std::memcpy(slot.name, symbol.c_str(), symbol.size() + 1);
+                slot.state.store(kReady, std::memory_order_release);
+                m_symbolCount.fetch_add(1, std::memory_order_relaxed);
+                return static_cast<int>(index);
+            }
+            state = expected;
+        }
+        if (state == kClaiming) {
+            WaitReady(slot.state);
+        }
+        if (std::strcmp(slot.name, symbol.c_str()) == 0) {
+            return static_cast<int>(index);
+        }
+    }
+    return -1;
+}
+
+int ConsolidatedBook::Symbol(const std::string& symbol) {
+    return Lookup(symbol, true);
+}
+
+int ConsolidatedBook::FindSymbol(const std::string& symbol) const {
+    return const_cast<ConsolidatedBook*>(this)->Lookup(symbol, false);
+}
+
+bool ConsolidatedBook::Update(int symbol, int source, double bid, double ask, long long timeMsc, long long receivedAtUs) {
+    if (symbol < 0 || static_cast<size_t>(symbol) >= kMaxSymbols ||
+        source < 0 || static_cast<size_t>(source) >= kMaxSources || bid <= 0.0 || ask <= 0.0) {
+        return false;
+    }
+    SymbolSlot& slot = m_symbols[symbol];
+    if (slot.state.load(std::memory_order_acquire) != kReady) {
+        return false;
+    }
+
+    // 同じ通貨ペアの書き込み同士は番号を奇数にした側が先に進む
+    uint64_t seq = 0;
+    for (;;) {
+        seq = slot.seq.load(std::memory_order_relaxed);
+        if ((seq & 1) == 0 &&
+            slot.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    SourceQuote& quote = slot.quotes[source];
+    bool accepted = timeMsc == 0 || quote.timeMsc <= timeMsc;
+    if (accepted) {
+        quote.bid = bid;
+        quote.ask = ask;
+        quote.timeMsc = timeMsc;
+        quote.receivedAtUs = receivedAtUs;
+        Publish(slot, receivedAtUs);
+    }
+
+    slot.seq.store(accepted ? seq + 2 : seq, std::memory_order_release);
+    return accepted;
+}
+
+bool ConsolidatedBook::Update(const std::string& symbol, const std::string& accountId, double bid, double ask,
+                              long long timeMsc, long long receivedAtUs) {
+    return Update(Symbol(symbol), Source(accountId), bid, ask, timeMsc, receivedAtUs);
+}
+
+void ConsolidatedBook::Publish(SymbolSlot& slot, long long nowUs) {
+    long long maxAgeUs = m_maxAgeUs.load(std::memory_order_relaxed);
+    size_t count = m_sourceCount.load(std::memory_order_acquire);
+
+    const SourceQuote* bestBid = nullptr;
+    const SourceQuote* bestAsk = nullptr;
+    int bidSource = -1;
+    int askSource = -1;
+    int sources = 0;
+    for (size_t i = 0; i < count; i++) {
+        const SourceQuote& quote = slot.quotes[i];
+        if (quote.receivedAtUs == 0 || (maxAgeUs > 0 && nowUs - quote.receivedAtUs > maxAgeUs)) {
+            continue;
+        }
+        sources++;
+        // 同値の場合は新しい気配を優先する（約定できる可能性が高い）
+        if (bestBid == nullptr || quote.bid > bestBid->bid ||
+            (quote.bid == bestBid->bid && quote.receivedAtUs > bestBid->receivedAtUs)) {
+            bestBid = &quote;
+            bidSource = static_cast<int>(i);
+        }
+        if (bestAsk == nullptr || quote.ask < bestAsk->ask ||
+            (quote.ask == bestAsk->ask && quote.receivedAtUs > bestAsk->receivedAtUs)) {
+            bestAsk = &quote;
+            askSource = static_cast<int>(i);
+        }
+    }
+    if (bestBid == nullptr) {
+        return;
+    }
+
+    slot.bid.store(bestBid->bid, std::memory_order_relaxed);
+    slot.ask.store(bestAsk->ask, std::memory_order_relaxed);
+    slot.bidSource.store(bidSource, std::memory_order_relaxed);
+    slot.askSource.store(askSource, std::memory_order_relaxed);
+    slot.bidReceivedUs.store(bestBid->receivedAtUs, std::memory_order_relaxed);
+    slot.askReceivedUs.store(bestAsk->receivedAtUs, std::memory_order_relaxed);
+    slot.bidTimeMsc.store(bestBid->timeMsc, std::memory_order_relaxed);
+    slot.askTimeMsc.store(bestAsk->timeMsc, std::memory_order_relaxed);
+    slot.sources.store(sources, std::memory_order_relaxed);
+}
+
+bool ConsolidatedBook::Best(int symbol, BestQuote& quote) const {
+    if (symbol < 0 || static_cast<size_t>(symbol) >= kMaxSymbols) {
+        return false;
+    }
+    const SymbolSlot& slot = m_symbols[symbol];
+    if (slot.state.load(std::memory_order_acquire) != kReady) {
+        return false;
+    }
+
+    for (;;) {
+        uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        quote.bid = slot.bid.load(std::memory_order_relaxed);
+        quote.ask = slot.ask.load(std::memory_order_relaxed);
+        quote.bidSource = slot.bidSource.load(std::memory_order_relaxed);
+        quote.askSource = slot.askSource.load(std::memory_order_relaxed);
+        quote.bidReceivedUs = slot.bidReceivedUs.load(std::memory_order_relaxed);
+        quote.askReceivedUs = slot.askReceivedUs.load(std::memory_order_relaxed);
+        quote.bidTimeMsc = slot.bidTimeMsc.load(std::memory_order_relaxed);
+        quote.askTimeMsc = slot.askTimeMsc.load(std::memory_order_relaxed);
+        quote.sources = slot.sources.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == before) {
+            quote.updates = before / 2;
+            return before != 0;
+        }
+    }
+}
+
+bool ConsolidatedBook::Best(const std::string& symbol, BestQuote& quote) const {
+    return Best(FindSymbol(symbol), quote);
+}
+
+void ConsolidatedBook::SetMaxAgeUs(long long maxAgeUs) {
+    m_maxAgeUs.store(maxAgeUs < 0 ? 0 : maxAgeUs, std::memory_order_relaxed);
+}
+
+size_t ConsolidatedBook::SymbolCount() const {
+    return m_symbolCount.load(std::memory_order_relaxed);
+}
+
+size_t ConsolidatedBook::SourceCount() const {
+    return m_sourceCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#ifndef CONSOLIDATEDBOOK_H
+#define CONSOLIDATEDBOOK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 通貨ペアごとの全口座（ブローカー）の最良気配
+struct BestQuote {
+    double bid = 0.0;                // 最も高い bid
+    double ask = 0.0;                // 最も安い ask
+    int bidSource = -1;              // 最良 bid の提供元番号（ConsolidatedBook::SourceName で口座IDを引く）
+    int askSource = -1;
+    long long bidReceivedUs = 0;     // 最良 bid の受信時刻（UNIXエポックからのマイクロ秒）
+    long long askReceivedUs = 0;
+    long long bidTimeMsc = 0;        // 最良 bid のブローカー側のティック時刻
+    long long askTimeMsc = 0;
+    int sources = 0;                 // 最良気配の計算に使った（期限内の）口座数
+    uint64_t updates = 0;            // この通貨ペアの更新回数
+};
+
+// 複数口座の気配から作る通貨ペアごとの統合気配（最良 bid / 最良 ask と提供元・受信時刻）
+// 通貨ペアと提供元（口座）は固定長の表に登録し、一度登録した番号は変わらない。
+// 通貨ペアごとに最良気配を seqlock で公開するため、読み出し（Best）はロックを取らず、
+// 書き込み中の値を読んだ場合のみ読み直す。通貨ペアの検索はハッシュ表の開番地法で O(1)。
+// 書き込み（Update）は EA・共有メモリバス・ioスレッドから呼ばれるため、同じ通貨ペアへの
+// 書き込み同士だけは seqlock の番号の CAS で順番を待つ（別の通貨ペアは互いに待たない）。
+// 最良気配は書き込みのたびに登録済みの提供元の気配を走査して求め、maxAgeUs より古い気配は除く
+class ConsolidatedBook {
+public:
+    static constexpr size_t kMaxSymbols = 1024;       // 2 の累乗
+    static constexpr size_t kMaxSources = 32;
+    static constexpr size_t kSymbolSize = 32;
+    static constexpr size_t kSourceSize = 64;
+    static constexpr long long kDefaultMaxAgeUs = 5LL * 1000 * 1000;
+
+    ConsolidatedBook();
+    ~ConsolidatedBook();
+
+    ConsolidatedBook(const ConsolidatedBook&) = delete;
+    ConsolidatedBook& operator=(const ConsolidatedBook&) = delete;
+
+    // 提供元（口座）の番号。未登録なら登録する（表が満杯・名前が長すぎる場合は -1）
+    int Source(const std::string& accountId);
+    std::string SourceName(int source) const;
+
+    // 通貨ペアの番号。FindSymbol は登録しない（未登録なら -1）
+    int Symbol(const std::string& symbol);
+    int FindSymbol(const std::string& symbol) const;
+
+    // 提供元の気配を更新して最良気配を公開し直す。同じ提供元でブローカー時刻が戻った気配は捨てる
+    bool Update(int symbol, int source, double bid, double ask, long long timeMsc, long long receivedAtUs);
+    bool Update(const std::string& symbol, const std::string& accountId, double bid, double ask,
+                long long timeMsc, long long receivedAtUs);
+
+    // 最良気配（ロックなし、O(1)）。未登録・気配なしの通貨ペアは false
+    bool Best(int symbol, BestQuote& quote) const;
+    bool Best(const std::string& symbol, BestQuote& quote) const;
+
+    // 最良気配の計算から除く気配の古さ（0 で無制限）。次の更新から反映される
+    void SetMaxAgeUs(long long maxAgeUs);
+
+    size_t SymbolCount() const;
+    size_t SourceCount() const;
+
+private:
+    enum SlotState : uint32_t {
+        kEmpty = 0,
+        kClaiming = 1,     // 登録中（名前の書き込み待ち）
+        kReady = 2
+    };
+
+    // 提供元ごとの気配（書き込み側が通貨ペアの seqlock を取っている間だけ触る）
+    struct SourceQuote {
+        double bid = 0.0;
+        double ask = 0.0;
+        long long timeMsc = 0;
+        long long receivedAtUs = 0;
+    };
+
+    struct SymbolSlot {
+        std::atomic<uint32_t> state{kEmpty};
+        char name[kSymbolSize];
+
+        // seqlock（奇数の間は書き込み中）と公開中の最良気配
+        std::atomic<uint64_t> seq{0};
+        std::atomic<double> bid{0.0};
+        std::atomic<double> ask{0.0};
+        std::atomic<int> bidSource{-1};
+        std::atomic<int> askSource{-1};
+        std::atomic<long long> bidReceivedUs{0};
+        std::atomic<long long> askReceivedUs{0};
+        std::atomic<long long> bidTimeMsc{0};
+        std::atomic<long long> askTimeMsc{0};
+        std::atomic<int> sources{0};
+
+        SourceQuote quotes[kMaxSources];
+    };
+
+    struct SourceSlot {
+        std::atomic<uint32_t> state{kEmpty};
+        char name[kSourceSize];
+    };
+
+    static uint64_t Hash(const char* data, size_t size);
+    static void WaitReady(const std::atomic<uint32_t>& state);
+    int Lookup(const std::string& symbol, bool insert);
+    void Publish(SymbolSlot& slot, long long nowUs);
+
+    std::unique_ptr<SymbolSlot[]> m_symbols;
+    SourceSlot m_sources[kMaxSources];
+    std::atomic<size_t> m_symbolCount{0};
+    std::atomic<size_t> m_sourceCount{0};
+    std::atomic<long long> m_maxAgeUs{kDefaultMaxAgeUs};
+};
+
+#endif // CONSOLIDATEDBOOK_H
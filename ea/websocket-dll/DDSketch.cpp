@@ -0,0 +1,95 @@
+#include "DDSketch.h"
+#include <algorithm>
+#include <cmath>
+
+DDSketch::DDSketch(double relativeAccuracy, double minValue, double maxValue)
+    : m_zeroCount(0), m_count(0), m_min(0.0), m_max(0.0), m_sum(0.0) {
+    if (relativeAccuracy <= 0.0 || relativeAccuracy >= 1.0) relativeAccuracy = 0.01;
+    if (minValue <= 0.0) minValue = 1e-9;
+    if (maxValue < minValue) maxValue = minValue;
+
+    m_gamma = (1.0 + relativeAccuracy) / (1.0 - relativeAccuracy);
+    m_logGamma = std::log(m_gamma);
+    m_minValue = minValue;
+    m_maxValue = maxValue;
+    m_minIndex = static_cast<int>(std::ceil(std::log(minValue) / m_logGamma));
+    int maxIndex = static_cast<int>(std::ceil(std::log(maxValue) / m_logGamma));
+    m_bins.assign(static_cast<size_t>(maxIndex - m_minIndex + 1), 0);
+}
+
+void DDSketch::Add(double value) {
+    if (!(value >= 0.0)) value = 0.0;   // NaN / 負値は 0 扱い
+
+    if (value < m_minValue) {
+        m_zeroCount++;
+    } else {
+        uint32_t& bin = m_bins[static_cast<size_t>(IndexFor(std::min(value, m_maxValue)) - m_minIndex)];
+        if (bin != UINT32_MAX) {
+            bin++;
+        }
+    }
+
+    if (m_count == 0 || value < m_min) m_min = value;
+    if (m_count == 0 || value > m_max) m_max = value;
+    m_count++;
+    m_sum += value;
+}
+
+void DDSketch::Merge(const DDSketch& other) {
+    if (other.m_count == 0 || other.m_bins.size() != m_bins.size() || other.m_minIndex != m_minIndex) {
+        return;
+    }
+
+    for (size_t i = 0; i < m_bins.size(); i++) {
+        uint64_t merged = static_cast<uint64_t>(m_bins[i]) + other.m_bins[i];
+        m_bins[i] = merged > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(merged);
+    }
+    m_zeroCount += other.m_zeroCount;
+
+    if (m_count == 0 || other.m_min < m_min) m_min = other.m_min;
+    if (m_count == 0 || other.m_max > m_max) m_max = other.m_max;
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+}
+
+void DDSketch::Clear() {
+    std::fill(m_bins.begin(), m_bins.end(), 0);
+    m_zeroCount = 0;
+    m_count = 0;
+    m_min = 0.0;
+    m_max = 0.0;
+    m_sum = 0.0;
+}
+
+double DDSketch::Quantile(double quantile) const {
+    if (m_count == 0) {
+        return 0.0;
+    }
+    if (quantile <= 0.0) return m_min;
+    if (quantile >= 1.0) return m_max;
+
+    // 小さい方から rank 番目（0始まり）を含むバケットの代表値
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(m_count - 1));
+    uint64_t cumulative = m_zeroCount;
+    if (rank < cumulative) {
+        return 0.0;
+    }
+
+    for (size_t i = 0; i < m_bins.size(); i++) {
+        cumulative += m_bins[i];
+        if (rank < cumulative) {
+            double value = ValueAt(static_cast<int>(i) + m_minIndex);
+            return std::min(std::max(value, m_min), m_max);
+        }
+    }
+    return m_max;
+}
+
+int DDSketch::IndexFor(double value) const {
+    return static_cast<int>(std::ceil(std::log(value) / m_logGamma));
+}
+
+// バケット (gamma^(i-1), gamma^i] の代表値（相対誤差が最小になる点）
+double DDSketch::ValueAt(int index) const {
+    return 2.0 * std::pow(m_gamma, index) / (m_gamma + 1.0);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#ifndef DDSKETCH_H
+#define DDSKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 固定メモリの DDSketch（相対誤差保証付きの分位点スケッチ）
+// 値を対数スケール（底 gamma = (1 + α) / (1 - α)）のバケットに数え上げ、
+// 任意の分位点を相対誤差 α 以内で返す。バケット数は [minValue, maxValue] から構築時に決まり、
+// 同じ設定のスケッチ同士は加算でマージできる（時間窓のスロットの合算に使用）。
+// スレッドセーフではないため呼び出し側で排他する
+class DDSketch {
+public:
+    DDSketch(double relativeAccuracy, double minValue, double maxValue);
+
+    // 値の追加（minValue 未満は 0 として、maxValue 超は maxValue として数える）
+    void Add(double value);
+
+    // 同じ設定のスケッチを加算
+    void Merge(const DDSketch& other);
+
+    void Clear();
+
+    // 分位点（quantile: 0〜1）。記録なしの場合は 0
+    double Quantile(double quantile) const;
+
+    uint64_t Count() const { return m_count; }
+    double Min() const { return m_count > 0 ? m_min : 0.0; }
+    double Max() const { return m_count > 0 ? m_max : 0.0; }
+    double Mean() const { return m_count > 0 ? m_sum / static_cast<double>(m_count) : 0.0; }
+
+private:
+    int IndexFor(double value) const;
+    double ValueAt(int index) const;
+
+    double m_gamma;
+    double m_logGamma;
+    double m_minValue;
+    double m_maxValue;
+    int m_minIndex;
+    std::vector<uint32_t> m_bins;
+    uint64_t m_zeroCount;
+    uint64_t m_count;
+    double m_min;
+    double m_max;
+    double m_sum;
+};
+
+#endif // DDSKETCH_H
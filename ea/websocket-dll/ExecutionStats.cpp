@@ -0,0 +1,141 @@
+#include "ExecutionStats.h"
+#include <cmath>
+
+ExecutionStats::Entry::Entry()
+    : fills(0), rejects(0),
+      adverseSlippage(kMaxSlippageUnits, kSignificantDigits),
+      favorableSlippage(kMaxSlippageUnits, kSignificantDigits),
+      latency(kMaxLatencyUs, kSignificantDigits) {
+}
+
+void ExecutionStats::Record(const CompletedTrade& trade) {
+    const TradeSubmission& submission = trade.submission;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry* bySymbol = FindOrAssign(submission.accountId, submission.symbol);
+    Entry* byAccount = FindOrAssign(submission.accountId, std::string());
+    if (bySymbol == nullptr || byAccount == nullptr) {
+        m_droppedCount++;
+    }
+    if (bySymbol != nullptr) {
+        RecordInto(*bySymbol, trade);
+    }
+    if (byAccount != nullptr) {
+        RecordInto(*byAccount, trade);
+    }
+}
+
+void ExecutionStats::Collect(std::vector<ExecutionStatsSnapshot>& snapshots) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& entry : m_entries) {
+        if (entry->fills == 0 && entry->rejects == 0) {
+            continue;
+        }
+        snapshots.push_back(MakeSnapshot(*entry));
+        ResetEntry(*entry);
+    }
+}
+
+long long ExecutionStats::DroppedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_droppedCount;
+}
+
+ExecutionStats::Entry* ExecutionStats::FindOrAssign(const std::string& accountId, const std::string& symbol) {
+    Entry* idle = nullptr;
+    for (auto& entry : m_entries) {
+        if (entry->accountId == accountId && entry->symbol == symbol) {
+            return entry.get();
+        }
+        if (idle == nullptr && entry->fills == 0 && entry->rejects == 0) {
+            idle = entry.get();
+        }
+    }
+
+    if (m_entries.size() < kMaxKeys) {
+        m_entries.push_back(std::make_unique<Entry>());
+        idle = m_entries.back().get();
+    } else if (idle == nullptr) {
+        return nullptr;
+    }
+
+    // 今区間に記録のないキーのヒストグラムを再利用する
+    idle->accountId = accountId;
+    idle->symbol = symbol;
+    return idle;
+}
+
+void ExecutionStats::RecordInto(Entry& entry, const CompletedTrade& trade) {
+    if (trade.outcome == CompletedTrade::Outcome::Rejected) {
+        entry.rejects++;
+        return;
+    }
+
+    entry.fills++;
+
+    int64_t slippageUnits = static_cast<int64_t>(std::llround(trade.slippagePoints * kSlippageScale));
+    if (slippageUnits >= 0) {
+        entry.adverseSlippage.Record(slippageUnits);
+    } else {
+        entry.favorableSlippage.Record(-slippageUnits);
+    }
+
+    if (trade.submitToFillUs >= 0) {
+        entry.latency.Record(trade.submitToFillUs);
+    }
+}
+
+// 有利方向（負）→ 不利方向（正）の順に並べたときの百分位
+double ExecutionStats::SlippageAtPercentile(const Entry& entry, double percentile) {
+    uint64_t favorable = entry.favorableSlippage.TotalCount();
+    uint64_t total = favorable + entry.adverseSlippage.TotalCount();
+    if (total == 0) {
+        return 0.0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+    if (rank == 0) rank = 1;
+    if (rank > total) rank = total;
+
+    int64_t units = rank <= favorable
+        ? -entry.favorableSlippage.ValueAtRank(favorable - rank + 1)
+        : entry.adverseSlippage.ValueAtRank(rank - favorable);
+    return static_cast<double>(units) / kSlippageScale;
+}
+
+ExecutionStatsSnapshot ExecutionStats::MakeSnapshot(const Entry& entry) {
+    ExecutionStatsSnapshot snapshot;
+    snapshot.accountId = entry.accountId;
+    snapshot.symbol = entry.symbol;
+    snapshot.fills = entry.fills;
+    snapshot.rejects = entry.rejects;
+    snapshot.rejectRate = static_cast<double>(entry.rejects) / static_cast<double>(entry.fills + entry.rejects);
+
+    uint64_t adverseCount = entry.adverseSlippage.TotalCount();
+    uint64_t favorableCount = entry.favorableSlippage.TotalCount();
+    if (adverseCount + favorableCount > 0) {
+        double sum = entry.adverseSlippage.Mean() * static_cast<double>(adverseCount) -
+                     entry.favorableSlippage.Mean() * static_cast<double>(favorableCount);
+        snapshot.slippageMean = sum / static_cast<double>(adverseCount + favorableCount) / kSlippageScale;
+        snapshot.slippageP50 = SlippageAtPercentile(entry, 50.0);
+        snapshot.slippageP90 = SlippageAtPercentile(entry, 90.0);
+        snapshot.slippageP99 = SlippageAtPercentile(entry, 99.0);
+        snapshot.slippageMax = adverseCount > 0
+            ? static_cast<double>(entry.adverseSlippage.Max()) / kSlippageScale
+            : -static_cast<double>(entry.favorableSlippage.Min()) / kSlippageScale;
+    }
+
+    snapshot.latencyP50Us = entry.latency.ValueAtPercentile(50.0);
+    snapshot.latencyP90Us = entry.latency.ValueAtPercentile(90.0);
+    snapshot.latencyP99Us = entry.latency.ValueAtPercentile(99.0);
+    snapshot.latencyMaxUs = entry.latency.Max();
+    return snapshot;
+}
+
+void ExecutionStats::ResetEntry(Entry& entry) {
+    entry.fills = 0;
+    entry.rejects = 0;
+    entry.adverseSlippage.Reset();
+    entry.favorableSlippage.Reset();
+    entry.latency.Reset();
+}
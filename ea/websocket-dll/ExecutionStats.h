@@ -0,0 +1,78 @@
+#pragma once
+
+#ifndef EXECUTIONSTATS_H
+#define EXECUTIONSTATS_H
+
+#include "HdrHistogram.h"
+#include "TradeCorrelator.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 1区間分の約定品質の集計（口座 × 通貨ペア、symbol が空の場合は口座全体）
+struct ExecutionStatsSnapshot {
+    std::string accountId;
+    std::string symbol;
+    long long fills = 0;
+    long long rejects = 0;
+    double rejectRate = 0.0;
+    double slippageMean = 0.0;      // ポイント（正が不利方向）
+    double slippageP50 = 0.0;
+    double slippageP90 = 0.0;
+    double slippageP99 = 0.0;
+    double slippageMax = 0.0;
+    long long latencyP50Us = 0;     // 発注（気配値取得）→ 約定
+    long long latencyP90Us = 0;
+    long long latencyP99Us = 0;
+    long long latencyMaxUs = 0;
+};
+
+// 約定品質の集計
+// 突き合わせ済みの発注（CompletedTrade）を口座 × 通貨ペアごと、および口座全体で
+// スリッページ・約定遅延のHDRヒストグラムと拒否件数に集計し、区間ごとに取り出してリセットする。
+// ヒストグラムは集計キーごとに固定サイズで、キー数も上限を設けるためメモリ使用量は一定
+class ExecutionStats {
+public:
+    // 集計キー（口座 × 通貨ペア + 口座全体）の上限
+    static const size_t kMaxKeys = 64;
+
+    // スリッページは 0.1 ポイント単位で記録する
+    static const int64_t kSlippageScale = 10;
+    static const int64_t kMaxSlippageUnits = 100000 * kSlippageScale;
+    static const int64_t kMaxLatencyUs = TradeCorrelator::kMaxPendingUs;
+    static const int kSignificantDigits = 2;
+
+    void Record(const CompletedTrade& trade);
+
+    // 前回の取り出し以降に記録のあったキーの集計を取り出し、ヒストグラムをリセットする
+    void Collect(std::vector<ExecutionStatsSnapshot>& snapshots);
+
+    // 上限超過で集計できなかった発注数
+    long long DroppedCount() const;
+
+private:
+    struct Entry {
+        Entry();
+
+        std::string accountId;
+        std::string symbol;
+        long long fills;
+        long long rejects;
+        HdrHistogram adverseSlippage;     // 不利方向（0 を含む）
+        HdrHistogram favorableSlippage;   // 有利方向（絶対値）
+        HdrHistogram latency;
+    };
+
+    Entry* FindOrAssign(const std::string& accountId, const std::string& symbol);
+    static void RecordInto(Entry& entry, const CompletedTrade& trade);
+    static double SlippageAtPercentile(const Entry& entry, double percentile);
+    static ExecutionStatsSnapshot MakeSnapshot(const Entry& entry);
+    static void ResetEntry(Entry& entry);
+
+    std::vector<std::unique_ptr<Entry>> m_entries;
+    long long m_droppedCount = 0;
+    mutable std::mutex m_mutex;
+};
+
+#endif // EXECUTIONSTATS_H
@@ -0,0 +1,40 @@
+#include "GatewayProtocol.h"
+#include "MessageUtils.h"
+#include "WireMessages.h"
+
+const char* const kGatewayAccountId = "@gateway";
+
+std::string WrapAccountFrame(const std::string& accountId, const std::string& frame) {
+    AccountFrameHeader header;
+    header.accountId = accountId;
+
+    // スキーマは生の JSON 値を持たないため、message は元のフレームをそのまま連結する
+    std::string envelope = schema::ToJson(header);
+    envelope.reserve(envelope.size() + frame.size() + 12);
+    envelope.pop_back();
+    envelope += ",\"message\":";
+    envelope += frame;
+    envelope += "}";
+    return envelope;
+}
+
+bool UnwrapAccountFrame(const std::string& envelope, std::string& accountId, std::string& frame) {
+    if (ExtractMessageType(envelope) != "ACCOUNT_FRAME") {
+        return false;
+    }
+
+    // 口座IDは包む側と同じスキーマで読み、エスケープを戻す（message は読み飛ばす）
+    AccountFrameHeader header;
+    if (!schema::DecodeJson(envelope, header) || header.accountId.empty()) {
+        return false;
+    }
+
+    size_t begin = 0;
+    size_t end = 0;
+    if (!FindJsonField(envelope, "message", begin, end) || envelope[begin] != '{') {
+        return false;
+    }
+    accountId = std::move(header.accountId);
+    frame.assign(envelope, begin, end - begin);
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#ifndef GATEWAYPROTOCOL_H
+#define GATEWAYPROTOCOL_H
+
+#include <string>
+
+// ゲートウェイ経由の接続の取り決め
+// 同一ホストの端末のDLLは共有メモリバス（BusFrameLink）でゲートウェイとフレームを受け渡し、
+// ゲートウェイは全端末のフレームを1本の上流接続に ACCOUNT_FRAME で口座ごとに包んで多重化する
+
+// ゲートウェイが共有メモリバスに参加するときの口座ID（実在の口座IDと重ならない名前）
+extern const char* const kGatewayAccountId;
+
+// 端末のフレームを口座IDつきのエンベロープに包む
+std::string WrapAccountFrame(const std::string& accountId, const std::string& frame);
+
+// ACCOUNT_FRAME エンベロープを開く（エンベロープでない場合は false）
+bool UnwrapAccountFrame(const std::string& envelope, std::string& accountId, std::string& frame);
+
+#endif // GATEWAYPROTOCOL_H
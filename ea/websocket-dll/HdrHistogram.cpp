@@ -0,0 +1,134 @@
+#include "HdrHistogram.h"
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// 最上位ビットの位置（value > 0）
+int HighestBit(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+} // namespace
+
+HdrHistogram::HdrHistogram(int64_t highestTrackableValue, int significantDigits)
+    : m_highestTrackableValue(highestTrackableValue < 2 ? 2 : highestTrackableValue),
+      m_totalCount(0), m_minValue(0), m_maxValue(0), m_sum(0.0) {
+    if (significantDigits < 1) significantDigits = 1;
+    if (significantDigits > 5) significantDigits = 5;
+
+    // 有効桁数を満たすサブバケット数（2 × 10^digits 以上の2のべき乗）
+    int64_t largestSingleUnitResolution = 2;
+    for (int i = 0; i < significantDigits; i++) {
+        largestSingleUnitResolution *= 10;
+    }
+    int subBucketCountMagnitude = HighestBit(static_cast<uint64_t>(largestSingleUnitResolution - 1)) + 1;
+    m_subBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+    int64_t subBucketCount = int64_t(1) << subBucketCountMagnitude;
+    m_subBucketHalfCount = subBucketCount / 2;
+    m_subBucketMask = subBucketCount - 1;
+
+    int bucketCount = 1;
+    int64_t smallestUntrackableValue = subBucketCount;
+    while (smallestUntrackableValue <= m_highestTrackableValue) {
+        smallestUntrackableValue <<= 1;
+        bucketCount++;
+    }
+
+    m_counts.assign(static_cast<size_t>((bucketCount + 1) * m_subBucketHalfCount), 0);
+}
+
+void HdrHistogram::Record(int64_t value) {
+    if (value < 0) value = 0;
+    if (value > m_highestTrackableValue) value = m_highestTrackableValue;
+
+    uint32_t& count = m_counts[CountsIndexFor(value)];
+    if (count != UINT32_MAX) {
+        count++;
+    }
+
+    if (m_totalCount == 0 || value < m_minValue) m_minValue = value;
+    if (m_totalCount == 0 || value > m_maxValue) m_maxValue = value;
+    m_totalCount++;
+    m_sum += static_cast<double>(value);
+}
+
+void HdrHistogram::Reset() {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_totalCount = 0;
+    m_minValue = 0;
+    m_maxValue = 0;
+    m_sum = 0.0;
+}
+
+int64_t HdrHistogram::ValueAtPercentile(double percentile) const {
+    if (m_totalCount == 0) {
+        return 0;
+    }
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 100.0) percentile = 100.0;
+
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(m_totalCount) + 0.5);
+    return ValueAtRank(rank == 0 ? 1 : rank);
+}
+
+int64_t HdrHistogram::ValueAtRank(uint64_t rank) const {
+    if (m_totalCount == 0) {
+        return 0;
+    }
+    if (rank >= m_totalCount) {
+        return m_maxValue;
+    }
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < m_counts.size(); i++) {
+        cumulative += m_counts[i];
+        if (cumulative >= rank) {
+            // バケット内の最大値を返し、実測の最小値・最大値の範囲に収める
+            int64_t value = HighestEquivalentValue(ValueFromIndex(i));
+            if (value < m_minValue) return m_minValue;
+            if (value > m_maxValue) return m_maxValue;
+            return value;
+        }
+    }
+    return m_maxValue;
+}
+
+double HdrHistogram::Mean() const {
+    return m_totalCount > 0 ? m_sum / static_cast<double>(m_totalCount) : 0.0;
+}
+
+int HdrHistogram::BucketIndexFor(int64_t value) const {
+    return HighestBit(static_cast<uint64_t>(value | m_subBucketMask)) - m_subBucketHalfCountMagnitude;
+}
+
+size_t HdrHistogram::CountsIndexFor(int64_t value) const {
+    int bucketIndex = BucketIndexFor(value);
+    int64_t subBucketIndex = value >> bucketIndex;
+    int64_t bucketBase = static_cast<int64_t>(bucketIndex + 1) << m_subBucketHalfCountMagnitude;
+    return static_cast<size_t>(bucketBase + (subBucketIndex - m_subBucketHalfCount));
+}
+
+int64_t HdrHistogram::ValueFromIndex(size_t index) const {
+    int bucketIndex = static_cast<int>(index >> m_subBucketHalfCountMagnitude) - 1;
+    int64_t subBucketIndex = static_cast<int64_t>(index & static_cast<size_t>(m_subBucketHalfCount - 1)) + m_subBucketHalfCount;
+    if (bucketIndex < 0) {
+        subBucketIndex -= m_subBucketHalfCount;
+        bucketIndex = 0;
+    }
+    return subBucketIndex << bucketIndex;
+}
+
+int64_t HdrHistogram::HighestEquivalentValue(int64_t value) const {
+    int64_t bucketSize = int64_t(1) << BucketIndexFor(value);
+    return value + bucketSize - 1;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#ifndef HDRHISTOGRAM_H
+#define HDRHISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 固定メモリのHDRヒストグラム（High Dynamic Range Histogram）
+// 値域 [0, highestTrackableValue] を2のべき乗ごとのバケットに分け、各バケットを
+// 有効桁数 significantDigits 相当のサブバケットで等分する。相対誤差は 10^-significantDigits 以下で、
+// メモリ使用量は構築時に決まり記録件数によらず一定。スレッドセーフではないため呼び出し側で排他する
+class HdrHistogram {
+public:
+    HdrHistogram(int64_t highestTrackableValue, int significantDigits);
+
+    // 値の記録（負の値は 0、上限を超える値は上限として記録）
+    void Record(int64_t value);
+
+    void Reset();
+
+    // 百分位値（percentile: 0〜100）。記録なしの場合は 0
+    int64_t ValueAtPercentile(double percentile) const;
+
+    // 小さい方から rank 番目（1始まり）の値
+    int64_t ValueAtRank(uint64_t rank) const;
+
+    uint64_t TotalCount() const { return m_totalCount; }
+    int64_t Min() const { return m_totalCount > 0 ? m_minValue : 0; }
+    int64_t Max() const { return m_totalCount > 0 ? m_maxValue : 0; }
+    double Mean() const;
+
+    size_t FootprintBytes() const { return m_counts.size() * sizeof(uint32_t); }
+
+private:
+    size_t CountsIndexFor(int64_t value) const;
+    int64_t ValueFromIndex(size_t index) const;
+    int64_t HighestEquivalentValue(int64_t value) const;
+    int BucketIndexFor(int64_t value) const;
+
+    int64_t m_highestTrackableValue;
+    int m_subBucketHalfCountMagnitude;
+    int64_t m_subBucketHalfCount;
+    int64_t m_subBucketMask;
+    std::vector<uint32_t> m_counts;
+    uint64_t m_totalCount;
+    int64_t m_minValue;
+    int64_t m_maxValue;
+    double m_sum;
+};
+
+#endif // HDRHISTOGRAM_H
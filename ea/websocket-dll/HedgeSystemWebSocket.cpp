@@ -1,11 +1,42 @@
 #include "HedgeSystemWebSocket.h"
+#include "MessageUtils.h"
+#include "CommandDecoder.h"
+#include "CommandScheduler.h"
+#include "ClockSkewEstimator.h"
+#include "BusFrameLink.h"
+#include "ExecutionStats.h"
+#include "GatewayProtocol.h"
+#include "InboundQueue.h"
+#include "LocalLegBus.h"
+#include "MessageDispatch.h"
+#include "PriceAlertEngine.h"
+#include "NetExposure.h"
+#include "MarginMonitor.h"
+#include "PeerDirectory.h"
+#include "ConsolidatedBook.h"
+#include "SpreadDetector.h"
+#include "PnLEngine.h"
+#include "RiskGate.h"
+#include "SymbolSpecTable.h"
+#include "RetransmitRing.h"
+#include "RollingPriceStats.h"
+#include "SharedBus.h"
+#include "SpreadTracker.h"
+#include "TradeCorrelator.h"
+#include "WireMessages.h"
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <string>
-#include <queue>
+#include <vector>
 #include <mutex>
 #include <thread>
 #include <memory>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
 #include <websocketpp/config/asio_client.hpp>
 #include <websocketpp/client.hpp>
 
@@ -18,23 +49,152 @@ private:
     websocketpp::connection_hdl m_hdl;
     std::string m_url;
     std::string m_token;
-    std::queue<std::string> m_messageQueue;
-    std::mutex m_queueMutex;
+    InboundQueue m_inboundQueue;
     std::string m_lastError;
     bool m_connected;
     std::thread m_thread;
     bool m_shouldRun;
 
+    // 送信バッチ（マイクロバッチング）設定 - m_lingerMicros == 0 で無効
+    // 設定・滞留分の読み書きと滞留分の送信はすべて m_batchMutex の中で行い、送信順を保つ
+    unsigned int m_lingerMicros;
+    unsigned int m_batchMaxMessages;
+    bool m_batchEnvelope;
+    std::vector<std::string> m_outboundBatch;
+    std::mutex m_batchMutex;
+    std::unique_ptr<websocketpp::lib::asio::steady_timer> m_lingerTimer;
+
+    // 送信シーケンス番号と再送用リング（再接続をまたいで保持）
+    uint64_t m_lastSeq;
+    RetransmitRing m_retransmitRing;
+    std::mutex m_sequenceMutex;
+
+    // コマンド有効期限（ミリ秒、0で無効）とサーバー時刻のスキュー推定
+    std::atomic<long long> m_openTtlMs;
+    std::atomic<long long> m_modifyTtlMs;
+    std::atomic<long long> m_expiredCommandCount;
+    ClockSkewEstimator m_clockSkew;
+
+    // 未知の種別のため破棄した受信メッセージ数
+    std::atomic<long long> m_unknownMessageCount;
+
+    // 発注結果・約定の突き合わせ（EAスレッドから呼び出される）
+    TradeCorrelator m_tradeCorrelator;
+
+    // 約定品質の集計と定期送信（EXECUTION_STATS）
+    ExecutionStats m_executionStats;
+    std::atomic<long long> m_statsIntervalMs;
+    std::unique_ptr<websocketpp::lib::asio::steady_timer> m_statsTimer;
+    std::chrono::steady_clock::time_point m_statsIntervalStart;
+
+    // 通貨ペアごとのスプレッド統計（EAスレッドから記録、任意のスレッドから参照）
+    SpreadTracker m_spreadTracker;
+
+    // 通貨ペアごとの価格統計と定期送信（PRICE_STATS）
+    RollingPriceStats m_priceStats;
+    std::atomic<long long> m_priceStatsIntervalMs;
+    std::unique_ptr<websocketpp::lib::asio::steady_timer> m_priceStatsTimer;
+
+    // 価格アラート（ioスレッドで登録、EAスレッドのティックで判定）
+    PriceAlertEngine m_priceAlerts;
+
+    // 通貨ペアごとのネットエクスポージャー（約定ごとに差分更新、EAスレッドから参照）
+    NetExposure m_exposure;
+
+    // 通貨ペア仕様（EAスレッドで一括登録、各エンジンはロックなしで参照）と上流への送信済みの版
+    SymbolSpecTable m_symbolSpecs;
+    std::atomic<uint64_t> m_sentSpecVersion;
+
+    // 全ポジションの評価損益（EAスレッドのティック・約定で差分更新）と定期送信（PNL_UPDATE）
+    PnLEngine m_pnl;
+    std::atomic<long long> m_pnlIntervalMs;
+    std::unique_ptr<websocketpp::lib::asio::steady_timer> m_pnlTimer;
+
+    // 証拠金維持率の推定とストップアウト接近の検知（評価損益は m_pnl の値を使う）
+    MarginMonitor m_marginMonitor;
+
+    // 発注前リスクチェック（ioスレッドで OPEN のデコード直後に評価）
+    RiskGate m_riskGate;
+
+    // 実行予定時刻つきコマンドの保留（ioスレッドで登録、EAスレッドが予定時刻まで待って取り出す）
+    // EAのスレッドは1本のため、待つのは予定時刻が kMaxScheduledWaitMs 以内のコマンドがある場合だけ
+    CommandScheduler m_scheduler;
+    static constexpr int kMaxScheduledWaitMs = 5;
+
+    // 対のレッグ（ioスレッドで保持、EAスレッドで主レッグの約定時に取り出してEAのキューへ直接入れる）
+    LocalLegBus m_legBus;
+
+    // 同一ホストの端末間の共有メモリバス（受信は専用スレッド、送信・参加・離脱はEAスレッドのみ）と
+    // 他の端末から受け取った最新のティック・口座状態
+    SharedBus m_sharedBus;
+    PeerDirectory m_peers;
+    std::thread m_busThread;
+    std::atomic<bool> m_busRunning;
+    std::atomic<long long> m_busSpinUs;
+    std::string m_busName;
+    std::string m_busAccountId;
+    long long m_lastBusSnapshotUs;
+    static constexpr long long kBusHeartbeatUs = 100 * 1000;
+    static constexpr long long kBusSnapshotIntervalUs = 100 * 1000;
+    static constexpr long long kBusIdleSleepUs = 1000;
+
+    // ゲートウェイ経由の接続（WebSocket の代わりに共有メモリバスでゲートウェイとフレームを受け渡す）
+    BusFrameLink m_gatewayLink;
+    std::atomic<bool> m_viaGateway;
+    std::atomic<int> m_gatewayIndex;
+    static constexpr long long kGatewayHelloIntervalUs = 1000 * 1000;
+
+    // 全口座の統合気配（EA・共有メモリバス・ioスレッドから更新し、EAスレッドからロックなしで参照）
+    ConsolidatedBook m_book;
+    static constexpr const char* kLocalQuoteSource = "@local";
+    // この端末の口座ID（統合気配の自分の提供元。EA・ioスレッド・共有メモリバスの受信スレッドから参照）
+    std::shared_ptr<const std::string> m_localAccountId;
+
+    // 口座間スプレッドの機会検出（既定は無効。同じ気配を受け取る端末のうち1台で有効にする）
+    // 気配の届かない組の判定はioスレッドのタイマーで行い、気配の経路では行わない
+    SpreadDetector m_spreads;
+    std::atomic<bool> m_spreadDetection;
+    std::atomic<long long> m_spreadSweepIntervalMs;
+    // OPPORTUNITY の通番の起点（DLLの起動時刻のマイクロ秒。再起動しても通番が戻らない）
+    const long long m_spreadSequenceBase;
+    std::unique_ptr<websocketpp::lib::asio::steady_timer> m_spreadSweepTimer;
+
     static std::unique_ptr<WebSocketClient> s_instance;
     static std::mutex s_instanceMutex;
 
 public:
-    WebSocketClient() : m_connected(false), m_shouldRun(false) {
+    WebSocketClient()
+        : m_connected(false), m_shouldRun(false),
+          m_lingerMicros(0), m_batchMaxMessages(0), m_batchEnvelope(false),
+          m_lastSeq(0),
+          m_openTtlMs(3000), m_modifyTtlMs(0), m_expiredCommandCount(0),
+          m_unknownMessageCount(0),
+          m_statsIntervalMs(60000),
+          m_priceStatsIntervalMs(5000),
+          m_sentSpecVersion(0),
+          m_pnl(m_symbolSpecs),
+          m_pnlIntervalMs(1000),
+          m_marginMonitor(m_symbolSpecs),
+          m_riskGate(m_exposure, m_marginMonitor, m_symbolSpecs),
+          m_busRunning(false),
+          m_busSpinUs(0),
+          m_lastBusSnapshotUs(0),
+          m_gatewayLink(m_sharedBus),
+          m_viaGateway(false),
+          m_gatewayIndex(-1),
+          m_spreadDetection(false),
+          m_spreadSweepIntervalMs(SpreadDetector::kSweepIntervalUs / 1000),
+          m_spreadSequenceBase(NowMicros()) {
         // WebSocketクライアントの設定
         m_client.clear_access_channels(websocketpp::log::alevel::all);
         m_client.clear_error_channels(websocketpp::log::elevel::all);
         
         m_client.init_asio();
+        m_lingerTimer.reset(new websocketpp::lib::asio::steady_timer(m_client.get_io_service()));
+        m_statsTimer.reset(new websocketpp::lib::asio::steady_timer(m_client.get_io_service()));
+        m_priceStatsTimer.reset(new websocketpp::lib::asio::steady_timer(m_client.get_io_service()));
+        m_pnlTimer.reset(new websocketpp::lib::asio::steady_timer(m_client.get_io_service()));
+        m_spreadSweepTimer.reset(new websocketpp::lib::asio::steady_timer(m_client.get_io_service()));
         m_client.set_tls_init_handler([this](websocketpp::connection_hdl) {
             return websocketpp::lib::make_shared<websocketpp::lib::asio::ssl::context>(websocketpp::lib::asio::ssl::context::sslv23);
         });
@@ -59,6 +219,7 @@ public:
 
     ~WebSocketClient() {
         Disconnect();
+        LeaveSharedBus();
     }
 
     static WebSocketClient& GetInstance() {
@@ -73,6 +234,10 @@ public:
         try {
             m_url = url;
             m_token = token;
+
+            // 前回接続のイベントループが残っている場合（切断検知後の再接続）は停止してから再利用
+            StopEventLoop();
+            m_connected = false;
             
             websocketpp::lib::error_code ec;
             client::connection_ptr con = m_client.get_connection(url, ec);
@@ -109,17 +274,74 @@ public:
         }
     }
 
+    // ゲートウェイ経由で接続する（共有メモリバスに参加し、ゲートウェイの上流接続の確立を最大5秒待つ）
+    // 接続後の送受信・再送・定期送信は直接接続と同じ。ゲートウェイが落ちる・上流が切れると切断として扱い、
+    // ゲートウェイが戻れば受信スレッドが参加を通知し直して自動的に再開する
+    bool ConnectGateway(const std::string& busName, const std::string& accountId, long long spinMicros) {
+        try {
+            Disconnect();
+            StopEventLoop();
+            m_connected = false;
+
+            m_viaGateway = true;
+            if (!JoinSharedBus(busName, accountId, spinMicros)) {
+                m_viaGateway = false;
+                return false;
+            }
+
+            // タイマー・受信フレームの処理はWebSocket接続がなくても同じイベントループで行う
+            m_client.start_perpetual();
+            m_shouldRun = true;
+            m_thread = std::thread([this]() {
+                m_client.run();
+            });
+
+            int timeout = 50;
+            while (timeout > 0 && !m_connected) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                timeout--;
+            }
+            if (!m_connected) {
+                m_lastError = "Gateway unavailable";
+            }
+            return m_connected;
+        }
+        catch (const std::exception& e) {
+            m_lastError = "Gateway connection error: " + std::string(e.what());
+            return false;
+        }
+    }
+
     void Disconnect() {
+        if (m_viaGateway) {
+            // 滞留中のバッチをゲートウェイへ送り切ってから切り離す（共有メモリバスの参加は残す）
+            FlushBatch();
+            m_connected = false;
+            m_viaGateway = false;
+            m_gatewayIndex = -1;
+            m_shouldRun = false;
+            StopEventLoop();
+            return;
+        }
+
         if (m_connected) {
             try {
+                // 滞留中のバッチを送り切ってから切断
+                FlushBatch();
+
                 websocketpp::lib::error_code ec;
                 m_client.close(m_hdl, websocketpp::close::status::going_away, "", ec);
-                
-                m_shouldRun = false;
-                if (m_thread.joinable()) {
-                    m_thread.join();
+
+                // 閉じるハンドシェイクの完了（OnTransportClosed で定期送信のタイマーも止まる）を最大1秒待ち、
+                // 応答がなくてもイベントループを止めて戻る
+                int timeout = 10;
+                while (timeout > 0 && m_connected) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    timeout--;
                 }
-                
+
+                m_shouldRun = false;
+                StopEventLoop();
                 m_connected = false;
             }
             catch (const std::exception& e) {
@@ -134,108 +356,2578 @@ public:
             return false;
         }
 
-        try {
-            websocketpp::lib::error_code ec;
-            m_client.send(m_hdl, message, websocketpp::frame::opcode::text, ec);
-            
-            if (ec) {
-                m_lastError = "Send error: " + ec.message();
+        // シーケンス番号の付与・リングへの登録・送信キュー投入を同一ロック内で行い、
+        // シーケンス順と送信順を一致させる
+        std::lock_guard<std::mutex> lock(m_sequenceMutex);
+        uint64_t seq = ++m_lastSeq;
+        std::string frame = TagSequence(message, seq);
+        m_retransmitRing.Push(seq, frame);
+
+        return EnqueueFrame(frame);
+    }
+
+    void SetRetransmitWindow(unsigned int maxSeconds, size_t maxBytes) {
+        std::lock_guard<std::mutex> lock(m_sequenceMutex);
+        m_retransmitRing.SetLimits(std::chrono::seconds(maxSeconds), maxBytes);
+    }
+
+    uint64_t GetLastSentSeq() {
+        std::lock_guard<std::mutex> lock(m_sequenceMutex);
+        return m_lastSeq;
+    }
+
+    void SetBatching(unsigned int lingerMicros, unsigned int maxMessages, bool envelope) {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+        m_lingerMicros = lingerMicros;
+        m_batchMaxMessages = maxMessages;
+        m_batchEnvelope = envelope;
+
+        // バッチ無効化時は滞留分をそのまま送信
+        if (lingerMicros == 0) {
+            FlushBatchLocked();
+        }
+    }
+
+    std::string ReceiveMessage() {
+        std::vector<InboundMessage> expired;
+        InboundMessage inbound;
+        auto now = std::chrono::system_clock::now();
+        bool found = m_inboundQueue.PopNext(now, inbound, expired);
+
+        for (const auto& message : expired) {
+            RejectExpiredCommand(message, now, "dequeue");
+        }
+
+        return found ? inbound.payload : "";
+    }
+
+    // 最優先のコマンドをデコード済みの形で取り出す
+    bool ReceiveCommand(HSCommand& command) {
+        std::vector<InboundMessage> expired;
+        InboundMessage inbound;
+        auto now = std::chrono::system_clock::now();
+        bool found = m_inboundQueue.PopNextCommand(now, inbound, expired);
+
+        for (const auto& message : expired) {
+            RejectExpiredCommand(message, now, "dequeue");
+        }
+
+        if (!found) {
+            return false;
+        }
+
+        FillCommandStruct(inbound, command);
+        return true;
+    }
+
+    // timeoutMs（最大 kMaxScheduledWaitMs）以内に実行予定時刻を迎えるコマンドを予定時刻まで待って取り出す
+    // 予定時刻から TTL を過ぎたコマンドは COMMAND_EXPIRED（stage "schedule"）を返して読み飛ばす
+    bool ReceiveScheduledCommand(int timeoutMs, HSCommand& command) {
+        int waitMs = std::min(std::max(timeoutMs, 0), kMaxScheduledWaitMs);
+        long long limitUs = NowMicros() + static_cast<long long>(waitMs) * 1000;
+
+        while (true) {
+            InboundMessage inbound;
+            long long dueUs = 0;
+            if (!m_scheduler.WaitNext(std::max(0LL, limitUs - NowMicros()), inbound, dueUs)) {
                 return false;
             }
-            
+
+            auto now = std::chrono::system_clock::now();
+            if (inbound.hasDeadline && now > inbound.deadline) {
+                RejectExpiredCommand(inbound, now, "schedule");
+                continue;
+            }
+
+            // EAへ渡す処理を先に済ませ、通知の送信は後に回す
+            FillCommandStruct(inbound, command);
+            SendCommandReleased(inbound, dueUs, now);
             return true;
         }
-        catch (const std::exception& e) {
-            m_lastError = "Send exception: " + std::string(e.what());
+    }
+
+    long long GetScheduledCommandCount() const {
+        return static_cast<long long>(m_scheduler.Size());
+    }
+
+    // 共有メモリバスに参加し、受信スレッドを開始する（参加中なら一度離脱してから参加し直す）
+    // spinMicros: 最後の受信からこの時間は眠らずに受信を待つ（0 なら受信がなければ毎回1ミリ秒眠る）
+    bool JoinSharedBus(const std::string& name, const std::string& accountId, long long spinMicros) {
+        // 同じバス・口座で参加済み（ゲートウェイ経由の接続で参加済みなど）なら待ち方だけ変える
+        if (m_sharedBus.Self() >= 0 && name == m_busName && accountId == m_busAccountId) {
+            m_busSpinUs = spinMicros;
+            return true;
+        }
+
+        LeaveSharedBus();
+        if (!m_sharedBus.Open(name)) {
+            m_lastError = "Could not open shared bus: " + name;
+            return false;
+        }
+        if (m_sharedBus.Join(accountId, SharedBus::CurrentProcessId(), NowMicros()) < 0) {
+            m_lastError = "Shared bus has no free slot: " + name;
+            m_sharedBus.Close();
             return false;
         }
+
+        m_busName = name;
+        m_busAccountId = accountId;
+        SetLocalAccount(accountId);
+        m_busSpinUs = spinMicros;
+        m_busRunning = true;
+        m_busThread = std::thread([this]() {
+            RunSharedBus();
+        });
+
+        // 参加直後に口座状態を共有する（未通知なら空の値）
+        BroadcastBusSnapshot();
+        return true;
     }
 
-    std::string ReceiveMessage() {
-        std::lock_guard<std::mutex> lock(m_queueMutex);
-        if (m_messageQueue.empty()) {
-            return "";
+    void LeaveSharedBus() {
+        m_busRunning = false;
+        if (m_busThread.joinable()) {
+            m_busThread.join();
         }
-        
-        std::string message = m_messageQueue.front();
-        m_messageQueue.pop();
-        return message;
+        m_sharedBus.Close();
+        m_peers.Reset();
+        m_gatewayLink.Reset();
+        m_busName.clear();
+        m_busAccountId.clear();
     }
 
-    bool IsConnected() const {
-        return m_connected;
+    bool GetBestQuote(const std::string& symbol, HSBestQuote& result) const {
+        BestQuote best;
+        if (!m_book.Best(symbol, best)) {
+            return false;
+        }
+
+        long long nowUs = NowMicros();
+        std::memset(&result, 0, sizeof(result));
+        result.bid = best.bid;
+        result.ask = best.ask;
+        result.bidAgeUs = std::max(0LL, nowUs - best.bidReceivedUs);
+        result.askAgeUs = std::max(0LL, nowUs - best.askReceivedUs);
+        result.bidTimeMsc = best.bidTimeMsc;
+        result.askTimeMsc = best.askTimeMsc;
+        result.sources = best.sources;
+        CopyFixedString(result.bidAccountId, m_book.SourceName(best.bidSource));
+        CopyFixedString(result.askAccountId, m_book.SourceName(best.askSource));
+        return true;
     }
 
-    std::string GetLastError() const {
-        return m_lastError;
+    void SetBestQuoteMaxAge(long long maxAgeMs) {
+        m_book.SetMaxAgeUs(maxAgeMs * 1000);
     }
 
-private:
-    void OnOpen(websocketpp::connection_hdl hdl) {
-        m_connected = true;
-        m_lastError.clear();
+    void SetLocalAccount(const std::string& accountId) {
+        std::atomic_store_explicit(&m_localAccountId, std::make_shared<const std::string>(accountId),
+                                   std::memory_order_release);
     }
 
-    void OnClose(websocketpp::connection_hdl hdl) {
-        m_connected = false;
-        m_lastError = "Connection closed";
+    bool GetPeerTick(const std::string& accountId, const std::string& symbol, HSTick& result) const {
+        PeerTick tick;
+        if (!m_peers.FindTick(accountId, symbol, tick)) {
+            return false;
+        }
+
+        std::memset(&result, 0, sizeof(result));
+        result.bid = tick.bid;
+        result.ask = tick.ask;
+        result.point = tick.point;
+        result.timeMsc = tick.timeMsc;
+        CopyFixedString(result.symbol, tick.symbol);
+        return true;
     }
 
-    void OnFail(websocketpp::connection_hdl hdl) {
-        m_connected = false;
-        m_lastError = "Connection failed";
+    std::string GetSharedBusJson() const {
+        long long nowUs = NowMicros();
+        std::vector<BusParticipant> participants;
+        if (m_sharedBus.IsOpen()) {
+            m_sharedBus.Participants(nowUs, participants);
+        }
+        BusCounters counters = m_sharedBus.Counters();
+
+        SharedBusStatusFrame frame;
+        frame.accountId = m_busAccountId;
+        frame.self = m_sharedBus.Self();
+        frame.sent = counters.sent;
+        frame.received = counters.received;
+        frame.dropped = counters.dropped;
+        frame.peerTicks = static_cast<long long>(m_peers.TickCount());
+
+        // スキーマは配列を持たないため、participants は要素ごとに直列化して連結する
+        std::string json = schema::ToJson(frame);
+        json.pop_back();
+        json += ",\"participants\":[";
+        for (size_t i = 0; i < participants.size(); i++) {
+            SharedBusParticipantFrame entry;
+            entry.index = participants[i].index;
+            entry.accountId = participants[i].accountId;
+            entry.pid = participants[i].pid;
+            entry.heartbeatAgeMs = (nowUs - participants[i].heartbeatUs) / 1000;
+            if (i > 0) json += ",";
+            json += schema::ToJson(entry);
+        }
+        json += "]}";
+        return json;
     }
 
-    void OnMessage(websocketpp::connection_hdl hdl, client::message_ptr msg) {
-        std::lock_guard<std::mutex> lock(m_queueMutex);
-        m_messageQueue.push(msg->get_payload());
+    void OnTradeResult(const HSTradeResult& record) {
+        TradeSubmission submission;
+        submission.action = record.action == HS_TRADE_CLOSE ? TradeAction::Close : TradeAction::Open;
+        submission.isBuy = record.side != HS_SIDE_SELL;
+        submission.requestId = record.requestId;
+        submission.retcode = record.retcode;
+        submission.order = static_cast<uint64_t>(record.order);
+        submission.requestedPrice = record.requestedPrice;
+        submission.requestedVolume = record.requestedVolume;
+        submission.point = record.point;
+        submission.commandReceivedAtUs = record.commandReceivedAtUs;
+        submission.accountId = ReadFixedString(record.accountId);
+        submission.positionId = ReadFixedString(record.positionId);
+        submission.actionId = ReadFixedString(record.actionId);
+        submission.symbol = ReadFixedString(record.symbol);
+        if (submission.point <= 0.0) {
+            SymbolSpec spec;
+            if (m_symbolSpecs.Find(submission.symbol, spec)) {
+                submission.point = spec.point;
+            }
+        }
+
+        std::vector<CompletedTrade> completed;
+        m_tradeCorrelator.OnResult(submission, NowMicros(), completed);
+        PublishCompletedTrades(completed);
     }
-};
 
-// 静的メンバーの定義
-std::unique_ptr<WebSocketClient> WebSocketClient::s_instance = nullptr;
-std::mutex WebSocketClient::s_instanceMutex;
+    void OnTradeTransaction(const HSTradeTransaction& record) {
+        DealFill deal;
+        deal.deal = static_cast<uint64_t>(record.deal);
+        deal.order = static_cast<uint64_t>(record.order);
+        deal.position = static_cast<uint64_t>(record.position);
+        deal.price = record.price;
+        deal.volume = record.volume;
+        deal.profit = record.profit;
+        deal.symbol = ReadFixedString(record.symbol);
 
-// 文字列のメモリ管理用
-static std::mutex g_stringMutex;
-static std::string g_tempString;
-static std::string g_errorString;
+        std::vector<CompletedTrade> completed;
+        m_tradeCorrelator.OnDeal(deal, NowMicros(), completed);
+        PublishCompletedTrades(completed);
 
-// C言語インターフェース
-extern "C" {
+        // SL/TP・ストップアウトによる決済も DEAL_ADD として届くため、ここで全ての保有変化を拾える
+        if (ApplyExposureDeal(record, record.entry)) {
+            m_pnl.OnDeal(record.position, deal.symbol, record.dealType == 0, record.entry,
+                         record.volume, record.price, record.profit);
+            MarginAlert alert;
+            if (m_marginMonitor.OnDeal(record.position, deal.symbol, record.dealType == 0, record.entry,
+                                       record.volume, record.profit, m_pnl.FloatingPnl(), alert)) {
+                PublishMarginWarning(alert);
+            }
+        }
+    }
 
-HEDGESYSTEMWEBSOCKET_API bool WSConnect(const char* url, const char* token) {
-    if (!url || !token) {
-        return false;
+    bool SeedExposure(const HSTradeTransaction& position) {
+        if (!ApplyExposureDeal(position, static_cast<int>(DealEntry::In))) {
+            return false;
+        }
+        // 既存ポジションの登録では profit に累積スワップを渡す
+        std::string symbol = ReadFixedString(position.symbol);
+        m_pnl.Seed(position.position, symbol, position.dealType == 0, position.volume, position.price, position.profit);
+        m_marginMonitor.Seed(position.position, symbol, position.dealType == 0, position.volume);
+        return true;
     }
-    
-    try {
-        return WebSocketClient::GetInstance().Connect(std::string(url), std::string(token));
+
+    void ResetExposure() {
+        m_exposure.Reset();
+        m_pnl.ResetPositions();
+        m_marginMonitor.ResetPositions();
+        m_riskGate.Reset();
     }
-    catch (...) {
-        return false;
+
+    bool LoadSymbolSpecs(const HSSymbolSpec* records, int count) {
+        std::vector<SymbolSpec> specs;
+        specs.reserve(static_cast<size_t>(count));
+        for (int i = 0; i < count; i++) {
+            const HSSymbolSpec& record = records[i];
+            SymbolSpec spec;
+            spec.symbol = ReadFixedString(record.symbol);
+            spec.digits = record.digits;
+            spec.point = record.point;
+            spec.tickSize = record.tickSize;
+            spec.tickValue = record.tickValue;
+            spec.contractSize = record.contractSize;
+            spec.volumeMin = record.volumeMin;
+            spec.volumeStep = record.volumeStep;
+            spec.volumeMax = record.volumeMax;
+            spec.marginPerLot = record.marginPerLot;
+            spec.marginHedged = record.marginHedged;
+            spec.baseCurrency = ReadFixedString(record.baseCurrency);
+            spec.profitCurrency = ReadFixedString(record.profitCurrency);
+            spec.marginCurrency = ReadFixedString(record.marginCurrency);
+            specs.push_back(spec);
+        }
+        return m_symbolSpecs.Load(specs);
     }
-}
 
-HEDGESYSTEMWEBSOCKET_API void WSDisconnect() {
-    try {
-        WebSocketClient::GetInstance().Disconnect();
+    bool GetSymbolSpec(const std::string& symbol, HSSymbolSpec& result) const {
+        SymbolSpec spec;
+        if (!m_symbolSpecs.Find(symbol, spec)) {
+            return false;
+        }
+
+        std::memset(&result, 0, sizeof(result));
+        result.point = spec.point;
+        result.tickSize = spec.tickSize;
+        result.tickValue = spec.tickValue;
+        result.contractSize = spec.contractSize;
+        result.volumeMin = spec.volumeMin;
+        result.volumeStep = spec.volumeStep;
+        result.volumeMax = spec.volumeMax;
+        result.marginPerLot = spec.marginPerLot;
+        result.marginHedged = spec.marginHedged;
+        result.digits = spec.digits;
+        CopyFixedString(result.symbol, spec.symbol);
+        CopyFixedString(result.baseCurrency, spec.baseCurrency);
+        CopyFixedString(result.profitCurrency, spec.profitCurrency);
+        CopyFixedString(result.marginCurrency, spec.marginCurrency);
+        return true;
     }
-    catch (...) {
-        // エラーを無視
+
+    void OnAccountUpdate(const HSAccountState& record) {
+        MarginAccountState account;
+        account.accountId = ReadFixedString(record.accountId);
+        account.equity = record.equity;
+        account.margin = record.margin;
+        account.marginCallLevel = record.marginCallLevel;
+        account.stopOutLevel = record.stopOutLevel;
+
+        m_pnl.SetAccount(account.accountId, ReadFixedString(record.currency), record.balance, record.credit);
+        if (!account.accountId.empty()) {
+            SetLocalAccount(account.accountId);
+        }
+        m_legBus.AddLocalAccount(account.accountId);
+
+        MarginAlert alert;
+        if (m_marginMonitor.SetAccount(account, m_pnl.FloatingPnl(), alert)) {
+            PublishMarginWarning(alert);
+        }
+        if (m_sharedBus.Self() >= 0) {
+            BroadcastBusSnapshot();
+        }
+
+        // 口座IDが確定した時点で、未送信の通貨ペア仕様を上流に共有する
+        PublishSymbolSpecs(account.accountId);
     }
-}
 
-HEDGESYSTEMWEBSOCKET_API bool WSSendMessage(const char* message) {
-    if (!message) {
-        return false;
+    void SetMarginThresholds(double warningLevel, double criticalLevel) {
+        m_marginMonitor.SetThresholds(warningLevel, criticalLevel);
     }
-    
-    try {
-        return WebSocketClient::GetInstance().SendMessage(std::string(message));
+
+    void GetMarginState(HSMarginState& result) const {
+        MarginState state = m_marginMonitor.GetState();
+        result.equity = state.equity;
+        result.margin = state.margin;
+        result.freeMargin = state.freeMargin;
+        result.marginLevel = state.marginLevel;
+        result.equityToStopOut = state.equityToStopOut;
+        result.severity = static_cast<int>(state.severity);
     }
-    catch (...) {
-        return false;
+
+    void GetPnLSummary(HSPnLSummary& result) const {
+        PnLSummary summary = m_pnl.GetSummary();
+        std::memset(&result, 0, sizeof(result));
+        result.balance = summary.balance;
+        result.credit = summary.credit;
+        result.floatingPnl = summary.floatingPnl;
+        result.swap = summary.swap;
+        result.realized = summary.realized;
+        result.equity = summary.equity;
+        result.positions = summary.positions;
+        result.unconverted = summary.unconverted;
+        CopyFixedString(result.currency, summary.currency);
+    }
+
+    bool GetPositionPnL(long long positionId, HSPositionPnL& result) const {
+        PositionPnL position;
+        if (!m_pnl.GetPosition(positionId, position)) {
+            return false;
+        }
+
+        std::memset(&result, 0, sizeof(result));
+        result.volume = position.volume;
+        result.openPrice = position.openPrice;
+        result.currentPrice = position.currentPrice;
+        result.profitCurrencyPnl = position.profitCurrencyPnl;
+        result.conversionRate = position.conversionRate;
+        result.pnl = position.pnl;
+        result.swap = position.swap;
+        result.isBuy = position.isBuy ? 1 : 0;
+        result.converted = position.converted ? 1 : 0;
+        CopyFixedString(result.symbol, position.symbol);
+        return true;
+    }
+
+    // 評価損益に必要なティックの通貨ペア（カンマ区切り）
+    std::string GetRequiredTickSymbols() const {
+        std::vector<std::string> symbols;
+        m_pnl.RequiredSymbols(symbols);
+        std::sort(symbols.begin(), symbols.end());
+
+        std::string result;
+        for (const auto& symbol : symbols) {
+            if (!result.empty()) result += ",";
+            result += symbol;
+        }
+        return result;
+    }
+
+    std::string GetExposureJson() const {
+        std::vector<SymbolExposure> symbols;
+        ExposureSummary summary = m_exposure.Snapshot(symbols);
+
+        ExposureSummaryFrame frame;
+        frame.grossVolume = summary.grossVolume;
+        frame.netVolume = summary.netVolume;
+        frame.hedgeRatio = summary.hedgeRatio;
+
+        // スキーマは配列を持たないため、symbols は要素ごとに直列化して連結する
+        std::string json = schema::ToJson(frame);
+        json.pop_back();
+        json += ",\"symbols\":[";
+        for (size_t i = 0; i < symbols.size(); i++) {
+            ExposureSymbolFrame entry;
+            entry.symbol = symbols[i].symbol;
+            entry.longVolume = symbols[i].longVolume;
+            entry.shortVolume = symbols[i].shortVolume;
+            entry.netVolume = symbols[i].longVolume - symbols[i].shortVolume;
+            entry.longNotional = symbols[i].longNotional;
+            entry.shortNotional = symbols[i].shortNotional;
+            if (i > 0) json += ",";
+            json += schema::ToJson(entry);
+        }
+        json += "]}";
+        return json;
+    }
+
+    bool OnTick(const HSTick& tick) {
+        std::string symbol = ReadFixedString(tick.symbol);
+        long long nowUs = NowMicros();
+        long long nowMs = nowUs / 1000;
+        bool recorded = m_spreadTracker.OnTick(symbol, tick.bid, tick.ask, tick.point, tick.timeMsc, nowMs);
+        recorded = m_priceStats.OnTick(symbol, tick.bid, tick.ask, tick.timeMsc, nowMs) && recorded;
+        CheckPriceAlerts(symbol, tick);
+
+        // 評価損益が変わったティックだけ維持率を再評価する
+        bool pnlChanged = m_pnl.OnTick(symbol, tick.bid, tick.ask);
+        if (pnlChanged) {
+            MarginAlert alert;
+            if (m_marginMonitor.OnPnL(m_pnl.FloatingPnl(), alert)) {
+                PublishMarginWarning(alert);
+            }
+        }
+
+        // 統合気配の自分の口座の提供元はこの端末の口座ID（未通知の場合のみ kLocalQuoteSource）
+        static const std::string unnamedSource(kLocalQuoteSource);
+        std::shared_ptr<const std::string> localAccount = LocalAccount();
+        OnQuote(symbol, localAccount ? *localAccount : unnamedSource, tick.bid, tick.ask, tick.timeMsc, nowUs);
+
+        if (m_sharedBus.Self() >= 0) {
+            BroadcastBusTick(tick);
+            if (pnlChanged && NowMicros() - m_lastBusSnapshotUs >= kBusSnapshotIntervalUs) {
+                BroadcastBusSnapshot();
+            }
+        }
+        return recorded;
+    }
+
+    bool ApplyExposureDeal(const HSTradeTransaction& record, int entry) {
+        if ((record.dealType != 0 && record.dealType != 1) ||
+            entry < static_cast<int>(DealEntry::In) || entry > static_cast<int>(DealEntry::OutBy)) {
+            return false;
+        }
+        std::string symbol = ReadFixedString(record.symbol);
+        if (symbol.empty() || record.volume <= 0.0) {
+            return false;
+        }
+        m_exposure.OnDeal(symbol, record.dealType == 0, static_cast<DealEntry>(entry), record.volume, record.price);
+        return true;
+    }
+
+    long long GetPriceAlertCount() const {
+        return static_cast<long long>(m_priceAlerts.Count());
+    }
+
+    bool GetPriceStats(const std::string& symbol, HSPriceStats& result) const {
+        PriceStatsSnapshot stats;
+        if (!m_priceStats.GetStats(symbol, stats)) {
+            return false;
+        }
+
+        result.ticks = stats.ticks;
+        result.lastTickMsc = stats.lastTickMsc;
+        result.mid = stats.mid;
+        result.ewma = stats.ewma;
+        result.mean = stats.mean;
+        result.high = stats.high;
+        result.low = stats.low;
+        result.spreadMean = stats.spreadMean;
+        result.spreadMin = stats.spreadMin;
+        result.spreadMax = stats.spreadMax;
+        result.volatility = stats.volatility;
+        result.shortVolatility = stats.shortVolatility;
+        result.tickRate = stats.tickRate;
+        return true;
+    }
+
+    bool GetSpreadStats(const std::string& symbol, HSSpreadStats& result) const {
+        SpreadStats stats;
+        if (!m_spreadTracker.GetStats(symbol, NowMicros() / 1000, stats)) {
+            return false;
+        }
+
+        result.count = stats.count;
+        result.windowMs = stats.windowMs;
+        result.current = stats.current;
+        result.mean = stats.mean;
+        result.min = stats.min;
+        result.p50 = stats.p50;
+        result.p90 = stats.p90;
+        result.p99 = stats.p99;
+        result.max = stats.max;
+        return true;
+    }
+
+    void SetSpreadWindow(long long windowMs) {
+        m_spreadTracker.SetWindow(windowMs);
+    }
+
+    // 送信間隔の変更はioスレッドでタイマーを張り直して反映する
+    void SetExecutionStatsInterval(long long intervalMs) {
+        m_statsIntervalMs = intervalMs;
+        websocketpp::lib::asio::post(m_client.get_io_service(), [this]() {
+            if (m_connected) {
+                ArmPeriodicTimer(*m_statsTimer, m_statsIntervalMs, &WebSocketClient::PublishExecutionStats);
+            }
+        });
+    }
+
+    void SetPriceStatsInterval(long long intervalMs) {
+        m_priceStatsIntervalMs = intervalMs;
+        websocketpp::lib::asio::post(m_client.get_io_service(), [this]() {
+            if (m_connected) {
+                ArmPeriodicTimer(*m_priceStatsTimer, m_priceStatsIntervalMs, &WebSocketClient::PublishPriceStats);
+            }
+        });
+    }
+
+    void SetPnLUpdateInterval(long long intervalMs) {
+        m_pnlIntervalMs = intervalMs;
+        websocketpp::lib::asio::post(m_client.get_io_service(), [this]() {
+            if (m_connected) {
+                ArmPeriodicTimer(*m_pnlTimer, m_pnlIntervalMs, &WebSocketClient::PublishPnLUpdate);
+            }
+        });
+    }
+
+    void SetCommandTtl(long long openTtlMs, long long modifyTtlMs) {
+        m_openTtlMs = openTtlMs;
+        m_modifyTtlMs = modifyTtlMs;
+    }
+
+    long long GetExpiredCommandCount() const {
+        return m_expiredCommandCount;
+    }
+
+    void SetRiskLimits(const HSRiskLimits& record) {
+        RiskLimits limits;
+        limits.maxLot = record.maxLot;
+        limits.maxSymbolVolume = record.maxSymbolVolume;
+        limits.maxAccountVolume = record.maxAccountVolume;
+        limits.minMarginLevel = record.minMarginLevel;
+        limits.maxOrdersPerSecond = record.maxOrdersPerSecond;
+        m_riskGate.SetLimits(limits);
+    }
+
+    long long GetRiskRejectCount() const {
+        return m_riskGate.RejectedCount();
+    }
+
+    bool SetSpreadRule(const std::string& symbol, const HSSpreadRule& record) {
+        SpreadRule rule;
+        rule.entry = record.entry;
+        rule.exit = record.exit;
+        rule.minPersistUs = static_cast<long long>(record.minPersistMs) * 1000;
+        rule.maxQuoteAgeUs = static_cast<long long>(record.maxQuoteAgeMs) * 1000;
+        rule.holdingDays = record.holdingDays;
+        return m_spreads.SetRule(symbol, rule);
+    }
+
+    bool SetSpreadCost(const std::string& accountId, const std::string& symbol, const HSSpreadCost& record) {
+        SpreadCost cost;
+        cost.commission = record.commission;
+        cost.swapLong = record.swapLong;
+        cost.swapShort = record.swapShort;
+        return m_spreads.SetCost(accountId, symbol, cost);
+    }
+
+    // 無効にすると組の状態を捨てる（再度有効にした後の OPEN は改めて持続時間を満たしてから送る）
+    void EnableSpreadDetector(bool enabled) {
+        if (!enabled) {
+            m_spreads.Reset();
+        }
+        m_spreadDetection = enabled;
+    }
+
+    long long GetOpenOpportunityCount() const {
+        return static_cast<long long>(m_spreads.OpenCount());
+    }
+
+    long long GetCoalescedModifyCount() const {
+        return m_inboundQueue.CoalescedModifyCount();
+    }
+
+    void SetCommandThrottle(double accountRate, int accountBurst, double symbolRate, int symbolBurst) {
+        ThrottleLimits limits;
+        limits.accountRate = accountRate;
+        limits.accountBurst = accountBurst;
+        limits.symbolRate = symbolRate;
+        limits.symbolBurst = symbolBurst;
+        m_inboundQueue.SetThrottle(limits);
+    }
+
+    void GetCommandWaitStats(HSCommandWaitStats& result) const {
+        CommandWaitStats stats = m_inboundQueue.WaitStats();
+        result.commands = stats.commands;
+        result.throttled = stats.throttled;
+        result.meanWaitUs = stats.commands > 0 ? stats.totalWaitUs / stats.commands : 0;
+        result.maxWaitUs = stats.maxWaitUs;
+        result.throttledMeanWaitUs = stats.throttled > 0 ? stats.throttledWaitUs / stats.throttled : 0;
+        result.pending = static_cast<long long>(m_inboundQueue.Size());
+    }
+
+    long long GetUnknownMessageCount() const {
+        return m_unknownMessageCount;
+    }
+
+    long long GetDroppedDealCount() const {
+        return m_tradeCorrelator.DroppedOrphanCount();
+    }
+
+    long long GetClockSkewMicros() const {
+        return m_clockSkew.OffsetMicros();
+    }
+
+    bool IsConnected() const {
+        return m_connected;
+    }
+
+    std::string GetLastError() const {
+        return m_lastError;
+    }
+
+private:
+    // イベントループを止めて再利用できる状態に戻す
+    void StopEventLoop() {
+        m_client.stop_perpetual();
+        if (m_thread.joinable()) {
+            m_client.stop();
+            m_thread.join();
+        }
+        // ioスレッドが止まった後に取り消す（取り消された待ちは次のイベントループで張り直されずに終わる）
+        CancelTimers();
+        m_client.reset();
+    }
+
+    // 定期送信・バッチのタイマーを止める（ioスレッドから、またはイベントループの停止後に呼び出す）
+    void CancelTimers() {
+        m_lingerTimer->cancel();
+        m_statsTimer->cancel();
+        m_priceStatsTimer->cancel();
+        m_pnlTimer->cancel();
+        m_spreadSweepTimer->cancel();
+    }
+
+    bool EnqueueFrame(const std::string& frame) {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+        if (m_lingerMicros == 0) {
+            // バッチ無効化の直前に積まれた滞留分があれば先に送る
+            FlushBatchLocked();
+            return SendFrame(frame);
+        }
+
+        // 取引イベント・コマンド受領通知はlingerを待たず、滞留分と一緒に即時送信（送信順は維持）
+        bool urgent = IsUrgentMessageType(ExtractMessageType(frame));
+        m_outboundBatch.push_back(frame);
+
+        if (urgent || (m_batchMaxMessages > 0 && m_outboundBatch.size() >= m_batchMaxMessages)) {
+            websocketpp::lib::asio::post(m_client.get_io_service(), [this]() {
+                FlushBatch();
+            });
+        } else if (m_outboundBatch.size() == 1) {
+            // バッチ先頭のメッセージでlingerタイマーを開始（タイマー操作はioスレッドで行う）
+            websocketpp::lib::asio::post(m_client.get_io_service(), [this]() {
+                ArmLingerTimer();
+            });
+        }
+
+        return true;
+    }
+
+    // JSONオブジェクトの先頭に "seq" フィールドを挿入
+    static std::string TagSequence(const std::string& message, uint64_t seq) {
+        size_t brace = message.find_first_not_of(" \t\r\n");
+        if (brace == std::string::npos || message[brace] != '{') {
+            return message;
+        }
+
+        size_t next = message.find_first_not_of(" \t\r\n", brace + 1);
+        bool emptyObject = next != std::string::npos && message[next] == '}';
+
+        std::string frame;
+        frame.reserve(message.size() + 32);
+        frame.append(message, 0, brace + 1);
+        frame += "\"seq\":";
+        frame += std::to_string(seq);
+        if (!emptyObject) {
+            frame += ",";
+        }
+        frame.append(message, brace + 1, std::string::npos);
+        return frame;
+    }
+
+    // サーバーからの RESEND_FROM 要求に対し、ギャップ分のみを再送（ioスレッドで実行）
+    void HandleResendRequest(const std::string& message, const MessageEnvelope&,
+                             std::chrono::system_clock::time_point) {
+        ResendFromFrame request;
+        request.seq = -1;
+        if (!schema::DecodeJson(message, request) || request.seq < 0) {
+            return;
+        }
+
+        uint64_t fromSeq = static_cast<uint64_t>(request.seq);
+        std::vector<std::string> frames;
+        RetransmitRing::ResendResult result;
+        uint64_t oldestSeq = 0;
+        uint64_t lastSeq = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_sequenceMutex);
+            result = m_retransmitRing.CollectFrom(fromSeq, frames);
+            oldestSeq = m_retransmitRing.OldestSeq();
+            lastSeq = m_lastSeq;
+        }
+
+        if (result == RetransmitRing::ResendResult::Unavailable) {
+            // 保持範囲外: サーバー側で完全同期にフォールバックさせる
+            ResendUnavailableFrame unavailable;
+            unavailable.requestedSeq = static_cast<long long>(fromSeq);
+            unavailable.oldestSeq = static_cast<long long>(oldestSeq);
+            unavailable.lastSeq = static_cast<long long>(lastSeq);
+            SendFrame(schema::ToJson(unavailable));
+            return;
+        }
+
+        for (const auto& frame : frames) {
+            SendFrame(frame);
+        }
+    }
+
+    bool SendFrame(const std::string& frame) {
+        if (m_viaGateway) {
+            int gateway = m_gatewayIndex;
+            if (gateway < 0 || !m_gatewayLink.Send(gateway, frame, NowMicros())) {
+                m_lastError = "Gateway send failed";
+                return false;
+            }
+            return true;
+        }
+
+        try {
+            websocketpp::lib::error_code ec;
+            m_client.send(m_hdl, frame, websocketpp::frame::opcode::text, ec);
+
+            if (ec) {
+                m_lastError = "Send error: " + ec.message();
+                return false;
+            }
+
+            return true;
+        }
+        catch (const std::exception& e) {
+            m_lastError = "Send exception: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    using PeriodicPublisher = void (WebSocketClient::*)();
+
+    // intervalMs ごとに publish を呼び出す（ioスレッドから呼び出す。0 以下で停止）
+    void ArmPeriodicTimer(websocketpp::lib::asio::steady_timer& timer, const std::atomic<long long>& intervalMs,
+                          PeriodicPublisher publish) {
+        long long interval = intervalMs;
+        if (interval <= 0) {
+            timer.cancel();
+            return;
+        }
+
+        timer.expires_after(std::chrono::milliseconds(interval));
+        timer.async_wait([this, &timer, &intervalMs, publish](const websocketpp::lib::error_code& ec) {
+            if (!ec) {
+                (this->*publish)();
+                ArmPeriodicTimer(timer, intervalMs, publish);
+            }
+        });
+    }
+
+    // 前回送信以降にティックのあった通貨ペアの価格統計を送信（生の価格履歴の代わり）
+    void PublishPriceStats() {
+        std::vector<PriceStatsSnapshot> snapshots;
+        m_priceStats.CollectUpdated(snapshots);
+
+        std::string timestamp = FormatIsoTimestamp(std::chrono::system_clock::now());
+        for (const auto& snapshot : snapshots) {
+            PriceStatsFrame frame;
+            frame.timestamp = timestamp;
+            frame.symbol = snapshot.symbol;
+            frame.ticks = snapshot.ticks;
+            frame.bid = snapshot.bid;
+            frame.ask = snapshot.ask;
+            frame.ewma = snapshot.ewma;
+            frame.mean = snapshot.mean;
+            frame.high = snapshot.high;
+            frame.low = snapshot.low;
+            frame.spreadMean = snapshot.spreadMean;
+            frame.spreadMin = snapshot.spreadMin;
+            frame.spreadMax = snapshot.spreadMax;
+            frame.volatility = snapshot.volatility;
+            frame.shortVolatility = snapshot.shortVolatility;
+            frame.tickRate = snapshot.tickRate;
+            SendMessage(schema::ToJson(frame));
+        }
+    }
+
+    // 前回送信以降に評価損益・保有が変化していれば口座全体とポジションごとの値を送信
+    void PublishPnLUpdate() {
+        if (!m_pnl.ConsumeChanged()) {
+            return;
+        }
+
+        PnLSummary summary = m_pnl.GetSummary();
+        if (summary.accountId.empty()) {
+            return;
+        }
+        std::vector<PositionPnL> positions;
+        m_pnl.CollectPositions(positions);
+
+        PnLUpdateFrame frame;
+        frame.timestamp = FormatIsoTimestamp(std::chrono::system_clock::now());
+        frame.accountId = summary.accountId;
+        frame.currency = summary.currency;
+        frame.balance = summary.balance;
+        frame.equity = summary.equity;
+        frame.floatingPnl = summary.floatingPnl;
+        frame.swap = summary.swap;
+        frame.unconverted = summary.unconverted;
+
+        // スキーマは配列を持たないため、positions は要素ごとに直列化して連結する
+        std::string json = schema::ToJson(frame);
+        json.pop_back();
+        json += ",\"positions\":[";
+        for (size_t i = 0; i < positions.size(); i++) {
+            PositionPnLFrame entry;
+            entry.ticket = static_cast<long long>(positions[i].positionId);
+            entry.symbol = positions[i].symbol;
+            entry.volume = positions[i].volume;
+            entry.currentPrice = positions[i].currentPrice;
+            entry.pnl = positions[i].pnl;
+            entry.swap = positions[i].swap;
+            entry.converted = positions[i].converted;
+            if (i > 0) json += ",";
+            json += schema::ToJson(entry);
+        }
+        json += "]}";
+        SendMessage(json);
+    }
+
+    // 前回送信以降に約定・拒否のあった口座 × 通貨ペア（および口座全体）の集計を送信
+    void PublishExecutionStats() {
+        std::vector<ExecutionStatsSnapshot> snapshots;
+        m_executionStats.Collect(snapshots);
+
+        auto now = std::chrono::steady_clock::now();
+        long long intervalMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_statsIntervalStart).count();
+        m_statsIntervalStart = now;
+
+        std::string timestamp = FormatIsoTimestamp(std::chrono::system_clock::now());
+        for (const auto& snapshot : snapshots) {
+            ExecutionStatsFrame frame;
+            frame.timestamp = timestamp;
+            frame.accountId = snapshot.accountId;
+            frame.symbol = snapshot.symbol;
+            frame.intervalMs = intervalMs;
+            frame.fills = snapshot.fills;
+            frame.rejects = snapshot.rejects;
+            frame.rejectRate = snapshot.rejectRate;
+            frame.slippageMean = snapshot.slippageMean;
+            frame.slippageP50 = snapshot.slippageP50;
+            frame.slippageP90 = snapshot.slippageP90;
+            frame.slippageP99 = snapshot.slippageP99;
+            frame.slippageMax = snapshot.slippageMax;
+            frame.latencyP50Us = snapshot.latencyP50Us;
+            frame.latencyP90Us = snapshot.latencyP90Us;
+            frame.latencyP99Us = snapshot.latencyP99Us;
+            frame.latencyMaxUs = snapshot.latencyMaxUs;
+            SendMessage(schema::ToJson(frame));
+        }
+    }
+
+    void ArmLingerTimer() {
+        unsigned int lingerMicros = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_batchMutex);
+            lingerMicros = m_lingerMicros;
+        }
+        m_lingerTimer->expires_after(std::chrono::microseconds(lingerMicros));
+        m_lingerTimer->async_wait([this](const websocketpp::lib::error_code& ec) {
+            if (!ec) {
+                FlushBatch();
+            }
+        });
+    }
+
+    // 滞留メッセージをまとめて送信
+    // エンベロープ有効時は1フレーム（1 TLSレコード）に詰め、無効時は連続送信して
+    // websocketppの送信キューでまとめて書き込ませる
+    void FlushBatch() {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+        FlushBatchLocked();
+    }
+
+    // m_batchMutex を保持して呼び出す。送信中も保持し、直接送信・他の送り出しと順序が入れ替わらないようにする
+    void FlushBatchLocked() {
+        if (m_outboundBatch.empty()) {
+            return;
+        }
+
+        std::vector<std::string> batch;
+        batch.swap(m_outboundBatch);
+        if (m_batchEnvelope && batch.size() > 1) {
+            SendFrame(BuildBatchEnvelope(batch));
+            return;
+        }
+
+        for (const auto& message : batch) {
+            SendFrame(message);
+        }
+    }
+
+    static std::string BuildBatchEnvelope(const std::vector<std::string>& batch) {
+        size_t total = 48;
+        for (const auto& message : batch) {
+            total += message.size() + 1;
+        }
+
+        std::string envelope;
+        envelope.reserve(total);
+        envelope += "{\"type\":\"BATCH\",\"count\":";
+        envelope += std::to_string(batch.size());
+        envelope += ",\"messages\":[";
+        for (size_t i = 0; i < batch.size(); i++) {
+            if (i > 0) envelope += ",";
+            envelope += batch[i];
+        }
+        envelope += "]}";
+        return envelope;
+    }
+
+    void OnOpen(websocketpp::connection_hdl) {
+        OnTransportOpen();
+    }
+
+    void OnClose(websocketpp::connection_hdl) {
+        OnTransportClosed("Connection closed");
+    }
+
+    void OnFail(websocketpp::connection_hdl) {
+        OnTransportClosed("Connection failed");
+    }
+
+    void OnMessage(websocketpp::connection_hdl, client::message_ptr msg) {
+        DispatchInbound(msg->get_payload());
+    }
+
+    // 上流との接続の確立（直接接続・ゲートウェイ経由とも ioスレッドで呼び出す）
+    void OnTransportOpen() {
+        m_connected = true;
+        m_lastError.clear();
+
+        // 接続ごとに送信済みシーケンスの範囲を通知し、サーバーにギャップ分の RESEND_FROM を促す
+        // （初回は lastSeq = 0。サーバーはこのフレームで接続と口座を対応づけ、DLLの再起動を検知する）
+        uint64_t oldestSeq = 0;
+        uint64_t lastSeq = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_sequenceMutex);
+            oldestSeq = m_retransmitRing.OldestSeq();
+            lastSeq = m_lastSeq;
+        }
+
+        StreamResumeFrame resume;
+        std::shared_ptr<const std::string> localAccount = LocalAccount();
+        if (localAccount) {
+            resume.accountId = *localAccount;
+        }
+        resume.oldestSeq = static_cast<long long>(oldestSeq);
+        resume.lastSeq = static_cast<long long>(lastSeq);
+        SendFrame(schema::ToJson(resume));
+
+        // 切断中の約定分は再接続後の最初の区間に含める
+        // 通貨ペア仕様は接続ごとに全件を共有し直す（次の口座情報通知で送信）
+        m_sentSpecVersion = 0;
+
+        m_statsIntervalStart = std::chrono::steady_clock::now();
+        ArmPeriodicTimer(*m_statsTimer, m_statsIntervalMs, &WebSocketClient::PublishExecutionStats);
+        ArmPeriodicTimer(*m_priceStatsTimer, m_priceStatsIntervalMs, &WebSocketClient::PublishPriceStats);
+        ArmPeriodicTimer(*m_pnlTimer, m_pnlIntervalMs, &WebSocketClient::PublishPnLUpdate);
+        ArmPeriodicTimer(*m_spreadSweepTimer, m_spreadSweepIntervalMs, &WebSocketClient::SweepSpreads);
+    }
+
+    // 上流との接続の切断（ioスレッドで呼び出す）。タイマーを止め、直接接続ではイベントループを終わらせる
+    void OnTransportClosed(const char* reason) {
+        m_connected = false;
+        m_lastError = reason;
+        CancelTimers();
+    }
+
+    using InboundHandler = void (WebSocketClient::*)(const std::string&, const MessageEnvelope&,
+                                                     std::chrono::system_clock::time_point);
+
+    void DispatchInbound(const std::string& payload) {
+        // 種別ごとのハンドラー表（InboundKind の並びと一致させること）
+        static constexpr std::array<InboundHandler, kInboundKindCount> kHandlers = {{
+            &WebSocketClient::HandleUnknown,            // Unknown
+            &WebSocketClient::HandleCommand,            // Open
+            &WebSocketClient::HandleCommand,            // Close
+            &WebSocketClient::HandleCommand,            // Modify
+            &WebSocketClient::HandleCommand,            // LegacyCommand（ClassifyInbound で解決済み）
+            &WebSocketClient::HandleResendRequest,      // ResendFrom
+            &WebSocketClient::HandleInformational,      // Ping
+            &WebSocketClient::HandleInformational,      // Pong
+            &WebSocketClient::HandleInformational,      // Info
+            &WebSocketClient::HandleInformational,      // Error
+            &WebSocketClient::HandlePriceAlertSet,      // PriceAlertSet
+            &WebSocketClient::HandlePriceAlertCancel,   // PriceAlertCancel
+            &WebSocketClient::HandlePriceUpdate,        // PriceUpdate
+            &WebSocketClient::HandleServerAck,          // HeartbeatAck
+            &WebSocketClient::HandleServerAck,          // AuthSuccess
+        }};
+
+        auto receivedAt = std::chrono::system_clock::now();
+
+        // 種別・時刻を1パスで取り出し、完全ハッシュ表で種別を判定
+        MessageEnvelope envelope;
+        InboundKind kind = ClassifyInbound(payload, envelope);
+
+        // サーバー送信時刻を持つフレームはクロックスキュー推定の標本にする（推定の起点はハートビートのみ）
+        std::chrono::system_clock::time_point serverTime;
+        if (kind != InboundKind::Unknown && ParseIsoTimestamp(envelope.timestamp, serverTime)) {
+            m_clockSkew.AddSample(serverTime, receivedAt, IsHeartbeatKind(kind));
+        }
+
+        (this->*kHandlers[static_cast<size_t>(kind)])(payload, envelope, receivedAt);
+    }
+
+    // 価格アラートの登録（EAには渡さない）
+    void HandlePriceAlertSet(const std::string& payload, const MessageEnvelope& envelope,
+                             std::chrono::system_clock::time_point receivedAt) {
+        PriceAlertSetFrame request;
+        if (!schema::DecodeJson(payload, request)) {
+            HandleUnknown(payload, envelope, receivedAt);
+            return;
+        }
+
+        std::string error;
+        bool hasDirection = !request.direction.empty();
+        AlertDirection direction = request.direction == "BELOW" ? AlertDirection::Below : AlertDirection::Above;
+        if (hasDirection && request.direction != "ABOVE" && request.direction != "BELOW") {
+            error = "Invalid price alert direction: " + request.direction;
+        } else if (!request.level.present ||
+                   !m_priceAlerts.Add(request.alertId, request.symbol, request.level.raw, hasDirection, direction)) {
+            error = "Price alert rejected: " + request.alertId;
+        }
+
+        if (!error.empty()) {
+            ErrorEventFrame frame;
+            frame.timestamp = FormatIsoTimestamp(receivedAt);
+            frame.message = error;
+            frame.errorCode = "PRICE_ALERT_REJECTED";
+            SendMessage(schema::ToJson(frame));
+        }
+    }
+
+    void HandlePriceAlertCancel(const std::string& payload, const MessageEnvelope& envelope,
+                                std::chrono::system_clock::time_point receivedAt) {
+        PriceAlertCancelFrame request;
+        if (!schema::DecodeJson(payload, request)) {
+            HandleUnknown(payload, envelope, receivedAt);
+            return;
+        }
+        m_priceAlerts.Remove(request.alertId);
+    }
+
+    // この端末の口座ID（未設定なら nullptr）
+    std::shared_ptr<const std::string> LocalAccount() const {
+        std::shared_ptr<const std::string> accountId = std::atomic_load_explicit(&m_localAccountId, std::memory_order_acquire);
+        return accountId && !accountId->empty() ? accountId : nullptr;
+    }
+
+    // 中継・共有メモリバスで戻ってきた自分の口座の気配（WSOnTick で反映済み）
+    bool IsLocalAccount(const std::string& accountId) const {
+        std::shared_ptr<const std::string> localAccount = LocalAccount();
+        return localAccount && *localAccount == accountId;
+    }
+
+    // 口座ごとの気配を統合気配と機会検出に反映する（EA・共有メモリバス・ioスレッドから呼ばれる）
+    void OnQuote(const std::string& symbol, const std::string& accountId, double bid, double ask,
+                 long long timeMsc, long long receivedUs) {
+        // ティック時刻が戻った気配は統合気配で捨てられるため、機会検出にも渡さない。統合気配の更新と
+        // 機会検出の間で同じ口座の新しい気配に追い越された場合は、機会検出がティック時刻で捨てる
+        if (!m_book.Update(symbol, accountId, bid, ask, timeMsc, receivedUs) || !m_spreadDetection) {
+            return;
+        }
+        std::vector<SpreadOpportunity> events;
+        if (m_spreads.OnQuote(symbol, accountId, bid, ask, timeMsc, receivedUs, events) > 0) {
+            PublishOpportunities(events);
+        }
+    }
+
+    // 気配の届かない組の持続時間の到達・気配の期限切れ（ioスレッドのタイマーから呼び出す）
+    void SweepSpreads() {
+        if (!m_spreadDetection) {
+            return;
+        }
+        std::vector<SpreadOpportunity> events;
+        if (m_spreads.Sweep(NowMicros(), events) > 0) {
+            PublishOpportunities(events);
+        }
+    }
+
+    // 気配のスレッドとタイマーの送信は前後しうるため、受け取る側は sequence で組ごとの順序を判断する
+    void PublishOpportunities(const std::vector<SpreadOpportunity>& events) {
+        for (const auto& event : events) {
+            OpportunityFrame frame;
+            frame.timestamp = FormatIsoTimestamp(std::chrono::system_clock::time_point(std::chrono::microseconds(event.atUs)));
+            frame.state = event.state == OpportunityState::Open ? "OPEN" : "CLOSED";
+            frame.symbol = m_spreads.SymbolName(event.symbol);
+            frame.sellAccountId = m_spreads.BrokerName(event.sellBroker);
+            frame.buyAccountId = m_spreads.BrokerName(event.buyBroker);
+            frame.sellBid = event.sellBid;
+            frame.buyAsk = event.buyAsk;
+            frame.grossSpread = event.grossSpread;
+            frame.netSpread = event.netSpread;
+            frame.peakNetSpread = event.peakNetSpread;
+            frame.threshold = event.threshold;
+            frame.durationMs = (event.atUs - event.startedUs) / 1000;
+            frame.sequence = m_spreadSequenceBase + static_cast<long long>(event.sequence);
+            SendMessage(schema::ToJson(frame));
+        }
+    }
+
+    // サーバーが中継した口座ごとの気配（EAには渡さない）。自分の口座の気配は OnTick と同じ提供元に入り、
+    // ティック時刻が古ければ捨てられる
+    void HandlePriceUpdate(const std::string& payload, const MessageEnvelope& envelope,
+                           std::chrono::system_clock::time_point receivedAt) {
+        PriceUpdateFrame update;
+        if (!schema::DecodeJson(payload, update) || update.accountId.empty()) {
+            HandleUnknown(payload, envelope, receivedAt);
+            return;
+        }
+        if (IsLocalAccount(update.accountId)) {
+            return;
+        }
+        long long receivedUs = std::chrono::duration_cast<std::chrono::microseconds>(receivedAt.time_since_epoch()).count();
+        OnQuote(update.symbol, update.accountId, update.bid, update.ask, update.timeMsc, receivedUs);
+    }
+
+    void CheckPriceAlerts(const std::string& symbol, const HSTick& tick) {
+        if (tick.bid <= 0.0) {
+            return;
+        }
+
+        std::vector<TriggeredAlert> triggered;
+        m_priceAlerts.OnTick(symbol, std::llround(tick.bid * static_cast<double>(schema::FixedPrice::kScale)), triggered);
+        if (triggered.empty()) {
+            return;
+        }
+
+        std::string timestamp = FormatIsoTimestamp(std::chrono::system_clock::now());
+        for (const auto& alert : triggered) {
+            PriceAlertFrame frame;
+            frame.timestamp = timestamp;
+            frame.alertId = alert.alertId;
+            frame.symbol = alert.symbol;
+            frame.direction = alert.direction == AlertDirection::Above ? "ABOVE" : "BELOW";
+            frame.level.raw = alert.level;
+            frame.level.present = true;
+            frame.price.raw = alert.price;
+            frame.price.present = true;
+            frame.tickTimeMsc = tick.timeMsc;
+            SendMessage(schema::ToJson(frame));
+        }
+    }
+
+    static const char* MarginSeverityName(MarginSeverity severity) {
+        switch (severity) {
+            case MarginSeverity::Warning:    return "WARNING";
+            case MarginSeverity::Critical:   return "CRITICAL";
+            case MarginSeverity::MarginCall: return "MARGIN_CALL";
+            case MarginSeverity::StopOut:    return "STOP_OUT";
+            default:                         return "NORMAL";
+        }
+    }
+
+    // 通貨ペア仕様を上流に送信（接続後の初回は全件、以降は前回送信後に変化した分のみ）
+    void PublishSymbolSpecs(const std::string& accountId) {
+        uint64_t version = m_symbolSpecs.Version();
+        uint64_t sent = m_sentSpecVersion;
+        if (!m_connected || version == 0 || version == sent) {
+            return;
+        }
+
+        std::vector<SymbolSpec> specs;
+        m_symbolSpecs.CollectSince(sent, specs);
+
+        SymbolSpecsFrame frame;
+        frame.timestamp = FormatIsoTimestamp(std::chrono::system_clock::now());
+        frame.accountId = accountId;
+        frame.version = static_cast<long long>(version);
+        frame.full = sent == 0;
+
+        // スキーマは配列を持たないため、specs は要素ごとに直列化して連結する
+        std::string json = schema::ToJson(frame);
+        json.pop_back();
+        json += ",\"specs\":[";
+        for (size_t i = 0; i < specs.size(); i++) {
+            SymbolSpecEntryFrame entry;
+            entry.symbol = specs[i].symbol;
+            entry.digits = specs[i].digits;
+            entry.point = specs[i].point;
+            entry.tickSize = specs[i].tickSize;
+            entry.tickValue = specs[i].tickValue;
+            entry.contractSize = specs[i].contractSize;
+            entry.volumeMin = specs[i].volumeMin;
+            entry.volumeStep = specs[i].volumeStep;
+            entry.volumeMax = specs[i].volumeMax;
+            entry.marginPerLot = specs[i].marginPerLot;
+            entry.marginHedged = specs[i].marginHedged;
+            entry.baseCurrency = specs[i].baseCurrency;
+            entry.profitCurrency = specs[i].profitCurrency;
+            entry.marginCurrency = specs[i].marginCurrency;
+            if (i > 0) json += ",";
+            json += schema::ToJson(entry);
+        }
+        json += "]}";
+
+        if (SendMessage(json)) {
+            m_sentSpecVersion = version;
+        }
+    }
+
+    // 維持率の段階の変化を即時送信（MARGIN_WARNING は linger を待たない）
+    void PublishMarginWarning(const MarginAlert& alert) {
+        MarginWarningFrame frame;
+        frame.timestamp = FormatIsoTimestamp(std::chrono::system_clock::now());
+        frame.accountId = alert.accountId;
+        frame.severity = MarginSeverityName(alert.state.severity);
+        frame.previousSeverity = MarginSeverityName(alert.previousSeverity);
+        frame.marginLevel = alert.state.marginLevel;
+        frame.threshold = alert.threshold;
+        frame.equity = alert.state.equity;
+        frame.margin = alert.state.margin;
+        frame.freeMargin = alert.state.freeMargin;
+        frame.stopOutLevel = alert.state.stopOutLevel;
+        frame.equityToStopOut = alert.state.equityToStopOut;
+        SendMessage(schema::ToJson(frame));
+    }
+
+    // 未知の種別はEAに渡さず件数のみ記録
+    void HandleUnknown(const std::string&, const MessageEnvelope&, std::chrono::system_clock::time_point) {
+        m_unknownMessageCount++;
+    }
+
+    // サーバーの応答（時刻はクロックスキュー推定の標本として取り込み済み。EAには渡さない）
+    void HandleServerAck(const std::string&, const MessageEnvelope&, std::chrono::system_clock::time_point) {
+    }
+
+    // コマンド以外の既知メッセージはそのままEAの取り出し待ちにする
+    void HandleInformational(const std::string& payload, const MessageEnvelope&,
+                             std::chrono::system_clock::time_point receivedAt) {
+        InboundMessage inbound;
+        inbound.payload = payload;
+        inbound.receivedAtUs = std::chrono::duration_cast<std::chrono::microseconds>(receivedAt.time_since_epoch()).count();
+        m_inboundQueue.Push(std::move(inbound));
+    }
+
+    // コマンドは受信・デコード直後にioスレッドから受領ACKを返す
+    // （実行結果の OPENED/CLOSED はEAでの実行後に別途送信される）
+    void HandleCommand(const std::string& payload, const MessageEnvelope& envelope,
+                       std::chrono::system_clock::time_point receivedAt) {
+        InboundMessage inbound;
+        inbound.receivedAtUs = std::chrono::duration_cast<std::chrono::microseconds>(receivedAt.time_since_epoch()).count();
+        if (!DecodeCommand(payload, inbound.command)) {
+            HandleUnknown(payload, envelope, receivedAt);
+            return;
+        }
+
+        // 実行予定時刻はサーバー時刻のため、クロックスキュー推定値でローカル時刻に換算する
+        // （解釈できない場合は即時実行せず、不正なコマンドとして扱う）
+        if (!inbound.command.executeAt.empty()) {
+            std::chrono::system_clock::time_point executeAt;
+            if (!ParseIsoTimestamp(inbound.command.executeAt, executeAt)) {
+                HandleUnknown(payload, envelope, receivedAt);
+                return;
+            }
+            inbound.scheduled = true;
+            inbound.executeAt = m_clockSkew.ToLocal(executeAt);
+        }
+
+        inbound.payload = payload;
+        inbound.isCommand = true;
+        SendCommandAck(inbound.command, receivedAt);
+
+        AdmitCommand(std::move(inbound), receivedAt);
+    }
+
+    // 有効期限・発注前リスクチェックを通ったコマンドをEAの取り出し待ちにする（通らなければ false）
+    bool AdmitCommand(InboundMessage inbound, std::chrono::system_clock::time_point receivedAt) {
+        AssignDeadline(inbound);
+        if (inbound.hasDeadline && receivedAt > inbound.deadline) {
+            RejectExpiredCommand(inbound, receivedAt, "receive");
+            return false;
+        }
+
+        // 上限を超える OPEN はEAのキューに入れずにここで返す
+        if (inbound.command.type == CommandType::Open) {
+            RiskOrder order;
+            order.symbol = inbound.command.symbol;
+            order.direction = SideDirection(inbound.command.side);
+            order.volume = inbound.command.volume;
+            order.key = RiskReservationKey(inbound.command.positionId, inbound.command.actionId);
+
+            RiskDecision decision;
+            if (!m_riskGate.Check(order, NowMicros(), decision)) {
+                RejectRiskCommand(inbound, decision, receivedAt);
+                return false;
+            }
+        }
+
+        if (inbound.command.pairedLeg.Present()) {
+            ArmPairedLeg(inbound);
+        }
+
+        // 実行予定時刻つきコマンドはレート上限の対象外（予定時刻の揃い具合を優先する）
+        if (inbound.scheduled) {
+            long long dueUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                inbound.executeAt.time_since_epoch()).count();
+            long long receivedUs = inbound.receivedAtUs;
+            m_scheduler.Schedule(std::move(inbound), dueUs, receivedUs);
+            return true;
+        }
+
+        m_inboundQueue.Push(std::move(inbound));
+        return true;
+    }
+
+    // 対のレッグを主レッグの約定まで保持する。主レッグが約定しないまま期限を過ぎたものは破棄を通知する
+    void ArmPairedLeg(const InboundMessage& inbound) {
+        std::vector<ArmedLeg> expired;
+        m_legBus.DropStale(inbound.receivedAtUs, expired);
+        for (const auto& stale : expired) {
+            LegDispatchedFrame report;
+            FillLegReport(report, stale, std::chrono::system_clock::now());
+            report.route = "CANCELLED";
+            report.reason = "PRIMARY_TIMEOUT";
+            SendMessage(schema::ToJson(report));
+        }
+
+        ArmedLeg armed;
+        armed.accountId = inbound.command.accountId;
+        armed.positionId = inbound.command.positionId;
+        armed.actionId = inbound.command.actionId;
+        armed.leg = inbound.command.pairedLeg;
+        armed.armedAtUs = inbound.receivedAtUs;
+        m_legBus.Arm(std::move(armed));
+    }
+
+    // 主レッグの約定結果に応じて対のレッグを扱う（保持していなければ false）
+    // 対のレッグの口座がこの端末にあれば、Hedge System を経由せずEAのキューへ直接入れる
+    bool DispatchPairedLeg(const CompletedTrade& trade, LegDispatchedFrame& report) {
+        const TradeSubmission& submission = trade.submission;
+        ArmedLeg armed;
+        if (!m_legBus.Take(submission.accountId, submission.positionId, armed)) {
+            return false;
+        }
+
+        auto now = std::chrono::system_clock::now();
+        FillLegReport(report, armed, now);
+
+        if (trade.outcome == CompletedTrade::Outcome::Rejected) {
+            report.route = "CANCELLED";
+            report.reason = "PRIMARY_REJECTED";
+            return true;
+        }
+        if (m_legBus.Route(armed.leg) != LegRoute::Local) {
+            // 同一ホストの別の端末が対象口座で参加していれば、共有メモリバスでその端末のDLLへ直接渡す
+            int peer = m_sharedBus.Self() >= 0 ? m_sharedBus.Find(armed.leg.accountId, NowMicros()) : -1;
+            if (peer >= 0) {
+                std::string payload = MakePairedLegCommand(armed.leg, now).payload;
+                if (m_sharedBus.Send(peer, BusMessageKind::Command, payload.data(), payload.size(), NowMicros())) {
+                    report.route = "PEER";
+                    report.dispatchUs = NowMicros() - trade.filledAtUs;
+                    return true;
+                }
+            }
+            report.route = "UPSTREAM";
+            report.reason = peer >= 0 ? "PEER_BUSY" : "NOT_LOCAL";
+            return true;
+        }
+
+        bool admitted = AdmitCommand(MakePairedLegCommand(armed.leg, now), now);
+        report.route = admitted ? "LOCAL" : "REJECTED";
+        report.dispatchUs = NowMicros() - trade.filledAtUs;
+        return true;
+    }
+
+    // 共有メモリバスの受信スレッド。受信が続く間は眠らずに取り出し、途切れたら短く眠る
+    void RunSharedBus() {
+        long long lastHeartbeatUs = 0;
+        long long lastReceiveUs = 0;
+        long long lastHelloUs = 0;
+        BusMessage message;
+        while (m_busRunning) {
+            bool received = false;
+            while (m_sharedBus.Receive(message)) {
+                HandleBusMessage(message);
+                received = true;
+            }
+
+            long long nowUs = NowMicros();
+            if (received) {
+                lastReceiveUs = nowUs;
+            }
+            if (nowUs - lastHeartbeatUs >= kBusHeartbeatUs) {
+                m_sharedBus.Heartbeat(nowUs);
+                lastHeartbeatUs = nowUs;
+                if (m_viaGateway) {
+                    CheckGateway(nowUs, lastHelloUs);
+                }
+            }
+
+            if (nowUs - lastReceiveUs < m_busSpinUs) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(kBusIdleSleepUs));
+            }
+        }
+    }
+
+    void HandleBusMessage(const BusMessage& message) {
+        auto receivedAt = std::chrono::system_clock::now();
+        long long receivedUs = std::chrono::duration_cast<std::chrono::microseconds>(receivedAt.time_since_epoch()).count();
+        BusParticipant sender;
+        if (!m_sharedBus.ParticipantAt(message.from, receivedUs, sender)) {
+            return;
+        }
+        long long sentAtUs = static_cast<long long>(message.sentAtUs);
+
+        switch (static_cast<BusMessageKind>(message.kind)) {
+        case BusMessageKind::Tick:
+            if (message.length == sizeof(BusTick)) {
+                BusTick tick;
+                std::memcpy(&tick, message.payload, sizeof(tick));
+                m_peers.OnTick(sender.accountId, tick, sentAtUs, receivedUs);
+                if (!IsLocalAccount(sender.accountId)) {
+                    OnQuote(ReadFixedString(tick.symbol), sender.accountId, tick.bid, tick.ask, tick.timeMsc, receivedUs);
+                }
+            }
+            break;
+        case BusMessageKind::Snapshot:
+            if (message.length == sizeof(BusSnapshot)) {
+                BusSnapshot snapshot;
+                std::memcpy(&snapshot, message.payload, sizeof(snapshot));
+                m_peers.OnSnapshot(sender.accountId, snapshot, sentAtUs, receivedUs);
+            }
+            break;
+        case BusMessageKind::Frame: {
+            std::string frame;
+            if (m_viaGateway && sender.accountId == kGatewayAccountId && m_gatewayLink.Accept(message, frame)) {
+                HandleGatewayFrame(std::move(frame), message.from);
+            }
+            break;
+        }
+        case BusMessageKind::Command: {
+            // 別の端末のDLLから渡された対のレッグ。受領ACKは送信元の LEG_DISPATCHED（PEER）が兼ねる
+            InboundMessage inbound;
+            inbound.receivedAtUs = receivedUs;
+            std::string payload(message.payload, message.length);
+            if (!DecodeCommand(payload, inbound.command) || !inbound.command.executeAt.empty()) {
+                m_unknownMessageCount++;
+                return;
+            }
+            inbound.payload = std::move(payload);
+            inbound.isCommand = true;
+            AdmitCommand(std::move(inbound), receivedAt);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // ゲートウェイの生存確認（受信スレッド）。いなくなれば切断とし、未接続の間は参加を通知し続ける
+    void CheckGateway(long long nowUs, long long& lastHelloUs) {
+        int gateway = m_sharedBus.Find(kGatewayAccountId, nowUs);
+        m_gatewayIndex = gateway;
+        if (gateway < 0) {
+            if (m_connected) {
+                PostToEventLoop([this]() {
+                    OnTransportClosed("Gateway unavailable");
+                });
+            }
+            return;
+        }
+
+        if (!m_connected && nowUs - lastHelloUs >= kGatewayHelloIntervalUs) {
+            GatewayHelloFrame hello;
+            hello.accountId = m_busAccountId;
+            m_gatewayLink.Send(gateway, schema::ToJson(hello), nowUs);
+            lastHelloUs = nowUs;
+        }
+    }
+
+    // ゲートウェイからのフレーム（受信スレッド）。上流のフレームは直接接続と同じくioスレッドで処理する
+    void HandleGatewayFrame(std::string frame, int gateway) {
+        m_gatewayIndex = gateway;
+        if (ExtractMessageType(frame) == "GATEWAY_STATUS") {
+            GatewayStatusFrame status;
+            if (!schema::DecodeJson(frame, status)) {
+                return;
+            }
+            bool connected = status.connected;
+            PostToEventLoop([this, connected]() {
+                if (!m_viaGateway || connected == m_connected) {
+                    return;
+                }
+                if (connected) {
+                    OnTransportOpen();
+                } else {
+                    OnTransportClosed("Gateway upstream disconnected");
+                }
+            });
+            return;
+        }
+
+        PostToEventLoop([this, payload = std::move(frame)]() {
+            DispatchInbound(payload);
+        });
+    }
+
+    template <typename Handler>
+    void PostToEventLoop(Handler handler) {
+        websocketpp::lib::asio::post(m_client.get_io_service(), std::move(handler));
+    }
+
+    void BroadcastBusTick(const HSTick& tick) {
+        BusTick busTick;
+        busTick.bid = tick.bid;
+        busTick.ask = tick.ask;
+        busTick.point = tick.point;
+        busTick.timeMsc = tick.timeMsc;
+        std::memcpy(busTick.symbol, tick.symbol, sizeof(busTick.symbol));
+        busTick.symbol[sizeof(busTick.symbol) - 1] = '\0';
+        m_sharedBus.Broadcast(BusMessageKind::Tick, &busTick, sizeof(busTick), NowMicros());
+    }
+
+    void BroadcastBusSnapshot() {
+        PnLSummary summary = m_pnl.GetSummary();
+        MarginState margin = m_marginMonitor.GetState();
+
+        BusSnapshot snapshot;
+        snapshot.balance = summary.balance;
+        snapshot.equity = margin.equity;
+        snapshot.margin = margin.margin;
+        snapshot.marginLevel = margin.marginLevel;
+        snapshot.floatingPnl = summary.floatingPnl;
+        m_lastBusSnapshotUs = NowMicros();
+        m_sharedBus.Broadcast(BusMessageKind::Snapshot, &snapshot, sizeof(snapshot), m_lastBusSnapshotUs);
+    }
+
+    // 受信したコマンドと同じ形にする（送信時刻はスキュー推定値でサーバー時刻に換算した現在時刻）
+    InboundMessage MakePairedLegCommand(const PairedLeg& leg, std::chrono::system_clock::time_point now) const {
+        CommandFrame frame;
+        frame.type = "OPEN";
+        frame.commandId = leg.commandId;
+        frame.accountId = leg.accountId;
+        frame.positionId = leg.positionId;
+        frame.actionId = leg.actionId;
+        frame.symbol = leg.symbol;
+        frame.side = leg.side;
+        frame.volume = leg.volume;
+        frame.ttlMs = leg.ttlMs;
+        frame.timestamp = FormatIsoTimestamp(now - std::chrono::microseconds(m_clockSkew.OffsetMicros()));
+
+        InboundMessage inbound;
+        inbound.payload = schema::ToJson(frame);
+        inbound.isCommand = true;
+        inbound.receivedAtUs = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+        inbound.command.type = CommandType::Open;
+        inbound.command.commandId = leg.commandId;
+        inbound.command.accountId = leg.accountId;
+        inbound.command.positionId = leg.positionId;
+        inbound.command.actionId = leg.actionId;
+        inbound.command.symbol = leg.symbol;
+        inbound.command.side = leg.side;
+        inbound.command.volume = leg.volume;
+        inbound.command.ttlMs = leg.ttlMs;
+        inbound.command.timestamp = frame.timestamp;
+        return inbound;
+    }
+
+    static void FillLegReport(LegDispatchedFrame& report, const ArmedLeg& armed, std::chrono::system_clock::time_point now) {
+        report.timestamp = FormatIsoTimestamp(now);
+        report.accountId = armed.accountId;
+        report.positionId = armed.positionId;
+        report.actionId = armed.actionId;
+        report.leg.commandId = armed.leg.commandId;
+        report.leg.accountId = armed.leg.accountId;
+        report.leg.positionId = armed.leg.positionId;
+        report.leg.actionId = armed.leg.actionId;
+        report.leg.symbol = armed.leg.symbol;
+        report.leg.side = armed.leg.side;
+        report.leg.volume = armed.leg.volume;
+        report.leg.ttlMs = armed.leg.ttlMs;
+    }
+
+    static int SideDirection(const std::string& side) {
+        if (side == "BUY" || side == "buy") return 1;
+        if (side == "SELL" || side == "sell") return -1;
+        return 0;
+    }
+
+    void RejectRiskCommand(const InboundMessage& inbound, const RiskDecision& decision, std::chrono::system_clock::time_point now) {
+        CommandRejectedFrame event;
+        event.timestamp = FormatIsoTimestamp(now);
+        event.commandType = CommandTypeName(inbound.command.type);
+        event.commandId = inbound.command.commandId;
+        event.accountId = inbound.command.accountId;
+        event.positionId = inbound.command.positionId;
+        event.actionId = inbound.command.actionId;
+        event.symbol = inbound.command.symbol;
+        event.volume = inbound.command.volume;
+        event.reason = RiskGate::ReasonName(decision.reason);
+        event.limit = decision.limit;
+        event.value = decision.value;
+
+        SendMessage(schema::ToJson(event));
+    }
+
+    // コマンド種別ごとのTTL（コマンド個別の ttlMs が優先）から有効期限を設定
+    // CLOSE はリスク削減のため期限切れにしない
+    void AssignDeadline(InboundMessage& inbound) {
+        long long ttlMs = inbound.command.ttlMs;
+        if (ttlMs <= 0) {
+            switch (inbound.command.type) {
+                case CommandType::Open:
+                    ttlMs = m_openTtlMs;
+                    break;
+                case CommandType::Modify:
+                    ttlMs = m_modifyTtlMs;
+                    break;
+                default:
+                    ttlMs = 0;
+                    break;
+            }
+        }
+
+        if (inbound.command.type == CommandType::Close || ttlMs <= 0) {
+            return;
+        }
+
+        // 実行予定時刻つきコマンドは予定時刻から TTL を数える
+        if (inbound.scheduled) {
+            inbound.issuedAt = inbound.executeAt;
+        } else {
+            std::chrono::system_clock::time_point serverTime;
+            if (!ParseIsoTimestamp(inbound.command.timestamp, serverTime)) {
+                return;
+            }
+            inbound.issuedAt = m_clockSkew.ToLocal(serverTime);
+        }
+
+        inbound.hasDeadline = true;
+        inbound.deadline = inbound.issuedAt + std::chrono::milliseconds(ttlMs);
+    }
+
+    void RejectExpiredCommand(const InboundMessage& inbound, std::chrono::system_clock::time_point now, const char* stage) {
+        m_expiredCommandCount++;
+
+        auto ageMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - inbound.issuedAt).count();
+        auto ttlMs = std::chrono::duration_cast<std::chrono::milliseconds>(inbound.deadline - inbound.issuedAt).count();
+
+        CommandExpiredFrame event;
+        event.timestamp = FormatIsoTimestamp(now);
+        event.commandType = CommandTypeName(inbound.command.type);
+        event.commandId = inbound.command.commandId;
+        event.accountId = inbound.command.accountId;
+        event.positionId = inbound.command.positionId;
+        event.actionId = inbound.command.actionId;
+        event.commandTimestamp = inbound.command.timestamp;
+        event.ageMs = ageMs;
+        event.ttlMs = ttlMs;
+        event.stage = stage;
+
+        SendMessage(schema::ToJson(event));
+    }
+
+    // 予定時刻との差はローカル時刻で測り、releasedAt はスキュー推定値でサーバー時刻に戻して返す
+    void SendCommandReleased(const InboundMessage& inbound, long long dueUs, std::chrono::system_clock::time_point releasedAt) {
+        long long releasedUs = std::chrono::duration_cast<std::chrono::microseconds>(releasedAt.time_since_epoch()).count();
+        int64_t offsetUs = m_clockSkew.OffsetMicros();
+
+        CommandReleasedFrame event;
+        event.timestamp = FormatIsoTimestamp(releasedAt);
+        event.commandType = CommandTypeName(inbound.command.type);
+        event.commandId = inbound.command.commandId;
+        event.accountId = inbound.command.accountId;
+        event.positionId = inbound.command.positionId;
+        event.actionId = inbound.command.actionId;
+        event.executeAt = inbound.command.executeAt;
+        event.releasedAt = FormatIsoTimestamp(releasedAt - std::chrono::microseconds(offsetUs));
+        event.skewUs = releasedUs - dueUs;
+        event.clockOffsetUs = offsetUs;
+        event.scheduledUs = releasedUs - inbound.receivedAtUs;
+
+        SendMessage(schema::ToJson(event));
+    }
+
+    static long long NowMicros() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    template <size_t N>
+    static std::string ReadFixedString(const char (&source)[N]) {
+        size_t length = 0;
+        while (length < N && source[length] != '\0') {
+            length++;
+        }
+        return std::string(source, length);
+    }
+
+    // 発注前チェックの予約と、その OPEN の発注結果・約定を結び付けるキー
+    static std::string RiskReservationKey(const std::string& positionId, const std::string& actionId) {
+        return positionId + "/" + actionId;
+    }
+
+    // 突き合わせが完了した発注を OPENED / CLOSED / ERROR として送信
+    void PublishCompletedTrades(const std::vector<CompletedTrade>& completed) {
+        for (const auto& trade : completed) {
+            const TradeSubmission& submission = trade.submission;
+            m_executionStats.Record(trade);
+
+            // 突き合わせの済んだ OPEN の予約を解放する（約定分は保有量に反映済み、拒否は保有量が増えない）
+            if (submission.action == TradeAction::Open) {
+                m_riskGate.Release(RiskReservationKey(submission.positionId, submission.actionId));
+            }
+            auto filledAt = std::chrono::system_clock::time_point(std::chrono::microseconds(trade.filledAtUs));
+
+            // 対のレッグは主レッグの結果を送る前にEAへ渡し、通知は結果の後に送る
+            LegDispatchedFrame legReport;
+            bool hasLeg = submission.action == TradeAction::Open && DispatchPairedLeg(trade, legReport);
+
+            if (trade.outcome == CompletedTrade::Outcome::Rejected) {
+                ErrorEventFrame error;
+                error.timestamp = FormatIsoTimestamp(filledAt);
+                error.accountId = submission.accountId;
+                error.positionId = submission.positionId;
+                error.actionId = submission.actionId;
+                error.message = std::string(submission.action == TradeAction::Close ? "Close" : "Open") +
+                                " order rejected (retcode " + std::to_string(submission.retcode) + ")";
+                error.errorCode = std::to_string(submission.retcode);
+                SendMessage(schema::ToJson(error));
+                if (hasLeg) {
+                    SendMessage(schema::ToJson(legReport));
+                }
+                continue;
+            }
+
+            if (submission.action == TradeAction::Close) {
+                ClosedEventFrame event;
+                FillExecutionFields(event, trade, filledAt);
+                event.profit = trade.profit;
+                SendMessage(schema::ToJson(event));
+            } else {
+                OpenedEventFrame event;
+                FillExecutionFields(event, trade, filledAt);
+                event.orderId = static_cast<long long>(submission.order);
+                SendMessage(schema::ToJson(event));
+                if (hasLeg) {
+                    SendMessage(schema::ToJson(legReport));
+                }
+            }
+        }
+    }
+
+    template <typename Event>
+    static void FillExecutionFields(Event& event, const CompletedTrade& trade, std::chrono::system_clock::time_point filledAt) {
+        const TradeSubmission& submission = trade.submission;
+        event.timestamp = FormatIsoTimestamp(filledAt);
+        event.accountId = submission.accountId;
+        event.positionId = submission.positionId;
+        event.actionId = submission.actionId;
+        event.price = trade.fillPrice;
+        event.time = event.timestamp;
+        event.mtTicket = std::to_string(trade.positionTicket != 0 ? trade.positionTicket : submission.order);
+        event.symbol = submission.symbol;
+        event.volume = trade.filledVolume;
+        event.requestedPrice = submission.requestedPrice;
+        event.slippagePoints = trade.slippagePoints;
+        event.fillLatencyUs = trade.fillLatencyUs > 0 ? trade.fillLatencyUs : 0;
+        event.submitToFillUs = trade.submitToFillUs > 0 ? trade.submitToFillUs : 0;
+    }
+
+    template <size_t N>
+    static void CopyFixedString(char (&destination)[N], const std::string& source) {
+        size_t length = source.size() < N - 1 ? source.size() : N - 1;
+        std::memcpy(destination, source.data(), length);
+        destination[length] = '\0';
+    }
+
+    void FillCommandStruct(const InboundMessage& inbound, HSCommand& command) const {
+        std::memset(&command, 0, sizeof(command));
+
+        switch (inbound.command.type) {
+            case CommandType::Open:
+                command.type = HS_COMMAND_OPEN;
+                break;
+            case CommandType::Close:
+                command.type = HS_COMMAND_CLOSE;
+                break;
+            case CommandType::Modify:
+                command.type = HS_COMMAND_MODIFY;
+                break;
+            default:
+                command.type = HS_COMMAND_NONE;
+                break;
+        }
+
+        command.priority = static_cast<int>(inbound.priority);
+        int direction = SideDirection(inbound.command.side);
+        if (direction > 0) {
+            command.side = HS_SIDE_BUY;
+        } else if (direction < 0) {
+            command.side = HS_SIDE_SELL;
+        } else {
+            command.side = HS_SIDE_NONE;
+        }
+        command.volume = inbound.command.volume;
+        command.receivedAtUs = inbound.receivedAtUs;
+        CopyFixedString(command.accountId, inbound.command.accountId);
+        CopyFixedString(command.positionId, inbound.command.positionId);
+        CopyFixedString(command.actionId, inbound.command.actionId);
+        CopyFixedString(command.symbol, inbound.command.symbol);
+
+        command.ticket = inbound.command.ticket;
+        command.stopLoss = inbound.command.stopLoss.raw;
+        command.takeProfit = inbound.command.takeProfit.raw;
+        command.modifyFlags = (inbound.command.stopLoss.present ? HS_MODIFY_SL : 0) |
+                              (inbound.command.takeProfit.present ? HS_MODIFY_TP : 0);
+
+        // 仕様登録済みの通貨ペアは SL/TP をティックサイズに丸め、EAでの SymbolInfo 呼び出しを省く
+        SymbolSpec spec;
+        if (!inbound.command.symbol.empty() && m_symbolSpecs.Find(inbound.command.symbol, spec)) {
+            command.digits = spec.digits;
+            command.stopLoss = RoundToTick(command.stopLoss, spec.tickSize);
+            command.takeProfit = RoundToTick(command.takeProfit, spec.tickSize);
+        }
+    }
+
+    static long long RoundToTick(long long raw, double tickSize) {
+        long long tick = std::llround(tickSize * static_cast<double>(schema::FixedPrice::kScale));
+        if (raw == 0 || tick <= 0) {
+            return raw;
+        }
+        long long half = tick / 2;
+        return (raw >= 0 ? (raw + half) / tick : (raw - half) / tick) * tick;
+    }
+
+    void SendCommandAck(const DecodedCommand& command, std::chrono::system_clock::time_point receivedAt) {
+        auto receivedAtUs = std::chrono::duration_cast<std::chrono::microseconds>(receivedAt.time_since_epoch()).count();
+
+        size_t queueDepth = m_inboundQueue.Size();
+
+        CommandAckFrame ack;
+        ack.timestamp = FormatIsoTimestamp(receivedAt);
+        ack.commandType = CommandTypeName(command.type);
+        ack.commandId = command.commandId;
+        ack.accountId = command.accountId;
+        ack.positionId = command.positionId;
+        ack.actionId = command.actionId;
+        ack.commandTimestamp = command.timestamp;
+        ack.receivedAtUs = receivedAtUs;
+        ack.queueDepth = static_cast<long long>(queueDepth);
+
+        SendMessage(schema::ToJson(ack));
+    }
+};
+
+// 静的メンバーの定義
+std::unique_ptr<WebSocketClient> WebSocketClient::s_instance = nullptr;
+std::mutex WebSocketClient::s_instanceMutex;
+
+// 文字列のメモリ管理用
+static std::mutex g_stringMutex;
+static std::string g_tempString;
+static std::string g_errorString;
+
+// C言語インターフェース
+extern "C" {
+
+HEDGESYSTEMWEBSOCKET_API bool WSConnect(const char* url, const char* token) {
+    if (!url || !token) {
+        return false;
+    }
+    
+    try {
+        return WebSocketClient::GetInstance().Connect(std::string(url), std::string(token));
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSConnectGateway(const char* busName, const char* accountId, int spinMicros) {
+    if (!busName || !accountId || busName[0] == '\0' || accountId[0] == '\0' || spinMicros < 0) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().ConnectGateway(busName, accountId, spinMicros);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API void WSDisconnect() {
+    try {
+        WebSocketClient::GetInstance().Disconnect();
+    }
+    catch (...) {
+        // エラーを無視
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSendMessage(const char* message) {
+    if (!message) {
+        return false;
+    }
+    
+    try {
+        return WebSocketClient::GetInstance().SendMessage(std::string(message));
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetOutboundBatching(int lingerMicros, int maxMessages, bool envelope) {
+    if (lingerMicros < 0 || lingerMicros > 100000 || maxMessages < 0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetBatching(static_cast<unsigned int>(lingerMicros),
+                                                   static_cast<unsigned int>(maxMessages),
+                                                   envelope);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetRetransmitWindow(int maxSeconds, int maxBytes) {
+    if (maxSeconds <= 0 || maxBytes <= 0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetRetransmitWindow(static_cast<unsigned int>(maxSeconds),
+                                                           static_cast<size_t>(maxBytes));
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API long long WSGetLastSentSeq() {
+    try {
+        return static_cast<long long>(WebSocketClient::GetInstance().GetLastSentSeq());
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSOnTick(const HSTick* tick) {
+    if (!tick) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().OnTick(*tick);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSGetSpreadStats(const char* symbol, HSSpreadStats* stats) {
+    if (!symbol || !stats) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().GetSpreadStats(symbol, *stats);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSGetPriceStats(const char* symbol, HSPriceStats* stats) {
+    if (!symbol || !stats) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().GetPriceStats(symbol, *stats);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetPriceStatsInterval(int intervalSeconds) {
+    if (intervalSeconds < 0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetPriceStatsInterval(static_cast<long long>(intervalSeconds) * 1000);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API long long WSGetPriceAlertCount() {
+    try {
+        return WebSocketClient::GetInstance().GetPriceAlertCount();
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSResetExposure() {
+    try {
+        WebSocketClient::GetInstance().ResetExposure();
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSeedExposure(const HSTradeTransaction* position) {
+    if (!position) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().SeedExposure(*position);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API const char* WSGetExposureJson() {
+    try {
+        std::lock_guard<std::mutex> lock(g_stringMutex);
+        g_tempString = WebSocketClient::GetInstance().GetExposureJson();
+        return g_tempString.c_str();
+    }
+    catch (...) {
+        return "";
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSLoadSymbolSpecs(const HSSymbolSpec* specs, int count) {
+    if (!specs || count <= 0) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().LoadSymbolSpecs(specs, count);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSGetSymbolSpec(const char* symbol, HSSymbolSpec* spec) {
+    if (!symbol || !spec) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().GetSymbolSpec(symbol, *spec);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSOnAccountUpdate(const HSAccountState* account) {
+    if (!account) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().OnAccountUpdate(*account);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetMarginThresholds(double warningLevel, double criticalLevel) {
+    if (warningLevel < 0.0 || criticalLevel < 0.0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetMarginThresholds(warningLevel, criticalLevel);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSGetMarginState(HSMarginState* state) {
+    if (!state) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().GetMarginState(*state);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetPnLUpdateInterval(int intervalMs) {
+    if (intervalMs < 0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetPnLUpdateInterval(intervalMs);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSGetPnLSummary(HSPnLSummary* summary) {
+    if (!summary) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().GetPnLSummary(*summary);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSGetPositionPnL(long long positionId, HSPositionPnL* position) {
+    if (!position || positionId <= 0) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().GetPositionPnL(positionId, *position);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API const char* WSGetRequiredTickSymbols() {
+    try {
+        std::lock_guard<std::mutex> lock(g_stringMutex);
+        g_tempString = WebSocketClient::GetInstance().GetRequiredTickSymbols();
+        return g_tempString.c_str();
+    }
+    catch (...) {
+        return "";
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetSpreadWindow(int windowSeconds) {
+    if (windowSeconds <= 0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetSpreadWindow(static_cast<long long>(windowSeconds) * 1000);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetExecutionStatsInterval(int intervalSeconds) {
+    if (intervalSeconds < 0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetExecutionStatsInterval(static_cast<long long>(intervalSeconds) * 1000);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSOnTradeResult(const HSTradeResult* result) {
+    if (!result) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().OnTradeResult(*result);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSOnTradeTransaction(const HSTradeTransaction* transaction) {
+    if (!transaction) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().OnTradeTransaction(*transaction);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSReceiveCommand(HSCommand* command) {
+    if (!command) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().ReceiveCommand(*command);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSReceiveScheduledCommand(int timeoutMs, HSCommand* command) {
+    if (!command || timeoutMs < 0) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().ReceiveScheduledCommand(timeoutMs, *command);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API long long WSGetScheduledCommandCount() {
+    try {
+        return WebSocketClient::GetInstance().GetScheduledCommandCount();
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSJoinSharedBus(const char* name, const char* accountId, int spinMicros) {
+    if (!name || !accountId || name[0] == '\0' || accountId[0] == '\0' || spinMicros < 0) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().JoinSharedBus(name, accountId, spinMicros);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSLeaveSharedBus() {
+    try {
+        WebSocketClient::GetInstance().LeaveSharedBus();
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSGetPeerTick(const char* accountId, const char* symbol, HSTick* tick) {
+    if (!accountId || !symbol || !tick) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().GetPeerTick(accountId, symbol, *tick);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API const char* WSGetSharedBusJson() {
+    try {
+        std::lock_guard<std::mutex> lock(g_stringMutex);
+        g_tempString = WebSocketClient::GetInstance().GetSharedBusJson();
+        return g_tempString.c_str();
+    }
+    catch (...) {
+        return "";
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSGetBestQuote(const char* symbol, HSBestQuote* quote) {
+    if (!symbol || !quote) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().GetBestQuote(symbol, *quote);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetLocalAccount(const char* accountId) {
+    if (!accountId || accountId[0] == '\0') {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetLocalAccount(accountId);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetBestQuoteMaxAge(int maxAgeMs) {
+    if (maxAgeMs < 0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetBestQuoteMaxAge(maxAgeMs);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetSpreadRule(const char* symbol, const HSSpreadRule* rule) {
+    if (!symbol || !rule || rule->minPersistMs < 0 || rule->maxQuoteAgeMs < 0 || rule->holdingDays < 0.0 ||
+        rule->exit > rule->entry) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().SetSpreadRule(symbol, *rule);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetSpreadCost(const char* accountId, const char* symbol, const HSSpreadCost* cost) {
+    if (!accountId || !symbol || !cost || cost->commission < 0.0) {
+        return false;
+    }
+
+    try {
+        return WebSocketClient::GetInstance().SetSpreadCost(accountId, symbol, *cost);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSEnableSpreadDetector(bool enabled) {
+    try {
+        WebSocketClient::GetInstance().EnableSpreadDetector(enabled);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API long long WSGetOpenOpportunityCount() {
+    try {
+        return WebSocketClient::GetInstance().GetOpenOpportunityCount();
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetCommandTtl(int openTtlMs, int modifyTtlMs) {
+    if (openTtlMs < 0 || modifyTtlMs < 0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetCommandTtl(openTtlMs, modifyTtlMs);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API long long WSGetExpiredCommandCount() {
+    try {
+        return WebSocketClient::GetInstance().GetExpiredCommandCount();
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetRiskLimits(const HSRiskLimits* limits) {
+    if (!limits || limits->maxLot < 0.0 || limits->maxSymbolVolume < 0.0 || limits->maxAccountVolume < 0.0 ||
+        limits->minMarginLevel < 0.0 || limits->maxOrdersPerSecond < 0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetRiskLimits(*limits);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API long long WSGetRiskRejectCount() {
+    try {
+        return WebSocketClient::GetInstance().GetRiskRejectCount();
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API long long WSGetCoalescedModifyCount() {
+    try {
+        return WebSocketClient::GetInstance().GetCoalescedModifyCount();
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSSetCommandThrottle(double accountRate, int accountBurst, double symbolRate, int symbolBurst) {
+    if (accountRate < 0.0 || symbolRate < 0.0 || accountBurst < 0 || symbolBurst < 0) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().SetCommandThrottle(accountRate, accountBurst, symbolRate, symbolBurst);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API bool WSGetCommandWaitStats(HSCommandWaitStats* stats) {
+    if (!stats) {
+        return false;
+    }
+
+    try {
+        WebSocketClient::GetInstance().GetCommandWaitStats(*stats);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API long long WSGetUnknownMessageCount() {
+    try {
+        return WebSocketClient::GetInstance().GetUnknownMessageCount();
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API long long WSGetDroppedDealCount() {
+    try {
+        return WebSocketClient::GetInstance().GetDroppedDealCount();
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+HEDGESYSTEMWEBSOCKET_API long long WSGetClockSkewMicros() {
+    try {
+        return WebSocketClient::GetInstance().GetClockSkewMicros();
+    }
+    catch (...) {
+        return 0;
     }
 }
 
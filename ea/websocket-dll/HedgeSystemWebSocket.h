@@ -13,18 +13,401 @@ extern "C" {
 #define HEDGESYSTEMWEBSOCKET_API __declspec(dllimport)
 #endif
 
+// コマンド種別
+#define HS_COMMAND_NONE   0
+#define HS_COMMAND_OPEN   1
+#define HS_COMMAND_CLOSE  2
+#define HS_COMMAND_MODIFY 3
+
+// 売買方向
+#define HS_SIDE_NONE -1
+#define HS_SIDE_BUY   0
+#define HS_SIDE_SELL  1
+
+// MODIFY で指定された項目（HSCommand.modifyFlags）
+#define HS_MODIFY_SL 1
+#define HS_MODIFY_TP 2
+
+// 固定小数点価格の倍率（HSCommand.stopLoss / takeProfit = 価格 × HS_PRICE_SCALE）
+#define HS_PRICE_SCALE 100000000LL
+
+// デコード済みコマンド（MQL5 の構造体と1バイト境界で一致させる）
+#pragma pack(push, 1)
+typedef struct HSCommand {
+    int       type;            // HS_COMMAND_*
+    int       priority;        // 0: CLOSE/MODIFY（リスク削減系）, 1: OPEN
+    int       side;            // HS_SIDE_*
+    double    volume;
+    long long receivedAtUs;    // DLLでの受信時刻（UNIXエポックからのマイクロ秒）
+    char      accountId[64];
+    char      positionId[64];
+    char      actionId[64];
+    char      symbol[32];
+    long long ticket;          // MODIFY: 対象チケット（0 の場合は positionId で特定）
+    long long stopLoss;        // MODIFY: 新しいSL（HS_PRICE_SCALE 倍の固定小数点、0 で解除）
+    long long takeProfit;      // MODIFY: 新しいTP（HS_PRICE_SCALE 倍の固定小数点、0 で解除）
+    int       modifyFlags;     // MODIFY: 指定された項目（HS_MODIFY_*）。未指定の項目は現状維持
+    int       digits;          // symbol の SYMBOL_DIGITS（仕様未登録・symbol なしは 0）。SL/TP はティックサイズに丸め済み
+} HSCommand;
+#pragma pack(pop)
+
+// 発注種別（HSTradeResult.action）
+#define HS_TRADE_OPEN  0
+#define HS_TRADE_CLOSE 1
+
+// 発注結果（OrderSend / OrderSendAsync 直後、および TRADE_TRANSACTION_REQUEST 時にEAから渡す）
+// TRADE_TRANSACTION_REQUEST 時は requestId / retcode / order のみでよい
+#pragma pack(push, 1)
+typedef struct HSTradeResult {
+    int          action;              // HS_TRADE_*
+    int          side;                // HS_SIDE_*（注文の売買方向。決済の場合は反対売買の方向）
+    unsigned int requestId;           // MqlTradeResult.request_id
+    int          retcode;             // MqlTradeResult.retcode
+    long long    order;               // MqlTradeResult.order（非同期送信直後は 0 の場合あり）
+    double       requestedPrice;      // 発注時の気配値
+    double       requestedVolume;
+    double       point;               // SYMBOL_POINT（スリッページのポイント換算用）
+    long long    commandReceivedAtUs; // 元コマンドの HSCommand.receivedAtUs（不明な場合は 0）
+    char         accountId[64];
+    char         positionId[64];
+    char         actionId[64];
+    char         symbol[32];
+} HSTradeResult;
+
+// 約定（OnTradeTransaction の TRADE_TRANSACTION_DEAL_ADD のみEAから渡す）
+typedef struct HSTradeTransaction {
+    long long deal;
+    long long order;
+    long long position;
+    double    price;
+    double    volume;
+    double    profit;                 // DEAL_PROFIT（決済約定の場合）
+    char      symbol[32];
+    int       dealType;               // DEAL_TYPE（0: 買い, 1: 売り, それ以外はエクスポージャー対象外）
+    int       entry;                  // DEAL_ENTRY（0: IN, 1: OUT, 2: INOUT, 3: OUT_BY, -1: 不明）
+} HSTradeTransaction;
+
+// ティック（OnTick ごとにEAから渡す）
+typedef struct HSTick {
+    double    bid;
+    double    ask;
+    double    point;                  // SYMBOL_POINT（スプレッドのポイント換算用）
+    long long timeMsc;                // MqlTick.time_msc
+    char      symbol[32];
+} HSTick;
+
+// 時間窓内のスプレッド統計（ポイント、分位点は相対誤差1%以内）
+typedef struct HSSpreadStats {
+    long long count;                  // 窓内のティック数
+    long long windowMs;
+    double    current;                // 最新ティックのスプレッド
+    double    mean;
+    double    min;
+    double    p50;
+    double    p90;
+    double    p99;
+    double    max;
+} HSSpreadStats;
+
+// 全口座（ブローカー）の最良気配（自分のティック・共有メモリバス・サーバー中継の PRICE_UPDATE から合成）
+typedef struct HSBestQuote {
+    double    bid;                    // 最も高い bid
+    double    ask;                    // 最も安い ask（bid > ask なら口座間で裁定可能）
+    long long bidAgeUs;               // 最良 bid の受信からの経過時間
+    long long askAgeUs;
+    long long bidTimeMsc;             // 最良 bid のブローカー側のティック時刻
+    long long askTimeMsc;
+    int       sources;                // 最良気配の計算に使った口座数
+    char      bidAccountId[64];
+    char      askAccountId[64];
+} HSBestQuote;
+
+// 口座間スプレッドの判定条件（価格単位。symbol を空にすると個別設定のない通貨ペアの既定値）
+typedef struct HSSpreadRule {
+    double    entry;                  // 機会とみなす正味スプレッド（売り口座の bid - 買い口座の ask - 費用）
+    double    exit;                   // 機会の終了とみなす正味スプレッド（entry 以下）
+    int       minPersistMs;           // entry 以上がこの時間続いてから OPPORTUNITY（OPEN）を送る
+    int       maxQuoteAgeMs;          // これより古い気配の口座は評価しない（0 で無制限）
+    double    holdingDays;            // スワップを見込む保有日数
+} HSSpreadRule;
+
+// 口座の費用（価格単位。symbol を空にするとその口座の個別設定のない通貨ペアの既定値）
+typedef struct HSSpreadCost {
+    double    commission;             // 往復の手数料
+    double    swapLong;               // 買いを1日持ち越したときのスワップ（受け取りは正）
+    double    swapShort;              // 売りを1日持ち越したときのスワップ（受け取りは正）
+} HSSpreadCost;
+
+// 直近 1024 ティックの価格統計（価格単位。volatility はティック対数リターンの標準偏差）
+typedef struct HSPriceStats {
+    long long ticks;                  // 窓内のティック数
+    long long lastTickMsc;
+    double    mid;
+    double    ewma;                   // 仲値の指数移動平均（時定数30秒）
+    double    mean;
+    double    high;
+    double    low;
+    double    spreadMean;
+    double    spreadMin;
+    double    spreadMax;
+    double    volatility;
+    double    shortVolatility;        // 直近16ティック
+    double    tickRate;               // ティック / 秒
+} HSPriceStats;
+
+// 通貨ペアの仕様（WSLoadSymbolSpecs で一括登録）
+typedef struct HSSymbolSpec {
+    double    point;                  // SYMBOL_POINT
+    double    tickSize;               // SYMBOL_TRADE_TICK_SIZE
+    double    tickValue;              // SYMBOL_TRADE_TICK_VALUE（1ロット・1ティックあたりの口座通貨額）
+    double    contractSize;           // SYMBOL_TRADE_CONTRACT_SIZE
+    double    volumeMin;              // SYMBOL_VOLUME_MIN
+    double    volumeStep;             // SYMBOL_VOLUME_STEP
+    double    volumeMax;              // SYMBOL_VOLUME_MAX
+    double    marginPerLot;           // 1ロットの必要証拠金（OrderCalcMargin、口座通貨）
+    double    marginHedged;           // SYMBOL_MARGIN_HEDGED
+    int       digits;                 // SYMBOL_DIGITS
+    char      symbol[32];
+    char      baseCurrency[8];        // SYMBOL_CURRENCY_BASE
+    char      profitCurrency[8];      // SYMBOL_CURRENCY_PROFIT
+    char      marginCurrency[8];      // SYMBOL_CURRENCY_MARGIN
+} HSSymbolSpec;
+
+// ブローカーの口座情報（証拠金維持率・評価損益の推定の基準点）
+typedef struct HSAccountState {
+    double    equity;
+    double    margin;
+    double    marginCallLevel;        // ACCOUNT_MARGIN_SO_CALL（%、0 は未使用）
+    double    stopOutLevel;           // ACCOUNT_MARGIN_SO_SO（%、0 は未使用）
+    double    balance;                // ACCOUNT_BALANCE
+    double    credit;                 // ACCOUNT_CREDIT
+    char      accountId[64];
+    char      currency[8];            // ACCOUNT_CURRENCY
+} HSAccountState;
+
+// 証拠金維持率の推定値
+typedef struct HSMarginState {
+    double    equity;
+    double    margin;
+    double    freeMargin;
+    double    marginLevel;            // %（証拠金 0 の場合は 0）
+    double    equityToStopOut;        // ストップアウトまでの余裕（口座通貨）
+    int       severity;               // 0: NORMAL, 1: WARNING, 2: CRITICAL, 3: MARGIN_CALL, 4: STOP_OUT
+} HSMarginState;
+
+// 口座全体の評価損益（口座通貨）
+typedef struct HSPnLSummary {
+    double    balance;
+    double    credit;
+    double    floatingPnl;
+    double    swap;
+    double    realized;               // 直近の口座情報通知以降の確定損益
+    double    equity;                 // balance + credit + floatingPnl + swap + realized
+    long long positions;
+    long long unconverted;            // 価格・換算レート不足で評価できないポジション数
+    char      currency[8];
+} HSPnLSummary;
+
+// ポジションごとの評価損益
+typedef struct HSPositionPnL {
+    double    volume;
+    double    openPrice;
+    double    currentPrice;           // 買いは bid、売りは ask
+    double    profitCurrencyPnl;      // 決済通貨建て
+    double    conversionRate;         // 決済通貨 → 口座通貨（仲値）
+    double    pnl;                    // 口座通貨建て
+    double    swap;
+    int       isBuy;
+    int       converted;
+    char      symbol[32];
+} HSPositionPnL;
+
+// 発注前リスクチェックの上限（0 の項目は無効）
+typedef struct HSRiskLimits {
+    double    maxLot;                 // 1注文のロット
+    double    maxSymbolVolume;        // 通貨ペアごとの |買い - 売り|（ロット）
+    double    maxAccountVolume;       // 口座全体の Σ(買い + 売り)（ロット）
+    double    minMarginLevel;         // 発注後の推定証拠金維持率（%）
+    int       maxOrdersPerSecond;
+} HSRiskLimits;
+
+// コマンドの待ち時間（受信からEAへの受け渡しまで、マイクロ秒）
+typedef struct HSCommandWaitStats {
+    long long commands;               // 受け渡したコマンド数
+    long long throttled;              // レート上限で待たされたコマンド数
+    long long meanWaitUs;
+    long long maxWaitUs;
+    long long throttledMeanWaitUs;    // レート上限で待たされたコマンドの平均
+    long long pending;                // 取り出し待ちの受信メッセージ数
+} HSCommandWaitStats;
+#pragma pack(pop)
+
 // WebSocket接続関数
 HEDGESYSTEMWEBSOCKET_API bool WSConnect(const char* url, const char* token);
 
+// ゲートウェイ経由の接続関数（同一ホストのゲートウェイと共有メモリバスでフレームを受け渡す。
+// busName・spinMicros は WSJoinSharedBus と同じ。ゲートウェイの上流接続の確立を最大5秒待つ）
+HEDGESYSTEMWEBSOCKET_API bool WSConnectGateway(const char* busName, const char* accountId, int spinMicros);
+
 // WebSocket切断関数
 HEDGESYSTEMWEBSOCKET_API void WSDisconnect();
 
 // メッセージ送信関数
 HEDGESYSTEMWEBSOCKET_API bool WSSendMessage(const char* message);
 
-// メッセージ受信関数（ノンブロッキング）
+// 送信マイクロバッチング設定関数
+// lingerMicros: 最大待機時間（マイクロ秒、0で無効）/ maxMessages: この件数で即時送信（0で無制限）
+// envelope: true で複数メッセージを1つの BATCH フレームに格納
+HEDGESYSTEMWEBSOCKET_API bool WSSetOutboundBatching(int lingerMicros, int maxMessages, bool envelope);
+
+// 再送リング設定関数（直近 maxSeconds 秒 / maxBytes バイト分の送信フレームを保持）
+HEDGESYSTEMWEBSOCKET_API bool WSSetRetransmitWindow(int maxSeconds, int maxBytes);
+
+// 最後に送信したメッセージのシーケンス番号取得関数
+HEDGESYSTEMWEBSOCKET_API long long WSGetLastSentSeq();
+
+// コマンド有効期限設定関数（ミリ秒、0で無効。CLOSE は期限切れにしない）
+// コマンドの metadata.ttlMs / ttlMs が指定されている場合はそちらが優先される
+HEDGESYSTEMWEBSOCKET_API bool WSSetCommandTtl(int openTtlMs, int modifyTtlMs);
+
+// 期限切れで破棄したコマンド数取得関数
+HEDGESYSTEMWEBSOCKET_API long long WSGetExpiredCommandCount();
+
+// 発注前リスクチェックの上限設定関数（OPEN のみ対象。超えた OPEN はEAに渡さず COMMAND_REJECTED を返す）
+HEDGESYSTEMWEBSOCKET_API bool WSSetRiskLimits(const HSRiskLimits* limits);
+
+// 発注前リスクチェックで破棄した OPEN の数取得関数
+HEDGESYSTEMWEBSOCKET_API long long WSGetRiskRejectCount();
+
+// サーバー時刻とのクロックスキュー推定値取得関数（マイクロ秒、ローカル - サーバー）
+HEDGESYSTEMWEBSOCKET_API long long WSGetClockSkewMicros();
+
+// 未知の種別のため破棄した受信メッセージ数取得関数
+HEDGESYSTEMWEBSOCKET_API long long WSGetUnknownMessageCount();
+
+// 発注結果と突き合わせられないまま件数の上限で破棄した約定数取得関数
+HEDGESYSTEMWEBSOCKET_API long long WSGetDroppedDealCount();
+
+// 後続の MODIFY にまとめて破棄した MODIFY コマンド数取得関数
+HEDGESYSTEMWEBSOCKET_API long long WSGetCoalescedModifyCount();
+
+// コマンドのレート上限設定関数（1秒あたりのコマンド数と連続で通せる数。rate 0 で無効）
+// 口座ごとと口座 × 通貨ペアごとのトークンバケットで、超えたコマンドは破棄せず受信順にキューで待たせる
+HEDGESYSTEMWEBSOCKET_API bool WSSetCommandThrottle(double accountRate, int accountBurst, double symbolRate, int symbolBurst);
+
+// コマンドの待ち時間取得関数
+HEDGESYSTEMWEBSOCKET_API bool WSGetCommandWaitStats(HSCommandWaitStats* stats);
+
+// 発注結果通知関数（DLLがコマンドと約定を突き合わせ、OPENED / CLOSED / ERROR を送信する）
+HEDGESYSTEMWEBSOCKET_API bool WSOnTradeResult(const HSTradeResult* result);
+
+// 約定通知関数（OnTradeTransaction の TRADE_TRANSACTION_DEAL_ADD を渡す）
+HEDGESYSTEMWEBSOCKET_API bool WSOnTradeTransaction(const HSTradeTransaction* transaction);
+
+// 約定品質集計（EXECUTION_STATS）の送信間隔設定関数（秒、0で無効。既定は60秒）
+HEDGESYSTEMWEBSOCKET_API bool WSSetExecutionStatsInterval(int intervalSeconds);
+
+// ティック通知関数（通貨ペアごとのスプレッド統計に記録する）
+HEDGESYSTEMWEBSOCKET_API bool WSOnTick(const HSTick* tick);
+
+// スプレッド統計取得関数（直近の時間窓、未記録の通貨ペアは false）
+HEDGESYSTEMWEBSOCKET_API bool WSGetSpreadStats(const char* symbol, HSSpreadStats* stats);
+
+// スプレッド統計の時間窓設定関数（秒、既定は300秒。既存の記録は破棄される）
+HEDGESYSTEMWEBSOCKET_API bool WSSetSpreadWindow(int windowSeconds);
+
+// 価格統計取得関数（直近1024ティック、未記録の通貨ペアは false）
+HEDGESYSTEMWEBSOCKET_API bool WSGetPriceStats(const char* symbol, HSPriceStats* stats);
+
+// 価格統計（PRICE_STATS）の送信間隔設定関数（秒、0で無効。既定は5秒）
+HEDGESYSTEMWEBSOCKET_API bool WSSetPriceStatsInterval(int intervalSeconds);
+
+// 登録中の価格アラート数取得関数
+HEDGESYSTEMWEBSOCKET_API long long WSGetPriceAlertCount();
+
+// 既存ポジション通知前のエクスポージャー初期化関数
+HEDGESYSTEMWEBSOCKET_API bool WSResetExposure();
+
+// 既存ポジションのエクスポージャー登録関数（dealType はポジションの売買方向、profit は累積スワップ、entry は無視される）
+HEDGESYSTEMWEBSOCKET_API bool WSSeedExposure(const HSTradeTransaction* position);
+
+// ネットエクスポージャー取得関数（口座全体の集計と通貨ペアごとの保有量の JSON）
+HEDGESYSTEMWEBSOCKET_API const char* WSGetExposureJson();
+
+// 通貨ペア仕様の一括登録関数（含まれない通貨ペアは保持。初期化時と仕様の変化時に呼び出す。新しい版を公開した場合のみ true）
+HEDGESYSTEMWEBSOCKET_API bool WSLoadSymbolSpecs(const HSSymbolSpec* specs, int count);
+
+// 通貨ペア仕様の取得関数（未登録は false）
+HEDGESYSTEMWEBSOCKET_API bool WSGetSymbolSpec(const char* symbol, HSSymbolSpec* spec);
+
+// 口座情報通知関数（証拠金維持率の推定の基準点を更新する）
+HEDGESYSTEMWEBSOCKET_API bool WSOnAccountUpdate(const HSAccountState* account);
+
+// 証拠金維持率の警告・危険水準設定関数（%、0で無効。既定は300% / 150%）
+HEDGESYSTEMWEBSOCKET_API bool WSSetMarginThresholds(double warningLevel, double criticalLevel);
+
+// 証拠金維持率の推定値取得関数
+HEDGESYSTEMWEBSOCKET_API bool WSGetMarginState(HSMarginState* state);
+
+// 評価損益（PNL_UPDATE）の送信間隔設定関数（ミリ秒、0で無効。既定は1000ミリ秒。変化がない区間は送信しない）
+HEDGESYSTEMWEBSOCKET_API bool WSSetPnLUpdateInterval(int intervalMs);
+
+// 口座全体の評価損益取得関数
+HEDGESYSTEMWEBSOCKET_API bool WSGetPnLSummary(HSPnLSummary* summary);
+
+// ポジションごとの評価損益取得関数（positionId は POSITION_IDENTIFIER）
+HEDGESYSTEMWEBSOCKET_API bool WSGetPositionPnL(long long positionId, HSPositionPnL* position);
+
+// 評価損益に必要なティックの通貨ペア取得関数（保有中と換算用の通貨ペア、カンマ区切り）
+HEDGESYSTEMWEBSOCKET_API const char* WSGetRequiredTickSymbols();
+
+// メッセージ受信関数（ノンブロッキング、優先度の高いメッセージから返す）
 HEDGESYSTEMWEBSOCKET_API const char* WSReceiveMessage();
 
+// コマンド受信関数（ノンブロッキング、CLOSE/MODIFY > OPEN の順に返す）
+HEDGESYSTEMWEBSOCKET_API bool WSReceiveCommand(HSCommand* command);
+
+// 実行予定時刻つきコマンド受信関数（timeoutMs 以内に予定時刻を迎えるコマンドがあれば予定時刻まで待って返す。
+// 0 なら予定時刻を過ぎたコマンドのみをノンブロッキングで返す）
+HEDGESYSTEMWEBSOCKET_API bool WSReceiveScheduledCommand(int timeoutMs, HSCommand* command);
+
+// 実行予定時刻待ちのコマンド数取得関数
+HEDGESYSTEMWEBSOCKET_API long long WSGetScheduledCommandCount();
+
+// 共有メモリバス参加関数（同一ホストの端末間でティック・口座状態・対のレッグを受け渡す。name は全端末で共通、
+// spinMicros は最後の受信から眠らずに待つ時間で、0 なら受信がなければ1ミリ秒ずつ眠る）
+HEDGESYSTEMWEBSOCKET_API bool WSJoinSharedBus(const char* name, const char* accountId, int spinMicros);
+
+// 共有メモリバス離脱関数
+HEDGESYSTEMWEBSOCKET_API bool WSLeaveSharedBus();
+
+// 他の端末の最新ティック取得関数（共有メモリバスで受信していない口座・通貨ペアは false）
+HEDGESYSTEMWEBSOCKET_API bool WSGetPeerTick(const char* accountId, const char* symbol, HSTick* tick);
+
+// 共有メモリバスの状態取得関数（参加者と送受信件数の JSON）
+HEDGESYSTEMWEBSOCKET_API const char* WSGetSharedBusJson();
+
+// 統合気配取得関数（通貨ペアごとの全口座の最良 bid / ask。ロックを取らず O(1)。気配のない通貨ペアは false）
+HEDGESYSTEMWEBSOCKET_API bool WSGetBestQuote(const char* symbol, HSBestQuote* quote);
+
+// この端末の口座ID設定関数（統合気配の自分の提供元。中継・共有メモリバスで戻ってきたこの口座の気配は捨てる。接続前に呼び出す）
+HEDGESYSTEMWEBSOCKET_API bool WSSetLocalAccount(const char* accountId);
+
+// 統合気配に使う気配の有効期間設定関数（ミリ秒、0で無制限。既定は5秒）
+HEDGESYSTEMWEBSOCKET_API bool WSSetBestQuoteMaxAge(int maxAgeMs);
+
+// 口座間スプレッドの判定条件設定関数
+HEDGESYSTEMWEBSOCKET_API bool WSSetSpreadRule(const char* symbol, const HSSpreadRule* rule);
+
+// 口座間スプレッドの費用設定関数（手数料・スワップを正味スプレッドから控除する）
+HEDGESYSTEMWEBSOCKET_API bool WSSetSpreadCost(const char* accountId, const char* symbol, const HSSpreadCost* cost);
+
+// 口座間スプレッドの機会検出の有効化関数（既定は無効。有効な間は統合気配の更新ごとに評価し OPPORTUNITY を送る）
+HEDGESYSTEMWEBSOCKET_API bool WSEnableSpreadDetector(bool enabled);
+
+// 開いている（OPEN を送って CLOSED を送っていない）機会の数取得関数
+HEDGESYSTEMWEBSOCKET_API long long WSGetOpenOpportunityCount();
+
 // 接続状態確認関数
 HEDGESYSTEMWEBSOCKET_API bool WSIsConnected();
 
@@ -0,0 +1,168 @@
+#include "InboundQueue.h"
+#include <algorithm>
+
+InboundPriority InboundQueue::Classify(const InboundMessage& message) {
+    if (!message.isCommand) {
+        return InboundPriority::Informational;
+    }
+
+    switch (message.command.type) {
+        case CommandType::Close:
+        case CommandType::Modify:
+            return InboundPriority::Critical;
+        case CommandType::Open:
+            return InboundPriority::Normal;
+        default:
+            return InboundPriority::Informational;
+    }
+}
+
+bool InboundQueue::Push(InboundMessage message) {
+    message.priority = Classify(message);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (message.isCommand && message.command.type == CommandType::Modify && CoalesceModify(message)) {
+        return false;
+    }
+    m_queues[static_cast<size_t>(message.priority)].push_back(std::move(message));
+    return true;
+}
+
+bool InboundQueue::PopNext(std::chrono::system_clock::time_point now, InboundMessage& message,
+                           std::vector<InboundMessage>& expired) {
+    return PopFrom(0, kPriorityCount, now, message, expired);
+}
+
+bool InboundQueue::PopNextCommand(std::chrono::system_clock::time_point now, InboundMessage& message,
+                                  std::vector<InboundMessage>& expired) {
+    // Informational にはコマンドが入らないため Critical / Normal のみを対象とする
+    return PopFrom(0, static_cast<size_t>(InboundPriority::Informational), now, message, expired);
+}
+
+size_t InboundQueue::Size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t total = 0;
+    for (const auto& queue : m_queues) {
+        total += queue.size();
+    }
+    return total;
+}
+
+void InboundQueue::SetThrottle(const ThrottleLimits& limits) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_throttle.SetLimits(limits);
+}
+
+CommandWaitStats InboundQueue::WaitStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_waitStats;
+}
+
+long long InboundQueue::CoalescedModifyCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_coalescedModifyCount;
+}
+
+bool InboundQueue::IsSameModifyTarget(const DecodedCommand& pending, const DecodedCommand& latest) {
+    if (pending.type != CommandType::Modify || pending.accountId != latest.accountId) {
+        return false;
+    }
+    if (latest.ticket != 0 && pending.ticket == latest.ticket) {
+        return true;
+    }
+    return !latest.positionId.empty() && pending.positionId == latest.positionId;
+}
+
+// m_mutex を保持した状態で呼び出すこと
+bool InboundQueue::CoalesceModify(InboundMessage& message) {
+    auto& queue = m_queues[static_cast<size_t>(message.priority)];
+    for (auto& pending : queue) {
+        if (!pending.isCommand || !IsSameModifyTarget(pending.command, message.command)) {
+            continue;
+        }
+
+        // 新しい MODIFY が指定していない項目は、置き換え前の指定を引き継ぐ
+        if (!message.command.stopLoss.present) {
+            message.command.stopLoss = pending.command.stopLoss;
+        }
+        if (!message.command.takeProfit.present) {
+            message.command.takeProfit = pending.command.takeProfit;
+        }
+        if (message.command.ticket == 0) {
+            message.command.ticket = pending.command.ticket;
+        }
+
+        // キュー内の位置は保ったまま内容のみ最新に置き換える
+        pending = std::move(message);
+        m_coalescedModifyCount++;
+        return true;
+    }
+    return false;
+}
+
+bool InboundQueue::PopFrom(size_t first, size_t last, std::chrono::system_clock::time_point now,
+                           InboundMessage& message, std::vector<InboundMessage>& expired) {
+    long long nowUs = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool throttling = m_throttle.Enabled();
+
+    // レート上限で見送った口座・口座 × 通貨ペア（優先度をまたいで追い越しを防ぐ）
+    std::vector<std::string> blockedAccounts;
+    std::vector<std::string> blockedSymbols;
+
+    for (size_t priority = first; priority < last; priority++) {
+        auto& queue = m_queues[priority];
+        for (auto it = queue.begin(); it != queue.end();) {
+            // 滞留中に期限切れとなったコマンドはEAに渡さない
+            if (it->hasDeadline && now > it->deadline) {
+                expired.push_back(std::move(*it));
+                it = queue.erase(it);
+                continue;
+            }
+
+            if (throttling && it->isCommand) {
+                const DecodedCommand& command = it->command;
+                std::string symbolKey = CommandThrottle::SymbolKey(command.accountId, command.symbol);
+                bool blocked =
+                    std::find(blockedAccounts.begin(), blockedAccounts.end(), command.accountId) != blockedAccounts.end() ||
+                    std::find(blockedSymbols.begin(), blockedSymbols.end(), symbolKey) != blockedSymbols.end();
+
+                ThrottleResult result = blocked ? ThrottleResult::AccountLimited
+                                                : m_throttle.TryAcquire(command.accountId, command.symbol, nowUs);
+                if (result != ThrottleResult::Allowed) {
+                    if (!blocked) {
+                        if (result == ThrottleResult::AccountLimited) {
+                            blockedAccounts.push_back(command.accountId);
+                        } else {
+                            blockedSymbols.push_back(symbolKey);
+                        }
+                    }
+                    it->throttled = true;
+                    ++it;
+                    continue;
+                }
+            }
+
+            message = std::move(*it);
+            queue.erase(it);
+            if (message.isCommand) {
+                RecordWait(message, nowUs);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// m_mutex を保持した状態で呼び出すこと
+void InboundQueue::RecordWait(const InboundMessage& message, long long nowUs) {
+    long long waitUs = message.receivedAtUs > 0 ? std::max(0LL, nowUs - message.receivedAtUs) : 0;
+    m_waitStats.commands++;
+    m_waitStats.totalWaitUs += waitUs;
+    m_waitStats.maxWaitUs = std::max(m_waitStats.maxWaitUs, waitUs);
+    if (message.throttled) {
+        m_waitStats.throttled++;
+        m_waitStats.throttledWaitUs += waitUs;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#ifndef INBOUNDQUEUE_H
+#define INBOUNDQUEUE_H
+
+#include "CommandDecoder.h"
+#include "CommandThrottle.h"
+#include <array>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 受信メッセージの優先度（値が小さいほど優先）
+enum class InboundPriority {
+    Critical = 0,      // CLOSE・MODIFY（ストップ変更）等のリスク削減系コマンド
+    Normal = 1,        // OPEN
+    Informational = 2  // コマンド以外
+};
+
+// EAの取り出し待ち受信メッセージ
+struct InboundMessage {
+    std::string payload;
+    bool isCommand = false;
+    DecodedCommand command;
+    InboundPriority priority = InboundPriority::Informational;
+    long long receivedAtUs = 0;
+    // コマンドの有効期限（サーバー送信時刻をローカル時刻に換算した値 + TTL）
+    bool hasDeadline = false;
+    std::chrono::system_clock::time_point issuedAt;
+    std::chrono::system_clock::time_point deadline;
+    // レート上限で取り出しを見送ったことがあるか
+    bool throttled = false;
+    // 実行予定時刻つきコマンド（executeAt をローカル時刻に換算した値。TTL はこの時刻から数える）
+    bool scheduled = false;
+    std::chrono::system_clock::time_point executeAt;
+};
+
+// 取り出したコマンドの待ち時間（受信から取り出しまで、マイクロ秒）
+struct CommandWaitStats {
+    long long commands = 0;
+    long long throttled = 0;           // レート上限で待たされたコマンド数
+    long long totalWaitUs = 0;
+    long long maxWaitUs = 0;
+    long long throttledWaitUs = 0;     // レート上限で待たされたコマンドの待ち時間の合計
+};
+
+// 受信時に優先度別のキューへ振り分け、取り出しは常に最優先の保留メッセージから行う
+// 同一優先度内は受信順（FIFO）
+// 同一ポジションへの MODIFY が未取り出しのまま残っている場合は、新しい MODIFY で上書きして1件にまとめる
+// コマンドはレート上限（口座・口座 × 通貨ペアのトークンバケット）を満たすまでキューに残す。
+// 上限で見送った口座・通貨ペアの後続コマンドも追い越さないため、同じバケット内の順序は保たれる
+class InboundQueue {
+public:
+    static InboundPriority Classify(const InboundMessage& message);
+
+    // 既存の MODIFY にまとめた場合は false
+    bool Push(InboundMessage message);
+
+    // 最優先のメッセージを取り出す。期限切れのコマンドは expired に移して読み飛ばす
+    bool PopNext(std::chrono::system_clock::time_point now, InboundMessage& message,
+                 std::vector<InboundMessage>& expired);
+
+    // 最優先のコマンドのみを取り出す（コマンド以外のメッセージはキューに残す）
+    bool PopNextCommand(std::chrono::system_clock::time_point now, InboundMessage& message,
+                        std::vector<InboundMessage>& expired);
+
+    size_t Size() const;
+
+    void SetThrottle(const ThrottleLimits& limits);
+
+    CommandWaitStats WaitStats() const;
+
+    // まとめて破棄した（後続の MODIFY に置き換えられた）MODIFY の件数
+    long long CoalescedModifyCount() const;
+
+private:
+    static const size_t kPriorityCount = 3;
+
+    static bool IsSameModifyTarget(const DecodedCommand& pending, const DecodedCommand& latest);
+    bool CoalesceModify(InboundMessage& message);
+
+    bool PopFrom(size_t first, size_t last, std::chrono::system_clock::time_point now,
+                 InboundMessage& message, std::vector<InboundMessage>& expired);
+
+    void RecordWait(const InboundMessage& message, long long nowUs);
+
+    std::array<std::deque<InboundMessage>, kPriorityCount> m_queues;
+    mutable std::mutex m_mutex;
+    long long m_coalescedModifyCount = 0;
+    CommandThrottle m_throttle;
+    CommandWaitStats m_waitStats;
+};
+
+#endif // INBOUNDQUEUE_H
@@ -0,0 +1,62 @@
+#include "LocalLegBus.h"
+
+std::string LocalLegBus::Key(const std::string& accountId, const std::string& positionId) {
+    std::string key;
+    key.reserve(accountId.size() + positionId.size() + 1);
+    key += accountId;
+    key += '\x1f';
+    key += positionId;
+    return key;
+}
+
+void LocalLegBus::AddLocalAccount(const std::string& accountId) {
+    if (accountId.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_localAccounts.insert(accountId);
+}
+
+LegRoute LocalLegBus::Route(const PairedLeg& leg) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_localAccounts.count(leg.accountId) > 0 ? LegRoute::Local : LegRoute::Upstream;
+}
+
+void LocalLegBus::Arm(ArmedLeg armed) {
+    std::string key = Key(armed.accountId, armed.positionId);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_armed[key] = std::move(armed);
+}
+
+bool LocalLegBus::Take(const std::string& accountId, const std::string& positionId, ArmedLeg& armed) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_armed.empty()) {
+        return false;
+    }
+
+    auto it = m_armed.find(Key(accountId, positionId));
+    if (it == m_armed.end()) {
+        return false;
+    }
+
+    armed = std::move(it->second);
+    m_armed.erase(it);
+    return true;
+}
+
+void LocalLegBus::DropStale(long long nowUs, std::vector<ArmedLeg>& expired) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_armed.begin(); it != m_armed.end();) {
+        if (nowUs - it->second.armedAtUs > kMaxArmedUs) {
+            expired.push_back(std::move(it->second));
+            it = m_armed.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t LocalLegBus::ArmedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_armed.size();
+}
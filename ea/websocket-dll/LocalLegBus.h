@@ -0,0 +1,57 @@
+#pragma once
+
+#ifndef LOCALLEGBUS_H
+#define LOCALLEGBUS_H
+
+#include "CommandDecoder.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 対のレッグの受け渡し先
+enum class LegRoute {
+    Local,     // この端末のEAへ直接渡す
+    Upstream   // Hedge System に任せる（対象口座がこの端末にない）
+};
+
+// 主レッグの約定待ちの対のレッグ
+struct ArmedLeg {
+    std::string accountId;     // 主レッグ
+    std::string positionId;
+    std::string actionId;
+    PairedLeg leg;
+    long long armedAtUs = 0;
+};
+
+// 同じ端末内のレッグ間のコマンド受け渡し
+// OPEN に添えられた対のレッグを主レッグの口座・ポジションIDで保持し、主レッグの約定時に取り出す。
+// 対のレッグの口座がこの端末で扱う口座なら Hedge System を経由せず直接EAへ渡せる（Route）
+class LocalLegBus {
+public:
+    // 主レッグが約定しないまま保持する最大時間
+    static const long long kMaxArmedUs = 60LL * 1000 * 1000;
+
+    void AddLocalAccount(const std::string& accountId);
+    LegRoute Route(const PairedLeg& leg) const;
+
+    void Arm(ArmedLeg armed);
+
+    // 主レッグの約定・失敗時に対のレッグを取り出す（保持していなければ false）
+    bool Take(const std::string& accountId, const std::string& positionId, ArmedLeg& armed);
+
+    // 保持期限を過ぎた対のレッグを取り出す
+    void DropStale(long long nowUs, std::vector<ArmedLeg>& expired);
+
+    size_t ArmedCount() const;
+
+private:
+    static std::string Key(const std::string& accountId, const std::string& positionId);
+
+    std::unordered_set<std::string> m_localAccounts;
+    std::unordered_map<std::string, ArmedLeg> m_armed;
+    mutable std::mutex m_mutex;
+};
+
+#endif // LOCALLEGBUS_H
@@ -0,0 +1,250 @@
+#include "MarginMonitor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double kVolumeEpsilon = 1e-9;
+
+} // namespace
+
+MarginMonitor::MarginMonitor(const SymbolSpecTable& specs) : m_specs(specs) {
+}
+
+void MarginMonitor::SetThresholds(double warningLevel, double criticalLevel) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_warningLevel = std::max(0.0, warningLevel);
+    m_criticalLevel = std::max(0.0, criticalLevel);
+}
+
+bool MarginMonitor::SetAccount(const MarginAccountState& account, double floatingPnl, MarginAlert& alert) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RefreshSpecsIfChanged();
+    m_account = account;
+    m_hasAccount = true;
+    m_floatingPnl = floatingPnl;
+    m_anchorPnl = floatingPnl;
+    m_anchorModelMargin = m_modelMargin;
+    m_realizedSinceAnchor = 0.0;
+    return EvaluateLocked(alert);
+}
+
+bool MarginMonitor::OnDeal(int64_t positionId, const std::string& symbol, bool isBuy, int entry,
+                           double volume, double profit, double floatingPnl, MarginAlert& alert) {
+    if (symbol.empty() || volume <= 0.0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RefreshSpecsIfChanged();
+    SymbolBook& book = BookFor(symbol);
+
+    switch (entry) {
+        case 0:     // IN
+            OpenLocked(positionId, book, isBuy, volume);
+            break;
+        case 1:     // OUT
+        case 3:     // OUT_BY
+            ReduceLocked(positionId, volume);
+            break;
+        case 2: {   // INOUT（ネッティング口座のドテン）
+            double remaining = ReduceLocked(positionId, volume);
+            if (remaining > kVolumeEpsilon) {
+                OpenLocked(positionId, book, isBuy, remaining);
+            }
+            break;
+        }
+        default:
+            return false;
+    }
+
+    m_realizedSinceAnchor += profit;
+    m_floatingPnl = floatingPnl;
+    Revalue(book);
+    return EvaluateLocked(alert);
+}
+
+void MarginMonitor::Seed(int64_t positionId, const std::string& symbol, bool isBuy, double volume) {
+    if (symbol.empty() || volume <= 0.0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RefreshSpecsIfChanged();
+    SymbolBook& book = BookFor(symbol);
+    OpenLocked(positionId, book, isBuy, volume);
+    Revalue(book);
+}
+
+void MarginMonitor::ResetPositions() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_positions.clear();
+    for (auto& entry : m_books) {
+        SymbolBook& book = entry.second;
+        book.longVolume = 0.0;
+        book.shortVolume = 0.0;
+        book.margin = 0.0;
+    }
+    m_modelMargin = 0.0;
+    m_floatingPnl = 0.0;
+    m_hasAccount = false;
+    m_severity = MarginSeverity::Normal;
+}
+
+bool MarginMonitor::OnPnL(double floatingPnl, MarginAlert& alert) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RefreshSpecsIfChanged();
+    m_floatingPnl = floatingPnl;
+    if (m_positions.empty()) {
+        return false;
+    }
+    return EvaluateLocked(alert);
+}
+
+MarginState MarginMonitor::GetState() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return StateLocked();
+}
+
+MarginMonitor::SymbolBook& MarginMonitor::BookFor(const std::string& symbol) {
+    SymbolBook& book = m_books[symbol];
+    if (book.symbol.empty()) {
+        book.symbol = symbol;
+    }
+    return book;
+}
+
+void MarginMonitor::OpenLocked(int64_t positionId, SymbolBook& book, bool isBuy, double volume) {
+    Position& position = m_positions[positionId];
+    if (position.book == nullptr || position.volume <= 0.0) {
+        position.book = &book;
+        position.isBuy = isBuy;
+        position.volume = 0.0;
+    }
+    position.volume += volume;
+
+    if (position.isBuy) {
+        book.longVolume += volume;
+    } else {
+        book.shortVolume += volume;
+    }
+}
+
+double MarginMonitor::ReduceLocked(int64_t positionId, double volume) {
+    auto it = m_positions.find(positionId);
+    if (it == m_positions.end()) {
+        return volume;
+    }
+
+    Position& position = it->second;
+    SymbolBook& book = *position.book;
+    double reduced = std::min(volume, position.volume);
+
+    double& held = position.isBuy ? book.longVolume : book.shortVolume;
+    held -= reduced;
+    if (held <= kVolumeEpsilon) {
+        held = 0.0;
+    }
+
+    position.volume -= reduced;
+    if (position.volume <= kVolumeEpsilon) {
+        m_positions.erase(it);
+    }
+    return volume - reduced;
+}
+
+void MarginMonitor::RefreshSpecsIfChanged() {
+    uint64_t version = m_specs.Version();
+    if (version == m_specVersion) {
+        return;
+    }
+    m_specVersion = version;
+    for (auto& entry : m_books) {
+        Revalue(entry.second);
+    }
+}
+
+void MarginMonitor::Revalue(SymbolBook& book) {
+    uint64_t version = m_specs.Version();
+    if (version != book.specVersion) {
+        book.hasSpec = m_specs.Find(book.symbol, book.spec);
+        book.specVersion = version;
+    }
+
+    double margin = 0.0;
+    if (book.hasSpec) {
+        double covered = std::min(book.longVolume, book.shortVolume);
+        double uncovered = std::fabs(book.longVolume - book.shortVolume);
+        double hedgedRatio = book.spec.contractSize > 0.0 ? book.spec.marginHedged / book.spec.contractSize : 1.0;
+        margin = book.spec.marginPerLot * (uncovered + covered * hedgedRatio);
+    }
+
+    m_modelMargin += margin - book.margin;
+    book.margin = margin;
+}
+
+MarginState MarginMonitor::StateLocked() const {
+    MarginState state;
+    if (!m_hasAccount) {
+        return state;
+    }
+
+    state.equity = m_account.equity + (m_floatingPnl - m_anchorPnl) + m_realizedSinceAnchor;
+    state.margin = m_positions.empty() ? 0.0 : std::max(0.0, m_account.margin + (m_modelMargin - m_anchorModelMargin));
+    state.freeMargin = state.equity - state.margin;
+    state.marginLevel = state.margin > 0.0 ? state.equity / state.margin * 100.0 : 0.0;
+    state.stopOutLevel = m_account.stopOutLevel;
+    state.equityToStopOut = state.equity - state.margin * m_account.stopOutLevel / 100.0;
+    state.severity = m_severity;
+    state.hasAccount = true;
+    return state;
+}
+
+double MarginMonitor::ThresholdFor(MarginSeverity severity) const {
+    switch (severity) {
+        case MarginSeverity::Warning:    return m_warningLevel;
+        case MarginSeverity::Critical:   return m_criticalLevel;
+        case MarginSeverity::MarginCall: return m_account.marginCallLevel;
+        case MarginSeverity::StopOut:    return m_account.stopOutLevel * kStopOutProximity;
+        default:                         return 0.0;
+    }
+}
+
+MarginSeverity MarginMonitor::Classify(const MarginState& state, double scale) const {
+    // 証拠金を使っていない場合は常に Normal（有効証拠金がマイナスの維持率は最も深刻な段階に入る）
+    if (state.margin <= 0.0) {
+        return MarginSeverity::Normal;
+    }
+    double marginLevel = state.marginLevel;
+
+    for (int s = static_cast<int>(MarginSeverity::StopOut); s > static_cast<int>(MarginSeverity::Normal); s--) {
+        double threshold = ThresholdFor(static_cast<MarginSeverity>(s));
+        if (threshold > 0.0 && marginLevel <= threshold * scale) {
+            return static_cast<MarginSeverity>(s);
+        }
+    }
+    return MarginSeverity::Normal;
+}
+
+bool MarginMonitor::EvaluateLocked(MarginAlert& alert) {
+    if (!m_hasAccount) {
+        return false;
+    }
+
+    MarginState state = StateLocked();
+    MarginSeverity next = Classify(state, 1.0);
+    if (next <= m_severity) {
+        // 回復はヒステリシス分の余裕を超えたときだけ（水準付近での通知の連発を防ぐ）
+        next = std::min(m_severity, Classify(state, 1.0 + kRecoveryHysteresis));
+        if (next == m_severity) {
+            return false;
+        }
+    }
+
+    alert.accountId = m_account.accountId;
+    alert.previousSeverity = m_severity;
+    alert.threshold = ThresholdFor(next > m_severity ? next : m_severity);
+    m_severity = next;
+    state.severity = next;
+    alert.state = state;
+    return true;
+}
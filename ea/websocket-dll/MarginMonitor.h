@@ -0,0 +1,139 @@
+#pragma once
+
+#ifndef MARGINMONITOR_H
+#define MARGINMONITOR_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "SymbolSpecTable.h"
+
+// 証拠金維持率の段階（値が大きいほど深刻）
+enum class MarginSeverity {
+    Normal = 0,
+    Warning = 1,       // 設定した警告水準以下
+    Critical = 2,      // 設定した危険水準以下
+    MarginCall = 3,    // ブローカーのマージンコール水準以下
+    StopOut = 4        // ブローカーのストップアウト水準の kStopOutProximity 倍以下
+};
+
+// ブローカーの口座情報（推定値の基準点）
+struct MarginAccountState {
+    std::string accountId;
+    double equity = 0.0;
+    double margin = 0.0;
+    double marginCallLevel = 0.0;   // %（0 は未使用）
+    double stopOutLevel = 0.0;      // %（0 は未使用）
+};
+
+// 現在の推定値
+struct MarginState {
+    double equity = 0.0;
+    double margin = 0.0;
+    double freeMargin = 0.0;
+    double marginLevel = 0.0;       // %（証拠金 0 の場合は 0）
+    double stopOutLevel = 0.0;
+    double equityToStopOut = 0.0;   // ストップアウトまでの有効証拠金の余裕（口座通貨）
+    MarginSeverity severity = MarginSeverity::Normal;
+    bool hasAccount = false;        // 口座情報の通知前は false（他の値は 0）
+};
+
+// 段階が変化したときの通知内容
+struct MarginAlert {
+    std::string accountId;
+    MarginState state;
+    MarginSeverity previousSeverity = MarginSeverity::Normal;
+    double threshold = 0.0;         // 新しい段階の水準（%、Normal への回復時は直前の段階の水準）
+};
+
+// 証拠金維持率モニター
+// 通貨ペアごとに買い・売りの保有量を約定ごとに差分更新して必要証拠金を求める。
+// 評価損益は PnLEngine が口座通貨建てで求めた合計を受け取る（OnPnL）。
+// 有効証拠金・必要証拠金はブローカーの口座情報（SetAccount）を基準点とし、
+// 基準点以降の評価損益・必要証拠金の変化と確定損益を加えて推定する（モデルの誤差は次の基準点で解消）。
+// 通貨ペアの仕様（1ロットの必要証拠金・両建て証拠金）は SymbolSpecTable からロックなしで読み、
+// テーブルの版が変わったときだけ取り直す。
+// 維持率が段階の水準を下回った時点で MarginAlert を返す。回復方向は水準の
+// (1 + kRecoveryHysteresis) 倍を上回るまで段階を戻さない
+class MarginMonitor {
+public:
+    static constexpr double kDefaultWarningLevel = 300.0;
+    static constexpr double kDefaultCriticalLevel = 150.0;
+    static constexpr double kStopOutProximity = 1.2;
+    static constexpr double kRecoveryHysteresis = 0.02;
+
+    explicit MarginMonitor(const SymbolSpecTable& specs);
+
+    // 設定した警告・危険水準（%、0 で無効）
+    void SetThresholds(double warningLevel, double criticalLevel);
+
+    // floatingPnl は同時点の PnLEngine の評価損益（口座通貨）
+    bool SetAccount(const MarginAccountState& account, double floatingPnl, MarginAlert& alert);
+
+    // 約定（DEAL_ENTRY: 0 IN, 1 OUT, 2 INOUT, 3 OUT_BY）。profit は決済約定の確定損益
+    bool OnDeal(int64_t positionId, const std::string& symbol, bool isBuy, int entry,
+                double volume, double profit, double floatingPnl, MarginAlert& alert);
+
+    // 既存ポジションの登録（基準点には含めず、次の SetAccount までに呼び出す）
+    void Seed(int64_t positionId, const std::string& symbol, bool isBuy, double volume);
+
+    void ResetPositions();
+
+    // 評価損益の更新（ティックごと）
+    bool OnPnL(double floatingPnl, MarginAlert& alert);
+
+    MarginState GetState() const;
+
+private:
+    struct SymbolBook {
+        std::string symbol;
+        SymbolSpec spec;
+        uint64_t specVersion = 0;
+        bool hasSpec = false;
+        double longVolume = 0.0;
+        double shortVolume = 0.0;
+        double margin = 0.0;        // 必要証拠金（口座通貨）
+    };
+
+    struct Position {
+        SymbolBook* book = nullptr;
+        bool isBuy = true;
+        double volume = 0.0;
+    };
+
+    SymbolBook& BookFor(const std::string& symbol);
+    void OpenLocked(int64_t positionId, SymbolBook& book, bool isBuy, double volume);
+    // ポジションを減らし、減らしきれなかった量を返す
+    double ReduceLocked(int64_t positionId, double volume);
+    // テーブルの版が変わっていれば仕様を取り直して必要証拠金を再計算
+    void Revalue(SymbolBook& book);
+    void RefreshSpecsIfChanged();
+    MarginState StateLocked() const;
+    double ThresholdFor(MarginSeverity severity) const;
+    MarginSeverity Classify(const MarginState& state, double scale) const;
+    bool EvaluateLocked(MarginAlert& alert);
+
+    const SymbolSpecTable& m_specs;
+    std::unordered_map<std::string, SymbolBook> m_books;
+    std::unordered_map<int64_t, Position> m_positions;
+
+    // 全通貨ペアの合計（差分更新）と直近の評価損益
+    double m_modelMargin = 0.0;
+    double m_floatingPnl = 0.0;
+    uint64_t m_specVersion = 0;
+
+    // 基準点（SetAccount 時点のブローカー値とモデル値）と基準点以降の確定損益
+    MarginAccountState m_account;
+    bool m_hasAccount = false;
+    double m_anchorPnl = 0.0;
+    double m_anchorModelMargin = 0.0;
+    double m_realizedSinceAnchor = 0.0;
+
+    double m_warningLevel = kDefaultWarningLevel;
+    double m_criticalLevel = kDefaultCriticalLevel;
+    MarginSeverity m_severity = MarginSeverity::Normal;
+    mutable std::mutex m_mutex;
+};
+
+#endif // MARGINMONITOR_H
@@ -0,0 +1,62 @@
+#include "MessageDispatch.h"
+
+namespace {
+
+constexpr schema::KeyEntry Entry(const char* type, InboundKind kind) {
+    return schema::KeyEntry{type, schema::ConstLength(type), static_cast<int>(kind)};
+}
+
+// 受信種別名 → InboundKind（小文字はレガシー形式の command / action の値）
+constexpr std::array<schema::KeyEntry, 18> kInboundTypes = {{
+    Entry("OPEN", InboundKind::Open),
+    Entry("CLOSE", InboundKind::Close),
+    Entry("MODIFY", InboundKind::Modify),
+    Entry("command", InboundKind::LegacyCommand),
+    Entry("RESEND_FROM", InboundKind::ResendFrom),
+    Entry("PING", InboundKind::Ping),
+    Entry("PONG", InboundKind::Pong),
+    Entry("INFO", InboundKind::Info),
+    Entry("ERROR", InboundKind::Error),
+    Entry("PRICE_ALERT_SET", InboundKind::PriceAlertSet),
+    Entry("PRICE_ALERT_CANCEL", InboundKind::PriceAlertCancel),
+    Entry("PRICE_UPDATE", InboundKind::PriceUpdate),
+    Entry("HEARTBEAT_ACK", InboundKind::HeartbeatAck),
+    Entry("AUTH_SUCCESS", InboundKind::AuthSuccess),
+    Entry("open", InboundKind::Open),
+    Entry("close", InboundKind::Close),
+    Entry("modify", InboundKind::Modify),
+    Entry("modify_position", InboundKind::Modify),
+}};
+
+constexpr auto kInboundTypeTable = schema::BuildPerfectHash(kInboundTypes);
+static_assert(kInboundTypeTable.valid, "No collision-free seed found for inbound message types");
+
+} // namespace
+
+InboundKind LookupInboundKind(std::string_view type) {
+    int kind = kInboundTypeTable.Find(type.data(), type.size());
+    return kind >= 0 ? static_cast<InboundKind>(kind) : InboundKind::Unknown;
+}
+
+bool IsHeartbeatKind(InboundKind kind) {
+    return kind == InboundKind::Ping || kind == InboundKind::Pong || kind == InboundKind::HeartbeatAck;
+}
+
+InboundKind ClassifyInbound(const std::string& message, MessageEnvelope& envelope) {
+    if (!schema::DecodeJsonPrefix(message, envelope, std::tuple_size<decltype(MessageEnvelope::kFields)>::value)) {
+        return InboundKind::Unknown;
+    }
+
+    InboundKind kind = LookupInboundKind(envelope.type);
+    if (kind == InboundKind::LegacyCommand) {
+        LegacyCommandEnvelope legacy;
+        if (!schema::DecodeJsonPrefix(message, legacy, 1)) {
+            return InboundKind::Unknown;
+        }
+        kind = LookupInboundKind(legacy.command);
+        if (kind != InboundKind::Open && kind != InboundKind::Close && kind != InboundKind::Modify) {
+            return InboundKind::Unknown;
+        }
+    }
+    return kind;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#ifndef MESSAGEDISPATCH_H
+#define MESSAGEDISPATCH_H
+
+#include "MessageSchema.h"
+#include <string>
+#include <string_view>
+
+// 受信フレームの種別（ハンドラー表のインデックス）
+enum class InboundKind {
+    Unknown = 0,
+    Open,
+    Close,
+    Modify,
+    LegacyCommand,   // {"type":"command","command"|"action":"open"...}
+    ResendFrom,
+    Ping,
+    Pong,
+    Info,
+    Error,
+    PriceAlertSet,
+    PriceAlertCancel,
+    PriceUpdate,     // 他の口座の気配（サーバーが中継）
+    HeartbeatAck,    // HEARTBEAT への応答（Hedge System の Rust サーバー）
+    AuthSuccess,
+    Count
+};
+
+constexpr size_t kInboundKindCount = static_cast<size_t>(InboundKind::Count);
+
+// ディスパッチに必要なトップレベルフィールドのみを1パスで取り出すためのスキーマ
+// （その他のフィールドは値を読み飛ばすだけで、文字列の切り出しも行わない）
+// type と timestamp が揃った時点で走査を打ち切る
+struct MessageEnvelope {
+    static constexpr const char* kTsName = "MessageEnvelope";
+
+    std::string type;
+    std::string timestamp;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &MessageEnvelope::type, "event"),
+        schema::MakeOptionalField("timestamp", &MessageEnvelope::timestamp));
+};
+
+// レガシー形式（{"type":"command",...}）のコマンド種別
+struct LegacyCommandEnvelope {
+    static constexpr const char* kTsName = "LegacyCommandEnvelope";
+
+    std::string command;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("command", &LegacyCommandEnvelope::command, "action"));
+};
+
+// 受信フレームの種別を判定（JSONとして不正・未知の種別は Unknown）
+// レガシー形式は command / action フィールドからコマンド種別を解決する
+InboundKind ClassifyInbound(const std::string& message, MessageEnvelope& envelope);
+
+// 種別名から InboundKind を引く（コンパイル時完全ハッシュ表）
+InboundKind LookupInboundKind(std::string_view type);
+
+// クロックスキュー推定の起点にするハートビートの種別（PING / PONG / HEARTBEAT_ACK）
+bool IsHeartbeatKind(InboundKind kind);
+
+#endif // MESSAGEDISPATCH_H
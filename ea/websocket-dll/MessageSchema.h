@@ -0,0 +1,916 @@
+#pragma once
+
+#ifndef MESSAGESCHEMA_H
+#define MESSAGESCHEMA_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// コンパイル時メッセージスキーマ
+//
+// メッセージ構造体ごとに constexpr のフィールド表（kFields）を定義すると、そこから
+//   - JSON エンコーダー / デコーダー
+//   - バイナリエンコーダー / デコーダー
+//   - TypeScript 型定義
+// を生成する。デコード時のキー照合はコンパイル時に求めた完全ハッシュ表で行うため、
+// フィールドを追加しても実行時の線形探索は発生しない。
+//
+// 定義例:
+//   struct Foo {
+//       static constexpr const char* kTsName = "Foo";
+//       std::string id;
+//       double price = 0.0;
+//       static constexpr auto kFields = std::make_tuple(
+//           schema::MakeField("id", &Foo::id),
+//           schema::MakeField("price", &Foo::price));
+//   };
+
+namespace schema {
+
+// ---------------------------------------------------------------------------
+// フィールド定義
+// ---------------------------------------------------------------------------
+
+enum class FieldKind {
+    String,
+    Number,
+    Integer,
+    Boolean,
+    FixedPoint,
+    Object
+};
+
+// 固定小数点の価格（kScale 倍した整数で保持）
+// JSON の10進表記から double を経由せずに変換するため、SL/TP 等の価格に丸め誤差が入らない
+struct FixedPrice {
+    static constexpr long long kScale = 100000000;   // 小数点以下8桁
+    static constexpr int kDecimals = 8;
+
+    long long raw = 0;
+    bool present = false;   // 受信フレームに含まれていたか
+
+    double ToDouble() const {
+        return static_cast<double>(raw) / static_cast<double>(kScale);
+    }
+};
+
+// 10進表記（"149.125"、"-0.5"、"1e-3" 等）を FixedPrice::kScale 倍の整数に変換
+// 9桁目以降は四捨五入。指数表記のみ double 経由で変換する
+inline bool ParseFixedPrice(std::string_view text, long long& raw) {
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+        negative = text[pos] == '-';
+        pos++;
+    }
+
+    long long integerPart = 0;
+    long long fraction = 0;
+    int fractionDigits = 0;
+    bool roundUp = false;
+    bool anyDigit = false;
+
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+        integerPart = integerPart * 10 + (text[pos] - '0');
+        anyDigit = true;
+        pos++;
+    }
+    if (pos < text.size() && text[pos] == '.') {
+        pos++;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            if (fractionDigits < FixedPrice::kDecimals) {
+                fraction = fraction * 10 + (text[pos] - '0');
+                fractionDigits++;
+            } else if (fractionDigits == FixedPrice::kDecimals) {
+                roundUp = text[pos] >= '5';
+                fractionDigits++;
+            }
+            anyDigit = true;
+            pos++;
+        }
+    }
+    if (!anyDigit) {
+        return false;
+    }
+
+    if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+        double value = std::strtod(std::string(text).c_str(), nullptr);
+        double scaled = value * static_cast<double>(FixedPrice::kScale);
+        raw = static_cast<long long>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+        return true;
+    }
+
+    for (int i = fractionDigits; i < FixedPrice::kDecimals; i++) {
+        fraction *= 10;
+    }
+    long long value = integerPart * FixedPrice::kScale + fraction + (roundUp ? 1 : 0);
+    raw = negative ? -value : value;
+    return true;
+}
+
+inline void AppendFixedPrice(std::string& out, long long raw) {
+    if (raw < 0) {
+        out += '-';
+        raw = -raw;
+    }
+    out += std::to_string(raw / FixedPrice::kScale);
+
+    long long fraction = raw % FixedPrice::kScale;
+    if (fraction == 0) {
+        return;
+    }
+    char digits[FixedPrice::kDecimals + 1];
+    for (int i = FixedPrice::kDecimals - 1; i >= 0; i--) {
+        digits[i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    int length = FixedPrice::kDecimals;
+    while (length > 0 && digits[length - 1] == '0') {
+        length--;
+    }
+    out += '.';
+    out.append(digits, static_cast<size_t>(length));
+}
+
+template <typename T, typename = void>
+struct HasFields : std::false_type {};
+
+template <typename T>
+struct HasFields<T, std::void_t<decltype(T::kFields)>> : std::true_type {};
+
+template <typename T, typename = void>
+struct FieldKindOf;
+
+template <>
+struct FieldKindOf<std::string> { static constexpr FieldKind value = FieldKind::String; };
+
+template <>
+struct FieldKindOf<double> { static constexpr FieldKind value = FieldKind::Number; };
+
+template <>
+struct FieldKindOf<long long> { static constexpr FieldKind value = FieldKind::Integer; };
+
+template <>
+struct FieldKindOf<bool> { static constexpr FieldKind value = FieldKind::Boolean; };
+
+template <>
+struct FieldKindOf<FixedPrice> { static constexpr FieldKind value = FieldKind::FixedPoint; };
+
+template <typename T>
+struct FieldKindOf<T, std::enable_if_t<HasFields<T>::value>> { static constexpr FieldKind value = FieldKind::Object; };
+
+template <typename Owner, typename T>
+struct Field {
+    using OwnerType = Owner;
+    using ValueType = T;
+    static constexpr FieldKind kKind = FieldKindOf<T>::value;
+
+    const char* name;
+    T Owner::*member;
+    const char* alias;   // 受信時のみ受け付ける別名（"account_id" 等）
+    bool optional;       // 既定値のままならエンコード時に省略
+};
+
+template <typename Owner, typename T>
+constexpr Field<Owner, T> MakeField(const char* name, T Owner::*member, const char* alias = nullptr) {
+    return Field<Owner, T>{name, member, alias, false};
+}
+
+template <typename Owner, typename T>
+constexpr Field<Owner, T> MakeOptionalField(const char* name, T Owner::*member, const char* alias = nullptr) {
+    return Field<Owner, T>{name, member, alias, true};
+}
+
+// ---------------------------------------------------------------------------
+// コンパイル時完全ハッシュ
+// ---------------------------------------------------------------------------
+
+constexpr size_t ConstLength(const char* text) {
+    size_t length = 0;
+    while (text[length] != '\0') {
+        length++;
+    }
+    return length;
+}
+
+constexpr uint32_t Fnv1a(const char* data, size_t length, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    // 下位ビットをテーブルサイズでマスクするため、最後に全ビットを攪拌する
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+constexpr size_t NextPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+struct KeyEntry {
+    const char* key;
+    size_t length;
+    int fieldIndex;
+};
+
+// キー集合に対し、衝突のないシードを探索した完全ハッシュ表
+template <size_t KeyCount>
+struct PerfectHashTable {
+    static constexpr size_t kSize = NextPowerOfTwo(KeyCount * 2 > 4 ? KeyCount * 2 : 4);
+
+    std::array<KeyEntry, KeyCount> keys{};
+    std::array<int, kSize> slots{};   // スロット → keys のインデックス（-1 は空き）
+    uint32_t seed = 0;
+    bool valid = false;
+
+    constexpr int Find(const char* data, size_t length) const {
+        int entry = slots[Fnv1a(data, length, seed) & (kSize - 1)];
+        if (entry < 0 || keys[entry].length != length) {
+            return -1;
+        }
+        for (size_t i = 0; i < length; i++) {
+            if (keys[entry].key[i] != data[i]) {
+                return -1;
+            }
+        }
+        return keys[entry].fieldIndex;
+    }
+};
+
+template <size_t KeyCount>
+constexpr PerfectHashTable<KeyCount> BuildPerfectHash(const std::array<KeyEntry, KeyCount>& keys) {
+    PerfectHashTable<KeyCount> table{};
+    table.keys = keys;
+
+    for (uint32_t seed = 0; seed < 10000; seed++) {
+        for (auto& slot : table.slots) {
+            slot = -1;
+        }
+
+        bool collision = false;
+        for (size_t i = 0; i < KeyCount && !collision; i++) {
+            size_t slot = Fnv1a(keys[i].key, keys[i].length, seed) & (PerfectHashTable<KeyCount>::kSize - 1);
+            if (table.slots[slot] >= 0) {
+                collision = true;
+            } else {
+                table.slots[slot] = static_cast<int>(i);
+            }
+        }
+
+        if (!collision) {
+            table.seed = seed;
+            table.valid = true;
+            return table;
+        }
+    }
+    return table;
+}
+
+// メッセージのフィールド表（名前 + 別名）からキー表を構築
+template <typename Message>
+constexpr size_t CountSchemaKeys() {
+    return std::apply([](const auto&... fields) {
+        return ((fields.alias != nullptr ? size_t(2) : size_t(1)) + ... + size_t(0));
+    }, Message::kFields);
+}
+
+template <typename Message, size_t KeyCount, size_t... Is>
+constexpr std::array<KeyEntry, KeyCount> BuildSchemaKeys(std::index_sequence<Is...>) {
+    std::array<KeyEntry, KeyCount> keys{};
+    size_t next = 0;
+    auto add = [&](const auto& field, int index) {
+        keys[next++] = KeyEntry{field.name, ConstLength(field.name), index};
+        if (field.alias != nullptr) {
+            keys[next++] = KeyEntry{field.alias, ConstLength(field.alias), index};
+        }
+    };
+    (add(std::get<Is>(Message::kFields), static_cast<int>(Is)), ...);
+    return keys;
+}
+
+template <typename Message>
+struct SchemaIndex {
+    static constexpr size_t kFieldCount = std::tuple_size<decltype(Message::kFields)>::value;
+    static constexpr size_t kKeyCount = CountSchemaKeys<Message>();
+
+    static constexpr PerfectHashTable<kKeyCount> kTable =
+        BuildPerfectHash(BuildSchemaKeys<Message, kKeyCount>(std::make_index_sequence<kFieldCount>{}));
+
+    static_assert(kTable.valid, "No collision-free seed found for message schema keys");
+};
+
+// ---------------------------------------------------------------------------
+// JSON 読み取り
+// ---------------------------------------------------------------------------
+
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view json) : m_json(json), m_pos(0) {}
+
+    void SkipWhitespace() {
+        while (m_pos < m_json.size() &&
+               (m_json[m_pos] == ' ' || m_json[m_pos] == '\t' || m_json[m_pos] == '\r' || m_json[m_pos] == '\n')) {
+            m_pos++;
+        }
+    }
+
+    bool Consume(char expected) {
+        SkipWhitespace();
+        if (m_pos < m_json.size() && m_json[m_pos] == expected) {
+            m_pos++;
+            return true;
+        }
+        return false;
+    }
+
+    char Peek() {
+        SkipWhitespace();
+        return m_pos < m_json.size() ? m_json[m_pos] : '\0';
+    }
+
+    // キーをエスケープ解除せずに読む（スキーマのキーはASCII識別子のみ）
+    bool ReadRawString(std::string_view& value) {
+        if (!Consume('"')) {
+            return false;
+        }
+        size_t begin = m_pos;
+        size_t end = FindClosingQuote(begin);
+        if (end == std::string_view::npos) {
+            return false;
+        }
+        value = m_json.substr(begin, end - begin);
+        m_pos = end + 1;
+        return true;
+    }
+
+    bool ReadString(std::string& value) {
+        if (!Consume('"')) {
+            return false;
+        }
+
+        // エスケープを含まない文字列（大半のケース）は一括でコピー
+        size_t end = FindClosingQuote(m_pos);
+        if (end == std::string_view::npos) {
+            return false;
+        }
+        if (std::memchr(m_json.data() + m_pos, '\\', end - m_pos) == nullptr) {
+            value.assign(m_json.data() + m_pos, end - m_pos);
+            m_pos = end + 1;
+            return true;
+        }
+
+        value.clear();
+        while (m_pos < m_json.size() && m_json[m_pos] != '"') {
+            char c = m_json[m_pos++];
+            if (c != '\\') {
+                value += c;
+                continue;
+            }
+            if (m_pos >= m_json.size()) {
+                return false;
+            }
+            char escaped = m_json[m_pos++];
+            switch (escaped) {
+                case 'b': value += '\b'; break;
+                case 'f': value += '\f'; break;
+                case 'n': value += '\n'; break;
+                case 'r': value += '\r'; break;
+                case 't': value += '\t'; break;
+                case 'u': {
+                    if (m_pos + 4 > m_json.size()) {
+                        return false;
+                    }
+                    unsigned codePoint = static_cast<unsigned>(std::strtoul(std::string(m_json.substr(m_pos, 4)).c_str(), nullptr, 16));
+                    m_pos += 4;
+                    AppendUtf8(value, codePoint);
+                    break;
+                }
+                default: value += escaped; break;
+            }
+        }
+        if (m_pos >= m_json.size()) {
+            return false;
+        }
+        m_pos++;
+        return true;
+    }
+
+    // 数値（文字列で送られてくる数値 "123" も許容）
+    bool ReadNumberText(std::string_view& text) {
+        if (Peek() == '"') {
+            return ReadRawString(text);
+        }
+        size_t begin = m_pos;
+        while (m_pos < m_json.size() &&
+               (m_json[m_pos] == '-' || m_json[m_pos] == '+' || m_json[m_pos] == '.' ||
+                m_json[m_pos] == 'e' || m_json[m_pos] == 'E' || (m_json[m_pos] >= '0' && m_json[m_pos] <= '9'))) {
+            m_pos++;
+        }
+        text = m_json.substr(begin, m_pos - begin);
+        return !text.empty();
+    }
+
+    bool ReadBoolean(bool& value) {
+        SkipWhitespace();
+        if (m_json.compare(m_pos, 4, "true") == 0) {
+            value = true;
+            m_pos += 4;
+            return true;
+        }
+        if (m_json.compare(m_pos, 5, "false") == 0) {
+            value = false;
+            m_pos += 5;
+            return true;
+        }
+        return false;
+    }
+
+    bool SkipValue() {
+        char c = Peek();
+        if (c == '"') {
+            std::string_view ignored;
+            return ReadRawString(ignored);
+        }
+        if (c == '{' || c == '[') {
+            int depth = 0;
+            while (m_pos < m_json.size()) {
+                char current = m_json[m_pos];
+                if (current == '"') {
+                    std::string_view ignored;
+                    if (!ReadRawString(ignored)) {
+                        return false;
+                    }
+                    continue;
+                }
+                m_pos++;
+                if (current == '{' || current == '[') {
+                    depth++;
+                } else if (current == '}' || current == ']') {
+                    if (--depth == 0) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+        while (m_pos < m_json.size() && m_json[m_pos] != ',' && m_json[m_pos] != '}' && m_json[m_pos] != ']') {
+            m_pos++;
+        }
+        return true;
+    }
+
+    // 生の値の範囲を取得（ネストしたオブジェクト等をそのまま保持する用途）
+    bool ReadRawValue(std::string_view& value) {
+        SkipWhitespace();
+        size_t begin = m_pos;
+        if (!SkipValue()) {
+            return false;
+        }
+        value = m_json.substr(begin, m_pos - begin);
+        return true;
+    }
+
+private:
+    // 開き引用符の次の位置から、エスケープされていない閉じ引用符の位置を探す
+    size_t FindClosingQuote(size_t pos) const {
+        while (pos < m_json.size()) {
+            const void* found = std::memchr(m_json.data() + pos, '"', m_json.size() - pos);
+            if (found == nullptr) {
+                return std::string_view::npos;
+            }
+            size_t quote = static_cast<size_t>(static_cast<const char*>(found) - m_json.data());
+
+            // 直前の連続したバックスラッシュが偶数個なら終端
+            size_t backslashes = 0;
+            while (quote - backslashes > pos && m_json[quote - backslashes - 1] == '\\') {
+                backslashes++;
+            }
+            if (backslashes % 2 == 0) {
+                return quote;
+            }
+            pos = quote + 1;
+        }
+        return std::string_view::npos;
+    }
+
+    static void AppendUtf8(std::string& out, unsigned codePoint) {
+        if (codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    std::string_view m_json;
+    size_t m_pos;
+};
+
+// ---------------------------------------------------------------------------
+// JSON デコード
+// ---------------------------------------------------------------------------
+
+template <typename Message>
+bool DecodeJsonObject(JsonReader& reader, Message& message, size_t stopAfter = 0);
+
+template <typename T>
+bool DecodeJsonValue(JsonReader& reader, T& value) {
+    if constexpr (std::is_same<T, std::string>::value) {
+        return reader.ReadString(value);
+    } else if constexpr (std::is_same<T, double>::value) {
+        std::string_view text;
+        if (!reader.ReadNumberText(text)) {
+            return false;
+        }
+        value = std::strtod(std::string(text).c_str(), nullptr);
+        return true;
+    } else if constexpr (std::is_same<T, long long>::value) {
+        std::string_view text;
+        if (!reader.ReadNumberText(text)) {
+            return false;
+        }
+        value = std::strtoll(std::string(text).c_str(), nullptr, 10);
+        return true;
+    } else if constexpr (std::is_same<T, bool>::value) {
+        return reader.ReadBoolean(value);
+    } else if constexpr (std::is_same<T, FixedPrice>::value) {
+        std::string_view text;
+        if (!reader.ReadNumberText(text) || !ParseFixedPrice(text, value.raw)) {
+            return false;
+        }
+        value.present = true;
+        return true;
+    } else {
+        return DecodeJsonObject(reader, value);
+    }
+}
+
+template <typename Message, size_t Index>
+bool DecodeFieldAt(JsonReader& reader, Message& message) {
+    const auto& field = std::get<Index>(Message::kFields);
+    return DecodeJsonValue(reader, message.*(field.member));
+}
+
+template <typename Message, size_t... Is>
+constexpr auto MakeFieldDecoders(std::index_sequence<Is...>) {
+    using Decoder = bool (*)(JsonReader&, Message&);
+    return std::array<Decoder, sizeof...(Is)>{&DecodeFieldAt<Message, Is>...};
+}
+
+// stopAfter > 0 の場合、その数の異なるフィールドを読んだ時点で残りを走査せずに終了する
+// （この場合 reader はオブジェクトの途中を指したままになる）
+template <typename Message>
+bool DecodeJsonObject(JsonReader& reader, Message& message, size_t stopAfter) {
+    using Index = SchemaIndex<Message>;
+    static_assert(Index::kFieldCount <= 64, "Message schema supports at most 64 fields");
+    static constexpr auto kDecoders = MakeFieldDecoders<Message>(std::make_index_sequence<Index::kFieldCount>{});
+    uint64_t seen = 0;
+    size_t seenCount = 0;
+
+    if (!reader.Consume('{')) {
+        return false;
+    }
+    if (reader.Consume('}')) {
+        return true;
+    }
+
+    do {
+        std::string_view key;
+        if (!reader.ReadRawString(key) || !reader.Consume(':')) {
+            return false;
+        }
+
+        int fieldIndex = Index::kTable.Find(key.data(), key.size());
+        if (fieldIndex < 0) {
+            if (!reader.SkipValue()) {
+                return false;
+            }
+            continue;
+        }
+
+        if (!kDecoders[fieldIndex](reader, message)) {
+            return false;
+        }
+        if (stopAfter > 0 && (seen & (uint64_t(1) << fieldIndex)) == 0) {
+            seen |= uint64_t(1) << fieldIndex;
+            if (++seenCount >= stopAfter) {
+                return true;
+            }
+        }
+    } while (reader.Consume(','));
+
+    return reader.Consume('}');
+}
+
+template <typename Message>
+bool DecodeJson(std::string_view json, Message& message) {
+    JsonReader reader(json);
+    return DecodeJsonObject(reader, message);
+}
+
+// 先頭から走査し、stopAfter 個の異なるフィールドが揃った時点で打ち切るデコード
+// （種別判定など、フレームの一部のフィールドだけが必要な場合に使う）
+template <typename Message>
+bool DecodeJsonPrefix(std::string_view json, Message& message, size_t stopAfter) {
+    JsonReader reader(json);
+    return DecodeJsonObject(reader, message, stopAfter);
+}
+
+// ---------------------------------------------------------------------------
+// JSON エンコード
+// ---------------------------------------------------------------------------
+
+inline void AppendJsonString(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char kHex[] = "0123456789abcdef";
+                    out += "\\u00";
+                    out += kHex[(c >> 4) & 0x0F];
+                    out += kHex[c & 0x0F];
+                } else {
+                    out += c;
+                }
+                break;
+        }
+    }
+    out += '"';
+}
+
+template <typename Message>
+void EncodeJson(const Message& message, std::string& out);
+
+template <typename T>
+void EncodeJsonValue(const T& value, std::string& out) {
+    if constexpr (std::is_same<T, std::string>::value) {
+        AppendJsonString(out, value);
+    } else if constexpr (std::is_same<T, double>::value) {
+        char buffer[32];
+        int length = std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+        out.append(buffer, static_cast<size_t>(length));
+    } else if constexpr (std::is_same<T, long long>::value) {
+        out += std::to_string(value);
+    } else if constexpr (std::is_same<T, bool>::value) {
+        out += value ? "true" : "false";
+    } else if constexpr (std::is_same<T, FixedPrice>::value) {
+        AppendFixedPrice(out, value.raw);
+    } else {
+        EncodeJson(value, out);
+    }
+}
+
+template <typename T>
+bool IsDefaultValue(const T& value) {
+    if constexpr (std::is_same<T, std::string>::value) {
+        return value.empty();
+    } else if constexpr (std::is_same<T, FixedPrice>::value) {
+        return !value.present;
+    } else if constexpr (HasFields<T>::value) {
+        // 入れ子のオブジェクトは全フィールドが既定値の場合に省略する
+        return std::apply([&](const auto&... fields) {
+            return (IsDefaultValue(value.*(fields.member)) && ...);
+        }, T::kFields);
+    } else {
+        return value == T();
+    }
+}
+
+template <typename Message>
+void EncodeJson(const Message& message, std::string& out) {
+    out += '{';
+    bool first = true;
+    std::apply([&](const auto&... fields) {
+        auto encode = [&](const auto& field) {
+            const auto& value = message.*(field.member);
+            if (field.optional && IsDefaultValue(value)) {
+                return;
+            }
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            out += '"';
+            out += field.name;
+            out += "\":";
+            EncodeJsonValue(value, out);
+        };
+        (encode(fields), ...);
+    }, Message::kFields);
+    out += '}';
+}
+
+template <typename Message>
+std::string ToJson(const Message& message) {
+    std::string out;
+    out.reserve(256);
+    EncodeJson(message, out);
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// バイナリ エンコード / デコード
+// フィールド定義順に固定レイアウトで書き出す（リトルエンディアン）
+//   String: uint16 長さ + バイト列 / Number: IEEE754 double / Integer: int64 / Boolean: uint8
+//   FixedPoint: int64 + 有無フラグ uint8
+// ---------------------------------------------------------------------------
+
+template <typename Message>
+void EncodeBinary(const Message& message, std::string& out);
+
+template <typename T>
+void AppendLittleEndian(std::string& out, T value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++) {
+        out += static_cast<char>((bits >> (8 * i)) & 0xFF);
+    }
+}
+
+template <typename T>
+void EncodeBinaryValue(const T& value, std::string& out) {
+    if constexpr (std::is_same<T, std::string>::value) {
+        uint16_t length = static_cast<uint16_t>(value.size() < 0xFFFF ? value.size() : 0xFFFF);
+        AppendLittleEndian(out, length);
+        out.append(value.data(), length);
+    } else if constexpr (std::is_same<T, double>::value || std::is_same<T, long long>::value) {
+        AppendLittleEndian(out, value);
+    } else if constexpr (std::is_same<T, bool>::value) {
+        out += static_cast<char>(value ? 1 : 0);
+    } else if constexpr (std::is_same<T, FixedPrice>::value) {
+        AppendLittleEndian(out, value.raw);
+        out += static_cast<char>(value.present ? 1 : 0);
+    } else {
+        EncodeBinary(value, out);
+    }
+}
+
+template <typename Message>
+void EncodeBinary(const Message& message, std::string& out) {
+    std::apply([&](const auto&... fields) {
+        (EncodeBinaryValue(message.*(fields.member), out), ...);
+    }, Message::kFields);
+}
+
+class BinaryReader {
+public:
+    explicit BinaryReader(std::string_view data) : m_data(data), m_pos(0) {}
+
+    template <typename T>
+    bool ReadLittleEndian(T& value) {
+        if (m_pos + sizeof(T) > m_data.size()) {
+            return false;
+        }
+        uint64_t bits = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            bits |= static_cast<uint64_t>(static_cast<uint8_t>(m_data[m_pos + i])) << (8 * i);
+        }
+        std::memcpy(&value, &bits, sizeof(T));
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool ReadBytes(size_t length, std::string& value) {
+        if (m_pos + length > m_data.size()) {
+            return false;
+        }
+        value.assign(m_data.data() + m_pos, length);
+        m_pos += length;
+        return true;
+    }
+
+private:
+    std::string_view m_data;
+    size_t m_pos;
+};
+
+template <typename Message>
+bool DecodeBinaryObject(BinaryReader& reader, Message& message);
+
+template <typename T>
+bool DecodeBinaryValue(BinaryReader& reader, T& value) {
+    if constexpr (std::is_same<T, std::string>::value) {
+        uint16_t length = 0;
+        return reader.ReadLittleEndian(length) && reader.ReadBytes(length, value);
+    } else if constexpr (std::is_same<T, double>::value || std::is_same<T, long long>::value) {
+        return reader.ReadLittleEndian(value);
+    } else if constexpr (std::is_same<T, bool>::value) {
+        uint8_t flag = 0;
+        if (!reader.ReadLittleEndian(flag)) {
+            return false;
+        }
+        value = flag != 0;
+        return true;
+    } else if constexpr (std::is_same<T, FixedPrice>::value) {
+        uint8_t flag = 0;
+        if (!reader.ReadLittleEndian(value.raw) || !reader.ReadLittleEndian(flag)) {
+            return false;
+        }
+        value.present = flag != 0;
+        return true;
+    } else {
+        return DecodeBinaryObject(reader, value);
+    }
+}
+
+template <typename Message>
+bool DecodeBinaryObject(BinaryReader& reader, Message& message) {
+    return std::apply([&](const auto&... fields) {
+        return (DecodeBinaryValue(reader, message.*(fields.member)) && ...);
+    }, Message::kFields);
+}
+
+template <typename Message>
+bool DecodeBinary(std::string_view data, Message& message) {
+    BinaryReader reader(data);
+    return DecodeBinaryObject(reader, message);
+}
+
+// ---------------------------------------------------------------------------
+// TypeScript 型定義の生成
+// ---------------------------------------------------------------------------
+
+template <typename T, typename = void>
+struct HasTypeLiteral : std::false_type {};
+
+template <typename T>
+struct HasTypeLiteral<T, std::void_t<decltype(T::kTypeLiteral)>> : std::true_type {};
+
+template <typename T>
+const char* TypeScriptTypeName() {
+    if constexpr (std::is_same<T, std::string>::value) {
+        return "string";
+    } else if constexpr (std::is_same<T, bool>::value) {
+        return "boolean";
+    } else if constexpr (HasFields<T>::value) {
+        return T::kTsName;
+    } else {
+        return "number";
+    }
+}
+
+template <typename Message>
+void EmitTypeScript(std::ostream& out) {
+    out << "export interface " << Message::kTsName << " {\n";
+    std::apply([&](const auto&... fields) {
+        auto emit = [&](const auto& field) {
+            using ValueType = typename std::decay_t<decltype(field)>::ValueType;
+            out << "  " << field.name << (field.optional ? "?: " : ": ");
+            if constexpr (HasTypeLiteral<Message>::value) {
+                if (std::strcmp(field.name, "type") == 0) {
+                    out << Message::kTypeLiteral << ";\n";
+                    return;
+                }
+            }
+            out << TypeScriptTypeName<ValueType>() << ";\n";
+        };
+        (emit(fields), ...);
+    }, Message::kFields);
+    out << "}\n";
+}
+
+template <typename... Messages>
+void EmitTypeScriptAll(std::ostream& out, std::tuple<Messages...>*) {
+    bool first = true;
+    auto emit = [&](auto* tag) {
+        using Message = std::remove_pointer_t<decltype(tag)>;
+        if (!first) {
+            out << "\n";
+        }
+        first = false;
+        EmitTypeScript<Message>(out);
+    };
+    (emit(static_cast<Messages*>(nullptr)), ...);
+}
+
+} // namespace schema
+
+#endif // MESSAGESCHEMA_H
@@ -0,0 +1,261 @@
+#include "MessageUtils.h"
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+
+namespace {
+
+size_t SkipWhitespace(const std::string& json, size_t pos) {
+    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\r' || json[pos] == '\n')) {
+        pos++;
+    }
+    return pos;
+}
+
+// 文字列リテラルの終端（閉じ引用符の次）を返す。pos は開き引用符を指すこと
+size_t SkipString(const std::string& json, size_t pos) {
+    pos++;
+    while (pos < json.size()) {
+        if (json[pos] == '\\') {
+            pos += 2;
+            continue;
+        }
+        if (json[pos] == '"') {
+            return pos + 1;
+        }
+        pos++;
+    }
+    return std::string::npos;
+}
+
+// 任意の値の終端を返す（オブジェクト・配列はネストを数えて読み飛ばす）
+size_t SkipValue(const std::string& json, size_t pos) {
+    if (pos >= json.size()) {
+        return std::string::npos;
+    }
+
+    if (json[pos] == '"') {
+        return SkipString(json, pos);
+    }
+
+    if (json[pos] == '{' || json[pos] == '[') {
+        int depth = 0;
+        while (pos < json.size()) {
+            char c = json[pos];
+            if (c == '"') {
+                pos = SkipString(json, pos);
+                if (pos == std::string::npos) return pos;
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                depth--;
+                if (depth == 0) {
+                    return pos + 1;
+                }
+            }
+            pos++;
+        }
+        return std::string::npos;
+    }
+
+    // 数値・true/false/null
+    while (pos < json.size() && json[pos] != ',' && json[pos] != '}' && json[pos] != ']' &&
+           json[pos] != ' ' && json[pos] != '\t' && json[pos] != '\r' && json[pos] != '\n') {
+        pos++;
+    }
+    return pos;
+}
+
+// 1970-01-01 からの日数（グレゴリオ暦）
+int64_t DaysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+int DaysInMonth(int year, int month) {
+    static const int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : kDays[month - 1];
+}
+
+bool ParseDigits(const std::string& text, size_t pos, size_t count, int& value) {
+    if (pos + count > text.size()) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = pos; i < pos + count; i++) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+bool FindJsonField(const std::string& json, const char* key, size_t& valueBegin, size_t& valueEnd) {
+    const size_t keyLength = std::strlen(key);
+    size_t pos = SkipWhitespace(json, 0);
+    if (pos >= json.size() || json[pos] != '{') {
+        return false;
+    }
+    pos++;
+
+    while (true) {
+        pos = SkipWhitespace(json, pos);
+        if (pos >= json.size() || json[pos] != '"') {
+            return false;
+        }
+
+        size_t keyBegin = pos + 1;
+        size_t keyEnd = SkipString(json, pos);
+        if (keyEnd == std::string::npos) {
+            return false;
+        }
+
+        pos = SkipWhitespace(json, keyEnd);
+        if (pos >= json.size() || json[pos] != ':') {
+            return false;
+        }
+        pos = SkipWhitespace(json, pos + 1);
+
+        size_t end = SkipValue(json, pos);
+        if (end == std::string::npos) {
+            return false;
+        }
+
+        if (keyEnd - 1 - keyBegin == keyLength && json.compare(keyBegin, keyLength, key) == 0) {
+            valueBegin = pos;
+            valueEnd = end;
+            return true;
+        }
+
+        pos = SkipWhitespace(json, end);
+        if (pos >= json.size() || json[pos] != ',') {
+            return false;
+        }
+        pos++;
+    }
+}
+
+std::string GetJsonString(const std::string& json, const char* key) {
+    size_t begin = 0;
+    size_t end = 0;
+    if (!FindJsonField(json, key, begin, end) || json[begin] != '"' || end - begin < 2) {
+        return "";
+    }
+    return json.substr(begin + 1, end - begin - 2);
+}
+
+bool GetJsonNumber(const std::string& json, const char* key, double& value) {
+    size_t begin = 0;
+    size_t end = 0;
+    if (!FindJsonField(json, key, begin, end)) {
+        return false;
+    }
+
+    // 数値が文字列として送られてくる場合（"mtTicket":"123" 等）も許容
+    if (json[begin] == '"') {
+        begin++;
+        end--;
+    }
+
+    std::string text = json.substr(begin, end - begin);
+    char* parsedEnd = nullptr;
+    value = std::strtod(text.c_str(), &parsedEnd);
+    return parsedEnd != text.c_str();
+}
+
+std::string ExtractMessageType(const std::string& json) {
+    std::string type = GetJsonString(json, "type");
+    if (type.empty()) {
+        type = GetJsonString(json, "event");
+    }
+    if (type.empty()) {
+        type = GetJsonString(json, "command");
+    }
+    return type;
+}
+
+bool IsTradeEventType(const std::string& type) {
+    return type == "OPENED" || type == "CLOSED" || type == "STOPPED";
+}
+
+bool IsUrgentMessageType(const std::string& type) {
+    return IsTradeEventType(type) || type == "COMMAND_ACK" || type == "COMMAND_EXPIRED" ||
+           type == "COMMAND_REJECTED" || type == "COMMAND_RELEASED" || type == "LEG_DISPATCHED" ||
+           type == "MARGIN_WARNING";
+}
+
+std::string FormatIsoTimestamp(std::chrono::system_clock::time_point time) {
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    std::time_t seconds = static_cast<std::time_t>(millis / 1000);
+
+    std::tm utc;
+#ifdef _WIN32
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+
+    char buffer[80];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+                  utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday,
+                  utc.tm_hour, utc.tm_min, utc.tm_sec, static_cast<int>(millis % 1000));
+    return buffer;
+}
+
+bool ParseIsoTimestamp(const std::string& text, std::chrono::system_clock::time_point& time) {
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    if (!ParseDigits(text, 0, 4, year) || text.size() < 19 || text[4] != '-' ||
+        !ParseDigits(text, 5, 2, month) || text[7] != '-' ||
+        !ParseDigits(text, 8, 2, day) || (text[10] != 'T' && text[10] != ' ') ||
+        !ParseDigits(text, 11, 2, hour) || text[13] != ':' ||
+        !ParseDigits(text, 14, 2, minute) || text[16] != ':' ||
+        !ParseDigits(text, 17, 2, second)) {
+        return false;
+    }
+    // 範囲外の値は正規化せずに不正とする（"2024-13-45" を別の日時として受け付けない。60秒はうるう秒）
+    if (month < 1 || month > 12 || day < 1 || day > DaysInMonth(year, month) ||
+        hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+
+    size_t pos = 19;
+    int64_t micros = 0;
+    if (pos < text.size() && text[pos] == '.') {
+        pos++;
+        int64_t scale = 100000;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            micros += (text[pos] - '0') * scale;
+            scale /= 10;
+            pos++;
+        }
+    }
+
+    int64_t offsetSeconds = 0;
+    if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+        int offsetHour = 0, offsetMinute = 0;
+        if (!ParseDigits(text, pos + 1, 2, offsetHour) || pos + 3 >= text.size() || text[pos + 3] != ':' ||
+            !ParseDigits(text, pos + 4, 2, offsetMinute) || offsetHour > 23 || offsetMinute > 59) {
+            return false;
+        }
+        offsetSeconds = (offsetHour * 3600 + offsetMinute * 60) * (text[pos] == '+' ? 1 : -1);
+    }
+
+    int64_t seconds = DaysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) * 86400 +
+                      hour * 3600 + minute * 60 + second - offsetSeconds;
+    time = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::microseconds(seconds * 1000000 + micros)));
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#ifndef MESSAGEUTILS_H
+#define MESSAGEUTILS_H
+
+#include <chrono>
+#include <string>
+
+// JSONメッセージ用の軽量ヘルパー
+// 汎用JSONパーサーは使わず、トップレベルのフィールドのみを1パスで走査する
+// （ネストしたオブジェクト・配列内のキーは一致対象にならない）
+
+// トップレベルフィールドの値の範囲 [valueBegin, valueEnd) を取得
+bool FindJsonField(const std::string& json, const char* key, size_t& valueBegin, size_t& valueEnd);
+
+// 文字列フィールドの取得（存在しない・文字列でない場合は空文字列）
+std::string GetJsonString(const std::string& json, const char* key);
+
+// 数値フィールドの取得
+bool GetJsonNumber(const std::string& json, const char* key, double& value);
+
+// メッセージ種別の取得（"type" → "event" → "command" の順に参照）
+std::string ExtractMessageType(const std::string& json);
+
+// 取引イベント（OPENED/CLOSED/STOPPED）かどうか
+bool IsTradeEventType(const std::string& type);
+
+// 送信バッチの待機をせず即時送信すべきメッセージ（取引イベント・コマンド受領通知・期限切れ通知）かどうか
+bool IsUrgentMessageType(const std::string& type);
+
+// ISO 8601 形式（UTC・ミリ秒精度）の時刻文字列
+std::string FormatIsoTimestamp(std::chrono::system_clock::time_point time);
+
+// ISO 8601 形式の時刻文字列の解析（"2024-01-01T00:00:00.123Z"、タイムゾーンオフセット付きも可）
+// 月・日・時・分・秒・オフセットが範囲外なら false
+bool ParseIsoTimestamp(const std::string& text, std::chrono::system_clock::time_point& time);
+
+#endif // MESSAGEUTILS_H
@@ -0,0 +1,127 @@
+#include "NetExposure.h"
+#include <cmath>
+
+namespace {
+
+const double kVolumeEpsilon = 1e-9;
+
+double Gross(const SymbolExposure& exposure) {
+    return exposure.longVolume + exposure.shortVolume;
+}
+
+double AbsNet(const SymbolExposure& exposure) {
+    return std::fabs(exposure.longVolume - exposure.shortVolume);
+}
+
+} // namespace
+
+void NetExposure::OnDeal(const std::string& symbol, bool isBuy, DealEntry entry, double volume, double price) {
+    if (symbol.empty() || volume <= 0.0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ApplyLocked(symbol, isBuy, entry, volume, price);
+}
+
+void NetExposure::Seed(const std::string& symbol, bool isBuy, double volume, double openPrice) {
+    OnDeal(symbol, isBuy, DealEntry::In, volume, openPrice);
+}
+
+void NetExposure::Reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_symbols.clear();
+    m_grossVolume = 0.0;
+    m_netVolume = 0.0;
+}
+
+bool NetExposure::Get(const std::string& symbol, SymbolExposure& exposure) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_symbols.find(symbol);
+    if (it == m_symbols.end()) {
+        return false;
+    }
+    exposure = it->second;
+    return true;
+}
+
+ExposureSummary NetExposure::Snapshot(std::vector<SymbolExposure>& symbols) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& entry : m_symbols) {
+        if (Gross(entry.second) > kVolumeEpsilon) {
+            symbols.push_back(entry.second);
+        }
+    }
+    return SummaryLocked();
+}
+
+ExposureSummary NetExposure::Summary() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return SummaryLocked();
+}
+
+ExposureSummary NetExposure::SummaryLocked() const {
+    ExposureSummary summary;
+    summary.grossVolume = m_grossVolume > kVolumeEpsilon ? m_grossVolume : 0.0;
+    summary.netVolume = m_netVolume > kVolumeEpsilon ? m_netVolume : 0.0;
+    summary.hedgeRatio = summary.grossVolume > 0.0 ? 1.0 - summary.netVolume / summary.grossVolume : 1.0;
+    return summary;
+}
+
+void NetExposure::ApplyLocked(const std::string& symbol, bool isBuy, DealEntry entry, double volume, double price) {
+    SymbolExposure& exposure = m_symbols[symbol];
+    if (exposure.symbol.empty()) {
+        exposure.symbol = symbol;
+    }
+
+    // 口座合計は変更前後の差分で更新する
+    double grossBefore = Gross(exposure);
+    double netBefore = AbsNet(exposure);
+
+    switch (entry) {
+        case DealEntry::In:
+            Open(exposure, isBuy, volume, price);
+            break;
+        case DealEntry::Out:
+        case DealEntry::OutBy:
+            // 買い約定は売りポジションの決済、売り約定は買いポジションの決済
+            Reduce(exposure, !isBuy, volume);
+            break;
+        case DealEntry::InOut: {
+            // ネッティング口座のドテン: 反対方向を決済しきった残りを新規として加算
+            double remaining = Reduce(exposure, !isBuy, volume);
+            if (remaining > kVolumeEpsilon) {
+                Open(exposure, isBuy, remaining, price);
+            }
+            break;
+        }
+    }
+
+    m_grossVolume += Gross(exposure) - grossBefore;
+    m_netVolume += AbsNet(exposure) - netBefore;
+}
+
+void NetExposure::Open(SymbolExposure& exposure, bool isBuy, double volume, double price) {
+    if (isBuy) {
+        exposure.longVolume += volume;
+        exposure.longNotional += volume * price;
+    } else {
+        exposure.shortVolume += volume;
+        exposure.shortNotional += volume * price;
+    }
+}
+
+double NetExposure::Reduce(SymbolExposure& exposure, bool reduceLong, double volume) {
+    double& held = reduceLong ? exposure.longVolume : exposure.shortVolume;
+    double& notional = reduceLong ? exposure.longNotional : exposure.shortNotional;
+
+    double reduced = volume < held ? volume : held;
+    if (held > 0.0) {
+        notional -= notional * (reduced / held);
+    }
+    held -= reduced;
+    if (held <= kVolumeEpsilon) {
+        held = 0.0;
+        notional = 0.0;
+    }
+    return volume - reduced;
+}
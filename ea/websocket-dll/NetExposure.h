@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef NETEXPOSURE_H
+#define NETEXPOSURE_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 約定のエントリー種別（MQL5 の ENUM_DEAL_ENTRY と同じ値）
+enum class DealEntry {
+    In = 0,
+    Out = 1,
+    InOut = 2,
+    OutBy = 3
+};
+
+// 通貨ペアごとの保有量（ロット）と建値ベースの想定元本（ロット × 建値）
+struct SymbolExposure {
+    std::string symbol;
+    double longVolume = 0.0;
+    double shortVolume = 0.0;
+    double longNotional = 0.0;
+    double shortNotional = 0.0;
+};
+
+// 口座全体の集計
+struct ExposureSummary {
+    double grossVolume = 0.0;     // Σ(買い + 売り)
+    double netVolume = 0.0;       // Σ|買い - 売り|
+    double hedgeRatio = 1.0;      // 1 - netVolume / grossVolume（ポジションなしは 1）
+};
+
+// 口座のネットエクスポージャー
+// 約定（OPENED / CLOSED / STOPPED の元になる DEAL_ADD）ごとに通貨ペアの買い・売り保有量と
+// 想定元本を O(1) で更新し、口座全体の合計も差分で維持する。
+// 決済時の想定元本は平均建値で減らす
+class NetExposure {
+public:
+    void OnDeal(const std::string& symbol, bool isBuy, DealEntry entry, double volume, double price);
+
+    // 既存ポジションの登録（新規約定として加算）
+    void Seed(const std::string& symbol, bool isBuy, double volume, double openPrice);
+
+    void Reset();
+
+    bool Get(const std::string& symbol, SymbolExposure& exposure) const;
+
+    // 保有のある通貨ペアと口座全体の集計
+    ExposureSummary Snapshot(std::vector<SymbolExposure>& symbols) const;
+
+    // 口座全体の集計のみ（O(1)）
+    ExposureSummary Summary() const;
+
+private:
+    void Open(SymbolExposure& exposure, bool isBuy, double volume, double price);
+    // 反対方向の保有を減らし、減らしきれなかった量を返す
+    static double Reduce(SymbolExposure& exposure, bool reduceLong, double volume);
+    ExposureSummary SummaryLocked() const;
+    void ApplyLocked(const std::string& symbol, bool isBuy, DealEntry entry, double volume, double price);
+
+    std::unordered_map<std::string, SymbolExposure> m_symbols;
+    double m_grossVolume = 0.0;
+    double m_netVolume = 0.0;
+    mutable std::mutex m_mutex;
+};
+
+#endif // NETEXPOSURE_H
@@ -0,0 +1,81 @@
+#include "PeerDirectory.h"
+#include <cstring>
+
+std::string PeerDirectory::Key(const std::string& accountId, const std::string& symbol) {
+    std::string key;
+    key.reserve(accountId.size() + symbol.size() + 1);
+    key += accountId;
+    key += '\x1f';
+    key += symbol;
+    return key;
+}
+
+void PeerDirectory::OnTick(const std::string& accountId, const BusTick& tick, long long sentAtUs, long long receivedAtUs) {
+    std::string symbol(tick.symbol, strnlen(tick.symbol, sizeof(tick.symbol)));
+    if (accountId.empty() || symbol.empty()) {
+        return;
+    }
+
+    std::string key = Key(accountId, symbol);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    PeerTick& entry = m_ticks[key];
+    // 同じ通貨ペアのティックはリング上で順序が保たれるが、参加し直しの前後で古いものが届いた場合は捨てる
+    if (entry.timeMsc > tick.timeMsc) {
+        return;
+    }
+    if (entry.symbol.empty()) {
+        entry.accountId = accountId;
+        entry.symbol = symbol;
+    }
+    entry.bid = tick.bid;
+    entry.ask = tick.ask;
+    entry.point = tick.point;
+    entry.timeMsc = tick.timeMsc;
+    entry.sentAtUs = sentAtUs;
+    entry.receivedAtUs = receivedAtUs;
+}
+
+void PeerDirectory::OnSnapshot(const std::string& accountId, const BusSnapshot& snapshot, long long sentAtUs, long long receivedAtUs) {
+    if (accountId.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    PeerSnapshot& entry = m_snapshots[accountId];
+    entry.accountId = accountId;
+    entry.snapshot = snapshot;
+    entry.sentAtUs = sentAtUs;
+    entry.receivedAtUs = receivedAtUs;
+}
+
+bool PeerDirectory::FindTick(const std::string& accountId, const std::string& symbol, PeerTick& result) const {
+    std::string key = Key(accountId, symbol);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_ticks.find(key);
+    if (it == m_ticks.end()) {
+        return false;
+    }
+    result = it->second;
+    return true;
+}
+
+bool PeerDirectory::FindSnapshot(const std::string& accountId, PeerSnapshot& result) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_snapshots.find(accountId);
+    if (it == m_snapshots.end()) {
+        return false;
+    }
+    result = it->second;
+    return true;
+}
+
+size_t PeerDirectory::TickCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ticks.size();
+}
+
+void PeerDirectory::Reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ticks.clear();
+    m_snapshots.clear();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#ifndef PEERDIRECTORY_H
+#define PEERDIRECTORY_H
+
+#include "SharedBus.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 他の端末から共有メモリバスで受け取った最新のティック
+struct PeerTick {
+    std::string accountId;
+    std::string symbol;
+    double bid = 0.0;
+    double ask = 0.0;
+    double point = 0.0;
+    long long timeMsc = 0;
+    long long sentAtUs = 0;          // 送信元での送信時刻
+    long long receivedAtUs = 0;
+};
+
+// 他の端末から受け取った最新の口座状態
+struct PeerSnapshot {
+    std::string accountId;
+    BusSnapshot snapshot;
+    long long sentAtUs = 0;
+    long long receivedAtUs = 0;
+};
+
+// 同一ホストの他の端末の最新ティック（口座 × 通貨ペア）と口座状態
+// バスの受信スレッドで更新し、EAスレッドから参照する
+class PeerDirectory {
+public:
+    void OnTick(const std::string& accountId, const BusTick& tick, long long sentAtUs, long long receivedAtUs);
+    void OnSnapshot(const std::string& accountId, const BusSnapshot& snapshot, long long sentAtUs, long long receivedAtUs);
+
+    bool FindTick(const std::string& accountId, const std::string& symbol, PeerTick& result) const;
+    bool FindSnapshot(const std::string& accountId, PeerSnapshot& result) const;
+
+    size_t TickCount() const;
+    void Reset();
+
+private:
+    static std::string Key(const std::string& accountId, const std::string& symbol);
+
+    std::unordered_map<std::string, PeerTick> m_ticks;
+    std::unordered_map<std::string, PeerSnapshot> m_snapshots;
+    mutable std::mutex m_mutex;
+};
+
+#endif // PEERDIRECTORY_H
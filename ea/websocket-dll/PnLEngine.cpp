@@ -0,0 +1,454 @@
+#include "PnLEngine.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double kVolumeEpsilon = 1e-9;
+const char* const kPivotCurrency = "USD";
+
+} // namespace
+
+PnLEngine::PnLEngine(const SymbolSpecTable& specs) : m_specs(specs) {
+}
+
+void PnLEngine::SetAccount(const std::string& accountId, const std::string& currency, double balance, double credit) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_accountId = accountId;
+    m_balance = balance;
+    m_credit = credit;
+    m_realized = 0.0;
+    m_changed = true;
+
+    RefreshSpecsIfChanged();
+    if (currency != m_accountCurrency) {
+        m_accountCurrency = currency;
+        ResetRoutes();
+        RecomputeTotal();
+    }
+}
+
+void PnLEngine::OnDeal(int64_t positionId, const std::string& symbol, bool isBuy, int entry,
+                       double volume, double price, double profit) {
+    if (symbol.empty() || volume <= 0.0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RefreshSpecsIfChanged();
+    SymbolState& state = StateFor(symbol);
+
+    switch (entry) {
+        case 0:     // IN
+            OpenLocked(positionId, state, isBuy, volume, price, 0.0);
+            break;
+        case 1:     // OUT
+        case 3:     // OUT_BY
+            ReduceLocked(positionId, volume);
+            break;
+        case 2: {   // INOUT（ネッティング口座のドテン）
+            double remaining = ReduceLocked(positionId, volume);
+            if (remaining > kVolumeEpsilon) {
+                OpenLocked(positionId, state, isBuy, remaining, price, 0.0);
+            }
+            break;
+        }
+        default:
+            return;
+    }
+
+    m_realized += profit;
+    ResolveRoutes();
+    Revalue(state);
+    RecomputeTotal();
+    m_changed = true;
+}
+
+void PnLEngine::Seed(int64_t positionId, const std::string& symbol, bool isBuy, double volume, double openPrice, double swap) {
+    if (symbol.empty() || volume <= 0.0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RefreshSpecsIfChanged();
+    SymbolState& state = StateFor(symbol);
+    OpenLocked(positionId, state, isBuy, volume, openPrice, swap);
+    ResolveRoutes();
+    Revalue(state);
+    RecomputeTotal();
+    m_changed = true;
+}
+
+void PnLEngine::ResetPositions() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_positions.clear();
+    for (auto& entry : m_symbols) {
+        SymbolState& state = entry.second;
+        state.longVolume = 0.0;
+        state.shortVolume = 0.0;
+        state.longCost = 0.0;
+        state.shortCost = 0.0;
+        state.pnl = 0.0;
+    }
+    for (auto& currency : m_currencies) {
+        currency.pnl = 0.0;
+    }
+    m_floatingPnl = 0.0;
+    m_realized = 0.0;
+    m_changed = true;
+}
+
+bool PnLEngine::OnTick(const std::string& symbol, double bid, double ask) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RefreshSpecsIfChanged();
+
+    auto it = m_symbols.find(symbol);
+    if (it == m_symbols.end()) {
+        return false;
+    }
+
+    SymbolState& state = it->second;
+    state.bid = bid;
+    state.ask = ask;
+    state.hasPrice = bid > 0.0 && ask > 0.0;
+
+    if (state.longVolume > 0.0 || state.shortVolume > 0.0) {
+        Revalue(state);
+    }
+    for (int index : state.legOf) {
+        UpdateRate(m_currencies[static_cast<size_t>(index)]);
+    }
+
+    double previous = m_floatingPnl;
+    RecomputeTotal();
+    return m_floatingPnl != previous;
+}
+
+double PnLEngine::FloatingPnl() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_floatingPnl;
+}
+
+PnLSummary PnLEngine::GetSummary() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    PnLSummary summary;
+    summary.accountId = m_accountId;
+    summary.currency = m_accountCurrency;
+    summary.balance = m_balance;
+    summary.credit = m_credit;
+    summary.floatingPnl = m_floatingPnl;
+    summary.realized = m_realized;
+
+    for (const auto& entry : m_positions) {
+        summary.positions++;
+        summary.swap += entry.second.swap;
+        if (!PositionLocked(entry.first, entry.second).converted) {
+            summary.unconverted++;
+        }
+    }
+
+    summary.equity = summary.balance + summary.credit + summary.floatingPnl + summary.swap + summary.realized;
+    return summary;
+}
+
+bool PnLEngine::GetPosition(int64_t positionId, PositionPnL& result) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_positions.find(positionId);
+    if (it == m_positions.end()) {
+        return false;
+    }
+    result = PositionLocked(it->first, it->second);
+    return true;
+}
+
+void PnLEngine::CollectPositions(std::vector<PositionPnL>& positions) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    positions.reserve(positions.size() + m_positions.size());
+    for (const auto& entry : m_positions) {
+        positions.push_back(PositionLocked(entry.first, entry.second));
+    }
+}
+
+bool PnLEngine::ConsumeChanged() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool changed = m_changed;
+    m_changed = false;
+    return changed;
+}
+
+void PnLEngine::RequiredSymbols(std::vector<std::string>& symbols) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& entry : m_symbols) {
+        const SymbolState& state = entry.second;
+        if (state.longVolume > 0.0 || state.shortVolume > 0.0 || !state.legOf.empty()) {
+            symbols.push_back(state.symbol);
+        }
+    }
+}
+
+PnLEngine::SymbolState& PnLEngine::StateFor(const std::string& symbol) {
+    auto it = m_symbols.find(symbol);
+    if (it != m_symbols.end()) {
+        return it->second;
+    }
+
+    SymbolState& state = m_symbols[symbol];
+    state.symbol = symbol;
+    RefreshSymbolSpec(state, m_specVersion);
+    return state;
+}
+
+int PnLEngine::CurrencyIndex(const std::string& code) {
+    auto it = m_currencyIndex.find(code);
+    if (it != m_currencyIndex.end()) {
+        return it->second;
+    }
+
+    int index = static_cast<int>(m_currencies.size());
+    m_currencies.emplace_back();
+    m_currencies.back().code = code;
+    m_currencyIndex.emplace(code, index);
+    return index;
+}
+
+void PnLEngine::RefreshSpecsIfChanged() {
+    uint64_t version = m_specs.Version();
+    if (version == m_specVersion) {
+        return;
+    }
+
+    m_specVersion = version;
+    for (auto& entry : m_symbols) {
+        RefreshSymbolSpec(entry.second, version);
+    }
+    ResetRoutes();
+    RecomputeTotal();
+}
+
+void PnLEngine::RefreshSymbolSpec(SymbolState& state, uint64_t version) {
+    // 決済通貨が変わる場合に備え、現在の損益を一旦通貨別の合計から外す
+    if (state.currency >= 0) {
+        m_currencies[static_cast<size_t>(state.currency)].pnl -= state.pnl;
+    }
+    state.pnl = 0.0;
+    state.specVersion = version;
+
+    SymbolSpec spec;
+    if (m_specs.Find(state.symbol, spec) && !spec.profitCurrency.empty()) {
+        state.contractSize = spec.contractSize;
+        state.currency = CurrencyIndex(spec.profitCurrency);
+    } else {
+        state.contractSize = 0.0;
+        state.currency = -1;
+    }
+    Revalue(state);
+}
+
+void PnLEngine::ResetRoutes() {
+    for (auto& entry : m_symbols) {
+        entry.second.legOf.clear();
+    }
+    for (auto& currency : m_currencies) {
+        currency.routed = false;
+        currency.legCount = 0;
+    }
+    ResolveRoutes();
+}
+
+void PnLEngine::ResolveRoutes() {
+    if (m_accountCurrency.empty()) {
+        return;
+    }
+
+    std::vector<SymbolSpec> specs;
+    // 経路の解決で換算用の通貨ペアを追加すると通貨も増えるため、添字で最後まで回す
+    for (size_t i = 0; i < m_currencies.size(); i++) {
+        if (m_currencies[i].routed) {
+            continue;
+        }
+        if (specs.empty()) {
+            m_specs.CollectSince(0, specs);
+        }
+        ResolveRoute(m_currencies[i], specs);
+        UpdateRate(m_currencies[i]);
+    }
+}
+
+void PnLEngine::ResolveRoute(CurrencyState& currency, const std::vector<SymbolSpec>& specs) {
+    currency.routed = true;
+    currency.legCount = 0;
+    if (currency.code == m_accountCurrency) {
+        return;
+    }
+
+    int index = m_currencyIndex[currency.code];
+    Leg direct;
+    if (FindLeg(specs, currency.code, m_accountCurrency, direct)) {
+        currency.legs[0] = direct;
+        currency.legCount = 1;
+    } else {
+        // USD 経由（決済通貨 → USD → 口座通貨）
+        Leg first;
+        Leg second;
+        if (currency.code != kPivotCurrency && m_accountCurrency != kPivotCurrency &&
+            FindLeg(specs, currency.code, kPivotCurrency, first) &&
+            FindLeg(specs, kPivotCurrency, m_accountCurrency, second)) {
+            currency.legs[0] = first;
+            currency.legs[1] = second;
+            currency.legCount = 2;
+        }
+    }
+
+    for (int i = 0; i < currency.legCount; i++) {
+        std::vector<int>& legOf = currency.legs[i].symbol->legOf;
+        if (std::find(legOf.begin(), legOf.end(), index) == legOf.end()) {
+            legOf.push_back(index);
+        }
+    }
+}
+
+bool PnLEngine::FindLeg(const std::vector<SymbolSpec>& specs, const std::string& from, const std::string& to, Leg& leg) {
+    for (const auto& spec : specs) {
+        bool forward = spec.baseCurrency == from && spec.profitCurrency == to;
+        bool inverse = spec.baseCurrency == to && spec.profitCurrency == from;
+        if (forward || inverse) {
+            leg.symbol = &StateFor(spec.symbol);
+            leg.inverse = inverse;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PnLEngine::UpdateRate(CurrencyState& currency) {
+    if (currency.code == m_accountCurrency) {
+        currency.rate = 1.0;
+        currency.hasRate = true;
+        return;
+    }
+
+    double rate = currency.legCount > 0 ? 1.0 : 0.0;
+    for (int i = 0; i < currency.legCount; i++) {
+        const SymbolState& leg = *currency.legs[i].symbol;
+        double mid = (leg.bid + leg.ask) / 2.0;
+        if (!leg.hasPrice || mid <= 0.0) {
+            rate = 0.0;
+            break;
+        }
+        rate *= currency.legs[i].inverse ? 1.0 / mid : mid;
+    }
+
+    currency.rate = rate;
+    currency.hasRate = rate > 0.0;
+}
+
+void PnLEngine::OpenLocked(int64_t positionId, SymbolState& state, bool isBuy, double volume, double price, double swap) {
+    Position& position = m_positions[positionId];
+    if (position.symbol == nullptr || position.volume <= 0.0) {
+        position.symbol = &state;
+        position.isBuy = isBuy;
+        position.volume = 0.0;
+        position.openPrice = 0.0;
+    }
+
+    // 追加約定は加重平均の建値にまとめる
+    double total = position.volume + volume;
+    position.openPrice = (position.openPrice * position.volume + price * volume) / total;
+    position.volume = total;
+    position.swap += swap;
+
+    if (position.isBuy) {
+        state.longVolume += volume;
+        state.longCost += volume * price;
+    } else {
+        state.shortVolume += volume;
+        state.shortCost += volume * price;
+    }
+}
+
+double PnLEngine::ReduceLocked(int64_t positionId, double volume) {
+    auto it = m_positions.find(positionId);
+    if (it == m_positions.end()) {
+        return volume;
+    }
+
+    Position& position = it->second;
+    SymbolState& state = *position.symbol;
+    double reduced = std::min(volume, position.volume);
+
+    double& held = position.isBuy ? state.longVolume : state.shortVolume;
+    double& cost = position.isBuy ? state.longCost : state.shortCost;
+    held -= reduced;
+    cost -= reduced * position.openPrice;
+    if (held <= kVolumeEpsilon) {
+        held = 0.0;
+        cost = 0.0;
+    }
+
+    // 決済分のスワップは残高に振り替えられる
+    double releasedSwap = position.volume > 0.0 ? position.swap * (reduced / position.volume) : 0.0;
+    position.swap -= releasedSwap;
+    m_realized += releasedSwap;
+
+    position.volume -= reduced;
+    if (position.volume <= kVolumeEpsilon) {
+        m_positions.erase(it);
+    }
+    return volume - reduced;
+}
+
+void PnLEngine::Revalue(SymbolState& state) {
+    double pnl = 0.0;
+    if (state.hasPrice && state.contractSize > 0.0) {
+        // 買いは bid、売りは ask で評価
+        pnl = ((state.bid * state.longVolume - state.longCost) + (state.shortCost - state.ask * state.shortVolume)) * state.contractSize;
+    }
+
+    if (state.currency >= 0) {
+        m_currencies[static_cast<size_t>(state.currency)].pnl += pnl - state.pnl;
+    }
+    state.pnl = pnl;
+}
+
+void PnLEngine::RecomputeTotal() {
+    double total = 0.0;
+    for (const auto& currency : m_currencies) {
+        if (currency.hasRate) {
+            total += currency.pnl * currency.rate;
+        }
+    }
+
+    if (total != m_floatingPnl) {
+        m_floatingPnl = total;
+        m_changed = true;
+    }
+}
+
+PositionPnL PnLEngine::PositionLocked(int64_t positionId, const Position& position) const {
+    const SymbolState& state = *position.symbol;
+
+    PositionPnL result;
+    result.positionId = positionId;
+    result.symbol = state.symbol;
+    result.isBuy = position.isBuy;
+    result.volume = position.volume;
+    result.openPrice = position.openPrice;
+    result.swap = position.swap;
+    if (!state.hasPrice || state.contractSize <= 0.0) {
+        return result;
+    }
+
+    result.currentPrice = position.isBuy ? state.bid : state.ask;
+    double priceDiff = position.isBuy ? result.currentPrice - position.openPrice : position.openPrice - result.currentPrice;
+    result.profitCurrencyPnl = priceDiff * position.volume * state.contractSize;
+
+    if (state.currency >= 0) {
+        const CurrencyState& currency = m_currencies[static_cast<size_t>(state.currency)];
+        if (currency.hasRate) {
+            result.conversionRate = currency.rate;
+            result.pnl = result.profitCurrencyPnl * currency.rate;
+            result.converted = true;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#ifndef PNLENGINE_H
+#define PNLENGINE_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SymbolSpecTable.h"
+
+// ポジションごとの評価損益
+struct PositionPnL {
+    int64_t positionId = 0;
+    std::string symbol;
+    bool isBuy = true;
+    double volume = 0.0;
+    double openPrice = 0.0;
+    double currentPrice = 0.0;      // 買いは bid、売りは ask
+    double profitCurrencyPnl = 0.0; // 決済通貨建て
+    double conversionRate = 0.0;    // 決済通貨 → 口座通貨
+    double pnl = 0.0;               // 口座通貨建て（換算できない場合は 0）
+    double swap = 0.0;
+    bool converted = false;
+};
+
+// 口座全体の評価損益と推定有効証拠金
+struct PnLSummary {
+    std::string accountId;
+    std::string currency;
+    double balance = 0.0;
+    double credit = 0.0;
+    double floatingPnl = 0.0;       // 口座通貨建ての評価損益の合計
+    double swap = 0.0;
+    double realized = 0.0;          // 直近の口座情報以降の確定損益
+    double equity = 0.0;            // balance + credit + floatingPnl + swap + realized
+    long long positions = 0;
+    long long unconverted = 0;      // 価格・仕様・換算レート不足で評価できないポジション数
+};
+
+// 評価損益エンジン
+// 通貨ペアごとに買い・売りの保有量と Σ(ロット × 建値) を約定ごとに更新し、ティックでは
+// その通貨ペアの決済通貨建て損益だけを O(1) で再計算する。決済通貨ごとの合計に換算レートを
+// 掛けて口座通貨建ての合計を求める（通貨数は少ないため再集計は実質 O(1)）。
+// 換算レートは仕様テーブルの通貨から 決済通貨/口座通貨・口座通貨/決済通貨 の通貨ペアを探し、
+// なければ USD 経由の2本の通貨ペアで求める（仲値）。換算に使う通貨ペアのティックで該当通貨のレートを更新する
+class PnLEngine {
+public:
+    explicit PnLEngine(const SymbolSpecTable& specs);
+
+    // ブローカーの口座情報（残高・クレジットと口座通貨）。確定損益の積算はここで 0 に戻る
+    void SetAccount(const std::string& accountId, const std::string& currency, double balance, double credit);
+
+    // 約定（DEAL_ENTRY: 0 IN, 1 OUT, 2 INOUT, 3 OUT_BY）
+    void OnDeal(int64_t positionId, const std::string& symbol, bool isBuy, int entry,
+                double volume, double price, double profit);
+
+    void Seed(int64_t positionId, const std::string& symbol, bool isBuy, double volume, double openPrice, double swap);
+
+    void ResetPositions();
+
+    // 評価損益が変化した場合 true
+    bool OnTick(const std::string& symbol, double bid, double ask);
+
+    double FloatingPnl() const;
+
+    PnLSummary GetSummary() const;
+
+    bool GetPosition(int64_t positionId, PositionPnL& result) const;
+
+    void CollectPositions(std::vector<PositionPnL>& positions) const;
+
+    // 前回の呼び出し以降に評価損益・保有が変化したか
+    bool ConsumeChanged();
+
+    // 評価に必要なティック（保有中の通貨ペアと換算用の通貨ペア）
+    void RequiredSymbols(std::vector<std::string>& symbols) const;
+
+private:
+    struct SymbolState {
+        std::string symbol;
+        double contractSize = 0.0;
+        int currency = -1;              // 決済通貨（m_currencies の添字）
+        uint64_t specVersion = 0;
+        double bid = 0.0;
+        double ask = 0.0;
+        bool hasPrice = false;
+        double longVolume = 0.0;
+        double shortVolume = 0.0;
+        double longCost = 0.0;          // Σ(ロット × 建値)
+        double shortCost = 0.0;
+        double pnl = 0.0;               // 決済通貨建て
+        std::vector<int> legOf;         // この通貨ペアを換算に使う通貨
+    };
+
+    struct Leg {
+        SymbolState* symbol = nullptr;
+        bool inverse = false;           // true: 口座通貨側が基軸通貨（1 / 仲値）
+    };
+
+    struct CurrencyState {
+        std::string code;
+        double pnl = 0.0;               // この通貨建ての損益の合計
+        double rate = 0.0;
+        bool hasRate = false;
+        bool routed = false;            // 換算経路を解決済み
+        Leg legs[2];
+        int legCount = 0;
+    };
+
+    struct Position {
+        SymbolState* symbol = nullptr;
+        bool isBuy = true;
+        double volume = 0.0;
+        double openPrice = 0.0;
+        double swap = 0.0;
+    };
+
+    SymbolState& StateFor(const std::string& symbol);
+    int CurrencyIndex(const std::string& code);
+    void RefreshSpecsIfChanged();
+    void ResetRoutes();
+    void RefreshSymbolSpec(SymbolState& state, uint64_t version);
+    void ResolveRoutes();
+    void ResolveRoute(CurrencyState& currency, const std::vector<SymbolSpec>& specs);
+    bool FindLeg(const std::vector<SymbolSpec>& specs, const std::string& from, const std::string& to, Leg& leg);
+    void UpdateRate(CurrencyState& currency);
+    void OpenLocked(int64_t positionId, SymbolState& state, bool isBuy, double volume, double price, double swap);
+    double ReduceLocked(int64_t positionId, double volume);
+    void Revalue(SymbolState& state);
+    void RecomputeTotal();
+    PositionPnL PositionLocked(int64_t positionId, const Position& position) const;
+
+    const SymbolSpecTable& m_specs;
+    uint64_t m_specVersion = 0;
+    std::unordered_map<std::string, SymbolState> m_symbols;
+    std::deque<CurrencyState> m_currencies;      // 追加しても既存要素への参照は無効にならない
+    std::unordered_map<std::string, int> m_currencyIndex;
+    std::unordered_map<int64_t, Position> m_positions;
+
+    std::string m_accountId;
+    std::string m_accountCurrency;
+    double m_balance = 0.0;
+    double m_credit = 0.0;
+    double m_realized = 0.0;
+    double m_floatingPnl = 0.0;
+    bool m_changed = false;
+    mutable std::mutex m_mutex;
+};
+
+#endif // PNLENGINE_H
@@ -0,0 +1,149 @@
+#include "PriceAlertEngine.h"
+#include <algorithm>
+
+bool PriceAlertEngine::Add(const std::string& alertId, const std::string& symbol, long long level,
+                           bool hasDirection, AlertDirection direction) {
+    if (alertId.empty() || symbol.empty() || level <= 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RemoveLocked(alertId);
+    if (m_index.size() >= kMaxAlerts) {
+        return false;
+    }
+
+    Book& book = m_books[symbol];
+    Level entry{level, m_nextOrder++, alertId};
+    IndexEntry index{symbol, level, true, direction};
+
+    if (!hasDirection) {
+        if (!book.hasLastBid) {
+            index.decided = false;
+            book.undecided.push_back(std::move(entry));
+            m_index.emplace(alertId, std::move(index));
+            return true;
+        }
+        // 現在値と同じ水準は到達済みとして次のティックで発火させる
+        index.direction = level >= book.lastBid ? AlertDirection::Above : AlertDirection::Below;
+    }
+
+    Insert(book, std::move(entry), index.direction);
+    m_index.emplace(alertId, std::move(index));
+    return true;
+}
+
+bool PriceAlertEngine::Remove(const std::string& alertId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return RemoveLocked(alertId);
+}
+
+void PriceAlertEngine::OnTick(const std::string& symbol, long long bid, std::vector<TriggeredAlert>& triggered) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_books.find(symbol);
+    if (it == m_books.end()) {
+        return;
+    }
+
+    Book& book = it->second;
+    TakeCrossed(book, symbol, bid, triggered);
+
+    // 方向未確定の水準は最初のティックとの比較で振り分ける
+    if (!book.undecided.empty()) {
+        for (auto& entry : book.undecided) {
+            AlertDirection direction = entry.level >= bid ? AlertDirection::Above : AlertDirection::Below;
+            auto indexIt = m_index.find(entry.alertId);
+            if (indexIt != m_index.end()) {
+                indexIt->second.decided = true;
+                indexIt->second.direction = direction;
+            }
+            Insert(book, std::move(entry), direction);
+        }
+        book.undecided.clear();
+    }
+
+    book.lastBid = bid;
+    book.hasLastBid = true;
+}
+
+size_t PriceAlertEngine::Count() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.size();
+}
+
+void PriceAlertEngine::Insert(Book& book, Level level, AlertDirection direction) {
+    // 同一水準では登録順に発火するよう、後から登録したものを先頭側に置く
+    if (direction == AlertDirection::Above) {
+        auto position = std::partition_point(book.above.begin(), book.above.end(),
+            [&level](const Level& existing) { return existing.level > level.level; });
+        book.above.insert(position, std::move(level));
+    } else {
+        auto position = std::partition_point(book.below.begin(), book.below.end(),
+            [&level](const Level& existing) { return existing.level < level.level; });
+        book.below.insert(position, std::move(level));
+    }
+}
+
+bool PriceAlertEngine::RemoveLocked(const std::string& alertId) {
+    auto indexIt = m_index.find(alertId);
+    if (indexIt == m_index.end()) {
+        return false;
+    }
+
+    const IndexEntry& index = indexIt->second;
+    auto bookIt = m_books.find(index.symbol);
+    if (bookIt != m_books.end()) {
+        Book& book = bookIt->second;
+        if (!index.decided) {
+            auto it = std::find_if(book.undecided.begin(), book.undecided.end(),
+                [&alertId](const Level& entry) { return entry.alertId == alertId; });
+            if (it != book.undecided.end()) {
+                book.undecided.erase(it);
+            }
+        } else if (index.direction == AlertDirection::Above) {
+            EraseFrom(book.above, index.level, alertId, true);
+        } else {
+            EraseFrom(book.below, index.level, alertId, false);
+        }
+    }
+
+    m_index.erase(indexIt);
+    return true;
+}
+
+// 二分探索で同一水準の範囲を求め、その中から alertId を探して削除
+bool PriceAlertEngine::EraseFrom(std::vector<Level>& levels, long long level, const std::string& alertId, bool descending) {
+    auto first = std::partition_point(levels.begin(), levels.end(),
+        [level, descending](const Level& entry) { return descending ? entry.level > level : entry.level < level; });
+    for (auto it = first; it != levels.end() && it->level == level; ++it) {
+        if (it->alertId == alertId) {
+            levels.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void PriceAlertEngine::TakeCrossed(Book& book, const std::string& symbol, long long bid, std::vector<TriggeredAlert>& triggered) {
+    // 上抜け: 水準 <= bid が末尾に集まる
+    auto aboveStart = std::partition_point(book.above.begin(), book.above.end(),
+        [bid](const Level& entry) { return entry.level > bid; });
+    // 下抜け: 水準 >= bid が末尾に集まる
+    auto belowStart = std::partition_point(book.below.begin(), book.below.end(),
+        [bid](const Level& entry) { return entry.level < bid; });
+
+    // 末尾から、すなわち直前の価格に近い水準から順に通知する（同一水準は登録順）
+    for (auto it = book.above.end(); it != aboveStart;) {
+        --it;
+        triggered.push_back(TriggeredAlert{it->alertId, symbol, AlertDirection::Above, it->level, bid});
+        m_index.erase(it->alertId);
+    }
+    for (auto it = book.below.end(); it != belowStart;) {
+        --it;
+        triggered.push_back(TriggeredAlert{it->alertId, symbol, AlertDirection::Below, it->level, bid});
+        m_index.erase(it->alertId);
+    }
+
+    book.above.erase(aboveStart, book.above.end());
+    book.below.erase(belowStart, book.below.end());
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef PRICEALERTENGINE_H
+#define PRICEALERTENGINE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// アラートの方向
+enum class AlertDirection {
+    Above,   // 価格が水準以上になったら通知
+    Below    // 価格が水準以下になったら通知
+};
+
+// 発火したアラート
+struct TriggeredAlert {
+    std::string alertId;
+    std::string symbol;
+    AlertDirection direction = AlertDirection::Above;
+    long long level = 0;      // 固定小数点（FixedPrice::kScale 倍）
+    long long price = 0;      // 発火させたティックの bid（同上）
+};
+
+// 価格アラート（通貨ペアごとの閾値インデックス）
+// 水準を通貨ペアごとに上抜け用・下抜け用の2つのソート済み配列に保持し、
+// 到達済みの水準が常に配列の末尾に集まるよう並べる（上抜け: 降順、下抜け: 昇順）。
+// ティックごとに二分探索で境界を求めて末尾を切り取るため O(log n + k) で、
+// 登録数によらずティックごとの全件走査は発生しない。アラートは1回発火すると削除される
+class PriceAlertEngine {
+public:
+    static const size_t kMaxAlerts = 100000;
+
+    // 登録（同じ alertId は置き換え）。hasDirection が false の場合は直近の bid との比較で方向を決める
+    // （ティック未受信の通貨ペアは最初のティックで決め、そのティックでは発火させない）
+    bool Add(const std::string& alertId, const std::string& symbol, long long level,
+             bool hasDirection, AlertDirection direction);
+
+    bool Remove(const std::string& alertId);
+
+    // bid: 固定小数点（FixedPrice::kScale 倍）
+    void OnTick(const std::string& symbol, long long bid, std::vector<TriggeredAlert>& triggered);
+
+    size_t Count() const;
+
+private:
+    struct Level {
+        long long level;
+        uint64_t order;       // 同一水準内の登録順
+        std::string alertId;
+    };
+
+    struct Book {
+        std::vector<Level> above;         // 降順（末尾が最も低い水準）
+        std::vector<Level> below;         // 昇順（末尾が最も高い水準）
+        std::vector<Level> undecided;     // 方向未確定（ティック未受信）
+        long long lastBid = 0;
+        bool hasLastBid = false;
+    };
+
+    struct IndexEntry {
+        std::string symbol;
+        long long level;
+        bool decided;
+        AlertDirection direction;
+    };
+
+    void Insert(Book& book, Level level, AlertDirection direction);
+    bool RemoveLocked(const std::string& alertId);
+    static bool EraseFrom(std::vector<Level>& levels, long long level, const std::string& alertId, bool descending);
+    void TakeCrossed(Book& book, const std::string& symbol, long long bid, std::vector<TriggeredAlert>& triggered);
+
+    std::unordered_map<std::string, Book> m_books;
+    std::unordered_map<std::string, IndexEntry> m_index;   // alertId → 登録先
+    uint64_t m_nextOrder = 0;
+    mutable std::mutex m_mutex;
+};
+
+#endif // PRICEALERTENGINE_H
@@ -0,0 +1,52 @@
+#include "RetransmitRing.h"
+
+RetransmitRing::RetransmitRing()
+    : m_totalBytes(0), m_maxAge(std::chrono::seconds(30)), m_maxBytes(4 * 1024 * 1024) {
+}
+
+void RetransmitRing::SetLimits(std::chrono::seconds maxAge, size_t maxBytes) {
+    m_maxAge = maxAge;
+    m_maxBytes = maxBytes;
+    Prune(std::chrono::steady_clock::now());
+}
+
+void RetransmitRing::Push(uint64_t seq, const std::string& frame) {
+    auto now = std::chrono::steady_clock::now();
+    m_entries.push_back(Entry{seq, frame, now});
+    m_totalBytes += frame.size();
+    Prune(now);
+}
+
+RetransmitRing::ResendResult RetransmitRing::CollectFrom(uint64_t fromSeq, std::vector<std::string>& frames) const {
+    if (m_entries.empty()) {
+        return fromSeq == 0 ? ResendResult::Ok : ResendResult::Unavailable;
+    }
+
+    if (fromSeq < m_entries.front().seq) {
+        return ResendResult::Unavailable;
+    }
+
+    // シーケンスは連番のため先頭からのオフセットで直接位置を求める
+    uint64_t offset = fromSeq - m_entries.front().seq;
+    for (size_t i = static_cast<size_t>(offset); i < m_entries.size(); i++) {
+        frames.push_back(m_entries[i].frame);
+    }
+    return ResendResult::Ok;
+}
+
+uint64_t RetransmitRing::OldestSeq() const {
+    return m_entries.empty() ? 0 : m_entries.front().seq;
+}
+
+uint64_t RetransmitRing::NewestSeq() const {
+    return m_entries.empty() ? 0 : m_entries.back().seq;
+}
+
+void RetransmitRing::Prune(std::chrono::steady_clock::time_point now) {
+    // 最新フレームは常に保持する
+    while (m_entries.size() > 1 &&
+           (m_totalBytes > m_maxBytes || now - m_entries.front().sentAt > m_maxAge)) {
+        m_totalBytes -= m_entries.front().frame.size();
+        m_entries.pop_front();
+    }
+}
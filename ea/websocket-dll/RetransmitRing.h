@@ -0,0 +1,49 @@
+#pragma once
+
+#ifndef RETRANSMITRING_H
+#define RETRANSMITRING_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+// 送信済みフレームの保持リング
+// 直近 maxAge / maxBytes 分のフレームをシーケンス番号付きで保持し、
+// 再接続後のギャップ（RESEND_FROM）を再送で埋めるために使用する
+class RetransmitRing {
+public:
+    enum class ResendResult {
+        Ok,          // 要求されたシーケンス以降を全て取得
+        Unavailable  // 要求位置が保持範囲外（サーバー側で完全同期が必要）
+    };
+
+    RetransmitRing();
+
+    void SetLimits(std::chrono::seconds maxAge, size_t maxBytes);
+
+    void Push(uint64_t seq, const std::string& frame);
+
+    // fromSeq 以降のフレームを送信順に取得
+    ResendResult CollectFrom(uint64_t fromSeq, std::vector<std::string>& frames) const;
+
+    uint64_t OldestSeq() const;
+    uint64_t NewestSeq() const;
+
+private:
+    struct Entry {
+        uint64_t seq;
+        std::string frame;
+        std::chrono::steady_clock::time_point sentAt;
+    };
+
+    void Prune(std::chrono::steady_clock::time_point now);
+
+    std::deque<Entry> m_entries;
+    size_t m_totalBytes;
+    std::chrono::seconds m_maxAge;
+    size_t m_maxBytes;
+};
+
+#endif // RETRANSMITRING_H
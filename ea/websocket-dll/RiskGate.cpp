@@ -0,0 +1,223 @@
+#include "RiskGate.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double kVolumeEpsilon = 1e-9;
+const long long kRateWindowUs = 1000000;
+
+// 必要証拠金の変化（MarginMonitor と同じ 未カバー分 + カバー分 × 両建て比率）
+double MarginFor(const SymbolSpec& spec, double longVolume, double shortVolume) {
+    double covered = std::min(longVolume, shortVolume);
+    double uncovered = std::fabs(longVolume - shortVolume);
+    double hedgedRatio = spec.contractSize > 0.0 ? spec.marginHedged / spec.contractSize : 1.0;
+    return spec.marginPerLot * (uncovered + covered * hedgedRatio);
+}
+
+} // namespace
+
+RiskGate::RiskGate(const NetExposure& exposure, const MarginMonitor& margin, const SymbolSpecTable& specs)
+    : m_exposure(exposure), m_margin(margin), m_specs(specs) {
+}
+
+void RiskGate::SetLimits(const RiskLimits& limits) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_limits = limits;
+    m_orderTimes.assign(static_cast<size_t>(std::max(0, limits.maxOrdersPerSecond)), 0);
+    m_orderHead = 0;
+}
+
+RiskLimits RiskGate::GetLimits() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_limits;
+}
+
+bool RiskGate::Check(const RiskOrder& order, long long nowUs, RiskDecision& decision) {
+    decision = RiskDecision();
+
+    SymbolSpec spec;
+    bool hasSpec = m_specs.Find(order.symbol, spec);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ExpireLocked(nowUs);
+
+    if (order.symbol.empty() || order.direction == 0) {
+        return Reject(RiskRejectReason::InvalidOrder, 0.0, 0.0, decision);
+    }
+    bool isBuy = order.direction > 0;
+    if (!CheckVolumeLocked(order, hasSpec ? &spec : nullptr, decision)) {
+        m_rejected++;
+        return false;
+    }
+    if (m_limits.maxLot > 0.0 && order.volume > m_limits.maxLot + kVolumeEpsilon) {
+        return Reject(RiskRejectReason::MaxLot, m_limits.maxLot, order.volume, decision);
+    }
+    if (!CheckRateLocked(nowUs, decision)) {
+        m_rejected++;
+        return false;
+    }
+
+    // 約定済みの保有量に約定待ちの予約を加えた発注後の保有量
+    SymbolExposure held;
+    m_exposure.Get(order.symbol, held);
+    double reservedLong = 0.0;
+    double reservedShort = 0.0;
+    double reservedTotal = 0.0;
+    ReservedLocked(order.symbol, reservedLong, reservedShort, reservedTotal);
+
+    double longBefore = held.longVolume + reservedLong;
+    double shortBefore = held.shortVolume + reservedShort;
+    double longAfter = longBefore + (isBuy ? order.volume : 0.0);
+    double shortAfter = shortBefore + (isBuy ? 0.0 : order.volume);
+
+    // 通貨ペアの上限は偏りを増やす注文だけを止める（反対売買による縮小は通す）
+    double netBefore = std::fabs(longBefore - shortBefore);
+    double netAfter = std::fabs(longAfter - shortAfter);
+    if (m_limits.maxSymbolVolume > 0.0 && netAfter > netBefore &&
+        netAfter > m_limits.maxSymbolVolume + kVolumeEpsilon) {
+        return Reject(RiskRejectReason::SymbolExposure, m_limits.maxSymbolVolume, netAfter, decision);
+    }
+
+    if (m_limits.maxAccountVolume > 0.0) {
+        double grossAfter = m_exposure.Summary().grossVolume + reservedTotal + order.volume;
+        if (grossAfter > m_limits.maxAccountVolume + kVolumeEpsilon) {
+            return Reject(RiskRejectReason::AccountExposure, m_limits.maxAccountVolume, grossAfter, decision);
+        }
+    }
+
+    // 維持率は口座情報と仕様が揃っている場合のみ（必要証拠金が増える注文だけを止める）
+    if (m_limits.minMarginLevel > 0.0 && hasSpec && spec.marginPerLot > 0.0) {
+        MarginState state = m_margin.GetState();
+        double added = MarginFor(spec, longAfter, shortAfter) - MarginFor(spec, longBefore, shortBefore);
+        double marginAfter = state.margin + added;
+        if (state.hasAccount && added > 0.0 && marginAfter > 0.0) {
+            double levelAfter = state.equity / marginAfter * 100.0;
+            if (levelAfter < m_limits.minMarginLevel) {
+                return Reject(RiskRejectReason::MarginHeadroom, m_limits.minMarginLevel, levelAfter, decision);
+            }
+        }
+    }
+
+    if (!m_orderTimes.empty()) {
+        m_orderTimes[m_orderHead] = nowUs;
+        m_orderHead = (m_orderHead + 1) % m_orderTimes.size();
+    }
+
+    Reservation reservation;
+    reservation.key = order.key;
+    reservation.symbol = order.symbol;
+    reservation.isBuy = isBuy;
+    reservation.volume = order.volume;
+    reservation.expiresUs = nowUs + kReservationTtlMs * 1000;
+    m_reservations.push_back(reservation);
+    return true;
+}
+
+void RiskGate::Release(const std::string& key) {
+    if (key.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_reservations.begin(); it != m_reservations.end(); ++it) {
+        if (it->key == key) {
+            m_reservations.erase(it);
+            return;
+        }
+    }
+}
+
+void RiskGate::Reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_reservations.clear();
+    std::fill(m_orderTimes.begin(), m_orderTimes.end(), 0);
+    m_orderHead = 0;
+}
+
+long long RiskGate::RejectedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rejected;
+}
+
+const char* RiskGate::ReasonName(RiskRejectReason reason) {
+    switch (reason) {
+        case RiskRejectReason::InvalidOrder:    return "INVALID_ORDER";
+        case RiskRejectReason::InvalidVolume:   return "INVALID_VOLUME";
+        case RiskRejectReason::MaxLot:          return "MAX_LOT";
+        case RiskRejectReason::SymbolExposure:  return "SYMBOL_EXPOSURE";
+        case RiskRejectReason::AccountExposure: return "ACCOUNT_EXPOSURE";
+        case RiskRejectReason::OrderRate:       return "ORDER_RATE";
+        case RiskRejectReason::MarginHeadroom:  return "MARGIN_HEADROOM";
+        default:                                return "NONE";
+    }
+}
+
+void RiskGate::ExpireLocked(long long nowUs) {
+    // 予約は追加順＝失効順
+    while (!m_reservations.empty() && m_reservations.front().expiresUs <= nowUs) {
+        m_reservations.pop_front();
+    }
+}
+
+void RiskGate::ReservedLocked(const std::string& symbol, double& longVolume, double& shortVolume, double& total) const {
+    for (const auto& reservation : m_reservations) {
+        total += reservation.volume;
+        if (reservation.symbol == symbol) {
+            (reservation.isBuy ? longVolume : shortVolume) += reservation.volume;
+        }
+    }
+}
+
+bool RiskGate::CheckVolumeLocked(const RiskOrder& order, const SymbolSpec* spec, RiskDecision& decision) const {
+    decision.reason = RiskRejectReason::InvalidVolume;
+    decision.value = order.volume;
+
+    if (!(order.volume > 0.0) || !std::isfinite(order.volume)) {
+        return false;
+    }
+    if (spec != nullptr) {
+        if (spec->volumeMin > 0.0 && order.volume < spec->volumeMin - kVolumeEpsilon) {
+            decision.limit = spec->volumeMin;
+            return false;
+        }
+        if (spec->volumeMax > 0.0 && order.volume > spec->volumeMax + kVolumeEpsilon) {
+            decision.limit = spec->volumeMax;
+            return false;
+        }
+        if (spec->volumeStep > 0.0) {
+            double steps = order.volume / spec->volumeStep;
+            if (std::fabs(steps - std::round(steps)) > 1e-6) {
+                decision.limit = spec->volumeStep;
+                return false;
+            }
+        }
+    }
+
+    decision = RiskDecision();
+    return true;
+}
+
+bool RiskGate::CheckRateLocked(long long nowUs, RiskDecision& decision) const {
+    if (m_orderTimes.empty()) {
+        return true;
+    }
+
+    // リングの次の書き込み位置が最も古い記録。それが1秒以内なら上限に達している
+    long long oldest = m_orderTimes[m_orderHead];
+    if (oldest > 0 && nowUs - oldest < kRateWindowUs) {
+        decision.reason = RiskRejectReason::OrderRate;
+        decision.limit = static_cast<double>(m_limits.maxOrdersPerSecond);
+        decision.value = static_cast<double>(m_orderTimes.size() + 1);
+        return false;
+    }
+    return true;
+}
+
+bool RiskGate::Reject(RiskRejectReason reason, double limit, double value, RiskDecision& decision) {
+    decision.reason = reason;
+    decision.limit = limit;
+    decision.value = value;
+    m_rejected++;
+    return false;
+}
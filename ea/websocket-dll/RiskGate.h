@@ -0,0 +1,102 @@
+#pragma once
+
+#ifndef RISKGATE_H
+#define RISKGATE_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MarginMonitor.h"
+#include "NetExposure.h"
+#include "SymbolSpecTable.h"
+
+// 発注前チェックの上限（0 の項目は無効）
+struct RiskLimits {
+    double maxLot = 0.0;                // 1注文のロット
+    double maxSymbolVolume = 0.0;       // 通貨ペアごとの |買い - 売り|（ロット）
+    double maxAccountVolume = 0.0;      // 口座全体の Σ(買い + 売り)（ロット）
+    int maxOrdersPerSecond = 0;         // 直近1秒間に通した OPEN の数
+    double minMarginLevel = 0.0;        // 発注後の推定証拠金維持率（%）
+};
+
+enum class RiskRejectReason {
+    None = 0,
+    InvalidOrder,       // 通貨ペア・売買方向がない
+    InvalidVolume,      // 0 以下・仕様の最小 / 最大ロット・刻みに合わない
+    MaxLot,
+    SymbolExposure,
+    AccountExposure,
+    OrderRate,
+    MarginHeadroom
+};
+
+struct RiskOrder {
+    std::string symbol;
+    int direction = 0;                  // 1: 買い, -1: 売り, 0: 不明
+    double volume = 0.0;
+    std::string key;                    // 予約の解放に使うコマンドの識別子（positionId / actionId）
+};
+
+struct RiskDecision {
+    RiskRejectReason reason = RiskRejectReason::None;
+    double limit = 0.0;                 // 超えた上限
+    double value = 0.0;                 // 発注後の値
+};
+
+// 発注前リスクチェック
+// ioスレッドで OPEN をデコードした直後に呼び出し、EAのキューに入れる前に上限を確認する。
+// 保有量は NetExposure、維持率は MarginMonitor、ロット・必要証拠金は SymbolSpecTable の現在値を使い、
+// 約定前の OPEN は通した時点で予約として加算する（発注結果と約定を突き合わせたその OPEN の
+// 完了・拒否で解放、kReservationTtlMs で失効）。
+// CLOSE・MODIFY はリスクを増やさないためチェックしない
+class RiskGate {
+public:
+    static constexpr long long kReservationTtlMs = 5000;
+
+    RiskGate(const NetExposure& exposure, const MarginMonitor& margin, const SymbolSpecTable& specs);
+
+    void SetLimits(const RiskLimits& limits);
+    RiskLimits GetLimits() const;
+
+    // 通した場合 true（予約と発注レートに計上する）
+    bool Check(const RiskOrder& order, long long nowUs, RiskDecision& decision);
+
+    // key の OPEN の約定完了・拒否で予約を解放（決済や他の発注の約定では解放しない）
+    void Release(const std::string& key);
+
+    void Reset();
+
+    long long RejectedCount() const;
+
+    static const char* ReasonName(RiskRejectReason reason);
+
+private:
+    struct Reservation {
+        std::string key;
+        std::string symbol;
+        bool isBuy = true;
+        double volume = 0.0;
+        long long expiresUs = 0;
+    };
+
+    void ExpireLocked(long long nowUs);
+    void ReservedLocked(const std::string& symbol, double& longVolume, double& shortVolume, double& total) const;
+    bool CheckVolumeLocked(const RiskOrder& order, const SymbolSpec* spec, RiskDecision& decision) const;
+    bool CheckRateLocked(long long nowUs, RiskDecision& decision) const;
+    bool Reject(RiskRejectReason reason, double limit, double value, RiskDecision& decision);
+
+    const NetExposure& m_exposure;
+    const MarginMonitor& m_margin;
+    const SymbolSpecTable& m_specs;
+
+    RiskLimits m_limits;
+    std::deque<Reservation> m_reservations;
+    std::vector<long long> m_orderTimes;    // 直近に通した OPEN の時刻（maxOrdersPerSecond 件のリング）
+    size_t m_orderHead = 0;
+    long long m_rejected = 0;
+    mutable std::mutex m_mutex;
+};
+
+#endif // RISKGATE_H
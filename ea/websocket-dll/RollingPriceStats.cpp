@@ -0,0 +1,198 @@
+#include "RollingPriceStats.h"
+#include <cmath>
+
+void RollingPriceStats::RunningVariance::Add(double value) {
+    count++;
+    double delta = value - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (value - mean);
+}
+
+void RollingPriceStats::RunningVariance::Remove(double value) {
+    if (count <= 1) {
+        count = 0;
+        mean = 0.0;
+        m2 = 0.0;
+        return;
+    }
+    count--;
+    double delta = value - mean;
+    mean -= delta / static_cast<double>(count);
+    m2 -= delta * (value - mean);
+    if (m2 < 0.0) m2 = 0.0;   // 丸め誤差による負値を防ぐ
+}
+
+double RollingPriceStats::RunningVariance::StdDev() const {
+    return count > 1 ? std::sqrt(m2 / static_cast<double>(count)) : 0.0;
+}
+
+bool RollingPriceStats::OnTick(const std::string& symbol, double bid, double ask, long long tickTimeMsc, long long nowMs) {
+    if (symbol.empty() || bid <= 0.0 || ask <= 0.0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SymbolState* state = FindOrCreate(symbol);
+    if (state == nullptr) {
+        return false;
+    }
+    if (tickTimeMsc > 0 && tickTimeMsc == state->lastTickMsc) {
+        return true;
+    }
+
+    double mid = (bid + ask) / 2.0;
+    double spread = ask - bid;
+    unsigned long long seq = state->nextSeq;
+    size_t slot = static_cast<size_t>(seq % kWindowTicks);
+
+    // 窓から外れるティックを集計から除く（このスロットは新しいティックで上書きされる）
+    if (seq >= kWindowTicks) {
+        state->midSum -= state->mids[slot];
+        state->spreadSum -= state->spreads[slot];
+        if (seq >= kWindowTicks + 1) {
+            state->longReturns.Remove(state->returns[slot]);
+        }
+    }
+    if (seq >= kShortWindowTicks + 1) {
+        state->shortReturns.Remove(state->returns[static_cast<size_t>((seq - kShortWindowTicks) % kWindowTicks)]);
+    }
+
+    double logReturn = 0.0;
+    if (seq > 0) {
+        double previousMid = state->mids[static_cast<size_t>((seq - 1) % kWindowTicks)];
+        logReturn = std::log(mid / previousMid);
+        state->longReturns.Add(logReturn);
+        state->shortReturns.Add(logReturn);
+
+        // 不等間隔のティックに対応するため、経過時間に応じて減衰率を決める
+        double elapsedMs = static_cast<double>(nowMs - state->lastReceivedMs);
+        double alpha = elapsedMs > 0.0 ? 1.0 - std::exp(-elapsedMs / kEwmaTimeConstantMs) : 0.0;
+        state->ewma += alpha * (mid - state->ewma);
+    } else {
+        state->ewma = mid;
+    }
+
+    state->mids[slot] = mid;
+    state->spreads[slot] = spread;
+    state->returns[slot] = logReturn;
+    state->receivedMs[slot] = nowMs;
+    state->midSum += mid;
+    state->spreadSum += spread;
+
+    PushDeque(state->highs, state->mids, seq, true);
+    PushDeque(state->lows, state->mids, seq, false);
+    PushDeque(state->spreadHighs, state->spreads, seq, true);
+    PushDeque(state->spreadLows, state->spreads, seq, false);
+
+    state->nextSeq = seq + 1;
+    state->bid = bid;
+    state->ask = ask;
+    state->lastTickMsc = tickTimeMsc;
+    state->lastReceivedMs = nowMs;
+    state->updated = true;
+    return true;
+}
+
+bool RollingPriceStats::GetStats(const std::string& symbol, PriceStatsSnapshot& stats) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const SymbolState* state = Find(symbol);
+    if (state == nullptr) {
+        return false;
+    }
+    stats = MakeSnapshot(*state);
+    return true;
+}
+
+void RollingPriceStats::CollectUpdated(std::vector<PriceStatsSnapshot>& snapshots) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& state : m_symbols) {
+        if (!state->updated) {
+            continue;
+        }
+        snapshots.push_back(MakeSnapshot(*state));
+        state->updated = false;
+    }
+}
+
+RollingPriceStats::SymbolState* RollingPriceStats::FindOrCreate(const std::string& symbol) {
+    for (auto& state : m_symbols) {
+        if (state->symbol == symbol) {
+            return state.get();
+        }
+    }
+    if (m_symbols.size() >= kMaxSymbols) {
+        return nullptr;
+    }
+
+    m_symbols.push_back(std::make_unique<SymbolState>());
+    m_symbols.back()->symbol = symbol;
+    return m_symbols.back().get();
+}
+
+const RollingPriceStats::SymbolState* RollingPriceStats::Find(const std::string& symbol) const {
+    for (const auto& state : m_symbols) {
+        if (state->symbol == symbol) {
+            return state.get();
+        }
+    }
+    return nullptr;
+}
+
+void RollingPriceStats::PushDeque(MonotonicDeque& deque, const std::array<double, kWindowTicks>& values,
+                                  unsigned long long seq, bool greater) {
+    // 窓から外れた先頭を除く
+    if (deque.size > 0 && seq >= kWindowTicks && deque.seqs[deque.head] <= seq - kWindowTicks) {
+        deque.head = (deque.head + 1) % kWindowTicks;
+        deque.size--;
+    }
+
+    // 新しい値に劣る末尾を除く（以後、窓内の最大・最小になり得ない）
+    double value = values[static_cast<size_t>(seq % kWindowTicks)];
+    while (deque.size > 0) {
+        size_t tail = (deque.head + deque.size - 1) % kWindowTicks;
+        double tailValue = values[static_cast<size_t>(deque.seqs[tail] % kWindowTicks)];
+        if (greater ? tailValue > value : tailValue < value) {
+            break;
+        }
+        deque.size--;
+    }
+
+    deque.seqs[(deque.head + deque.size) % kWindowTicks] = seq;
+    deque.size++;
+}
+
+double RollingPriceStats::DequeFront(const MonotonicDeque& deque, const std::array<double, kWindowTicks>& values) {
+    return deque.size > 0 ? values[static_cast<size_t>(deque.seqs[deque.head] % kWindowTicks)] : 0.0;
+}
+
+PriceStatsSnapshot RollingPriceStats::MakeSnapshot(const SymbolState& state) {
+    PriceStatsSnapshot snapshot;
+    snapshot.symbol = state.symbol;
+    if (state.nextSeq == 0) {
+        return snapshot;
+    }
+
+    size_t count = state.nextSeq < kWindowTicks ? static_cast<size_t>(state.nextSeq) : kWindowTicks;
+    snapshot.ticks = static_cast<long long>(count);
+    snapshot.lastTickMsc = state.lastTickMsc;
+    snapshot.bid = state.bid;
+    snapshot.ask = state.ask;
+    snapshot.mid = (state.bid + state.ask) / 2.0;
+    snapshot.ewma = state.ewma;
+    snapshot.mean = state.midSum / static_cast<double>(count);
+    snapshot.high = DequeFront(state.highs, state.mids);
+    snapshot.low = DequeFront(state.lows, state.mids);
+    snapshot.spreadMean = state.spreadSum / static_cast<double>(count);
+    snapshot.spreadMax = DequeFront(state.spreadHighs, state.spreads);
+    snapshot.spreadMin = DequeFront(state.spreadLows, state.spreads);
+    snapshot.volatility = state.longReturns.StdDev();
+    snapshot.shortVolatility = state.shortReturns.StdDev();
+
+    // 窓内の最古ティックから最新ティックまでの経過時間で割る
+    unsigned long long oldestSeq = state.nextSeq - count;
+    long long spanMs = state.lastReceivedMs - state.receivedMs[static_cast<size_t>(oldestSeq % kWindowTicks)];
+    if (count > 1 && spanMs > 0) {
+        snapshot.tickRate = static_cast<double>(count - 1) * 1000.0 / static_cast<double>(spanMs);
+    }
+    return snapshot;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#ifndef ROLLINGPRICESTATS_H
+#define ROLLINGPRICESTATS_H
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 直近ティック窓の価格統計
+struct PriceStatsSnapshot {
+    std::string symbol;
+    long long ticks = 0;            // 窓内のティック数
+    long long lastTickMsc = 0;
+    double bid = 0.0;
+    double ask = 0.0;
+    double mid = 0.0;
+    double ewma = 0.0;              // 仲値の指数移動平均（時定数 kEwmaTimeConstantMs）
+    double mean = 0.0;              // 窓内の仲値の平均
+    double high = 0.0;              // 窓内の仲値の最高値
+    double low = 0.0;               // 窓内の仲値の最安値
+    double spreadMean = 0.0;        // 価格単位
+    double spreadMin = 0.0;
+    double spreadMax = 0.0;
+    double volatility = 0.0;        // 窓内のティック対数リターンの標準偏差
+    double shortVolatility = 0.0;   // 直近 kShortWindowTicks ティックの同上
+    double tickRate = 0.0;          // ティック / 秒
+};
+
+// 通貨ペアごとのストリーミング価格統計
+// 直近 kWindowTicks ティックを固定長リングに保持し、ティックごとに O(1) で
+//  - 仲値の EWMA（ティック間隔に応じた減衰）
+//  - 窓内の高値・安値とスプレッドの最小・最大（単調デック）
+//  - ティック対数リターンの分散（追加・削除に対応した Welford 法、長短2窓）
+//  - ティックレート
+// を更新する
+class RollingPriceStats {
+public:
+    static const size_t kMaxSymbols = 64;
+    static const size_t kWindowTicks = 1024;
+    static const size_t kShortWindowTicks = 16;
+    static const long long kEwmaTimeConstantMs = 30000;
+
+    // tickTimeMsc: 取引サーバーのティック時刻（同一ティックの重複通知を除外する。0 の場合は判定しない）
+    bool OnTick(const std::string& symbol, double bid, double ask, long long tickTimeMsc, long long nowMs);
+
+    bool GetStats(const std::string& symbol, PriceStatsSnapshot& stats) const;
+
+    // 前回の取り出し以降にティックのあった通貨ペアの統計を取り出す
+    void CollectUpdated(std::vector<PriceStatsSnapshot>& snapshots);
+
+private:
+    // 値の追加・削除に対応した Welford 法
+    struct RunningVariance {
+        long long count = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+
+        void Add(double value);
+        void Remove(double value);
+        double StdDev() const;
+    };
+
+    // 窓内の最大値（または最小値）を保持する単調デック（要素はティック通番）
+    struct MonotonicDeque {
+        std::array<unsigned long long, kWindowTicks> seqs;
+        size_t head = 0;
+        size_t size = 0;
+    };
+
+    struct SymbolState {
+        std::string symbol;
+        unsigned long long nextSeq = 0;       // 次のティック通番
+        std::array<double, kWindowTicks> mids;
+        std::array<double, kWindowTicks> spreads;
+        std::array<double, kWindowTicks> returns;
+        std::array<long long, kWindowTicks> receivedMs;
+        MonotonicDeque highs;
+        MonotonicDeque lows;
+        MonotonicDeque spreadHighs;
+        MonotonicDeque spreadLows;
+        RunningVariance longReturns;
+        RunningVariance shortReturns;
+        double midSum = 0.0;
+        double spreadSum = 0.0;
+        double ewma = 0.0;
+        double bid = 0.0;
+        double ask = 0.0;
+        long long lastTickMsc = 0;
+        long long lastReceivedMs = 0;
+        bool updated = false;
+    };
+
+    SymbolState* FindOrCreate(const std::string& symbol);
+    const SymbolState* Find(const std::string& symbol) const;
+
+    // greater: true で最大値、false で最小値のデック
+    static void PushDeque(MonotonicDeque& deque, const std::array<double, kWindowTicks>& values,
+                          unsigned long long seq, bool greater);
+    static double DequeFront(const MonotonicDeque& deque, const std::array<double, kWindowTicks>& values);
+
+    static PriceStatsSnapshot MakeSnapshot(const SymbolState& state);
+
+    std::vector<std::unique_ptr<SymbolState>> m_symbols;
+    mutable std::mutex m_mutex;
+};
+
+#endif // ROLLINGPRICESTATS_H
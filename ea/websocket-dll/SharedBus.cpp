@@ -0,0 +1,429 @@
+#include "SharedBus.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const uint32_t kMagic = 0x31425348;  // "HSB1"
+const uint32_t kVersion = 1;
+
+enum : uint32_t {
+    kSegmentUninitialized = 0,
+    kSegmentInitializing = 1,
+    kSegmentReady = 2
+};
+
+enum : uint32_t {
+    kSlotFree = 0,
+    kSlotClaiming = 1,
+    kSlotActive = 2
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "共有メモリ上の atomic はロックフリーである必要がある");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "共有メモリ上の atomic はロックフリーである必要がある");
+
+} // namespace
+
+// 共有メモリのレイアウト（ポインタを持たず、全プロセスで同じ配置になる）
+struct SharedBus::Segment {
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> state;
+        std::atomic<uint32_t> generation;   // 登録・解除のたびに増やし、読み取り中の書き換えを検出する
+        std::atomic<uint32_t> pid;
+        std::atomic<uint64_t> heartbeatUs;
+        std::atomic<uint64_t> joinedUs;
+        char accountId[64];
+    };
+
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> sequence;
+        BusMessage message;
+    };
+
+    struct Ring {
+        alignas(64) std::atomic<uint64_t> enqueuePos;
+        alignas(64) std::atomic<uint64_t> dequeuePos;
+        alignas(64) Cell cells[kRingSlots];
+    };
+
+    std::atomic<uint32_t> initState;
+    uint32_t magic;
+    uint32_t version;
+    uint32_t participantCount;
+    uint32_t ringSlots;
+    Slot slots[kMaxParticipants];
+    Ring rings[kMaxParticipants];
+};
+
+static_assert((SharedBus::kRingSlots & (SharedBus::kRingSlots - 1)) == 0, "kRingSlots は2のべき乗");
+
+SharedBus::SharedBus()
+    : m_segment(nullptr),
+      m_handle(nullptr),
+      m_mappedSize(0),
+      m_self(-1),
+      m_joinedUs(0),
+      m_sent(0),
+      m_received(0),
+      m_dropped(0) {
+}
+
+SharedBus::~SharedBus() {
+    Close();
+}
+
+uint32_t SharedBus::CurrentProcessId() {
+#ifdef _WIN32
+    return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint32_t>(getpid());
+#endif
+}
+
+void SharedBus::Remove(const std::string& name) {
+#ifdef _WIN32
+    (void)name;
+#else
+    shm_unlink(("/" + name).c_str());
+#endif
+}
+
+bool SharedBus::MapSegment(const std::string& name, size_t size) {
+#ifdef _WIN32
+    std::string objectName = "Local\\" + name;
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                        static_cast<DWORD>(size & 0xFFFFFFFFu), objectName.c_str());
+    if (!mapping) {
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    m_handle = mapping;
+    m_segment = static_cast<Segment*>(view);
+#else
+    std::string objectName = "/" + name;
+    int fd = shm_open(objectName.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        (static_cast<size_t>(info.st_size) < size && ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    m_segment = static_cast<Segment*>(view);
+#endif
+    m_mappedSize = size;
+    return true;
+}
+
+void SharedBus::UnmapSegment() {
+    if (!m_segment) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(m_segment);
+    CloseHandle(static_cast<HANDLE>(m_handle));
+#else
+    munmap(m_segment, m_mappedSize);
+#endif
+    m_segment = nullptr;
+    m_handle = nullptr;
+    m_mappedSize = 0;
+}
+
+bool SharedBus::Open(const std::string& name) {
+    if (m_segment) {
+        return true;
+    }
+    if (name.empty() || !MapSegment(name, sizeof(Segment))) {
+        return false;
+    }
+
+    // 新規作成された共有メモリはゼロ埋めされているため、最初に CAS に成功したプロセスが初期化する
+    uint32_t expected = kSegmentUninitialized;
+    if (m_segment->initState.compare_exchange_strong(expected, kSegmentInitializing, std::memory_order_acq_rel)) {
+        m_segment->magic = kMagic;
+        m_segment->version = kVersion;
+        m_segment->participantCount = static_cast<uint32_t>(kMaxParticipants);
+        m_segment->ringSlots = static_cast<uint32_t>(kRingSlots);
+        for (auto& ring : m_segment->rings) {
+            for (size_t i = 0; i < kRingSlots; i++) {
+                ring.cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            ring.enqueuePos.store(0, std::memory_order_relaxed);
+            ring.dequeuePos.store(0, std::memory_order_relaxed);
+        }
+        m_segment->initState.store(kSegmentReady, std::memory_order_release);
+    } else {
+        // 他のプロセスの初期化を待つ（初期化中に落ちた場合に備えて1秒で諦める）
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (m_segment->initState.load(std::memory_order_acquire) != kSegmentReady) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                UnmapSegment();
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    if (m_segment->magic != kMagic || m_segment->version != kVersion ||
+        m_segment->participantCount != kMaxParticipants || m_segment->ringSlots != kRingSlots) {
+        UnmapSegment();
+        return false;
+    }
+    return true;
+}
+
+void SharedBus::Close() {
+    Leave();
+    UnmapSegment();
+}
+
+int SharedBus::Join(const std::string& accountId, uint32_t pid, long long nowUs) {
+    if (!m_segment || accountId.empty()) {
+        return -1;
+    }
+    if (m_self >= 0) {
+        return m_self;
+    }
+
+    // 同じ口座の枠（端末の再起動）→ 空き枠 → ハートビートの途絶えた枠 の順に確保する
+    int claimed = -1;
+    for (int pass = 0; pass < 3 && claimed < 0; pass++) {
+        for (size_t i = 0; i < kMaxParticipants && claimed < 0; i++) {
+            Segment::Slot& slot = m_segment->slots[i];
+            uint32_t state = slot.state.load(std::memory_order_acquire);
+            bool candidate = false;
+            if (pass == 0) {
+                candidate = state == kSlotActive &&
+                            std::strncmp(slot.accountId, accountId.c_str(), sizeof(slot.accountId)) == 0;
+            } else if (pass == 1) {
+                candidate = state == kSlotFree;
+            } else {
+                candidate = state == kSlotActive &&
+                            nowUs - static_cast<long long>(slot.heartbeatUs.load(std::memory_order_relaxed)) > kStaleUs;
+            }
+            if (candidate && slot.state.compare_exchange_strong(state, kSlotClaiming, std::memory_order_acq_rel)) {
+                claimed = static_cast<int>(i);
+            }
+        }
+    }
+    if (claimed < 0) {
+        return -1;
+    }
+
+    Segment::Slot& slot = m_segment->slots[claimed];
+    slot.generation.fetch_add(1, std::memory_order_acq_rel);
+    std::memset(slot.accountId, 0, sizeof(slot.accountId));
+    std::memcpy(slot.accountId, accountId.data(), std::min(accountId.size(), sizeof(slot.accountId) - 1));
+    slot.pid.store(pid, std::memory_order_relaxed);
+    slot.heartbeatUs.store(static_cast<uint64_t>(nowUs), std::memory_order_relaxed);
+    slot.joinedUs.store(static_cast<uint64_t>(nowUs), std::memory_order_relaxed);
+    slot.generation.fetch_add(1, std::memory_order_acq_rel);
+    slot.state.store(kSlotActive, std::memory_order_release);
+
+    m_self = claimed;
+    m_joinedUs = nowUs;
+    return m_self;
+}
+
+void SharedBus::Leave() {
+    if (!m_segment || m_self < 0) {
+        return;
+    }
+    Segment::Slot& slot = m_segment->slots[m_self];
+    slot.generation.fetch_add(1, std::memory_order_acq_rel);
+    slot.state.store(kSlotFree, std::memory_order_release);
+    m_self = -1;
+}
+
+void SharedBus::Heartbeat(long long nowUs) {
+    if (!m_segment || m_self < 0) {
+        return;
+    }
+    m_segment->slots[m_self].heartbeatUs.store(static_cast<uint64_t>(nowUs), std::memory_order_relaxed);
+}
+
+bool SharedBus::ParticipantAt(int index, long long nowUs, BusParticipant& participant) const {
+    if (!m_segment || index < 0 || index >= static_cast<int>(kMaxParticipants)) {
+        return false;
+    }
+
+    const Segment::Slot& slot = m_segment->slots[index];
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint32_t before = slot.generation.load(std::memory_order_acquire);
+        if (slot.state.load(std::memory_order_acquire) != kSlotActive) {
+            return false;
+        }
+
+        char accountId[sizeof(slot.accountId)];
+        std::memcpy(accountId, slot.accountId, sizeof(accountId));
+        accountId[sizeof(accountId) - 1] = '\0';
+        participant.index = index;
+        participant.pid = slot.pid.load(std::memory_order_relaxed);
+        participant.heartbeatUs = static_cast<long long>(slot.heartbeatUs.load(std::memory_order_relaxed));
+        participant.joinedUs = static_cast<long long>(slot.joinedUs.load(std::memory_order_relaxed));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.generation.load(std::memory_order_relaxed) == before) {
+            participant.accountId = accountId;
+            return nowUs - participant.heartbeatUs <= kStaleUs;
+        }
+    }
+    return false;
+}
+
+int SharedBus::Find(const std::string& accountId, long long nowUs) const {
+    BusParticipant participant;
+    for (size_t i = 0; i < kMaxParticipants; i++) {
+        if (static_cast<int>(i) != m_self && ParticipantAt(static_cast<int>(i), nowUs, participant) &&
+            participant.accountId == accountId) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void SharedBus::Participants(long long nowUs, std::vector<BusParticipant>& participants) const {
+    participants.clear();
+    BusParticipant participant;
+    for (size_t i = 0; i < kMaxParticipants; i++) {
+        if (ParticipantAt(static_cast<int>(i), nowUs, participant)) {
+            participants.push_back(participant);
+        }
+    }
+}
+
+bool SharedBus::Send(int target, BusMessageKind kind, const void* data, size_t length, long long nowUs) {
+    if (!m_segment || m_self < 0 || target < 0 || target >= static_cast<int>(kMaxParticipants)) {
+        return false;
+    }
+    if (length > BusMessage::kPayloadSize) {
+        m_dropped++;
+        return false;
+    }
+
+    Segment::Ring& ring = m_segment->rings[target];
+    uint64_t pos = ring.enqueuePos.load(std::memory_order_relaxed);
+    Segment::Cell* cell = nullptr;
+    while (true) {
+        cell = &ring.cells[pos & (kRingSlots - 1)];
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (ring.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            m_dropped++;
+            return false;
+        } else {
+            pos = ring.enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->message.kind = static_cast<uint32_t>(kind);
+    cell->message.length = static_cast<uint32_t>(length);
+    cell->message.from = m_self;
+    cell->message.sentAtUs = static_cast<uint64_t>(nowUs);
+    if (length > 0) {
+        std::memcpy(cell->message.payload, data, length);
+    }
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    m_sent++;
+    return true;
+}
+
+size_t SharedBus::Broadcast(BusMessageKind kind, const void* data, size_t length, long long nowUs) {
+    if (!m_segment || m_self < 0) {
+        return 0;
+    }
+
+    size_t delivered = 0;
+    for (size_t i = 0; i < kMaxParticipants; i++) {
+        if (static_cast<int>(i) == m_self ||
+            m_segment->slots[i].state.load(std::memory_order_acquire) != kSlotActive ||
+            nowUs - static_cast<long long>(m_segment->slots[i].heartbeatUs.load(std::memory_order_relaxed)) > kStaleUs) {
+            continue;
+        }
+        if (Send(static_cast<int>(i), kind, data, length, nowUs)) {
+            delivered++;
+        }
+    }
+    return delivered;
+}
+
+bool SharedBus::Receive(BusMessage& message) {
+    if (!m_segment || m_self < 0) {
+        return false;
+    }
+
+    Segment::Ring& ring = m_segment->rings[m_self];
+    while (true) {
+        uint64_t pos = ring.dequeuePos.load(std::memory_order_relaxed);
+        Segment::Cell* cell = nullptr;
+        while (true) {
+            cell = &ring.cells[pos & (kRingSlots - 1)];
+            uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos + 1);
+            if (diff == 0) {
+                if (ring.dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = ring.dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        size_t length = std::min<size_t>(cell->message.length, BusMessage::kPayloadSize);
+        message.kind = cell->message.kind;
+        message.length = static_cast<uint32_t>(length);
+        message.from = cell->message.from;
+        message.sentAtUs = cell->message.sentAtUs;
+        std::memcpy(message.payload, cell->message.payload, length);
+        cell->sequence.store(pos + kRingSlots, std::memory_order_release);
+
+        // 参加枠を引き継ぐ前に前の参加者宛てに送られたものは読み捨てる
+        if (static_cast<long long>(message.sentAtUs) < m_joinedUs) {
+            continue;
+        }
+        m_received++;
+        return true;
+    }
+}
+
+BusCounters SharedBus::Counters() const {
+    BusCounters counters;
+    counters.sent = m_sent;
+    counters.received = m_received;
+    counters.dropped = m_dropped;
+    return counters;
+}
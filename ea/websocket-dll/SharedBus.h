@@ -0,0 +1,135 @@
+#pragma once
+
+#ifndef SHAREDBUS_H
+#define SHAREDBUS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 同一ホストの端末間で共有するメッセージの種別
+enum class BusMessageKind : uint32_t {
+    None = 0,
+    Tick = 1,        // BusTick
+    Command = 2,     // コマンドのJSON（CommandFrame）
+    Snapshot = 3,    // BusSnapshot
+    Frame = 4        // WebSocket フレームの断片（BusFrameLink）
+};
+
+// 共有メモリ上のメッセージ（固定長。payload は length バイトのみ有効）
+struct BusMessage {
+    static constexpr size_t kPayloadSize = 480;
+
+    uint32_t kind = 0;
+    uint32_t length = 0;
+    int32_t from = -1;               // 送信元の参加者番号
+    uint32_t reserved = 0;
+    uint64_t sentAtUs = 0;           // 送信時刻（UNIXエポックからのマイクロ秒）
+    char payload[kPayloadSize];
+};
+
+// ティック（BusMessageKind::Tick の payload）
+struct BusTick {
+    double bid = 0.0;
+    double ask = 0.0;
+    double point = 0.0;
+    long long timeMsc = 0;
+    char symbol[32];
+};
+
+// 口座の状態（BusMessageKind::Snapshot の payload）
+struct BusSnapshot {
+    double balance = 0.0;
+    double equity = 0.0;
+    double margin = 0.0;
+    double marginLevel = 0.0;
+    double floatingPnl = 0.0;
+};
+
+// 参加中の端末
+struct BusParticipant {
+    int index = -1;
+    std::string accountId;
+    uint32_t pid = 0;
+    long long heartbeatUs = 0;
+    long long joinedUs = 0;
+};
+
+// 送受信の件数（この端末分）
+struct BusCounters {
+    long long sent = 0;
+    long long received = 0;
+    long long dropped = 0;           // 相手の受信リングが満杯・ペイロード超過で送れなかった件数
+};
+
+// 同一ホストの端末（プロセス）間の共有メモリバス
+// 名前付き共有メモリに参加者の登録表（口座ID・pid・ハートビート）と、参加者ごとの受信リングを置く。
+// 受信リングは固定長セルの有界 MPMC キュー（Vyukov 方式）で、送信・受信ともロックを取らない。
+// 各プロセスは自分の番号のリングから受信し、相手の番号のリングへ送信する。
+// 参加枠はハートビートが kStaleUs より古くなると別の端末が再利用でき、再利用した端末は
+// 参加前に送られた古いメッセージを読み捨てる。
+// 送信途中のプロセスが落ちた場合、そのセル以降のリングは詰まるため、受信側は参加し直す必要がある
+class SharedBus {
+public:
+    static constexpr size_t kMaxParticipants = 16;
+    static constexpr size_t kRingSlots = 1024;
+    static constexpr long long kStaleUs = 3LL * 1000 * 1000;
+
+    SharedBus();
+    ~SharedBus();
+
+    SharedBus(const SharedBus&) = delete;
+    SharedBus& operator=(const SharedBus&) = delete;
+
+    // 共有メモリを作成または既存のものに接続する（先に作成した端末が初期化する）
+    bool Open(const std::string& name);
+    void Close();
+    bool IsOpen() const { return m_segment != nullptr; }
+
+    // 参加者として登録（同じ口座IDの参加枠があればそれを引き継ぐ）。空きがなければ -1
+    int Join(const std::string& accountId, uint32_t pid, long long nowUs);
+    void Leave();
+    int Self() const { return m_self; }
+
+    void Heartbeat(long long nowUs);
+
+    // ハートビートが新しい参加者の番号（見つからなければ -1）
+    int Find(const std::string& accountId, long long nowUs) const;
+    void Participants(long long nowUs, std::vector<BusParticipant>& participants) const;
+    bool ParticipantAt(int index, long long nowUs, BusParticipant& participant) const;
+
+    // target の受信リングへ送信（満杯・ペイロード超過の場合は false）
+    bool Send(int target, BusMessageKind kind, const void* data, size_t length, long long nowUs);
+
+    // 自分以外の全参加者へ送信し、送れた数を返す
+    size_t Broadcast(BusMessageKind kind, const void* data, size_t length, long long nowUs);
+
+    // 自分の受信リングから1件取り出す
+    bool Receive(BusMessage& message);
+
+    BusCounters Counters() const;
+
+    static uint32_t CurrentProcessId();
+
+    // 共有メモリの名前を削除する（POSIX のみ。Windows は最後のハンドルを閉じた時点で消える）
+    static void Remove(const std::string& name);
+
+private:
+    struct Segment;
+
+    bool MapSegment(const std::string& name, size_t size);
+    void UnmapSegment();
+
+    Segment* m_segment;
+    void* m_handle;
+    size_t m_mappedSize;
+    int m_self;
+    long long m_joinedUs;
+    std::atomic<long long> m_sent;
+    std::atomic<long long> m_received;
+    std::atomic<long long> m_dropped;
+};
+
+#endif // SHAREDBUS_H
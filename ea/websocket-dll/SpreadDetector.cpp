@@ -0,0 +1,270 @@
+#include "SpreadDetector.h"
+#include <algorithm>
+
+SpreadDetector::SpreadDetector() {
+    m_brokers.reserve(kMaxBrokers);
+}
+
+int SpreadDetector::Broker(const std::string& accountId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return BrokerLocked(accountId);
+}
+
+int SpreadDetector::BrokerLocked(const std::string& accountId) {
+    auto it = m_brokerIndex.find(accountId);
+    if (it != m_brokerIndex.end()) {
+        return it->second;
+    }
+    if (accountId.empty() || m_brokers.size() >= kMaxBrokers) {
+        return -1;
+    }
+
+    int broker = static_cast<int>(m_brokers.size());
+    m_brokers.push_back(accountId);
+    m_brokerIndex.emplace(accountId, broker);
+    ResolveAllCosts();
+    return broker;
+}
+
+int SpreadDetector::Symbol(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return SymbolLocked(symbol);
+}
+
+int SpreadDetector::SymbolLocked(const std::string& symbol) {
+    auto it = m_symbolIndex.find(symbol);
+    if (it != m_symbolIndex.end()) {
+        return it->second;
+    }
+    if (symbol.empty() || m_books.size() >= kMaxSymbols) {
+        return -1;
+    }
+
+    int index = static_cast<int>(m_books.size());
+    auto book = std::make_unique<Book>();
+    book->name = symbol;
+    ResolveCosts(*book);
+    m_books.push_back(std::move(book));
+    m_symbolIndex.emplace(symbol, index);
+    return index;
+}
+
+std::string SpreadDetector::BrokerName(int broker) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (broker < 0 || static_cast<size_t>(broker) >= m_brokers.size()) {
+        return std::string();
+    }
+    return m_brokers[broker];
+}
+
+std::string SpreadDetector::SymbolName(int symbol) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (symbol < 0 || static_cast<size_t>(symbol) >= m_books.size()) {
+        return std::string();
+    }
+    return m_books[symbol]->name;
+}
+
+bool SpreadDetector::SetRule(const std::string& symbol, const SpreadRule& rule) {
+    if (rule.exit > rule.entry || rule.minPersistUs < 0 || rule.maxQuoteAgeUs < 0 || rule.holdingDays < 0.0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (symbol.empty()) {
+        m_defaultRule = rule;
+        ResolveAllCosts();
+        return true;
+    }
+
+    int index = SymbolLocked(symbol);
+    if (index < 0) {
+        return false;
+    }
+    Book& book = *m_books[index];
+    book.rule = rule;
+    book.hasRule = true;
+    ResolveCosts(book);
+    return true;
+}
+
+bool SpreadDetector::SetCost(const std::string& accountId, const std::string& symbol, const SpreadCost& cost) {
+    if (accountId.empty() || cost.commission < 0.0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_costs[std::make_pair(accountId, symbol)] = cost;
+    ResolveAllCosts();
+    return true;
+}
+
+const SpreadRule& SpreadDetector::RuleOf(const Book& book) const {
+    return book.hasRule ? book.rule : m_defaultRule;
+}
+
+void SpreadDetector::ResolveCosts(Book& book) {
+    double days = RuleOf(book).holdingDays;
+    for (size_t broker = 0; broker < m_brokers.size(); broker++) {
+        SpreadCost cost;
+        auto it = m_costs.find(std::make_pair(m_brokers[broker], book.name));
+        if (it == m_costs.end()) {
+            it = m_costs.find(std::make_pair(m_brokers[broker], std::string()));
+        }
+        if (it != m_costs.end()) {
+            cost = it->second;
+        }
+        book.sellAdjust[broker] = -cost.commission + cost.swapShort * days;
+        book.buyAdjust[broker] = -cost.commission + cost.swapLong * days;
+    }
+}
+
+void SpreadDetector::ResolveAllCosts() {
+    for (auto& book : m_books) {
+        ResolveCosts(*book);
+    }
+}
+
+size_t SpreadDetector::OnQuote(int symbol, int broker, double bid, double ask, long long timeMsc, long long nowUs,
+                               std::vector<SpreadOpportunity>& events) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return QuoteLocked(symbol, broker, bid, ask, timeMsc, nowUs, events);
+}
+
+size_t SpreadDetector::OnQuote(const std::string& symbol, const std::string& accountId, double bid, double ask,
+                               long long timeMsc, long long nowUs, std::vector<SpreadOpportunity>& events) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return QuoteLocked(SymbolLocked(symbol), BrokerLocked(accountId), bid, ask, timeMsc, nowUs, events);
+}
+
+size_t SpreadDetector::QuoteLocked(int symbol, int broker, double bid, double ask, long long timeMsc, long long nowUs,
+                                   std::vector<SpreadOpportunity>& events) {
+    if (symbol < 0 || static_cast<size_t>(symbol) >= m_books.size() ||
+        broker < 0 || static_cast<size_t>(broker) >= m_brokers.size() || bid <= 0.0 || ask <= 0.0) {
+        return 0;
+    }
+
+    Book& book = *m_books[symbol];
+    Quote& quote = book.quotes[broker];
+    if (timeMsc != 0 && timeMsc < quote.timeMsc) {
+        return 0;
+    }
+    quote.bid = bid;
+    quote.ask = ask;
+    quote.timeMsc = timeMsc;
+    quote.atUs = nowUs;
+
+    // 気配の変わった口座を含む組だけを両方向に評価する
+    size_t added = 0;
+    int brokers = static_cast<int>(m_brokers.size());
+    for (int other = 0; other < brokers; other++) {
+        if (other == broker || book.quotes[other].atUs == 0) {
+            continue;
+        }
+        added += Evaluate(symbol, book, broker, other, nowUs, events) ? 1 : 0;
+        added += Evaluate(symbol, book, other, broker, nowUs, events) ? 1 : 0;
+    }
+    return added;
+}
+
+size_t SpreadDetector::Sweep(long long nowUs, std::vector<SpreadOpportunity>& events) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t added = 0;
+    int brokers = static_cast<int>(m_brokers.size());
+    for (size_t symbol = 0; symbol < m_books.size(); symbol++) {
+        Book& book = *m_books[symbol];
+        for (int sell = 0; sell < brokers; sell++) {
+            for (int buy = 0; buy < brokers; buy++) {
+                if (sell != buy && book.pairs[sell * kMaxBrokers + buy].state != PairState::Idle) {
+                    added += Evaluate(static_cast<int>(symbol), book, sell, buy, nowUs, events) ? 1 : 0;
+                }
+            }
+        }
+    }
+    return added;
+}
+
+bool SpreadDetector::Evaluate(int symbol, Book& book, int sell, int buy, long long nowUs,
+                              std::vector<SpreadOpportunity>& events) {
+    const SpreadRule& rule = RuleOf(book);
+    const Quote& sellQuote = book.quotes[sell];
+    const Quote& buyQuote = book.quotes[buy];
+    Pair& pair = book.pairs[sell * kMaxBrokers + buy];
+
+    bool fresh = sellQuote.atUs != 0 && buyQuote.atUs != 0 &&
+                 (rule.maxQuoteAgeUs == 0 ||
+                  (nowUs - sellQuote.atUs <= rule.maxQuoteAgeUs && nowUs - buyQuote.atUs <= rule.maxQuoteAgeUs));
+    double gross = sellQuote.bid - buyQuote.ask;
+    double net = gross + book.sellAdjust[sell] + book.buyAdjust[buy];
+
+    OpportunityState state;
+    if (pair.state == PairState::Open) {
+        // 開いている組は exit を下回るまで維持する（entry と exit の差がヒステリシス幅）
+        if (fresh && net >= rule.exit) {
+            pair.peak = std::max(pair.peak, net);
+            return false;
+        }
+        pair.state = PairState::Idle;
+        m_openCount--;
+        state = OpportunityState::Closed;
+    } else {
+        if (!fresh || net < rule.entry) {
+            pair.state = PairState::Idle;
+            return false;
+        }
+        if (pair.state == PairState::Idle) {
+            pair.state = PairState::Pending;
+            pair.sinceUs = nowUs;
+            pair.peak = net;
+        } else {
+            pair.peak = std::max(pair.peak, net);
+        }
+        if (nowUs - pair.sinceUs < rule.minPersistUs) {
+            return false;
+        }
+        pair.state = PairState::Open;
+        m_openCount++;
+        state = OpportunityState::Open;
+    }
+
+    SpreadOpportunity event;
+    event.state = state;
+    event.symbol = symbol;
+    event.sellBroker = sell;
+    event.buyBroker = buy;
+    event.sellBid = sellQuote.bid;
+    event.buyAsk = buyQuote.ask;
+    event.grossSpread = gross;
+    event.netSpread = net;
+    event.peakNetSpread = pair.peak;
+    event.threshold = state == OpportunityState::Open ? rule.entry : rule.exit;
+    event.startedUs = pair.sinceUs;
+    event.atUs = nowUs;
+    event.sequence = ++m_sequence;
+    events.push_back(event);
+    return true;
+}
+
+size_t SpreadDetector::OpenCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_openCount;
+}
+
+size_t SpreadDetector::SymbolCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_books.size();
+}
+
+size_t SpreadDetector::BrokerCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_brokers.size();
+}
+
+void SpreadDetector::Reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& book : m_books) {
+        std::fill(std::begin(book->quotes), std::end(book->quotes), Quote());
+        std::fill(std::begin(book->pairs), std::end(book->pairs), Pair());
+    }
+    m_openCount = 0;
+}
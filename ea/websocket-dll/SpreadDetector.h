@@ -0,0 +1,151 @@
+#pragma once
+
+#ifndef SPREADDETECTOR_H
+#define SPREADDETECTOR_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 口座ごとの費用（価格単位。1単位の売買あたり）
+struct SpreadCost {
+    double commission = 0.0;         // 往復の手数料
+    double swapLong = 0.0;           // 買いを1日持ち越したときのスワップ（受け取りは正、支払いは負）
+    double swapShort = 0.0;          // 売りを1日持ち越したときのスワップ（同上）
+};
+
+// 通貨ペアごとの判定条件（価格単位）
+struct SpreadRule {
+    double entry = 0.0;              // 機会とみなす正味スプレッド
+    double exit = 0.0;               // 機会の終了とみなす正味スプレッド（entry 以下。差がヒステリシス幅）
+    long long minPersistUs = 0;      // entry 以上がこの時間続いてから通知する
+    long long maxQuoteAgeUs = 5LL * 1000 * 1000;   // これより古い気配の口座は評価しない（0 で無制限）
+    double holdingDays = 0.0;        // スワップを見込む保有日数
+};
+
+enum class OpportunityState {
+    Open,       // 正味スプレッドが entry 以上で minPersistUs 続いた
+    Closed      // 正味スプレッドが exit を下回った（気配が古くなった場合を含む）
+};
+
+// 口座間スプレッドの機会（sellBroker で売り、buyBroker で買う）
+struct SpreadOpportunity {
+    OpportunityState state = OpportunityState::Open;
+    int symbol = -1;
+    int sellBroker = -1;
+    int buyBroker = -1;
+    double sellBid = 0.0;
+    double buyAsk = 0.0;
+    double grossSpread = 0.0;        // sellBid - buyAsk
+    double netSpread = 0.0;          // 手数料・スワップ控除後
+    double peakNetSpread = 0.0;      // entry を越えてからの最大値
+    double threshold = 0.0;          // 越えた閾値（Open は entry、Closed は exit）
+    long long startedUs = 0;         // entry を越えた時刻
+    long long atUs = 0;              // 状態が変わった時刻
+    uint64_t sequence = 0;           // 検出器全体の通番（同じ組の OPEN / CLOSED は必ずこの順。Reset でも戻らない）
+};
+
+// 口座（ブローカー）間スプレッドの機会検出
+// 通貨ペアごとに口座の最新気配を持ち、気配が届くたびにその口座を含む組（売り側・買い側の両方向）
+// だけを評価する（口座数 N に対して 2(N-1) 組）。組ごとに Idle → Pending → Open の状態を持ち、
+// 正味スプレッドが entry 以上で minPersistUs 続いたら Open、exit を下回ったら Closed を1回だけ通知する。
+// 持続時間の到達と気配の期限切れは、気配の届かない組も対象に呼び出し側が kSweepIntervalUs ごとに
+// Sweep を呼び出して判定する（OnQuote は気配の届いた通貨ペアの組だけを評価する）。
+// 複数のスレッドから呼び出した場合、events を受け取った後の送信順は前後しうるため、受け取る側は
+// 組ごとに sequence の小さい通知を捨てる。
+// 通貨ペア・口座の番号は登録順で、一度登録した番号は変わらない
+class SpreadDetector {
+public:
+    static constexpr size_t kMaxBrokers = 32;
+    static constexpr size_t kMaxSymbols = 4096;
+    static constexpr long long kSweepIntervalUs = 100LL * 1000;   // Sweep の推奨間隔
+
+    SpreadDetector();
+
+    // 口座・通貨ペアの番号（未登録なら登録。上限を超えた場合は -1）
+    int Broker(const std::string& accountId);
+    int Symbol(const std::string& symbol);
+    std::string BrokerName(int broker) const;
+    std::string SymbolName(int symbol) const;
+
+    // 判定条件（symbol が空なら個別設定のない通貨ペアの既定値）
+    bool SetRule(const std::string& symbol, const SpreadRule& rule);
+
+    // 口座の費用（symbol が空ならその口座の個別設定のない通貨ペアの既定値）
+    bool SetCost(const std::string& accountId, const std::string& symbol, const SpreadCost& cost);
+
+    // 気配を反映して組を評価し、状態が変わった組を events に追加する（追加した件数を返す）
+    // timeMsc はブローカーのティック時刻（0 なら不明）。統合気配と同じく、同じ口座で時刻が戻った気配は捨てる
+    // （統合気配の更新との間で別のスレッドの気配に追い越されても、古い価格で組を評価しない）
+    size_t OnQuote(int symbol, int broker, double bid, double ask, long long timeMsc, long long nowUs,
+                   std::vector<SpreadOpportunity>& events);
+    size_t OnQuote(const std::string& symbol, const std::string& accountId, double bid, double ask,
+                   long long timeMsc, long long nowUs, std::vector<SpreadOpportunity>& events);
+
+    // 全組の持続時間の到達・気配の期限切れを判定する（通貨ペア数 × 口座数の2乗に比例。気配の経路から呼び出さない）
+    size_t Sweep(long long nowUs, std::vector<SpreadOpportunity>& events);
+
+    size_t OpenCount() const;
+    size_t SymbolCount() const;
+    size_t BrokerCount() const;
+
+    // 気配と組の状態を捨てる（口座・通貨ペアの登録と設定は残す）
+    void Reset();
+
+private:
+    enum class PairState : unsigned char {
+        Idle,
+        Pending,
+        Open
+    };
+
+    struct Quote {
+        double bid = 0.0;
+        double ask = 0.0;
+        long long timeMsc = 0;
+        long long atUs = 0;
+    };
+
+    struct Pair {
+        PairState state = PairState::Idle;
+        double peak = 0.0;
+        long long sinceUs = 0;
+    };
+
+    struct Book {
+        std::string name;
+        bool hasRule = false;
+        SpreadRule rule;
+        Quote quotes[kMaxBrokers];
+        // 費用を正味スプレッドへの加算値にしたもの（売り側: -手数料 + 売りスワップ × 日数、買い側も同様）
+        double sellAdjust[kMaxBrokers] = {};
+        double buyAdjust[kMaxBrokers] = {};
+        Pair pairs[kMaxBrokers * kMaxBrokers];   // [売り口座 * kMaxBrokers + 買い口座]
+    };
+
+    int BrokerLocked(const std::string& accountId);
+    int SymbolLocked(const std::string& symbol);
+    const SpreadRule& RuleOf(const Book& book) const;
+    void ResolveCosts(Book& book);
+    void ResolveAllCosts();
+    size_t QuoteLocked(int symbol, int broker, double bid, double ask, long long timeMsc, long long nowUs,
+                       std::vector<SpreadOpportunity>& events);
+    bool Evaluate(int symbol, Book& book, int sell, int buy, long long nowUs, std::vector<SpreadOpportunity>& events);
+
+    std::vector<std::unique_ptr<Book>> m_books;
+    std::unordered_map<std::string, int> m_symbolIndex;
+    std::vector<std::string> m_brokers;
+    std::unordered_map<std::string, int> m_brokerIndex;
+    SpreadRule m_defaultRule;
+    std::map<std::pair<std::string, std::string>, SpreadCost> m_costs;   // (口座, 通貨ペア)
+    size_t m_openCount = 0;
+    uint64_t m_sequence = 0;
+    mutable std::mutex m_mutex;
+};
+
+#endif // SPREADDETECTOR_H
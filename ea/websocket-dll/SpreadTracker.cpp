@@ -0,0 +1,112 @@
+#include "SpreadTracker.h"
+
+SpreadTracker::SymbolState::SymbolState()
+    : current(0.0), lastTickMsc(0) {
+    for (size_t i = 0; i < kSlotCount; i++) {
+        slots[i].reset(new DDSketch(kRelativeAccuracy, kMinSpreadPoints, kMaxSpreadPoints));
+        slotEpochs[i] = -1;
+    }
+}
+
+SpreadTracker::SpreadTracker()
+    : m_slotMs(kDefaultWindowMs / static_cast<long long>(kSlotCount)),
+      m_scratch(new DDSketch(kRelativeAccuracy, kMinSpreadPoints, kMaxSpreadPoints)) {
+}
+
+void SpreadTracker::SetWindow(long long windowMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    long long slotMs = windowMs / static_cast<long long>(kSlotCount);
+    m_slotMs = slotMs > 0 ? slotMs : 1;
+
+    for (auto& state : m_symbols) {
+        for (size_t i = 0; i < kSlotCount; i++) {
+            state->slots[i]->Clear();
+            state->slotEpochs[i] = -1;
+        }
+    }
+}
+
+bool SpreadTracker::OnTick(const std::string& symbol, double bid, double ask, double point, long long tickTimeMsc, long long nowMs) {
+    if (symbol.empty() || point <= 0.0 || bid <= 0.0 || ask <= 0.0) {
+        return false;
+    }
+
+    double spreadPoints = (ask - bid) / point;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SymbolState* state = FindOrCreate(symbol);
+    if (state == nullptr) {
+        return false;
+    }
+
+    if (tickTimeMsc > 0 && tickTimeMsc == state->lastTickMsc) {
+        return true;
+    }
+    state->lastTickMsc = tickTimeMsc;
+
+    // 区間番号が変わったスロットは古い記録を捨てて再利用する
+    long long epoch = nowMs / m_slotMs;
+    size_t index = static_cast<size_t>(epoch % static_cast<long long>(kSlotCount));
+    if (state->slotEpochs[index] != epoch) {
+        state->slots[index]->Clear();
+        state->slotEpochs[index] = epoch;
+    }
+
+    state->slots[index]->Add(spreadPoints);
+    state->current = spreadPoints;
+    return true;
+}
+
+bool SpreadTracker::GetStats(const std::string& symbol, long long nowMs, SpreadStats& stats) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const SymbolState* state = Find(symbol);
+    if (state == nullptr) {
+        return false;
+    }
+
+    // 現在の区間を含む直近 kSlotCount 区間をマージ
+    long long epoch = nowMs / m_slotMs;
+    m_scratch->Clear();
+    for (size_t i = 0; i < kSlotCount; i++) {
+        long long slotEpoch = state->slotEpochs[i];
+        if (slotEpoch >= 0 && slotEpoch <= epoch && epoch - slotEpoch < static_cast<long long>(kSlotCount)) {
+            m_scratch->Merge(*state->slots[i]);
+        }
+    }
+
+    stats = SpreadStats();
+    stats.windowMs = m_slotMs * static_cast<long long>(kSlotCount);
+    stats.current = state->current;
+    stats.count = static_cast<long long>(m_scratch->Count());
+    stats.mean = m_scratch->Mean();
+    stats.min = m_scratch->Min();
+    stats.p50 = m_scratch->Quantile(0.50);
+    stats.p90 = m_scratch->Quantile(0.90);
+    stats.p99 = m_scratch->Quantile(0.99);
+    stats.max = m_scratch->Max();
+    return true;
+}
+
+SpreadTracker::SymbolState* SpreadTracker::FindOrCreate(const std::string& symbol) {
+    for (auto& state : m_symbols) {
+        if (state->symbol == symbol) {
+            return state.get();
+        }
+    }
+    if (m_symbols.size() >= kMaxSymbols) {
+        return nullptr;
+    }
+
+    m_symbols.push_back(std::make_unique<SymbolState>());
+    m_symbols.back()->symbol = symbol;
+    return m_symbols.back().get();
+}
+
+const SpreadTracker::SymbolState* SpreadTracker::Find(const std::string& symbol) const {
+    for (const auto& state : m_symbols) {
+        if (state->symbol == symbol) {
+            return state.get();
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#ifndef SPREADTRACKER_H
+#define SPREADTRACKER_H
+
+#include "DDSketch.h"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 時間窓内のスプレッド統計（ポイント）
+struct SpreadStats {
+    long long count = 0;
+    long long windowMs = 0;
+    double current = 0.0;
+    double mean = 0.0;
+    double min = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// 通貨ペアごとのスプレッド追跡
+// ティックごとのスプレッド（ポイント）を時間窓を等分したスロットの DDSketch に記録し、
+// 参照時に窓内のスロットをマージして分位点を求める。生ティックは保持しないため、
+// メモリ使用量は通貨ペア数 × スロット数で一定
+class SpreadTracker {
+public:
+    // 追跡する通貨ペアの上限
+    static const size_t kMaxSymbols = 64;
+    static const size_t kSlotCount = 10;
+    static const long long kDefaultWindowMs = 5 * 60 * 1000;
+
+    // 分位点の相対誤差（1%）と記録範囲（ポイント）
+    static constexpr double kRelativeAccuracy = 0.01;
+    static constexpr double kMinSpreadPoints = 0.1;
+    static constexpr double kMaxSpreadPoints = 100000.0;
+
+    SpreadTracker();
+
+    // 時間窓の変更（既存の記録は破棄される）
+    void SetWindow(long long windowMs);
+
+    // tickTimeMsc: 取引サーバーのティック時刻（同一ティックの重複通知を除外する。0 の場合は判定しない）
+    bool OnTick(const std::string& symbol, double bid, double ask, double point, long long tickTimeMsc, long long nowMs);
+
+    bool GetStats(const std::string& symbol, long long nowMs, SpreadStats& stats) const;
+
+private:
+    struct SymbolState {
+        SymbolState();
+
+        std::string symbol;
+        double current;
+        long long lastTickMsc;
+        std::array<std::unique_ptr<DDSketch>, kSlotCount> slots;
+        std::array<long long, kSlotCount> slotEpochs;   // スロットが表す区間番号（nowMs / slotMs）
+    };
+
+    SymbolState* FindOrCreate(const std::string& symbol);
+    const SymbolState* Find(const std::string& symbol) const;
+
+    std::vector<std::unique_ptr<SymbolState>> m_symbols;
+    long long m_slotMs;
+    mutable std::unique_ptr<DDSketch> m_scratch;   // 参照時のマージ用
+    mutable std::mutex m_mutex;
+};
+
+#endif // SPREADTRACKER_H
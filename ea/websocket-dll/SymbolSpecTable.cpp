@@ -0,0 +1,102 @@
+#include "SymbolSpecTable.h"
+
+bool SymbolSpec::SameContent(const SymbolSpec& other) const {
+    return symbol == other.symbol &&
+           digits == other.digits &&
+           point == other.point &&
+           tickSize == other.tickSize &&
+           tickValue == other.tickValue &&
+           contractSize == other.contractSize &&
+           volumeMin == other.volumeMin &&
+           volumeStep == other.volumeStep &&
+           volumeMax == other.volumeMax &&
+           marginPerLot == other.marginPerLot &&
+           marginHedged == other.marginHedged &&
+           baseCurrency == other.baseCurrency &&
+           profitCurrency == other.profitCurrency &&
+           marginCurrency == other.marginCurrency;
+}
+
+SymbolSpecTable::SymbolSpecTable() {
+}
+
+std::shared_ptr<const SymbolSpecTable::Table> SymbolSpecTable::Current() const {
+    return std::atomic_load_explicit(&m_current, std::memory_order_acquire);
+}
+
+bool SymbolSpecTable::Load(const std::vector<SymbolSpec>& specs) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    std::shared_ptr<const Table> current = Current();
+    uint64_t version = current ? current->version + 1 : 1;
+
+    auto next = std::make_shared<Table>();
+    next->version = version;
+    if (current) {
+        next->specs = current->specs;
+        next->index = current->index;
+    }
+
+    bool changed = false;
+    for (const auto& spec : specs) {
+        if (spec.symbol.empty()) {
+            continue;
+        }
+
+        auto it = next->index.find(spec.symbol);
+        if (it != next->index.end()) {
+            SymbolSpec& existing = next->specs[it->second];
+            if (existing.SameContent(spec)) {
+                continue;
+            }
+            existing = spec;
+            existing.updatedVersion = version;
+        } else {
+            if (next->specs.size() >= kMaxSymbols) {
+                continue;
+            }
+            next->index.emplace(spec.symbol, next->specs.size());
+            next->specs.push_back(spec);
+            next->specs.back().updatedVersion = version;
+        }
+        changed = true;
+    }
+
+    if (!changed) {
+        return false;
+    }
+
+    std::atomic_store_explicit(&m_current, std::shared_ptr<const Table>(std::move(next)), std::memory_order_release);
+    return true;
+}
+
+bool SymbolSpecTable::Find(const std::string& symbol, SymbolSpec& spec) const {
+    std::shared_ptr<const Table> table = Current();
+    if (!table) {
+        return false;
+    }
+
+    auto it = table->index.find(symbol);
+    if (it == table->index.end()) {
+        return false;
+    }
+    spec = table->specs[it->second];
+    return true;
+}
+
+uint64_t SymbolSpecTable::Version() const {
+    std::shared_ptr<const Table> table = Current();
+    return table ? table->version : 0;
+}
+
+void SymbolSpecTable::CollectSince(uint64_t sinceVersion, std::vector<SymbolSpec>& specs) const {
+    std::shared_ptr<const Table> table = Current();
+    if (!table) {
+        return;
+    }
+
+    for (const auto& spec : table->specs) {
+        if (spec.updatedVersion > sinceVersion) {
+            specs.push_back(spec);
+        }
+    }
+}
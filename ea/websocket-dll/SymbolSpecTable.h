@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef SYMBOLSPECTABLE_H
+#define SYMBOLSPECTABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 通貨ペアの仕様（EAの SymbolInfo* の値）
+struct SymbolSpec {
+    std::string symbol;
+    int digits = 0;
+    double point = 0.0;
+    double tickSize = 0.0;
+    double tickValue = 0.0;         // 1ロット・1ティックあたりの口座通貨額
+    double contractSize = 0.0;
+    double volumeMin = 0.0;
+    double volumeStep = 0.0;
+    double volumeMax = 0.0;
+    double marginPerLot = 0.0;      // 1ロットの必要証拠金（口座通貨）
+    double marginHedged = 0.0;      // SYMBOL_MARGIN_HEDGED
+    std::string baseCurrency;
+    std::string profitCurrency;
+    std::string marginCurrency;
+    uint64_t updatedVersion = 0;    // この内容が登録された版
+
+    // 内容が同じか（updatedVersion は比較しない）
+    bool SameContent(const SymbolSpec& other) const;
+};
+
+// 通貨ペア仕様のテーブル
+// EAからの一括登録（Load）ごとに不変のテーブルを作り直してアトミックに差し替える（RCU）。
+// 読み取り側（ティック・コマンド処理の各エンジン）は shared_ptr をアトミックに1回読むだけで、
+// 書き込み側のロックを取らない。差し替え前のテーブルは最後の読み取り側が参照を手放した時点で解放される
+class SymbolSpecTable {
+public:
+    static const size_t kMaxSymbols = 4096;
+
+    SymbolSpecTable();
+
+    // 一括登録（含まれない通貨ペアは保持）。内容に変化があった場合のみ新しい版を公開して true
+    bool Load(const std::vector<SymbolSpec>& specs);
+
+    bool Find(const std::string& symbol, SymbolSpec& spec) const;
+
+    // 現在の版（未登録は 0）
+    uint64_t Version() const;
+
+    // sinceVersion より後に登録・変更された仕様（0 で全件）
+    void CollectSince(uint64_t sinceVersion, std::vector<SymbolSpec>& specs) const;
+
+private:
+    struct Table {
+        uint64_t version = 0;
+        std::vector<SymbolSpec> specs;
+        std::unordered_map<std::string, size_t> index;
+    };
+
+    std::shared_ptr<const Table> Current() const;
+
+    std::shared_ptr<const Table> m_current;   // std::atomic_load / std::atomic_store でのみ読み書きする
+    std::mutex m_writeMutex;
+};
+
+#endif // SYMBOLSPECTABLE_H
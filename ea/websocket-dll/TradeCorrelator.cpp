@@ -0,0 +1,179 @@
+#include "TradeCorrelator.h"
+
+namespace {
+
+// MQL5 の取引サーバーリターンコード
+const int kRetcodePlaced = 10008;
+const int kRetcodeDone = 10009;
+const int kRetcodeDonePartial = 10010;
+
+const double kVolumeEpsilon = 1e-9;
+
+} // namespace
+
+bool TradeCorrelator::IsSuccessRetcode(int retcode) {
+    // 0 は非同期送信の応答待ち（結果未確定）
+    return retcode == 0 || retcode == kRetcodePlaced || retcode == kRetcodeDone || retcode == kRetcodeDonePartial;
+}
+
+void TradeCorrelator::OnResult(const TradeSubmission& result, long long nowUs, std::vector<CompletedTrade>& completed) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DropStale(nowUs, completed);
+
+    size_t index = FindPending(result.requestId, result.order);
+    if (index == kNotFound) {
+        // コマンド由来でない取引（手動発注等）の TRADE_TRANSACTION_REQUEST は対象外
+        if (result.positionId.empty()) {
+            return;
+        }
+        Pending pending;
+        pending.submission = result;
+        pending.submittedAtUs = nowUs;
+        m_pending.push_back(std::move(pending));
+        index = m_pending.size() - 1;
+    } else {
+        // 非同期送信では request_id → 注文チケットの順に判明する
+        TradeSubmission& submission = m_pending[index].submission;
+        if (submission.order == 0) {
+            submission.order = result.order;
+        }
+        if (submission.requestId == 0) {
+            submission.requestId = result.requestId;
+        }
+        if (result.retcode != 0) {
+            submission.retcode = result.retcode;
+        }
+    }
+
+    if (!IsSuccessRetcode(m_pending[index].submission.retcode)) {
+        completed.push_back(MakeCompleted(m_pending[index], CompletedTrade::Outcome::Rejected, nowUs));
+        m_pending.erase(m_pending.begin() + static_cast<std::ptrdiff_t>(index));
+        return;
+    }
+
+    ApplyOrphans(nowUs, completed);
+}
+
+void TradeCorrelator::OnDeal(const DealFill& deal, long long nowUs, std::vector<CompletedTrade>& completed) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DropStale(nowUs, completed);
+
+    size_t index = FindPending(0, deal.order);
+    if (index == kNotFound) {
+        // 発注結果より先に届いた約定（または対象外の約定）は一時保持
+        if (m_orphans.size() >= kMaxOrphanDeals) {
+            m_orphans.pop_front();
+            m_droppedOrphans++;
+        }
+        OrphanDeal orphan;
+        orphan.deal = deal;
+        orphan.receivedAtUs = nowUs;
+        m_orphans.push_back(std::move(orphan));
+        return;
+    }
+
+    ApplyDeal(m_pending[index], deal);
+    TryComplete(index, nowUs, completed);
+}
+
+size_t TradeCorrelator::PendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
+
+long long TradeCorrelator::DroppedOrphanCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_droppedOrphans;
+}
+
+size_t TradeCorrelator::FindPending(uint32_t requestId, uint64_t order) const {
+    for (size_t i = 0; i < m_pending.size(); i++) {
+        const TradeSubmission& submission = m_pending[i].submission;
+        if ((requestId != 0 && submission.requestId == requestId) ||
+            (order != 0 && submission.order == order)) {
+            return i;
+        }
+    }
+    return kNotFound;
+}
+
+void TradeCorrelator::ApplyDeal(Pending& pending, const DealFill& deal) {
+    pending.filledVolume += deal.volume;
+    pending.fillNotional += deal.price * deal.volume;
+    pending.profit += deal.profit;
+    if (deal.position != 0) {
+        pending.positionTicket = deal.position;
+    }
+}
+
+bool TradeCorrelator::TryComplete(size_t index, long long nowUs, std::vector<CompletedTrade>& completed) {
+    const Pending& pending = m_pending[index];
+    double requested = pending.submission.requestedVolume;
+    if (requested > 0.0 && pending.filledVolume + kVolumeEpsilon < requested) {
+        return false;   // 部分約定: 残りの約定を待つ
+    }
+
+    completed.push_back(MakeCompleted(pending, CompletedTrade::Outcome::Filled, nowUs));
+    m_pending.erase(m_pending.begin() + static_cast<std::ptrdiff_t>(index));
+    return true;
+}
+
+void TradeCorrelator::ApplyOrphans(long long nowUs, std::vector<CompletedTrade>& completed) {
+    for (auto it = m_orphans.begin(); it != m_orphans.end();) {
+        size_t index = FindPending(0, it->deal.order);
+        if (index == kNotFound) {
+            ++it;
+            continue;
+        }
+        ApplyDeal(m_pending[index], it->deal);
+        it = m_orphans.erase(it);
+        TryComplete(index, nowUs, completed);
+    }
+}
+
+void TradeCorrelator::DropStale(long long nowUs, std::vector<CompletedTrade>& completed) {
+    while (!m_orphans.empty() && nowUs - m_orphans.front().receivedAtUs > kMaxPendingUs) {
+        m_orphans.pop_front();
+    }
+
+    for (size_t i = 0; i < m_pending.size();) {
+        const Pending& pending = m_pending[i];
+        if (nowUs - pending.submittedAtUs <= kMaxPendingUs) {
+            i++;
+            continue;
+        }
+        // 残りが約定しないまま期限を迎えた部分約定は、約定済みの分で確定させる
+        if (pending.filledVolume > 0.0) {
+            completed.push_back(MakeCompleted(pending, CompletedTrade::Outcome::Filled, nowUs));
+        }
+        m_pending.erase(m_pending.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+CompletedTrade TradeCorrelator::MakeCompleted(const Pending& pending, CompletedTrade::Outcome outcome, long long nowUs) {
+    CompletedTrade trade;
+    trade.outcome = outcome;
+    trade.submission = pending.submission;
+    trade.positionTicket = pending.positionTicket;
+    trade.filledVolume = pending.filledVolume;
+    trade.profit = pending.profit;
+    trade.submittedAtUs = pending.submittedAtUs;
+    trade.filledAtUs = nowUs;
+
+    if (outcome != CompletedTrade::Outcome::Filled || pending.filledVolume <= 0.0) {
+        return trade;
+    }
+
+    trade.fillPrice = pending.fillNotional / pending.filledVolume;
+
+    const TradeSubmission& submission = pending.submission;
+    if (submission.point > 0.0 && submission.requestedPrice > 0.0) {
+        double difference = trade.fillPrice - submission.requestedPrice;
+        trade.slippagePoints = (submission.isBuy ? difference : -difference) / submission.point;
+    }
+    if (submission.commandReceivedAtUs > 0) {
+        trade.fillLatencyUs = nowUs - submission.commandReceivedAtUs;
+    }
+    trade.submitToFillUs = nowUs - pending.submittedAtUs;
+    return trade;
+}
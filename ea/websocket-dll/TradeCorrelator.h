@@ -0,0 +1,117 @@
+#pragma once
+
+#ifndef TRADECORRELATOR_H
+#define TRADECORRELATOR_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 発注の種別
+enum class TradeAction {
+    Open,
+    Close
+};
+
+// EAから渡される発注結果（OrderSend / OrderSendAsync 直後、および TRADE_TRANSACTION_REQUEST 時）
+struct TradeSubmission {
+    TradeAction action = TradeAction::Open;
+    bool isBuy = true;                  // 注文の売買方向（決済の場合は反対売買の方向）
+    uint32_t requestId = 0;             // MqlTradeResult.request_id
+    int retcode = 0;                    // MqlTradeResult.retcode
+    uint64_t order = 0;                 // MqlTradeResult.order（非同期送信直後は 0 の場合あり）
+    double requestedPrice = 0.0;        // 発注時の気配値
+    double requestedVolume = 0.0;
+    double point = 0.0;                 // SYMBOL_POINT
+    long long commandReceivedAtUs = 0;  // 元コマンドのDLL受信時刻（0 の場合は不明）
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    std::string symbol;
+};
+
+// EAから渡される約定（TRADE_TRANSACTION_DEAL_ADD）
+struct DealFill {
+    uint64_t deal = 0;
+    uint64_t order = 0;
+    uint64_t position = 0;
+    double price = 0.0;
+    double volume = 0.0;
+    double profit = 0.0;
+    std::string symbol;
+};
+
+// 突き合わせが完了した発注
+struct CompletedTrade {
+    enum class Outcome {
+        Filled,
+        Rejected
+    };
+
+    Outcome outcome = Outcome::Filled;
+    TradeSubmission submission;
+    uint64_t positionTicket = 0;
+    double fillPrice = 0.0;             // 約定の出来高加重平均価格
+    double filledVolume = 0.0;
+    double profit = 0.0;                // 決済約定の損益合計
+    double slippagePoints = 0.0;        // 気配値からの不利方向のずれ（ポイント、正が不利）
+    long long fillLatencyUs = -1;       // コマンド受信 → 約定（不明な場合は -1）
+    long long submitToFillUs = -1;      // 発注 → 約定
+    long long submittedAtUs = 0;
+    long long filledAtUs = 0;
+};
+
+// 発注結果と約定通知をコマンドに突き合わせ、実約定価格・スリッページ・約定遅延を求める
+// request_id / 注文チケットのどちらが先に判明しても対応できるよう、両方をキーとして照合する。
+// 発注結果より先に届いた約定は一時保持し、対応する発注結果の登録時に適用する
+class TradeCorrelator {
+public:
+    // 未約定のまま保持する最大時間（これを超えた発注・約定は破棄）
+    static const long long kMaxPendingUs = 60LL * 1000 * 1000;
+    // 保留する約定の最大件数（手動発注・コピー取引などの対象外の約定が集中した場合は古いものから破棄）
+    static const size_t kMaxOrphanDeals = 256;
+
+    void OnResult(const TradeSubmission& result, long long nowUs, std::vector<CompletedTrade>& completed);
+    void OnDeal(const DealFill& deal, long long nowUs, std::vector<CompletedTrade>& completed);
+
+    size_t PendingCount() const;
+
+    // 件数の上限で破棄した保留中の約定数
+    long long DroppedOrphanCount() const;
+
+    static bool IsSuccessRetcode(int retcode);
+
+private:
+    struct Pending {
+        TradeSubmission submission;
+        long long submittedAtUs = 0;
+        double filledVolume = 0.0;
+        double fillNotional = 0.0;
+        double profit = 0.0;
+        uint64_t positionTicket = 0;
+    };
+
+    struct OrphanDeal {
+        DealFill deal;
+        long long receivedAtUs = 0;
+    };
+
+    static const size_t kNotFound = static_cast<size_t>(-1);
+
+    size_t FindPending(uint32_t requestId, uint64_t order) const;
+    static void ApplyDeal(Pending& pending, const DealFill& deal);
+    bool TryComplete(size_t index, long long nowUs, std::vector<CompletedTrade>& completed);
+    void ApplyOrphans(long long nowUs, std::vector<CompletedTrade>& completed);
+    void DropStale(long long nowUs, std::vector<CompletedTrade>& completed);
+
+    static CompletedTrade MakeCompleted(const Pending& pending, CompletedTrade::Outcome outcome, long long nowUs);
+
+    std::vector<Pending> m_pending;
+    std::deque<OrphanDeal> m_orphans;
+    long long m_droppedOrphans = 0;
+    mutable std::mutex m_mutex;
+};
+
+#endif // TRADECORRELATOR_H
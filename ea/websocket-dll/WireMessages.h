@@ -0,0 +1,911 @@
+#pragma once
+
+#ifndef WIREMESSAGES_H
+#define WIREMESSAGES_H
+
+#include "MessageSchema.h"
+#include <string>
+#include <tuple>
+
+// Hedge System ⇔ EA 間のワイヤーフォーマット定義
+// ここに定義したスキーマから DLL のエンコーダー / デコーダーと
+// packages/shared-types/src/websocket-frames.generated.ts（tools/SchemaTsGen）が生成される。
+// キー名は camelCase に統一し、旧名は別名として受信時のみ受け付ける。
+
+// ---------------------------------------------------------------------------
+// サーバー → EA
+// ---------------------------------------------------------------------------
+
+struct CommandMetadataFrame {
+    static constexpr const char* kTsName = "CommandMetadataFrame";
+
+    std::string timestamp;
+    long long ttlMs = 0;
+    std::string executeAt;             // 実行予定時刻（ISO 8601、サーバー時刻）
+    std::string executionType;
+    std::string strategyId;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("timestamp", &CommandMetadataFrame::timestamp),
+        schema::MakeOptionalField("ttlMs", &CommandMetadataFrame::ttlMs),
+        schema::MakeOptionalField("executeAt", &CommandMetadataFrame::executeAt),
+        schema::MakeOptionalField("executionType", &CommandMetadataFrame::executionType),
+        schema::MakeOptionalField("strategyId", &CommandMetadataFrame::strategyId));
+};
+
+// OPEN に添える対のレッグ（主レッグの約定後、対象口座が同じ端末ならDLLが直接EAへ渡す）
+struct PairedLegFrame {
+    static constexpr const char* kTsName = "PairedLegFrame";
+
+    std::string commandId;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    std::string symbol;
+    std::string side;
+    double volume = 0.0;
+    long long ttlMs = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeOptionalField("commandId", &PairedLegFrame::commandId),
+        schema::MakeField("accountId", &PairedLegFrame::accountId),
+        schema::MakeField("positionId", &PairedLegFrame::positionId),
+        schema::MakeOptionalField("actionId", &PairedLegFrame::actionId),
+        schema::MakeField("symbol", &PairedLegFrame::symbol),
+        schema::MakeField("side", &PairedLegFrame::side),
+        schema::MakeField("volume", &PairedLegFrame::volume),
+        schema::MakeOptionalField("ttlMs", &PairedLegFrame::ttlMs));
+};
+
+// OPEN / CLOSE / MODIFY コマンド（レガシーの {"type":"command","command":"open"} も同じスキーマで受ける）
+struct CommandFrame {
+    static constexpr const char* kTsName = "CommandFrame";
+    static constexpr const char* kTypeLiteral = "'OPEN' | 'CLOSE' | 'MODIFY'";
+
+    std::string type;
+    std::string command;
+    std::string commandId;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    std::string symbol;
+    std::string side;
+    double volume = 0.0;
+    double trailWidth = 0.0;
+    long long ticket = 0;              // MODIFY: 対象チケット（positionId の代わりに指定可）
+    schema::FixedPrice stopLoss;       // MODIFY: 新しいSL（0 で解除、未指定なら現状維持）
+    schema::FixedPrice takeProfit;     // MODIFY: 新しいTP（0 で解除、未指定なら現状維持）
+    long long ttlMs = 0;
+    std::string executeAt;             // 実行予定時刻（ISO 8601、サーバー時刻。metadata.executeAt が優先）
+    std::string timestamp;
+    CommandMetadataFrame metadata;
+    PairedLegFrame pairedLeg;          // OPEN: 約定後に続けて発注する対のレッグ
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &CommandFrame::type, "event"),
+        schema::MakeOptionalField("command", &CommandFrame::command, "action"),
+        schema::MakeOptionalField("commandId", &CommandFrame::commandId),
+        schema::MakeField("accountId", &CommandFrame::accountId, "account_id"),
+        schema::MakeField("positionId", &CommandFrame::positionId, "position_id"),
+        schema::MakeOptionalField("actionId", &CommandFrame::actionId, "action_id"),
+        schema::MakeOptionalField("symbol", &CommandFrame::symbol),
+        schema::MakeOptionalField("side", &CommandFrame::side),
+        schema::MakeOptionalField("volume", &CommandFrame::volume),
+        schema::MakeOptionalField("trailWidth", &CommandFrame::trailWidth),
+        schema::MakeOptionalField("ticket", &CommandFrame::ticket, "mtTicket"),
+        schema::MakeOptionalField("stopLoss", &CommandFrame::stopLoss, "sl"),
+        schema::MakeOptionalField("takeProfit", &CommandFrame::takeProfit, "tp"),
+        schema::MakeOptionalField("ttlMs", &CommandFrame::ttlMs),
+        schema::MakeOptionalField("executeAt", &CommandFrame::executeAt),
+        schema::MakeField("timestamp", &CommandFrame::timestamp),
+        schema::MakeOptionalField("metadata", &CommandFrame::metadata),
+        schema::MakeOptionalField("pairedLeg", &CommandFrame::pairedLeg));
+};
+
+struct ResendFromFrame {
+    static constexpr const char* kTsName = "ResendFromFrame";
+    static constexpr const char* kTypeLiteral = "'RESEND_FROM'";
+
+    std::string type = "RESEND_FROM";
+    long long seq = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &ResendFromFrame::type),
+        schema::MakeField("seq", &ResendFromFrame::seq, "fromSeq"));
+};
+
+// 価格アラートの登録（同じ alertId は置き換え。direction 省略時は現在値との比較で決める）
+struct PriceAlertSetFrame {
+    static constexpr const char* kTsName = "PriceAlertSetFrame";
+    static constexpr const char* kTypeLiteral = "'PRICE_ALERT_SET'";
+
+    std::string type;
+    std::string alertId;
+    std::string symbol;
+    schema::FixedPrice level;
+    std::string direction;             // "ABOVE" | "BELOW"
+    std::string timestamp;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &PriceAlertSetFrame::type),
+        schema::MakeField("alertId", &PriceAlertSetFrame::alertId),
+        schema::MakeField("symbol", &PriceAlertSetFrame::symbol),
+        schema::MakeField("level", &PriceAlertSetFrame::level),
+        schema::MakeOptionalField("direction", &PriceAlertSetFrame::direction),
+        schema::MakeOptionalField("timestamp", &PriceAlertSetFrame::timestamp));
+};
+
+struct PriceAlertCancelFrame {
+    static constexpr const char* kTsName = "PriceAlertCancelFrame";
+    static constexpr const char* kTypeLiteral = "'PRICE_ALERT_CANCEL'";
+
+    std::string type;
+    std::string alertId;
+    std::string timestamp;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &PriceAlertCancelFrame::type),
+        schema::MakeField("alertId", &PriceAlertCancelFrame::alertId),
+        schema::MakeOptionalField("timestamp", &PriceAlertCancelFrame::timestamp));
+};
+
+// 他の口座の気配（サーバーが各EAの PRICE_UPDATE を口座IDつきで中継したもの。統合気配に入れる）
+struct PriceUpdateFrame {
+    static constexpr const char* kTsName = "PriceUpdateFrame";
+    static constexpr const char* kTypeLiteral = "'PRICE_UPDATE'";
+
+    std::string type;
+    std::string accountId;             // 気配の提供元の口座
+    std::string symbol;
+    double bid = 0.0;
+    double ask = 0.0;
+    long long timeMsc = 0;             // ブローカー側のティック時刻（省略時は受信順で扱う）
+    std::string timestamp;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &PriceUpdateFrame::type, "event"),
+        schema::MakeField("accountId", &PriceUpdateFrame::accountId),
+        schema::MakeField("symbol", &PriceUpdateFrame::symbol),
+        schema::MakeField("bid", &PriceUpdateFrame::bid),
+        schema::MakeField("ask", &PriceUpdateFrame::ask),
+        schema::MakeOptionalField("timeMsc", &PriceUpdateFrame::timeMsc),
+        schema::MakeOptionalField("timestamp", &PriceUpdateFrame::timestamp));
+};
+
+// ---------------------------------------------------------------------------
+// EA → サーバー
+// ---------------------------------------------------------------------------
+
+// 接続ごとの最初のフレーム（lastSeq が 0 なら未送信。サーバーの受信済みより小さければ DLL が再起動した）
+struct StreamResumeFrame {
+    static constexpr const char* kTsName = "StreamResumeFrame";
+    static constexpr const char* kTypeLiteral = "'STREAM_RESUME'";
+
+    std::string type = "STREAM_RESUME";
+    std::string accountId;             // 送信元の口座（直接接続の接続と口座の対応づけ）
+    long long oldestSeq = 0;
+    long long lastSeq = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &StreamResumeFrame::type),
+        schema::MakeField("accountId", &StreamResumeFrame::accountId),
+        schema::MakeField("oldestSeq", &StreamResumeFrame::oldestSeq),
+        schema::MakeField("lastSeq", &StreamResumeFrame::lastSeq));
+};
+
+struct ResendUnavailableFrame {
+    static constexpr const char* kTsName = "ResendUnavailableFrame";
+    static constexpr const char* kTypeLiteral = "'RESEND_UNAVAILABLE'";
+
+    std::string type = "RESEND_UNAVAILABLE";
+    long long requestedSeq = 0;
+    long long oldestSeq = 0;
+    long long lastSeq = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &ResendUnavailableFrame::type),
+        schema::MakeField("requestedSeq", &ResendUnavailableFrame::requestedSeq),
+        schema::MakeField("oldestSeq", &ResendUnavailableFrame::oldestSeq),
+        schema::MakeField("lastSeq", &ResendUnavailableFrame::lastSeq));
+};
+
+struct CommandAckFrame {
+    static constexpr const char* kTsName = "CommandAckFrame";
+    static constexpr const char* kTypeLiteral = "'COMMAND_ACK'";
+
+    std::string type = "COMMAND_ACK";
+    std::string timestamp;
+    std::string commandType;
+    std::string commandId;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    std::string commandTimestamp;
+    long long receivedAtUs = 0;
+    long long queueDepth = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &CommandAckFrame::type),
+        schema::MakeField("timestamp", &CommandAckFrame::timestamp),
+        schema::MakeField("commandType", &CommandAckFrame::commandType),
+        schema::MakeOptionalField("commandId", &CommandAckFrame::commandId),
+        schema::MakeField("accountId", &CommandAckFrame::accountId),
+        schema::MakeField("positionId", &CommandAckFrame::positionId),
+        schema::MakeField("actionId", &CommandAckFrame::actionId),
+        schema::MakeOptionalField("commandTimestamp", &CommandAckFrame::commandTimestamp),
+        schema::MakeField("receivedAtUs", &CommandAckFrame::receivedAtUs),
+        schema::MakeField("queueDepth", &CommandAckFrame::queueDepth));
+};
+
+struct CommandExpiredFrame {
+    static constexpr const char* kTsName = "CommandExpiredFrame";
+    static constexpr const char* kTypeLiteral = "'COMMAND_EXPIRED'";
+
+    std::string type = "COMMAND_EXPIRED";
+    std::string timestamp;
+    std::string commandType;
+    std::string commandId;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    std::string commandTimestamp;
+    long long ageMs = 0;
+    long long ttlMs = 0;
+    std::string stage;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &CommandExpiredFrame::type),
+        schema::MakeField("timestamp", &CommandExpiredFrame::timestamp),
+        schema::MakeField("commandType", &CommandExpiredFrame::commandType),
+        schema::MakeOptionalField("commandId", &CommandExpiredFrame::commandId),
+        schema::MakeField("accountId", &CommandExpiredFrame::accountId),
+        schema::MakeField("positionId", &CommandExpiredFrame::positionId),
+        schema::MakeField("actionId", &CommandExpiredFrame::actionId),
+        schema::MakeOptionalField("commandTimestamp", &CommandExpiredFrame::commandTimestamp),
+        schema::MakeField("ageMs", &CommandExpiredFrame::ageMs),
+        schema::MakeField("ttlMs", &CommandExpiredFrame::ttlMs),
+        schema::MakeField("stage", &CommandExpiredFrame::stage));
+};
+
+// 発注前リスクチェックで破棄した OPEN の通知（EAには渡さない）
+struct CommandRejectedFrame {
+    static constexpr const char* kTsName = "CommandRejectedFrame";
+    static constexpr const char* kTypeLiteral = "'COMMAND_REJECTED'";
+
+    std::string type = "COMMAND_REJECTED";
+    std::string timestamp;
+    std::string commandType;
+    std::string commandId;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    std::string symbol;
+    double volume = 0.0;
+    std::string reason;                // "INVALID_ORDER" | "INVALID_VOLUME" | "MAX_LOT" | "SYMBOL_EXPOSURE" | "ACCOUNT_EXPOSURE" | "ORDER_RATE" | "MARGIN_HEADROOM"
+    double limit = 0.0;                // 超えた上限
+    double value = 0.0;                // 発注後の値
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &CommandRejectedFrame::type),
+        schema::MakeField("timestamp", &CommandRejectedFrame::timestamp),
+        schema::MakeField("commandType", &CommandRejectedFrame::commandType),
+        schema::MakeOptionalField("commandId", &CommandRejectedFrame::commandId),
+        schema::MakeField("accountId", &CommandRejectedFrame::accountId),
+        schema::MakeField("positionId", &CommandRejectedFrame::positionId),
+        schema::MakeField("actionId", &CommandRejectedFrame::actionId),
+        schema::MakeField("symbol", &CommandRejectedFrame::symbol),
+        schema::MakeField("volume", &CommandRejectedFrame::volume),
+        schema::MakeField("reason", &CommandRejectedFrame::reason),
+        schema::MakeField("limit", &CommandRejectedFrame::limit),
+        schema::MakeField("value", &CommandRejectedFrame::value));
+};
+
+// 実行予定時刻つきコマンドをEAに渡した時点の通知（複数口座の同時実行の揃い具合の確認用）
+struct CommandReleasedFrame {
+    static constexpr const char* kTsName = "CommandReleasedFrame";
+    static constexpr const char* kTypeLiteral = "'COMMAND_RELEASED'";
+
+    std::string type = "COMMAND_RELEASED";
+    std::string timestamp;
+    std::string commandType;
+    std::string commandId;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    std::string executeAt;             // 指定された実行予定時刻（サーバー時刻）
+    std::string releasedAt;            // EAに渡した時刻（サーバー時刻に換算）
+    long long skewUs = 0;              // 渡した時刻 - 実行予定時刻（マイクロ秒、正なら遅れ）
+    long long clockOffsetUs = 0;       // 換算に使ったクロックスキュー推定値（ローカル - サーバー）
+    long long scheduledUs = 0;         // 受信から渡すまでの保留時間（マイクロ秒）
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &CommandReleasedFrame::type),
+        schema::MakeField("timestamp", &CommandReleasedFrame::timestamp),
+        schema::MakeField("commandType", &CommandReleasedFrame::commandType),
+        schema::MakeOptionalField("commandId", &CommandReleasedFrame::commandId),
+        schema::MakeField("accountId", &CommandReleasedFrame::accountId),
+        schema::MakeField("positionId", &CommandReleasedFrame::positionId),
+        schema::MakeField("actionId", &CommandReleasedFrame::actionId),
+        schema::MakeField("executeAt", &CommandReleasedFrame::executeAt),
+        schema::MakeField("releasedAt", &CommandReleasedFrame::releasedAt),
+        schema::MakeField("skewUs", &CommandReleasedFrame::skewUs),
+        schema::MakeField("clockOffsetUs", &CommandReleasedFrame::clockOffsetUs),
+        schema::MakeField("scheduledUs", &CommandReleasedFrame::scheduledUs));
+};
+
+// 対のレッグの扱いの通知（主レッグの OPENED の直後に送信）
+struct LegDispatchedFrame {
+    static constexpr const char* kTsName = "LegDispatchedFrame";
+    static constexpr const char* kTypeLiteral = "'LEG_DISPATCHED'";
+
+    std::string type = "LEG_DISPATCHED";
+    std::string timestamp;
+    std::string accountId;             // 主レッグ
+    std::string positionId;
+    std::string actionId;
+    std::string route;                 // "LOCAL" | "PEER" | "UPSTREAM" | "REJECTED" | "CANCELLED"
+    std::string reason;                // UPSTREAM / CANCELLED の理由（"NOT_LOCAL" | "PEER_BUSY" | "PRIMARY_REJECTED" | "PRIMARY_TIMEOUT"）
+    long long dispatchUs = 0;          // 主レッグの約定処理から対のレッグをキューに入れるまで（LOCAL / PEER のみ）
+    PairedLegFrame leg;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &LegDispatchedFrame::type),
+        schema::MakeField("timestamp", &LegDispatchedFrame::timestamp),
+        schema::MakeField("accountId", &LegDispatchedFrame::accountId),
+        schema::MakeField("positionId", &LegDispatchedFrame::positionId),
+        schema::MakeField("actionId", &LegDispatchedFrame::actionId),
+        schema::MakeField("route", &LegDispatchedFrame::route),
+        schema::MakeOptionalField("reason", &LegDispatchedFrame::reason),
+        schema::MakeField("dispatchUs", &LegDispatchedFrame::dispatchUs),
+        schema::MakeField("leg", &LegDispatchedFrame::leg));
+};
+
+struct OpenedEventFrame {
+    static constexpr const char* kTsName = "OpenedEventFrame";
+    static constexpr const char* kTypeLiteral = "'OPENED'";
+
+    std::string type = "OPENED";
+    std::string timestamp;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    long long orderId = 0;
+    double price = 0.0;
+    std::string time;
+    std::string mtTicket;
+    // DLLでの約定突き合わせ結果（WSOnTradeResult / WSOnTradeTransaction）
+    std::string symbol;
+    double volume = 0.0;
+    double requestedPrice = 0.0;
+    double slippagePoints = 0.0;
+    long long fillLatencyUs = 0;
+    long long submitToFillUs = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &OpenedEventFrame::type, "event"),
+        schema::MakeField("timestamp", &OpenedEventFrame::timestamp),
+        schema::MakeField("accountId", &OpenedEventFrame::accountId, "account_id"),
+        schema::MakeField("positionId", &OpenedEventFrame::positionId),
+        schema::MakeOptionalField("actionId", &OpenedEventFrame::actionId),
+        schema::MakeField("orderId", &OpenedEventFrame::orderId),
+        schema::MakeField("price", &OpenedEventFrame::price),
+        schema::MakeField("time", &OpenedEventFrame::time),
+        schema::MakeOptionalField("mtTicket", &OpenedEventFrame::mtTicket),
+        schema::MakeOptionalField("symbol", &OpenedEventFrame::symbol),
+        schema::MakeOptionalField("volume", &OpenedEventFrame::volume),
+        schema::MakeOptionalField("requestedPrice", &OpenedEventFrame::requestedPrice),
+        schema::MakeOptionalField("slippagePoints", &OpenedEventFrame::slippagePoints),
+        schema::MakeOptionalField("fillLatencyUs", &OpenedEventFrame::fillLatencyUs),
+        schema::MakeOptionalField("submitToFillUs", &OpenedEventFrame::submitToFillUs));
+};
+
+struct ClosedEventFrame {
+    static constexpr const char* kTsName = "ClosedEventFrame";
+    static constexpr const char* kTypeLiteral = "'CLOSED'";
+
+    std::string type = "CLOSED";
+    std::string timestamp;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    double price = 0.0;
+    double profit = 0.0;
+    std::string time;
+    std::string mtTicket;
+    // DLLでの約定突き合わせ結果（WSOnTradeResult / WSOnTradeTransaction）
+    std::string symbol;
+    double volume = 0.0;
+    double requestedPrice = 0.0;
+    double slippagePoints = 0.0;
+    long long fillLatencyUs = 0;
+    long long submitToFillUs = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &ClosedEventFrame::type, "event"),
+        schema::MakeField("timestamp", &ClosedEventFrame::timestamp),
+        schema::MakeField("accountId", &ClosedEventFrame::accountId, "account_id"),
+        schema::MakeField("positionId", &ClosedEventFrame::positionId),
+        schema::MakeOptionalField("actionId", &ClosedEventFrame::actionId),
+        schema::MakeField("price", &ClosedEventFrame::price),
+        schema::MakeField("profit", &ClosedEventFrame::profit),
+        schema::MakeField("time", &ClosedEventFrame::time),
+        schema::MakeOptionalField("mtTicket", &ClosedEventFrame::mtTicket),
+        schema::MakeOptionalField("symbol", &ClosedEventFrame::symbol),
+        schema::MakeOptionalField("volume", &ClosedEventFrame::volume),
+        schema::MakeOptionalField("requestedPrice", &ClosedEventFrame::requestedPrice),
+        schema::MakeOptionalField("slippagePoints", &ClosedEventFrame::slippagePoints),
+        schema::MakeOptionalField("fillLatencyUs", &ClosedEventFrame::fillLatencyUs),
+        schema::MakeOptionalField("submitToFillUs", &ClosedEventFrame::submitToFillUs));
+};
+
+struct StoppedEventFrame {
+    static constexpr const char* kTsName = "StoppedEventFrame";
+    static constexpr const char* kTypeLiteral = "'STOPPED'";
+
+    std::string type = "STOPPED";
+    std::string timestamp;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    double price = 0.0;
+    std::string time;
+    std::string reason;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &StoppedEventFrame::type, "event"),
+        schema::MakeField("timestamp", &StoppedEventFrame::timestamp),
+        schema::MakeField("accountId", &StoppedEventFrame::accountId, "account_id"),
+        schema::MakeField("positionId", &StoppedEventFrame::positionId),
+        schema::MakeOptionalField("actionId", &StoppedEventFrame::actionId),
+        schema::MakeField("price", &StoppedEventFrame::price),
+        schema::MakeField("time", &StoppedEventFrame::time),
+        schema::MakeField("reason", &StoppedEventFrame::reason));
+};
+
+struct ErrorEventFrame {
+    static constexpr const char* kTsName = "ErrorEventFrame";
+    static constexpr const char* kTypeLiteral = "'ERROR'";
+
+    std::string type = "ERROR";
+    std::string timestamp;
+    std::string accountId;
+    std::string positionId;
+    std::string actionId;
+    std::string message;
+    std::string errorCode;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &ErrorEventFrame::type),
+        schema::MakeField("timestamp", &ErrorEventFrame::timestamp),
+        schema::MakeOptionalField("accountId", &ErrorEventFrame::accountId),
+        schema::MakeOptionalField("positionId", &ErrorEventFrame::positionId),
+        schema::MakeOptionalField("actionId", &ErrorEventFrame::actionId),
+        schema::MakeField("message", &ErrorEventFrame::message),
+        schema::MakeOptionalField("errorCode", &ErrorEventFrame::errorCode));
+};
+
+// 約定品質の区間集計（口座 × 通貨ペアごと、symbol 省略時は口座全体）
+struct ExecutionStatsFrame {
+    static constexpr const char* kTsName = "ExecutionStatsFrame";
+    static constexpr const char* kTypeLiteral = "'EXECUTION_STATS'";
+
+    std::string type = "EXECUTION_STATS";
+    std::string timestamp;
+    std::string accountId;
+    std::string symbol;
+    long long intervalMs = 0;
+    long long fills = 0;
+    long long rejects = 0;
+    double rejectRate = 0.0;
+    double slippageMean = 0.0;         // ポイント（正が不利方向）
+    double slippageP50 = 0.0;
+    double slippageP90 = 0.0;
+    double slippageP99 = 0.0;
+    double slippageMax = 0.0;
+    long long latencyP50Us = 0;        // 発注 → 約定
+    long long latencyP90Us = 0;
+    long long latencyP99Us = 0;
+    long long latencyMaxUs = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &ExecutionStatsFrame::type),
+        schema::MakeField("timestamp", &ExecutionStatsFrame::timestamp),
+        schema::MakeField("accountId", &ExecutionStatsFrame::accountId),
+        schema::MakeOptionalField("symbol", &ExecutionStatsFrame::symbol),
+        schema::MakeField("intervalMs", &ExecutionStatsFrame::intervalMs),
+        schema::MakeField("fills", &ExecutionStatsFrame::fills),
+        schema::MakeField("rejects", &ExecutionStatsFrame::rejects),
+        schema::MakeField("rejectRate", &ExecutionStatsFrame::rejectRate),
+        schema::MakeField("slippageMean", &ExecutionStatsFrame::slippageMean),
+        schema::MakeField("slippageP50", &ExecutionStatsFrame::slippageP50),
+        schema::MakeField("slippageP90", &ExecutionStatsFrame::slippageP90),
+        schema::MakeField("slippageP99", &ExecutionStatsFrame::slippageP99),
+        schema::MakeField("slippageMax", &ExecutionStatsFrame::slippageMax),
+        schema::MakeField("latencyP50Us", &ExecutionStatsFrame::latencyP50Us),
+        schema::MakeField("latencyP90Us", &ExecutionStatsFrame::latencyP90Us),
+        schema::MakeField("latencyP99Us", &ExecutionStatsFrame::latencyP99Us),
+        schema::MakeField("latencyMaxUs", &ExecutionStatsFrame::latencyMaxUs));
+};
+
+// 通貨ペアごとの価格統計（直近 1024 ティック）。生の価格履歴の代わりに定期送信する
+struct PriceStatsFrame {
+    static constexpr const char* kTsName = "PriceStatsFrame";
+    static constexpr const char* kTypeLiteral = "'PRICE_STATS'";
+
+    std::string type = "PRICE_STATS";
+    std::string timestamp;
+    std::string symbol;
+    long long ticks = 0;
+    double bid = 0.0;
+    double ask = 0.0;
+    double ewma = 0.0;
+    double mean = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double spreadMean = 0.0;           // 価格単位
+    double spreadMin = 0.0;
+    double spreadMax = 0.0;
+    double volatility = 0.0;           // ティック対数リターンの標準偏差
+    double shortVolatility = 0.0;      // 直近16ティックの同上
+    double tickRate = 0.0;             // ティック / 秒
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &PriceStatsFrame::type),
+        schema::MakeField("timestamp", &PriceStatsFrame::timestamp),
+        schema::MakeField("symbol", &PriceStatsFrame::symbol),
+        schema::MakeField("ticks", &PriceStatsFrame::ticks),
+        schema::MakeField("bid", &PriceStatsFrame::bid),
+        schema::MakeField("ask", &PriceStatsFrame::ask),
+        schema::MakeField("ewma", &PriceStatsFrame::ewma),
+        schema::MakeField("mean", &PriceStatsFrame::mean),
+        schema::MakeField("high", &PriceStatsFrame::high),
+        schema::MakeField("low", &PriceStatsFrame::low),
+        schema::MakeField("spreadMean", &PriceStatsFrame::spreadMean),
+        schema::MakeField("spreadMin", &PriceStatsFrame::spreadMin),
+        schema::MakeField("spreadMax", &PriceStatsFrame::spreadMax),
+        schema::MakeField("volatility", &PriceStatsFrame::volatility),
+        schema::MakeField("shortVolatility", &PriceStatsFrame::shortVolatility),
+        schema::MakeField("tickRate", &PriceStatsFrame::tickRate));
+};
+
+// 価格アラートの発火（水準に到達したティックでのみ送信）
+struct PriceAlertFrame {
+    static constexpr const char* kTsName = "PriceAlertFrame";
+    static constexpr const char* kTypeLiteral = "'PRICE_ALERT'";
+
+    std::string type = "PRICE_ALERT";
+    std::string timestamp;
+    std::string alertId;
+    std::string symbol;
+    std::string direction;             // "ABOVE" | "BELOW"
+    schema::FixedPrice level;
+    schema::FixedPrice price;          // 発火させたティックの bid
+    long long tickTimeMsc = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &PriceAlertFrame::type),
+        schema::MakeField("timestamp", &PriceAlertFrame::timestamp),
+        schema::MakeField("alertId", &PriceAlertFrame::alertId),
+        schema::MakeField("symbol", &PriceAlertFrame::symbol),
+        schema::MakeField("direction", &PriceAlertFrame::direction),
+        schema::MakeField("level", &PriceAlertFrame::level),
+        schema::MakeField("price", &PriceAlertFrame::price),
+        schema::MakeOptionalField("tickTimeMsc", &PriceAlertFrame::tickTimeMsc));
+};
+
+// 口座間スプレッドの機会（正味スプレッドが entry 以上で持続したとき OPEN、exit を下回ったとき CLOSED を1回ずつ送信）
+struct OpportunityFrame {
+    static constexpr const char* kTsName = "OpportunityFrame";
+    static constexpr const char* kTypeLiteral = "'OPPORTUNITY'";
+
+    std::string type = "OPPORTUNITY";
+    std::string timestamp;
+    std::string state;                 // "OPEN" | "CLOSED"
+    std::string symbol;
+    std::string sellAccountId;         // 売る口座（bid が高い側）
+    std::string buyAccountId;          // 買う口座（ask が安い側）
+    double sellBid = 0.0;
+    double buyAsk = 0.0;
+    double grossSpread = 0.0;          // sellBid - buyAsk
+    double netSpread = 0.0;            // 手数料・スワップ控除後
+    double peakNetSpread = 0.0;
+    double threshold = 0.0;            // 越えた閾値（OPEN は entry、CLOSED は exit）
+    long long durationMs = 0;          // entry を越えてからの経過時間
+    long long sequence = 0;            // 送信元の DLL での通番（DLLの起動時刻から増える。組ごとにこれより小さい通知は古い）
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &OpportunityFrame::type),
+        schema::MakeField("timestamp", &OpportunityFrame::timestamp),
+        schema::MakeField("state", &OpportunityFrame::state),
+        schema::MakeField("symbol", &OpportunityFrame::symbol),
+        schema::MakeField("sellAccountId", &OpportunityFrame::sellAccountId),
+        schema::MakeField("buyAccountId", &OpportunityFrame::buyAccountId),
+        schema::MakeField("sellBid", &OpportunityFrame::sellBid),
+        schema::MakeField("buyAsk", &OpportunityFrame::buyAsk),
+        schema::MakeField("grossSpread", &OpportunityFrame::grossSpread),
+        schema::MakeField("netSpread", &OpportunityFrame::netSpread),
+        schema::MakeField("peakNetSpread", &OpportunityFrame::peakNetSpread),
+        schema::MakeField("threshold", &OpportunityFrame::threshold),
+        schema::MakeField("durationMs", &OpportunityFrame::durationMs),
+        schema::MakeField("sequence", &OpportunityFrame::sequence));
+};
+
+// 証拠金維持率の段階の変化（水準を下回った時点で送信、回復時も送信）
+struct MarginWarningFrame {
+    static constexpr const char* kTsName = "MarginWarningFrame";
+    static constexpr const char* kTypeLiteral = "'MARGIN_WARNING'";
+
+    std::string type = "MARGIN_WARNING";
+    std::string timestamp;
+    std::string accountId;
+    std::string severity;              // "NORMAL" | "WARNING" | "CRITICAL" | "MARGIN_CALL" | "STOP_OUT"
+    std::string previousSeverity;
+    double marginLevel = 0.0;          // %
+    double threshold = 0.0;            // 越えた水準（%）
+    double equity = 0.0;
+    double margin = 0.0;
+    double freeMargin = 0.0;
+    double stopOutLevel = 0.0;
+    double equityToStopOut = 0.0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &MarginWarningFrame::type),
+        schema::MakeField("timestamp", &MarginWarningFrame::timestamp),
+        schema::MakeField("accountId", &MarginWarningFrame::accountId),
+        schema::MakeField("severity", &MarginWarningFrame::severity),
+        schema::MakeField("previousSeverity", &MarginWarningFrame::previousSeverity),
+        schema::MakeField("marginLevel", &MarginWarningFrame::marginLevel),
+        schema::MakeField("threshold", &MarginWarningFrame::threshold),
+        schema::MakeField("equity", &MarginWarningFrame::equity),
+        schema::MakeField("margin", &MarginWarningFrame::margin),
+        schema::MakeField("freeMargin", &MarginWarningFrame::freeMargin),
+        schema::MakeField("stopOutLevel", &MarginWarningFrame::stopOutLevel),
+        schema::MakeField("equityToStopOut", &MarginWarningFrame::equityToStopOut));
+};
+
+// 通貨ペア仕様の共有（接続ごとに全件、以降は変化した通貨ペアのみ。specs には SymbolSpecEntryFrame を並べる）
+struct SymbolSpecsFrame {
+    static constexpr const char* kTsName = "SymbolSpecsFrame";
+    static constexpr const char* kTypeLiteral = "'SYMBOL_SPECS'";
+
+    std::string type = "SYMBOL_SPECS";
+    std::string timestamp;
+    std::string accountId;
+    long long version = 0;
+    bool full = false;                 // true: 全件（受信側は置き換え）, false: 差分
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &SymbolSpecsFrame::type),
+        schema::MakeField("timestamp", &SymbolSpecsFrame::timestamp),
+        schema::MakeField("accountId", &SymbolSpecsFrame::accountId),
+        schema::MakeField("version", &SymbolSpecsFrame::version),
+        schema::MakeField("full", &SymbolSpecsFrame::full));
+};
+
+struct SymbolSpecEntryFrame {
+    static constexpr const char* kTsName = "SymbolSpecEntryFrame";
+
+    std::string symbol;
+    long long digits = 0;
+    double point = 0.0;
+    double tickSize = 0.0;
+    double tickValue = 0.0;
+    double contractSize = 0.0;
+    double volumeMin = 0.0;
+    double volumeStep = 0.0;
+    double volumeMax = 0.0;
+    double marginPerLot = 0.0;
+    double marginHedged = 0.0;
+    std::string baseCurrency;
+    std::string profitCurrency;
+    std::string marginCurrency;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("symbol", &SymbolSpecEntryFrame::symbol),
+        schema::MakeField("digits", &SymbolSpecEntryFrame::digits),
+        schema::MakeField("point", &SymbolSpecEntryFrame::point),
+        schema::MakeField("tickSize", &SymbolSpecEntryFrame::tickSize),
+        schema::MakeField("tickValue", &SymbolSpecEntryFrame::tickValue),
+        schema::MakeField("contractSize", &SymbolSpecEntryFrame::contractSize),
+        schema::MakeField("volumeMin", &SymbolSpecEntryFrame::volumeMin),
+        schema::MakeField("volumeStep", &SymbolSpecEntryFrame::volumeStep),
+        schema::MakeField("volumeMax", &SymbolSpecEntryFrame::volumeMax),
+        schema::MakeField("marginPerLot", &SymbolSpecEntryFrame::marginPerLot),
+        schema::MakeField("marginHedged", &SymbolSpecEntryFrame::marginHedged),
+        schema::MakeOptionalField("baseCurrency", &SymbolSpecEntryFrame::baseCurrency),
+        schema::MakeOptionalField("profitCurrency", &SymbolSpecEntryFrame::profitCurrency),
+        schema::MakeOptionalField("marginCurrency", &SymbolSpecEntryFrame::marginCurrency));
+};
+
+// ハートビートの exposure フィールド（口座全体。symbols には ExposureSymbolFrame を並べる）
+struct ExposureSummaryFrame {
+    static constexpr const char* kTsName = "ExposureSummaryFrame";
+
+    double grossVolume = 0.0;          // Σ(買い + 売り) ロット
+    double netVolume = 0.0;            // Σ|買い - 売り| ロット
+    double hedgeRatio = 1.0;           // 1 - netVolume / grossVolume
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("grossVolume", &ExposureSummaryFrame::grossVolume),
+        schema::MakeField("netVolume", &ExposureSummaryFrame::netVolume),
+        schema::MakeField("hedgeRatio", &ExposureSummaryFrame::hedgeRatio));
+};
+
+// 通貨ペアごとの保有量と想定元本（ロット × 建値）
+struct ExposureSymbolFrame {
+    static constexpr const char* kTsName = "ExposureSymbolFrame";
+
+    std::string symbol;
+    double longVolume = 0.0;
+    double shortVolume = 0.0;
+    double netVolume = 0.0;            // 買い - 売り（符号付き）
+    double longNotional = 0.0;
+    double shortNotional = 0.0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("symbol", &ExposureSymbolFrame::symbol),
+        schema::MakeField("longVolume", &ExposureSymbolFrame::longVolume),
+        schema::MakeField("shortVolume", &ExposureSymbolFrame::shortVolume),
+        schema::MakeField("netVolume", &ExposureSymbolFrame::netVolume),
+        schema::MakeField("longNotional", &ExposureSymbolFrame::longNotional),
+        schema::MakeField("shortNotional", &ExposureSymbolFrame::shortNotional));
+};
+
+// 評価損益の定期送信（前回送信以降に変化があった場合のみ。positions には PositionPnLFrame を並べる）
+struct PnLUpdateFrame {
+    static constexpr const char* kTsName = "PnLUpdateFrame";
+    static constexpr const char* kTypeLiteral = "'PNL_UPDATE'";
+
+    std::string type = "PNL_UPDATE";
+    std::string timestamp;
+    std::string accountId;
+    std::string currency;              // 口座通貨
+    double balance = 0.0;
+    double equity = 0.0;               // balance + credit + floatingPnl + swap + realized
+    double floatingPnl = 0.0;          // 口座通貨建ての評価損益の合計
+    double swap = 0.0;
+    long long unconverted = 0;         // 価格・換算レート不足で評価できないポジション数
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &PnLUpdateFrame::type),
+        schema::MakeField("timestamp", &PnLUpdateFrame::timestamp),
+        schema::MakeField("accountId", &PnLUpdateFrame::accountId),
+        schema::MakeField("currency", &PnLUpdateFrame::currency),
+        schema::MakeField("balance", &PnLUpdateFrame::balance),
+        schema::MakeField("equity", &PnLUpdateFrame::equity),
+        schema::MakeField("floatingPnl", &PnLUpdateFrame::floatingPnl),
+        schema::MakeField("swap", &PnLUpdateFrame::swap),
+        schema::MakeField("unconverted", &PnLUpdateFrame::unconverted));
+};
+
+// ポジションごとの評価損益（ticket は MT5 のポジションID）
+struct PositionPnLFrame {
+    static constexpr const char* kTsName = "PositionPnLFrame";
+
+    long long ticket = 0;
+    std::string symbol;
+    double volume = 0.0;
+    double currentPrice = 0.0;
+    double pnl = 0.0;                  // 口座通貨
+    double swap = 0.0;
+    bool converted = false;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("ticket", &PositionPnLFrame::ticket),
+        schema::MakeField("symbol", &PositionPnLFrame::symbol),
+        schema::MakeField("volume", &PositionPnLFrame::volume),
+        schema::MakeField("currentPrice", &PositionPnLFrame::currentPrice),
+        schema::MakeField("pnl", &PositionPnLFrame::pnl),
+        schema::MakeField("swap", &PositionPnLFrame::swap),
+        schema::MakeField("converted", &PositionPnLFrame::converted));
+};
+
+// ---------------------------------------------------------------------------
+// ゲートウェイ経由の接続（端末のDLLとゲートウェイの間のみ。上流には送らない）
+// ---------------------------------------------------------------------------
+
+// DLL → ゲートウェイ: 参加の通知（ゲートウェイは GATEWAY_STATUS を返す）
+struct GatewayHelloFrame {
+    static constexpr const char* kTsName = "GatewayHelloFrame";
+
+    std::string type = "GATEWAY_HELLO";
+    std::string accountId;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &GatewayHelloFrame::type),
+        schema::MakeField("accountId", &GatewayHelloFrame::accountId));
+};
+
+// ゲートウェイ → DLL: 上流との接続状態（変化時と GATEWAY_HELLO への応答）
+struct GatewayStatusFrame {
+    static constexpr const char* kTsName = "GatewayStatusFrame";
+
+    std::string type = "GATEWAY_STATUS";
+    bool connected = false;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &GatewayStatusFrame::type),
+        schema::MakeField("connected", &GatewayStatusFrame::connected));
+};
+
+// ゲートウェイ ⇔ 上流: 口座ごとのフレームの包み（message には元のフレームをそのまま入れる）
+struct AccountFrameHeader {
+    static constexpr const char* kTsName = "AccountFrameHeader";
+
+    std::string type = "ACCOUNT_FRAME";
+    std::string accountId;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("type", &AccountFrameHeader::type),
+        schema::MakeField("accountId", &AccountFrameHeader::accountId));
+};
+
+// 共有メモリバスの状態（WSGetSharedBusJson。participants には SharedBusParticipantFrame を並べる。上流には送らない）
+struct SharedBusStatusFrame {
+    static constexpr const char* kTsName = "SharedBusStatusFrame";
+
+    std::string accountId;             // この端末の参加口座（未参加なら空）
+    long long self = -1;               // 参加者番号
+    long long sent = 0;
+    long long received = 0;
+    long long dropped = 0;             // 相手の受信リングが満杯で送れなかった件数
+    long long peerTicks = 0;           // 受信済みの口座 × 通貨ペア数
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("accountId", &SharedBusStatusFrame::accountId),
+        schema::MakeField("self", &SharedBusStatusFrame::self),
+        schema::MakeField("sent", &SharedBusStatusFrame::sent),
+        schema::MakeField("received", &SharedBusStatusFrame::received),
+        schema::MakeField("dropped", &SharedBusStatusFrame::dropped),
+        schema::MakeField("peerTicks", &SharedBusStatusFrame::peerTicks));
+};
+
+// 共有メモリバスの参加者
+struct SharedBusParticipantFrame {
+    static constexpr const char* kTsName = "SharedBusParticipantFrame";
+
+    long long index = -1;
+    std::string accountId;
+    long long pid = 0;
+    long long heartbeatAgeMs = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("index", &SharedBusParticipantFrame::index),
+        schema::MakeField("accountId", &SharedBusParticipantFrame::accountId),
+        schema::MakeField("pid", &SharedBusParticipantFrame::pid),
+        schema::MakeField("heartbeatAgeMs", &SharedBusParticipantFrame::heartbeatAgeMs));
+};
+
+// TypeScript 生成対象のメッセージ一覧（ネストされるスキーマを先に並べる）
+using WireMessageRegistry = std::tuple<
+    CommandMetadataFrame,
+    PairedLegFrame,
+    CommandFrame,
+    ResendFromFrame,
+    PriceAlertSetFrame,
+    PriceAlertCancelFrame,
+    PriceUpdateFrame,
+    StreamResumeFrame,
+    ResendUnavailableFrame,
+    CommandAckFrame,
+    CommandExpiredFrame,
+    CommandRejectedFrame,
+    CommandReleasedFrame,
+    LegDispatchedFrame,
+    OpenedEventFrame,
+    ClosedEventFrame,
+    StoppedEventFrame,
+    ErrorEventFrame,
+    ExecutionStatsFrame,
+    PriceStatsFrame,
+    PriceAlertFrame,
+    OpportunityFrame,
+    MarginWarningFrame,
+    SymbolSpecsFrame,
+    SymbolSpecEntryFrame,
+    ExposureSummaryFrame,
+    ExposureSymbolFrame,
+    PnLUpdateFrame,
+    PositionPnLFrame>;
+
+#endif // WIREMESSAGES_H
@@ -0,0 +1,108 @@
+// 受信メッセージの種別判定コストのベンチマーク
+//
+//   substring : EA の旧実装（StringFind による全文部分一致の連鎖）相当
+//   extract   : DLL の旧 OnMessage 相当（timestamp の取得 + ExtractMessageType + 文字列比較の連鎖）
+//   dispatch  : ClassifyInbound（type / timestamp を1パスで取得 + コンパイル時完全ハッシュ）
+//   lookup    : LookupInboundKind 単体（種別文字列 → InboundKind）
+//   fields    : コマンドの各フィールドを FindJsonField で個別に走査する旧デコード相当
+//   decode    : DecodeCommand（スキーマによる1パスのデコード）
+//
+// 使い方: DispatchBench [反復回数]
+
+#include "../CommandDecoder.h"
+#include "../MessageDispatch.h"
+#include "../MessageUtils.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::vector<std::string> kMessages = {
+    R"({"type":"OPEN","timestamp":"2024-01-01T00:00:00.000Z","accountId":"account-123456","positionId":"position-abcdef","actionId":"action-0001","symbol":"USDJPY","side":"BUY","volume":0.10,"trailWidth":0,"metadata":{"executionType":"ENTRY","timestamp":"2024-01-01T00:00:00.000Z"}})",
+    R"({"type":"CLOSE","timestamp":"2024-01-01T00:00:00.000Z","accountId":"account-123456","positionId":"position-abcdef","actionId":"action-0002","metadata":{"executionType":"EXIT","timestamp":"2024-01-01T00:00:00.000Z"}})",
+    R"({"type":"command","action":"modify_position","accountId":"account-123456","positionId":"position-abcdef","ticket":123456,"sl":149.5,"tp":151.25,"timestamp":"2024-01-01T00:00:00.000Z"})",
+    R"({"type":"PONG","timestamp":"2024-01-01T00:00:00.000Z"})",
+    R"({"type":"MARKET_NEWS","timestamp":"2024-01-01T00:00:00.000Z","headline":"unrelated informational frame","items":[1,2,3,4,5,6,7,8]})",
+};
+
+int SubstringChain(const std::string& message) {
+    if (message.find("\"type\":\"OPEN\"") != std::string::npos) return 1;
+    if (message.find("\"type\":\"CLOSE\"") != std::string::npos) return 2;
+    if (message.find("\"type\":\"command\"") != std::string::npos &&
+        message.find("\"action\":\"modify_position\"") != std::string::npos) return 3;
+    if (message.find("\"type\":\"PONG\"") != std::string::npos) return 7;
+    return 0;
+}
+
+int ExtractChain(const std::string& message) {
+    std::string timestamp = GetJsonString(message, "timestamp");
+    std::string type = ExtractMessageType(message);
+    if (type == "OPEN") return 1;
+    if (type == "CLOSE") return 2;
+    if (type == "MODIFY") return 3;
+    if (type == "command") {
+        std::string action = GetJsonString(message, "action");
+        if (action == "modify_position") return 3;
+    }
+    if (type == "PONG") return 7;
+    return static_cast<int>(timestamp.size() & 0);
+}
+
+int Dispatch(const std::string& message) {
+    MessageEnvelope envelope;
+    return static_cast<int>(ClassifyInbound(message, envelope));
+}
+
+int Lookup(const std::string& message) {
+    static const std::vector<std::string> kTypes = {"OPEN", "CLOSE", "modify_position", "PONG", "MARKET_NEWS"};
+    return static_cast<int>(LookupInboundKind(kTypes[message.size() % kTypes.size()]));
+}
+
+int FieldByField(const std::string& message) {
+    DecodedCommand command;
+    command.commandId = GetJsonString(message, "commandId");
+    command.accountId = GetJsonString(message, "accountId");
+    command.positionId = GetJsonString(message, "positionId");
+    command.actionId = GetJsonString(message, "actionId");
+    command.symbol = GetJsonString(message, "symbol");
+    command.side = GetJsonString(message, "side");
+    GetJsonNumber(message, "volume", command.volume);
+    command.timestamp = GetJsonString(message, "timestamp");
+    double ttlMs = 0.0;
+    GetJsonNumber(message, "ttlMs", ttlMs);
+    return static_cast<int>(command.positionId.size());
+}
+
+int Decode(const std::string& message) {
+    DecodedCommand command;
+    DecodeCommand(message, command);
+    return static_cast<int>(command.positionId.size());
+}
+
+template <typename Function>
+void Run(const char* name, Function function, long iterations) {
+    volatile long sink = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) {
+        sink = sink + function(kMessages[static_cast<size_t>(i) % kMessages.size()]);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("%-10s %8.1f ns/msg\n", name, static_cast<double>(elapsed) / static_cast<double>(iterations));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 2000000;
+
+    Run("substring", SubstringChain, iterations);
+    Run("extract", ExtractChain, iterations);
+    Run("dispatch", Dispatch, iterations);
+    Run("lookup", Lookup, iterations);
+    Run("fields", FieldByField, iterations);
+    Run("decode", Decode, iterations);
+    return 0;
+}
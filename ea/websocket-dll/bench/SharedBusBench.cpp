@@ -0,0 +1,291 @@
+// 共有メモリバスの複数プロセス ベンチマーク（POSIX のみ）
+//
+// 参加者数ぶんのプロセスを fork し、それぞれを1つの端末（EA）に見立てて同じ共有メモリに参加させる。
+//   broadcast : 各プロセスが他の全プロセスへ連番つきメッセージを送り、受信側で片道遅延と欠落・重複・順序違いを数える
+//   pingpong  : プロセス0 → プロセス1 → プロセス0 の往復遅延
+// 欠落・重複・順序違いがあった場合は終了コード 1 を返す。
+//
+// 使い方: SharedBusBench [参加者数] [1プロセスあたりの送信数] [往復回数]
+
+#include "../HdrHistogram.h"
+#include "../SharedBus.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+
+int main() {
+    std::printf("SharedBusBench is POSIX only\n");
+    return 0;
+}
+
+#else
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+const char* kBusName = "HedgeSystemBusBench";
+const uint64_t kStopSeq = ~0ULL;
+
+struct BenchPayload {
+    uint64_t seq;
+    uint64_t sentNs;
+};
+
+// CLOCK_MONOTONIC はプロセス間で共通のため、片道遅延を直接測れる
+uint64_t NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+long long NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void PrintHistogram(const char* label, int self, const HdrHistogram& histogram) {
+    std::printf("  sim-%d %-10s n=%-9llu p50=%6lldns p99=%7lldns p99.9=%8lldns max=%9lldns\n", self, label,
+                static_cast<unsigned long long>(histogram.TotalCount()),
+                static_cast<long long>(histogram.ValueAtPercentile(50.0)),
+                static_cast<long long>(histogram.ValueAtPercentile(99.0)),
+                static_cast<long long>(histogram.ValueAtPercentile(99.9)),
+                static_cast<long long>(histogram.Max()));
+}
+
+class SimulatedEa {
+public:
+    SimulatedEa(int self, int participants, uint64_t messages, uint64_t roundTrips)
+        : m_self(self),
+          m_participants(participants),
+          m_messages(messages),
+          m_roundTrips(roundTrips),
+          m_nextSeq(SharedBus::kMaxParticipants, 0),
+          m_oneWay(10LL * 1000 * 1000 * 1000, 3),
+          m_roundTrip(10LL * 1000 * 1000 * 1000, 3) {
+    }
+
+    int Run() {
+        std::string accountId = "sim-" + std::to_string(m_self);
+        if (!m_bus.Open(kBusName) || m_bus.Join(accountId, SharedBus::CurrentProcessId(), NowUs()) < 0) {
+            std::printf("  sim-%d failed to join the bus\n", m_self);
+            return 1;
+        }
+        if (!WaitForPeers()) {
+            std::printf("  sim-%d timed out waiting for peers\n", m_self);
+            return 1;
+        }
+
+        Broadcast();
+        if (m_self == 0 && m_participants > 1) {
+            PingPong();
+        } else if (m_self == 1) {
+            while (!m_stopped) {
+                Idle(Drain());
+            }
+        }
+
+        PrintHistogram("broadcast", m_self, m_oneWay);
+        if (m_roundTrip.TotalCount() > 0) {
+            PrintHistogram("pingpong", m_self, m_roundTrip);
+        }
+        BusCounters counters = m_bus.Counters();
+        std::printf("  sim-%d sent=%lld received=%lld full=%lld lost=%lld dup=%lld reordered=%lld\n", m_self,
+                    counters.sent, counters.received, counters.dropped, m_lost, m_duplicated, m_reordered);
+
+        m_bus.Close();
+        return (m_lost == 0 && m_duplicated == 0 && m_reordered == 0) ? 0 : 1;
+    }
+
+private:
+    bool WaitForPeers() {
+        std::vector<BusParticipant> participants;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < deadline) {
+            m_bus.Heartbeat(NowUs());
+            m_bus.Participants(NowUs(), participants);
+            if (participants.size() == static_cast<size_t>(m_participants)) {
+                m_peers.clear();
+                for (const auto& participant : participants) {
+                    if (participant.index != m_bus.Self()) {
+                        m_peers.push_back(participant.index);
+                    }
+                }
+                return true;
+            }
+            usleep(1000);
+        }
+        return false;
+    }
+
+    // 相手のリングが満杯なら自分の受信を進めながら再送する（全員が送信中でも詰まらない）
+    void SendReliably(int target, BusMessageKind kind, const BenchPayload& payload) {
+        while (!m_bus.Send(target, kind, &payload, sizeof(payload), NowUs())) {
+            Idle(Drain());
+        }
+    }
+
+    void Broadcast() {
+        uint64_t expected = m_messages * static_cast<uint64_t>(m_participants - 1);
+        for (uint64_t seq = 0; seq < m_messages; seq++) {
+            BenchPayload payload{seq, 0};
+            for (int peer : m_peers) {
+                payload.sentNs = NowNs();
+                SendReliably(peer, BusMessageKind::Tick, payload);
+            }
+            if ((seq & 1023) == 0) {
+                m_bus.Heartbeat(NowUs());
+                Drain();
+            }
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (m_ticksReceived < expected && std::chrono::steady_clock::now() < deadline) {
+            if (!Drain()) {
+                m_bus.Heartbeat(NowUs());
+                Idle(false);
+            }
+        }
+        if (m_ticksReceived < expected) {
+            m_lost += static_cast<long long>(expected - m_ticksReceived);
+        }
+    }
+
+    void PingPong() {
+        int target = -1;
+        BusParticipant participant;
+        for (int peer : m_peers) {
+            if (m_bus.ParticipantAt(peer, NowUs(), participant) && participant.accountId == "sim-1") {
+                target = peer;
+            }
+        }
+        if (target < 0) {
+            return;
+        }
+
+        for (uint64_t seq = 0; seq < m_roundTrips; seq++) {
+            BenchPayload payload{seq, NowNs()};
+            SendReliably(target, BusMessageKind::Command, payload);
+            m_awaitingEcho = true;
+            while (m_awaitingEcho) {
+                Idle(Drain());
+            }
+        }
+        BenchPayload stop{kStopSeq, NowNs()};
+        SendReliably(target, BusMessageKind::Command, stop);
+    }
+
+    // 何も受信できなかったときは CPU を譲る（コア数より参加者が多くても相手が進めるように）
+    static void Idle(bool progressed) {
+        if (!progressed) {
+            std::this_thread::yield();
+        }
+    }
+
+    bool Drain() {
+        bool any = false;
+        BusMessage message;
+        while (m_bus.Receive(message)) {
+            any = true;
+            BenchPayload payload;
+            std::memcpy(&payload, message.payload, sizeof(payload));
+
+            if (message.kind == static_cast<uint32_t>(BusMessageKind::Tick)) {
+                m_oneWay.Record(static_cast<int64_t>(NowNs() - payload.sentNs));
+                m_ticksReceived++;
+                uint64_t& next = m_nextSeq[static_cast<size_t>(message.from)];
+                if (payload.seq == next) {
+                    next++;
+                } else if (payload.seq < next) {
+                    m_duplicated++;
+                } else {
+                    m_reordered++;
+                    m_lost += static_cast<long long>(payload.seq - next);
+                    next = payload.seq + 1;
+                }
+            } else if (message.kind == static_cast<uint32_t>(BusMessageKind::Command)) {
+                if (m_self == 1) {
+                    // プロセス1は受け取ったコマンドをそのまま送り返す
+                    if (payload.seq == kStopSeq) {
+                        m_stopped = true;
+                    } else {
+                        SendReliably(message.from, BusMessageKind::Command, payload);
+                    }
+                } else {
+                    m_roundTrip.Record(static_cast<int64_t>(NowNs() - payload.sentNs));
+                    m_awaitingEcho = false;
+                }
+            }
+        }
+        return any;
+    }
+
+    int m_self;
+    int m_participants;
+    uint64_t m_messages;
+    uint64_t m_roundTrips;
+    SharedBus m_bus;
+    std::vector<int> m_peers;
+    std::vector<uint64_t> m_nextSeq;
+    HdrHistogram m_oneWay;
+    HdrHistogram m_roundTrip;
+    uint64_t m_ticksReceived = 0;
+    long long m_lost = 0;
+    long long m_duplicated = 0;
+    long long m_reordered = 0;
+    bool m_awaitingEcho = false;
+    bool m_stopped = false;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int participants = argc > 1 ? std::atoi(argv[1]) : 4;
+    uint64_t messages = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200000;
+    uint64_t roundTrips = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100000;
+    if (participants < 2 || participants > static_cast<int>(SharedBus::kMaxParticipants)) {
+        std::printf("participants must be between 2 and %zu\n", SharedBus::kMaxParticipants);
+        return 1;
+    }
+
+    SharedBus::Remove(kBusName);
+    std::printf("SharedBusBench: %d simulated EAs, %llu messages each, %llu round trips\n", participants,
+                static_cast<unsigned long long>(messages), static_cast<unsigned long long>(roundTrips));
+    std::fflush(stdout);
+
+    std::vector<pid_t> children;
+    for (int i = 0; i < participants; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            int code = SimulatedEa(i, participants, messages, roundTrips).Run();
+            std::fflush(stdout);
+            _exit(code);
+        }
+        if (pid < 0) {
+            std::printf("fork failed\n");
+            return 1;
+        }
+        children.push_back(pid);
+    }
+
+    int failures = 0;
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failures++;
+        }
+    }
+    SharedBus::Remove(kBusName);
+
+    std::printf("%s\n", failures == 0 ? "OK" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,182 @@
+// 口座間スプレッドの機会検出のベンチマーク（1スレッド）
+//
+// 通貨ペアごとの仲値のランダムウォークに口座ごとのずれを乗せた気配列を事前に生成し、
+// ときどき1口座の気配を一定時間ずらして機会を作る。気配は模擬時刻で一定間隔に並べる。
+//   indexed : 番号指定の OnQuote（登録済みの通貨ペア・口座）
+//   named   : 名前指定の OnQuote（DLL と同じ経路）
+//   latency : named の1気配あたりの処理時間の分布（時刻取得のコストを含む）
+//
+// 使い方: SpreadDetectorBench [通貨ペア数] [口座数] [気配数]
+
+#include "../HdrHistogram.h"
+#include "../SpreadDetector.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const long long kTickIntervalUs = 10;          // 模擬時刻での気配の間隔
+const double kEntry = 0.00020;
+const double kExit = 0.00005;
+const double kCommission = 0.00003;
+
+struct BenchQuote {
+    int symbol;
+    int broker;
+    double bid;
+    double ask;
+};
+
+std::vector<BenchQuote> GenerateQuotes(int symbols, int brokers, long count) {
+    std::mt19937_64 random(20240601);
+    std::normal_distribution<double> step(0.0, 0.00002);
+    std::normal_distribution<double> jitter(0.0, 0.000015);
+    std::uniform_int_distribution<int> pickSymbol(0, symbols - 1);
+    std::uniform_int_distribution<int> pickBroker(0, brokers - 1);
+    std::uniform_int_distribution<int> dislocation(0, 4999);
+
+    std::vector<double> mids(static_cast<size_t>(symbols));
+    for (int i = 0; i < symbols; i++) {
+        mids[static_cast<size_t>(i)] = 1.0 + 0.01 * i;
+    }
+    // 通貨ペアごとに、ずれている口座と残り気配数
+    std::vector<int> shiftedBroker(static_cast<size_t>(symbols), -1);
+    std::vector<int> shiftedLeft(static_cast<size_t>(symbols), 0);
+
+    std::vector<BenchQuote> quotes;
+    quotes.reserve(static_cast<size_t>(count));
+    for (long i = 0; i < count; i++) {
+        int symbol = pickSymbol(random);
+        int broker = pickBroker(random);
+        size_t s = static_cast<size_t>(symbol);
+        mids[s] += step(random);
+
+        if (shiftedLeft[s] == 0 && dislocation(random) == 0) {
+            shiftedBroker[s] = broker;
+            shiftedLeft[s] = 2000;
+        }
+        double mid = mids[s] + jitter(random);
+        if (shiftedLeft[s] > 0) {
+            shiftedLeft[s]--;
+            if (broker == shiftedBroker[s]) {
+                mid += 0.0006;
+            }
+        }
+        quotes.push_back(BenchQuote{symbol, broker, mid - 0.00005, mid + 0.00005});
+    }
+    return quotes;
+}
+
+void Configure(SpreadDetector& detector, int symbols, int brokers, std::vector<std::string>& symbolNames,
+               std::vector<std::string>& brokerNames) {
+    SpreadRule rule;
+    rule.entry = kEntry;
+    rule.exit = kExit;
+    rule.minPersistUs = 50 * 1000;
+    rule.maxQuoteAgeUs = 5LL * 1000 * 1000;
+    detector.SetRule("", rule);
+
+    for (int i = 0; i < brokers; i++) {
+        brokerNames.push_back("broker-" + std::to_string(i));
+        SpreadCost cost;
+        cost.commission = kCommission;
+        detector.SetCost(brokerNames.back(), "", cost);
+        detector.Broker(brokerNames.back());
+    }
+    for (int i = 0; i < symbols; i++) {
+        symbolNames.push_back("SYM" + std::to_string(i));
+        detector.Symbol(symbolNames.back());
+    }
+}
+
+struct RunResult {
+    double nsPerQuote = 0.0;
+    long long opened = 0;
+    long long closed = 0;
+};
+
+template <typename Feed>
+RunResult Run(const std::vector<BenchQuote>& quotes, Feed feed) {
+    RunResult result;
+    std::vector<SpreadOpportunity> events;
+    events.reserve(64);
+    long long nowUs = 1;
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& quote : quotes) {
+        nowUs += kTickIntervalUs;
+        if (feed(quote, nowUs, events) > 0) {
+            for (const auto& event : events) {
+                (event.state == OpportunityState::Open ? result.opened : result.closed)++;
+            }
+            events.clear();
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+    result.nsPerQuote = static_cast<double>(elapsed) / static_cast<double>(quotes.size());
+    return result;
+}
+
+void Print(const char* name, const RunResult& result, int symbols, int brokers) {
+    double perSecond = 1e9 / result.nsPerQuote;
+    std::printf("%-8s %7.1f ns/quote  %10.0f quotes/s  (%.0f quotes/s per symbol x broker)  open=%lld closed=%lld\n",
+                name, result.nsPerQuote, perSecond, perSecond / (symbols * brokers), result.opened, result.closed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int symbols = argc > 1 ? std::atoi(argv[1]) : 100;
+    int brokers = argc > 2 ? std::atoi(argv[2]) : 10;
+    long count = argc > 3 ? std::atol(argv[3]) : 5000000;
+    if (symbols < 1 || brokers < 2 || brokers > static_cast<int>(SpreadDetector::kMaxBrokers) || count < 1) {
+        std::printf("symbols must be positive, brokers between 2 and %zu\n", SpreadDetector::kMaxBrokers);
+        return 1;
+    }
+
+    std::printf("SpreadDetectorBench: %d symbols x %d brokers, %ld quotes (%d pairs evaluated per quote)\n",
+                symbols, brokers, count, 2 * (brokers - 1));
+    std::vector<BenchQuote> quotes = GenerateQuotes(symbols, brokers, count);
+
+    {
+        SpreadDetector detector;
+        std::vector<std::string> symbolNames, brokerNames;
+        Configure(detector, symbols, brokers, symbolNames, brokerNames);
+        Print("indexed", Run(quotes, [&](const BenchQuote& quote, long long nowUs, std::vector<SpreadOpportunity>& events) {
+            return detector.OnQuote(quote.symbol, quote.broker, quote.bid, quote.ask, nowUs / 1000, nowUs, events);
+        }), symbols, brokers);
+    }
+
+    {
+        SpreadDetector detector;
+        std::vector<std::string> symbolNames, brokerNames;
+        Configure(detector, symbols, brokers, symbolNames, brokerNames);
+        Print("named", Run(quotes, [&](const BenchQuote& quote, long long nowUs, std::vector<SpreadOpportunity>& events) {
+            return detector.OnQuote(symbolNames[static_cast<size_t>(quote.symbol)],
+                                    brokerNames[static_cast<size_t>(quote.broker)], quote.bid, quote.ask, nowUs / 1000, nowUs, events);
+        }), symbols, brokers);
+    }
+
+    {
+        SpreadDetector detector;
+        std::vector<std::string> symbolNames, brokerNames;
+        Configure(detector, symbols, brokers, symbolNames, brokerNames);
+        HdrHistogram histogram(1000LL * 1000 * 1000, 3);
+        Run(quotes, [&](const BenchQuote& quote, long long nowUs, std::vector<SpreadOpportunity>& events) {
+            auto begin = std::chrono::steady_clock::now();
+            size_t added = detector.OnQuote(symbolNames[static_cast<size_t>(quote.symbol)],
+                                            brokerNames[static_cast<size_t>(quote.broker)], quote.bid, quote.ask, nowUs / 1000, nowUs, events);
+            histogram.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+            return added;
+        });
+        std::printf("latency  p50=%lldns p99=%lldns p99.9=%lldns max=%lldns\n",
+                    static_cast<long long>(histogram.ValueAtPercentile(50.0)),
+                    static_cast<long long>(histogram.ValueAtPercentile(99.0)),
+                    static_cast<long long>(histogram.ValueAtPercentile(99.9)),
+                    static_cast<long long>(histogram.Max()));
+    }
+    return 0;
+}
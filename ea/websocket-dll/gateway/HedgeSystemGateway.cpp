@@ -0,0 +1,355 @@
+// 接続ゲートウェイ
+//
+// 同一ホストの端末のDLL（WSConnectGateway）と共有メモリバスでフレームを受け渡し、
+// 全端末のフレームを1本の上流 WebSocket 接続に多重化する。
+//   端末 → 上流 : 送信元の口座IDで ACCOUNT_FRAME に包む（まとめて取り出せた分は BATCH にする）
+//   上流 → 端末 : ACCOUNT_FRAME の口座IDの端末へ渡す。包まれていないフレームは accountId の端末、
+//                 accountId もなければ全端末へ渡す
+// 上流との接続状態は GATEWAY_STATUS で全端末へ通知し、切断時は間隔を延ばしながら再接続する。
+//
+// 使い方: HedgeSystemGateway <url> <token> [バス名] [spinMicros]
+
+#include "../BusFrameLink.h"
+#include "../GatewayProtocol.h"
+#include "../MessageUtils.h"
+#include "../SharedBus.h"
+#include "../WireMessages.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <websocketpp/config/asio_client.hpp>
+#include <websocketpp/client.hpp>
+
+typedef websocketpp::client<websocketpp::config::asio_tls_client> client;
+
+namespace {
+
+std::atomic<bool> g_running(true);
+
+void OnSignal(int) {
+    g_running = false;
+}
+
+long long NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+class Gateway {
+public:
+    static constexpr long long kHeartbeatUs = 100 * 1000;
+    static constexpr long long kIdleSleepUs = 1000;
+    static constexpr long long kStatsIntervalUs = 60LL * 1000 * 1000;
+    static constexpr int kMinReconnectMs = 1000;
+    static constexpr int kMaxReconnectMs = 30000;
+
+    Gateway(std::string url, std::string token, long long spinMicros)
+        : m_url(std::move(url)),
+          m_token(std::move(token)),
+          m_spinUs(spinMicros),
+          m_link(m_bus),
+          m_upstreamConnected(false),
+          m_reconnectMs(kMinReconnectMs),
+          m_upstreamFrames(0),
+          m_downstreamFrames(0),
+          m_unroutable(0),
+          m_droppedOffline(0) {
+        m_client.clear_access_channels(websocketpp::log::alevel::all);
+        m_client.clear_error_channels(websocketpp::log::elevel::all);
+        m_client.init_asio();
+        m_reconnectTimer.reset(new websocketpp::lib::asio::steady_timer(m_client.get_io_service()));
+        m_client.set_tls_init_handler([](websocketpp::connection_hdl) {
+            return websocketpp::lib::make_shared<websocketpp::lib::asio::ssl::context>(websocketpp::lib::asio::ssl::context::sslv23);
+        });
+        m_client.set_open_handler([this](websocketpp::connection_hdl hdl) {
+            OnOpen(hdl);
+        });
+        m_client.set_close_handler([this](websocketpp::connection_hdl) {
+            OnDisconnected("closed");
+        });
+        m_client.set_fail_handler([this](websocketpp::connection_hdl) {
+            OnDisconnected("failed");
+        });
+        m_client.set_message_handler([this](websocketpp::connection_hdl, client::message_ptr msg) {
+            RouteDownstream(msg->get_payload());
+        });
+    }
+
+    int Run(const std::string& busName) {
+        if (!m_bus.Open(busName) || m_bus.Join(kGatewayAccountId, SharedBus::CurrentProcessId(), NowMicros()) < 0) {
+            std::fprintf(stderr, "Failed to join shared bus %s\n", busName.c_str());
+            return 1;
+        }
+
+        m_client.start_perpetual();
+        std::thread ioThread([this]() {
+            m_client.run();
+        });
+        websocketpp::lib::asio::post(m_client.get_io_service(), [this]() {
+            ConnectUpstream();
+        });
+
+        std::printf("HedgeSystemGateway: bus=%s upstream=%s\n", busName.c_str(), m_url.c_str());
+        std::fflush(stdout);
+        PumpBus();
+
+        // 全端末へ切断を通知してから上流を閉じる
+        BroadcastStatus(false);
+        websocketpp::lib::asio::post(m_client.get_io_service(), [this]() {
+            m_reconnectTimer->cancel();
+            if (m_upstreamConnected) {
+                std::lock_guard<std::mutex> lock(m_hdlMutex);
+                websocketpp::lib::error_code ec;
+                m_client.close(m_hdl, websocketpp::close::status::going_away, "", ec);
+            }
+        });
+        m_client.stop_perpetual();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        m_client.stop();
+        ioThread.join();
+        m_bus.Close();
+        PrintStats();
+        return 0;
+    }
+
+private:
+    // 端末からの受信（メインスレッド）。1回で取り出せた分は1つの上流フレームにまとめる
+    void PumpBus() {
+        long long lastHeartbeatUs = 0;
+        long long lastReceiveUs = 0;
+        long long lastStatsUs = NowMicros();
+        std::vector<std::string> batch;
+        BusMessage message;
+        std::string frame;
+
+        while (g_running) {
+            while (m_bus.Receive(message)) {
+                if (m_link.Accept(message, frame)) {
+                    HandleTerminalFrame(message.from, frame, batch);
+                }
+            }
+
+            long long nowUs = NowMicros();
+            if (!batch.empty()) {
+                SendUpstream(batch);
+                batch.clear();
+                lastReceiveUs = nowUs;
+            }
+            if (nowUs - lastHeartbeatUs >= kHeartbeatUs) {
+                m_bus.Heartbeat(nowUs);
+                lastHeartbeatUs = nowUs;
+            }
+            if (nowUs - lastStatsUs >= kStatsIntervalUs) {
+                PrintStats();
+                lastStatsUs = nowUs;
+            }
+
+            if (nowUs - lastReceiveUs < m_spinUs) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(kIdleSleepUs));
+            }
+        }
+    }
+
+    void HandleTerminalFrame(int from, const std::string& frame, std::vector<std::string>& batch) {
+        BusParticipant sender;
+        if (!m_bus.ParticipantAt(from, NowMicros(), sender)) {
+            return;
+        }
+
+        if (ExtractMessageType(frame) == "GATEWAY_HELLO") {
+            SendStatus(from, m_upstreamConnected);
+            return;
+        }
+        batch.push_back(WrapAccountFrame(sender.accountId, frame));
+    }
+
+    void SendUpstream(const std::vector<std::string>& batch) {
+        if (!m_upstreamConnected) {
+            // 端末には切断を通知済み。再接続後に各端末の STREAM_RESUME から再送される
+            m_droppedOffline += static_cast<long long>(batch.size());
+            return;
+        }
+
+        std::string payload;
+        if (batch.size() == 1) {
+            payload = batch.front();
+        } else {
+            payload = "{\"type\":\"BATCH\",\"count\":" + std::to_string(batch.size()) + ",\"messages\":[";
+            for (size_t i = 0; i < batch.size(); i++) {
+                if (i > 0) payload += ",";
+                payload += batch[i];
+            }
+            payload += "]}";
+        }
+
+        websocketpp::connection_hdl hdl;
+        {
+            std::lock_guard<std::mutex> lock(m_hdlMutex);
+            hdl = m_hdl;
+        }
+        websocketpp::lib::error_code ec;
+        m_client.send(hdl, payload, websocketpp::frame::opcode::text, ec);
+        if (ec) {
+            m_droppedOffline += static_cast<long long>(batch.size());
+            return;
+        }
+        m_upstreamFrames += static_cast<long long>(batch.size());
+    }
+
+    // 上流からの受信（ioスレッド）
+    void RouteDownstream(const std::string& payload) {
+        long long nowUs = NowMicros();
+        std::string accountId;
+        std::string frame;
+        if (UnwrapAccountFrame(payload, accountId, frame)) {
+            SendToAccount(accountId, frame, nowUs);
+            return;
+        }
+
+        accountId = GetJsonString(payload, "accountId");
+        if (!accountId.empty()) {
+            SendToAccount(accountId, payload, nowUs);
+            return;
+        }
+
+        std::vector<BusParticipant> participants;
+        m_bus.Participants(nowUs, participants);
+        for (const auto& participant : participants) {
+            if (participant.index != m_bus.Self() && m_link.Send(participant.index, payload, nowUs)) {
+                m_downstreamFrames++;
+            }
+        }
+    }
+
+    void SendToAccount(const std::string& accountId, const std::string& frame, long long nowUs) {
+        int target = m_bus.Find(accountId, nowUs);
+        if (target < 0 || !m_link.Send(target, frame, nowUs)) {
+            m_unroutable++;
+            return;
+        }
+        m_downstreamFrames++;
+    }
+
+    void SendStatus(int target, bool connected) {
+        GatewayStatusFrame status;
+        status.connected = connected;
+        m_link.Send(target, schema::ToJson(status), NowMicros());
+    }
+
+    void BroadcastStatus(bool connected) {
+        std::vector<BusParticipant> participants;
+        m_bus.Participants(NowMicros(), participants);
+        for (const auto& participant : participants) {
+            if (participant.index != m_bus.Self()) {
+                SendStatus(participant.index, connected);
+            }
+        }
+    }
+
+    void ConnectUpstream() {
+        if (!g_running) {
+            return;
+        }
+
+        websocketpp::lib::error_code ec;
+        client::connection_ptr con = m_client.get_connection(m_url, ec);
+        if (ec) {
+            std::fprintf(stderr, "Could not create connection: %s\n", ec.message().c_str());
+            ScheduleReconnect();
+            return;
+        }
+        con->append_header("Authorization", "Bearer " + m_token);
+        m_client.connect(con);
+    }
+
+    void OnOpen(websocketpp::connection_hdl hdl) {
+        {
+            std::lock_guard<std::mutex> lock(m_hdlMutex);
+            m_hdl = hdl;
+        }
+        m_upstreamConnected = true;
+        m_reconnectMs = kMinReconnectMs;
+        std::printf("Upstream connected\n");
+        std::fflush(stdout);
+        BroadcastStatus(true);
+    }
+
+    void OnDisconnected(const char* reason) {
+        bool wasConnected = m_upstreamConnected.exchange(false);
+        if (wasConnected) {
+            BroadcastStatus(false);
+        }
+        std::printf("Upstream %s, retrying in %d ms\n", reason, m_reconnectMs);
+        std::fflush(stdout);
+        ScheduleReconnect();
+    }
+
+    void ScheduleReconnect() {
+        if (!g_running) {
+            return;
+        }
+        m_reconnectTimer->expires_after(std::chrono::milliseconds(m_reconnectMs));
+        m_reconnectTimer->async_wait([this](const websocketpp::lib::error_code& ec) {
+            if (!ec) {
+                ConnectUpstream();
+            }
+        });
+        m_reconnectMs = std::min(m_reconnectMs * 2, kMaxReconnectMs);
+    }
+
+    void PrintStats() {
+        std::vector<BusParticipant> participants;
+        if (m_bus.IsOpen()) {
+            m_bus.Participants(NowMicros(), participants);
+        }
+        size_t terminals = participants.empty() ? 0 : participants.size() - 1;
+        std::printf("terminals=%zu upstream=%s up=%lld down=%lld unroutable=%lld offline=%lld fragmentsDropped=%lld\n",
+                    terminals, m_upstreamConnected ? "connected" : "disconnected",
+                    m_upstreamFrames.load(), m_downstreamFrames.load(), m_unroutable.load(),
+                    m_droppedOffline.load(), m_link.DroppedFrames());
+        std::fflush(stdout);
+    }
+
+    std::string m_url;
+    std::string m_token;
+    long long m_spinUs;
+    client m_client;
+    websocketpp::connection_hdl m_hdl;
+    std::mutex m_hdlMutex;
+    std::unique_ptr<websocketpp::lib::asio::steady_timer> m_reconnectTimer;
+    SharedBus m_bus;
+    BusFrameLink m_link;
+    std::atomic<bool> m_upstreamConnected;
+    int m_reconnectMs;
+    std::atomic<long long> m_upstreamFrames;
+    std::atomic<long long> m_downstreamFrames;
+    std::atomic<long long> m_unroutable;
+    std::atomic<long long> m_droppedOffline;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: HedgeSystemGateway <url> <token> [busName] [spinMicros]\n");
+        return 1;
+    }
+    std::string busName = argc > 3 ? argv[3] : "HedgeSystemBus";
+    long long spinMicros = argc > 4 ? std::atoll(argv[4]) : 500;
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    Gateway gateway(argv[1], argv[2], spinMicros);
+    return gateway.Run(busName);
+}
@@ -0,0 +1,88 @@
+// クロックスキュー推定のテスト（Hedge System のサーバーが実際に送るフレームで推定が有効になること）
+//
+//   heartbeatAck : Rust サーバーの HEARTBEAT_ACK（RFC 3339、ナノ秒・+00:00）がハートビートとして分類され、推定が有効になる
+//   authSuccess  : AUTH_SUCCESS は既知の種別だが、ハートビートではないため単独では推定を有効にしない
+//   staleCommand : 再送された古いコマンドの標本は推定値を上げない（下げる方向にだけ効く）
+
+#include "../ClockSkewEstimator.h"
+#include "../MessageDispatch.h"
+#include "../MessageUtils.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::system_clock;
+
+// DLL の受信処理（DispatchInbound）と同じ手順で標本を追加する。サーバー時刻のないフレームは false
+bool Sample(ClockSkewEstimator& estimator, const std::string& frame, Clock::time_point receivedAt, InboundKind& kind) {
+    MessageEnvelope envelope;
+    kind = ClassifyInbound(frame, envelope);
+    Clock::time_point serverTime;
+    if (kind == InboundKind::Unknown || !ParseIsoTimestamp(envelope.timestamp, serverTime)) {
+        return false;
+    }
+    estimator.AddSample(serverTime, receivedAt, IsHeartbeatKind(kind));
+    return true;
+}
+
+Clock::time_point At(const char* timestamp) {
+    Clock::time_point time;
+    ParseIsoTimestamp(timestamp, time);
+    return time;
+}
+
+void TestHeartbeatAck() {
+    ClockSkewEstimator estimator;
+    EXPECT(!estimator.HasEstimate());
+
+    // ローカル時計がサーバーより 250ms 進んでいる
+    InboundKind kind = InboundKind::Unknown;
+    std::string ack = R"({"type":"HEARTBEAT_ACK","timestamp":"2024-06-10T06:13:20.123456789+00:00"})";
+    EXPECT(Sample(estimator, ack, At("2024-06-10T06:13:20.373456Z"), kind));
+    EXPECT(kind == InboundKind::HeartbeatAck);
+    EXPECT(IsHeartbeatKind(kind));
+    EXPECT(estimator.HasEstimate());
+    EXPECT(estimator.OffsetMicros() == 250000);
+    EXPECT(estimator.ToLocal(At("2024-06-10T06:14:00Z")) == At("2024-06-10T06:14:00.25Z"));
+
+    // より速く届いた応答で推定値が縮む
+    ack = R"({"type":"HEARTBEAT_ACK","timestamp":"2024-06-10T06:13:50.000000000+00:00"})";
+    EXPECT(Sample(estimator, ack, At("2024-06-10T06:13:50.240Z"), kind));
+    EXPECT(estimator.OffsetMicros() == 240000);
+}
+
+void TestAuthSuccess() {
+    ClockSkewEstimator estimator;
+    InboundKind kind = InboundKind::Unknown;
+    std::string auth = R"({"type":"AUTH_SUCCESS","timestamp":"2024-06-10T06:13:20.100+00:00","clientId":"c1"})";
+    EXPECT(Sample(estimator, auth, At("2024-06-10T06:13:20.300Z"), kind));
+    EXPECT(kind == InboundKind::AuthSuccess);
+    EXPECT(!IsHeartbeatKind(kind));
+    EXPECT(!estimator.HasEstimate());
+    EXPECT(estimator.OffsetMicros() == 0);
+}
+
+void TestStaleCommand() {
+    ClockSkewEstimator estimator;
+    InboundKind kind = InboundKind::Unknown;
+    EXPECT(Sample(estimator, R"({"type":"HEARTBEAT_ACK","timestamp":"2024-06-10T06:13:20+00:00"})",
+                  At("2024-06-10T06:13:20.050Z"), kind));
+    EXPECT(estimator.OffsetMicros() == 50000);
+
+    // 再接続後に届いた10秒前のコマンド（滞留分をずれとして取り込まない）
+    EXPECT(Sample(estimator, R"({"type":"OPEN","timestamp":"2024-06-10T06:13:10Z","commandId":"c1"})",
+                  At("2024-06-10T06:13:20.100Z"), kind));
+    EXPECT(kind == InboundKind::Open);
+    EXPECT(estimator.OffsetMicros() == 50000);
+}
+
+} // namespace
+
+int main() {
+    TestHeartbeatAck();
+    TestAuthSuccess();
+    TestStaleCommand();
+    return FinishTest("ClockSkewTest");
+}
@@ -0,0 +1,104 @@
+// コマンドのデコードのテスト（受信 ACK に返す識別子と MODIFY の SL/TP）
+//
+//   open       : OPEN / CLOSE から ACK に返す識別子を取り出し、metadata の timestamp / ttlMs / executeAt を優先する
+//   pairedLeg  : 対のレッグは OPEN のときだけ取り出す
+//   modify     : stopLoss / takeProfit を小数点以下8桁の固定小数点で読み、チケットを取り出す
+//   partial    : 含まれていない SL/TP は present == false（現状維持）、0 は解除として present == true
+//   legacy     : レガシー形式（"type":"command","action":"modify_position"、sl / tp / mtTicket）も同じ結果になる
+//   notCommand : コマンド以外のフレームは false
+
+#include "../CommandDecoder.h"
+#include "TestSupport.h"
+#include <string>
+
+namespace {
+
+void TestOpen() {
+    DecodedCommand command;
+    EXPECT(DecodeCommand(R"({"type":"OPEN","commandId":"c0","accountId":"A","positionId":"p0","actionId":"x0",)"
+                         R"("symbol":"EURUSD","side":"BUY","volume":0.25,"ttlMs":3000,"timestamp":"2024-06-10T06:13:20Z",)"
+                         R"("metadata":{"timestamp":"2024-06-10T06:13:21Z","executeAt":"2024-06-10T06:13:30Z"}})",
+                         command));
+    EXPECT(command.type == CommandType::Open && std::string(CommandTypeName(command.type)) == "OPEN");
+    EXPECT(command.commandId == "c0" && command.accountId == "A" && command.positionId == "p0");
+    EXPECT(command.actionId == "x0" && command.symbol == "EURUSD" && command.side == "BUY" && command.volume == 0.25);
+    EXPECT(command.timestamp == "2024-06-10T06:13:21Z");
+    EXPECT(command.ttlMs == 3000 && command.executeAt == "2024-06-10T06:13:30Z");
+
+    // 負の有効期限は既定値（0）として扱う
+    EXPECT(DecodeCommand(R"({"type":"CLOSE","accountId":"A","positionId":"p0","ttlMs":-5,)"
+                         R"("timestamp":"2024-06-10T06:13:20Z"})",
+                         command));
+    EXPECT(command.type == CommandType::Close && command.commandId.empty());
+    EXPECT(command.ttlMs == 0 && command.timestamp == "2024-06-10T06:13:20Z" && command.executeAt.empty());
+}
+
+void TestPairedLeg() {
+    const char* leg = R"("pairedLeg":{"commandId":"c2","accountId":"B","positionId":"p2","symbol":"EURUSD",)"
+                      R"("side":"SELL","volume":0.25,"ttlMs":5000})";
+    DecodedCommand command;
+    EXPECT(DecodeCommand(std::string(R"({"type":"OPEN","accountId":"A","positionId":"p1",)") + leg +
+                             R"(,"timestamp":"2024-06-10T06:13:20Z"})",
+                         command));
+    EXPECT(command.pairedLeg.Present());
+    EXPECT(command.pairedLeg.commandId == "c2" && command.pairedLeg.accountId == "B");
+    EXPECT(command.pairedLeg.side == "SELL" && command.pairedLeg.volume == 0.25 && command.pairedLeg.ttlMs == 5000);
+
+    EXPECT(DecodeCommand(std::string(R"({"type":"CLOSE","accountId":"A","positionId":"p1",)") + leg +
+                             R"(,"timestamp":"2024-06-10T06:13:20Z"})",
+                         command));
+    EXPECT(!command.pairedLeg.Present());
+}
+
+void TestModify() {
+    DecodedCommand command;
+    EXPECT(DecodeCommand(R"({"type":"MODIFY","commandId":"c1","accountId":"A","positionId":"p1","ticket":12345,)"
+                         R"("stopLoss":149.125,"takeProfit":"150.5","timestamp":"2024-06-10T06:13:20Z"})",
+                         command));
+    EXPECT(command.type == CommandType::Modify);
+    EXPECT(command.commandId == "c1" && command.accountId == "A" && command.positionId == "p1");
+    EXPECT(command.ticket == 12345);
+    EXPECT(command.stopLoss.present && command.stopLoss.raw == 14912500000LL);
+    EXPECT(command.takeProfit.present && command.takeProfit.raw == 15050000000LL);
+    EXPECT(std::string(CommandTypeName(command.type)) == "MODIFY");
+}
+
+void TestPartial() {
+    DecodedCommand command;
+    EXPECT(DecodeCommand(R"({"type":"MODIFY","accountId":"A","positionId":"p1","stopLoss":0,)"
+                         R"("timestamp":"2024-06-10T06:13:20Z"})",
+                         command));
+    EXPECT(command.stopLoss.present && command.stopLoss.raw == 0);
+    EXPECT(!command.takeProfit.present);
+    EXPECT(command.ticket == 0);
+}
+
+void TestLegacy() {
+    DecodedCommand command;
+    EXPECT(DecodeCommand(R"({"type":"command","action":"modify_position","account_id":"A","position_id":"p1",)"
+                         R"("mtTicket":777,"sl":1.23456789,"tp":1.3,"timestamp":"2024-06-10T06:13:20Z"})",
+                         command));
+    EXPECT(command.type == CommandType::Modify);
+    EXPECT(command.accountId == "A" && command.positionId == "p1");
+    EXPECT(command.ticket == 777);
+    EXPECT(command.stopLoss.present && command.stopLoss.raw == 123456789LL);
+    EXPECT(command.takeProfit.present && command.takeProfit.raw == 130000000LL);
+}
+
+void TestNotCommand() {
+    DecodedCommand command;
+    EXPECT(!DecodeCommand(R"({"type":"HEARTBEAT_ACK","timestamp":"2024-06-10T06:13:20Z"})", command));
+    EXPECT(!DecodeCommand("not json", command));
+}
+
+} // namespace
+
+int main() {
+    TestOpen();
+    TestPairedLeg();
+    TestModify();
+    TestPartial();
+    TestLegacy();
+    TestNotCommand();
+    return FinishTest("CommandDecoderTest");
+}
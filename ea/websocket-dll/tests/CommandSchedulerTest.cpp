@@ -0,0 +1,102 @@
+// 実行予定時刻つきコマンドの保留のテスト
+//
+//   order    : ホイール内・同じスロット内・オーバーフロー（kSlotCount ms より先）のコマンドを予定時刻順に取り出す
+//   notDue   : 予定時刻前のコマンドは timeoutUs == 0 なら待たずに false、期限より先のコマンドも待たない
+//   wait     : timeoutUs 以内のコマンドは予定時刻まで待ってから取り出す
+//   late     : 予定時刻を過ぎて追加されたコマンドは次の取り出しで渡される
+
+#include "../CommandScheduler.h"
+#include "TestSupport.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+const long long kMs = 1000;
+
+InboundMessage Message(const std::string& payload) {
+    InboundMessage message;
+    message.payload = payload;
+    message.scheduled = true;
+    return message;
+}
+
+void TestOrder() {
+    CommandScheduler scheduler;
+    // 3秒前を基準に登録する（予定時刻はすべて過ぎているため、取り出しは待たない）
+    long long baseUs = CommandScheduler::NowMicros() - 3000 * kMs;
+    scheduler.Schedule(Message("overflow2"), baseUs + 2500 * kMs, baseUs);
+    scheduler.Schedule(Message("wheel5"), baseUs + 5 * kMs, baseUs);
+    scheduler.Schedule(Message("overflow1"), baseUs + 1500 * kMs, baseUs);
+    scheduler.Schedule(Message("wheel1b"), baseUs + 1 * kMs + 600, baseUs);
+    scheduler.Schedule(Message("wheel1a"), baseUs + 1 * kMs + 100, baseUs);
+    EXPECT(scheduler.Size() == 5);
+    EXPECT(scheduler.NextDueUs() == baseUs + 1 * kMs + 100);
+
+    std::vector<std::string> order;
+    std::vector<long long> dues;
+    InboundMessage message;
+    long long dueUs = 0;
+    while (scheduler.WaitNext(0, message, dueUs)) {
+        order.push_back(message.payload);
+        dues.push_back(dueUs);
+    }
+    std::vector<std::string> expected = {"wheel1a", "wheel1b", "wheel5", "overflow1", "overflow2"};
+    EXPECT(order == expected);
+    EXPECT(dues.size() == 5 && dues[3] == baseUs + 1500 * kMs);
+    EXPECT(scheduler.Size() == 0);
+    EXPECT(scheduler.NextDueUs() == -1);
+}
+
+void TestNotDue() {
+    CommandScheduler scheduler;
+    long long nowUs = CommandScheduler::NowMicros();
+    scheduler.Schedule(Message("later"), nowUs + 10000 * kMs, nowUs);
+
+    InboundMessage message;
+    long long dueUs = 0;
+    EXPECT(!scheduler.WaitNext(0, message, dueUs));
+    // 期限（100ms）より先のコマンドは待たずに返す
+    long long startUs = CommandScheduler::NowMicros();
+    EXPECT(!scheduler.WaitNext(100 * kMs, message, dueUs));
+    EXPECT(CommandScheduler::NowMicros() - startUs < 1000 * kMs);
+    EXPECT(scheduler.Size() == 1);
+    EXPECT(scheduler.NextDueUs() == nowUs + 10000 * kMs);
+}
+
+void TestWait() {
+    CommandScheduler scheduler;
+    long long nowUs = CommandScheduler::NowMicros();
+    long long due = nowUs + 30 * kMs;
+    scheduler.Schedule(Message("soon"), due, nowUs);
+
+    InboundMessage message;
+    long long dueUs = 0;
+    EXPECT(scheduler.WaitNext(1000 * kMs, message, dueUs));
+    EXPECT(message.payload == "soon" && dueUs == due);
+    EXPECT(CommandScheduler::NowMicros() >= due);
+}
+
+void TestLate() {
+    CommandScheduler scheduler;
+    long long nowUs = CommandScheduler::NowMicros();
+    scheduler.Schedule(Message("later"), nowUs + 10000 * kMs, nowUs);
+    scheduler.Schedule(Message("late"), nowUs - 500 * kMs, nowUs);
+
+    InboundMessage message;
+    long long dueUs = 0;
+    EXPECT(scheduler.WaitNext(0, message, dueUs));
+    EXPECT(message.payload == "late" && dueUs == nowUs - 500 * kMs);
+    EXPECT(!scheduler.WaitNext(0, message, dueUs));
+    EXPECT(scheduler.Size() == 1);
+}
+
+} // namespace
+
+int main() {
+    TestOrder();
+    TestNotDue();
+    TestWait();
+    TestLate();
+    return FinishTest("CommandSchedulerTest");
+}
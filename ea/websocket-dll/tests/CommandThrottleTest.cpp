@@ -0,0 +1,146 @@
+// コマンドのレート上限のテスト
+//
+//   burst     : burst 件までは連続で通し、以降は rate に応じて補充されたトークンの分だけ通す
+//   buckets   : 口座 × 通貨ペアの上限は通貨ペアごと・口座ごとに独立し、symbol が空なら口座のバケットのみ
+//   atomic    : 通貨ペアの上限で止めた場合は口座のトークンも消費しない
+//   clock     : 時計が戻っても補充しない
+//   queue     : 上限で見送ったコマンドはキューに残り、同じバケットの後続コマンドに追い越されない
+
+#include "../CommandThrottle.h"
+#include "../InboundQueue.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+
+const long long kMs = 1000;
+
+ThrottleLimits AccountLimits(double rate, double burst) {
+    ThrottleLimits limits;
+    limits.accountRate = rate;
+    limits.accountBurst = burst;
+    return limits;
+}
+
+void TestBurst() {
+    CommandThrottle throttle;
+    EXPECT(!throttle.Enabled());
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 0) == ThrottleResult::Allowed);
+
+    // 10件/秒、連続3件
+    throttle.SetLimits(AccountLimits(10.0, 3.0));
+    EXPECT(throttle.Enabled());
+    for (int i = 0; i < 3; i++) {
+        EXPECT(throttle.TryAcquire("A", "EURUSD", 1000 * kMs) == ThrottleResult::Allowed);
+    }
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 1000 * kMs) == ThrottleResult::AccountLimited);
+    // 100ms で1件分補充
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 1099 * kMs) == ThrottleResult::AccountLimited);
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 1100 * kMs) == ThrottleResult::Allowed);
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 1100 * kMs) == ThrottleResult::AccountLimited);
+    // 長く空いても burst までしか貯まらない
+    for (int i = 0; i < 3; i++) {
+        EXPECT(throttle.TryAcquire("A", "EURUSD", 5000 * kMs) == ThrottleResult::Allowed);
+    }
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 5000 * kMs) == ThrottleResult::AccountLimited);
+
+    // burst 0 でも1件は通す
+    throttle.SetLimits(AccountLimits(1.0, 0.0));
+    EXPECT(throttle.Limits().accountBurst == 1.0);
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 0) == ThrottleResult::Allowed);
+}
+
+void TestBuckets() {
+    CommandThrottle throttle;
+    ThrottleLimits limits;
+    limits.symbolRate = 1.0;
+    limits.symbolBurst = 1.0;
+    throttle.SetLimits(limits);
+
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 0) == ThrottleResult::Allowed);
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 0) == ThrottleResult::SymbolLimited);
+    EXPECT(throttle.TryAcquire("A", "USDJPY", 0) == ThrottleResult::Allowed);
+    EXPECT(throttle.TryAcquire("B", "EURUSD", 0) == ThrottleResult::Allowed);
+    // 通貨ペアの指定がないコマンド（チケット指定の CLOSE 等）は通貨ペアの上限を受けない
+    EXPECT(throttle.TryAcquire("A", "", 0) == ThrottleResult::Allowed);
+    EXPECT(throttle.TryAcquire("A", "", 0) == ThrottleResult::Allowed);
+}
+
+void TestAtomic() {
+    CommandThrottle throttle;
+    ThrottleLimits limits;
+    limits.accountRate = 1.0;
+    limits.accountBurst = 2.0;
+    limits.symbolRate = 1.0;
+    limits.symbolBurst = 1.0;
+    throttle.SetLimits(limits);
+
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 0) == ThrottleResult::Allowed);
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 0) == ThrottleResult::SymbolLimited);
+    // 止めた EURUSD は口座のトークンを消費していないため、別の通貨ペアは通る
+    EXPECT(throttle.TryAcquire("A", "USDJPY", 0) == ThrottleResult::Allowed);
+    EXPECT(throttle.TryAcquire("A", "GBPUSD", 0) == ThrottleResult::AccountLimited);
+}
+
+void TestClock() {
+    CommandThrottle throttle;
+    throttle.SetLimits(AccountLimits(10.0, 1.0));
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 1000 * kMs) == ThrottleResult::Allowed);
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 500 * kMs) == ThrottleResult::AccountLimited);
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 1099 * kMs) == ThrottleResult::AccountLimited);
+    EXPECT(throttle.TryAcquire("A", "EURUSD", 1100 * kMs) == ThrottleResult::Allowed);
+}
+
+InboundMessage Command(CommandType type, const std::string& commandId, const std::string& accountId) {
+    InboundMessage message;
+    message.isCommand = true;
+    message.command.type = type;
+    message.command.commandId = commandId;
+    message.command.accountId = accountId;
+    message.command.symbol = "EURUSD";
+    message.payload = commandId;
+    return message;
+}
+
+void TestQueue() {
+    InboundQueue queue;
+    queue.SetThrottle(AccountLimits(1.0, 1.0));
+
+    using Clock = std::chrono::system_clock;
+    Clock::time_point now = Clock::now();
+    queue.Push(Command(CommandType::Open, "a1", "A"));
+    queue.Push(Command(CommandType::Open, "a2", "A"));
+    queue.Push(Command(CommandType::Open, "b1", "B"));
+    // CLOSE は先に受信した OPEN より先に口座 A のトークンを使う
+    queue.Push(Command(CommandType::Close, "a3", "A"));
+
+    std::vector<InboundMessage> expired;
+    InboundMessage message;
+    EXPECT(queue.PopNextCommand(now, message, expired) && message.payload == "a3");
+    // 口座 A は上限。後続の a2 も追い越さずに待ち、口座 B は通す
+    EXPECT(queue.PopNextCommand(now, message, expired) && message.payload == "b1");
+    EXPECT(!queue.PopNextCommand(now, message, expired));
+    EXPECT(queue.Size() == 2);
+
+    Clock::time_point later = now + std::chrono::seconds(1);
+    EXPECT(queue.PopNextCommand(later, message, expired) && message.payload == "a1");
+    EXPECT(message.throttled);
+    EXPECT(!queue.PopNextCommand(later, message, expired));
+    EXPECT(queue.PopNextCommand(later + std::chrono::seconds(1), message, expired) && message.payload == "a2");
+
+    CommandWaitStats stats = queue.WaitStats();
+    EXPECT(stats.commands == 4 && stats.throttled == 2);
+}
+
+} // namespace
+
+int main() {
+    TestBurst();
+    TestBuckets();
+    TestAtomic();
+    TestClock();
+    TestQueue();
+    return FinishTest("CommandThrottleTest");
+}
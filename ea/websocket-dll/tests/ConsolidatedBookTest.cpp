@@ -0,0 +1,133 @@
+// 口座横断の統合気配のテスト
+//
+//   best      : 最も高い bid と最も安い ask を別々の口座から選び、提供元・時刻を公開する
+//   tie       : 同値の場合は新しく受信した気配を優先する
+//   stale     : 同じ口座でブローカー時刻が戻った気配は捨て、最良気配を変えない
+//   maxAge    : maxAgeUs より古い気配は最良気配の計算から除く
+//   registry  : 通貨ペア・口座の番号は一度登録したら変わらず、未登録・長すぎる名前は -1
+
+#include "../ConsolidatedBook.h"
+#include "TestSupport.h"
+#include <string>
+
+namespace {
+
+const long long kMs = 1000;
+
+void TestBest() {
+    ConsolidatedBook book;
+    BestQuote quote;
+    EXPECT(!book.Best("EURUSD", quote));
+
+    EXPECT(book.Update("EURUSD", "A", 1.1000, 1.1003, 100, 1 * kMs));
+    EXPECT(book.Update("EURUSD", "B", 1.1001, 1.1004, 200, 2 * kMs));
+    EXPECT(book.Update("EURUSD", "C", 1.0999, 1.1002, 300, 3 * kMs));
+
+    EXPECT(book.Best("EURUSD", quote));
+    EXPECT(quote.bid == 1.1001 && book.SourceName(quote.bidSource) == "B");
+    EXPECT(quote.ask == 1.1002 && book.SourceName(quote.askSource) == "C");
+    EXPECT(quote.bidReceivedUs == 2 * kMs && quote.askReceivedUs == 3 * kMs);
+    EXPECT(quote.bidTimeMsc == 200 && quote.askTimeMsc == 300);
+    EXPECT(quote.sources == 3);
+    EXPECT(quote.updates == 3);
+
+    // 最良 bid の口座が値を下げると、次に高い口座に移る
+    EXPECT(book.Update("EURUSD", "B", 1.0990, 1.1004, 201, 4 * kMs));
+    EXPECT(book.Best("EURUSD", quote));
+    EXPECT(quote.bid == 1.1000 && book.SourceName(quote.bidSource) == "A");
+}
+
+void TestTie() {
+    ConsolidatedBook book;
+    book.Update("EURUSD", "A", 1.1000, 1.1003, 100, 1 * kMs);
+    book.Update("EURUSD", "B", 1.1000, 1.1003, 100, 2 * kMs);
+
+    BestQuote quote;
+    EXPECT(book.Best("EURUSD", quote));
+    EXPECT(book.SourceName(quote.bidSource) == "B" && book.SourceName(quote.askSource) == "B");
+
+    book.Update("EURUSD", "A", 1.1000, 1.1003, 101, 3 * kMs);
+    EXPECT(book.Best("EURUSD", quote));
+    EXPECT(book.SourceName(quote.bidSource) == "A");
+}
+
+void TestStale() {
+    ConsolidatedBook book;
+    EXPECT(book.Update("EURUSD", "A", 1.1000, 1.1003, 500, 1 * kMs));
+    // 遅れて届いた古いティック（より良い価格でも採用しない）
+    EXPECT(!book.Update("EURUSD", "A", 1.2000, 1.2003, 400, 2 * kMs));
+
+    BestQuote quote;
+    EXPECT(book.Best("EURUSD", quote));
+    EXPECT(quote.bid == 1.1000 && quote.bidTimeMsc == 500);
+    EXPECT(quote.updates == 1);
+
+    // 同じ時刻の更新と、ブローカー時刻のない気配（0）は採用する
+    EXPECT(book.Update("EURUSD", "A", 1.1001, 1.1004, 500, 3 * kMs));
+    EXPECT(book.Update("EURUSD", "A", 1.1002, 1.1005, 0, 4 * kMs));
+    EXPECT(book.Best("EURUSD", quote));
+    EXPECT(quote.bid == 1.1002 && quote.updates == 3);
+
+    // 別の口座の時刻は比べない
+    EXPECT(book.Update("EURUSD", "B", 1.0990, 1.0993, 100, 5 * kMs));
+}
+
+void TestMaxAge() {
+    ConsolidatedBook book;
+    book.SetMaxAgeUs(1000 * kMs);
+    book.Update("EURUSD", "A", 1.1005, 1.1008, 100, 1);
+    book.Update("EURUSD", "B", 1.1000, 1.1003, 100, 500 * kMs);
+
+    BestQuote quote;
+    EXPECT(book.Best("EURUSD", quote));
+    EXPECT(book.SourceName(quote.bidSource) == "A" && quote.sources == 2);
+
+    // A の気配は 1 秒以上前のため、B の更新で最良気配から外れる
+    book.Update("EURUSD", "B", 1.1000, 1.1003, 101, 1500 * kMs);
+    EXPECT(book.Best("EURUSD", quote));
+    EXPECT(book.SourceName(quote.bidSource) == "B" && quote.sources == 1);
+
+    // 無制限にすると次の更新から A も含める
+    book.SetMaxAgeUs(0);
+    book.Update("EURUSD", "B", 1.1000, 1.1003, 102, 1600 * kMs);
+    EXPECT(book.Best("EURUSD", quote));
+    EXPECT(book.SourceName(quote.bidSource) == "A" && quote.sources == 2);
+}
+
+void TestRegistry() {
+    ConsolidatedBook book;
+    int eurusd = book.Symbol("EURUSD");
+    int usdjpy = book.Symbol("USDJPY");
+    EXPECT(eurusd >= 0 && usdjpy >= 0 && eurusd != usdjpy);
+    EXPECT(book.Symbol("EURUSD") == eurusd);
+    EXPECT(book.FindSymbol("USDJPY") == usdjpy);
+    EXPECT(book.FindSymbol("GBPUSD") == -1);
+    EXPECT(book.SymbolCount() == 2);
+
+    int a = book.Source("A");
+    EXPECT(a == 0 && book.Source("B") == 1 && book.Source("A") == 0);
+    EXPECT(book.SourceCount() == 2);
+    EXPECT(book.Source("") == -1);
+    EXPECT(book.Source(std::string(ConsolidatedBook::kSourceSize, 'x')) == -1);
+    EXPECT(book.Symbol(std::string(ConsolidatedBook::kSymbolSize, 'x')) == -1);
+    EXPECT(book.SourceName(5).empty());
+
+    // 番号指定の更新と価格の検証
+    EXPECT(book.Update(eurusd, a, 1.1, 1.1002, 1, 1));
+    EXPECT(!book.Update(eurusd, a, 0.0, 1.1002, 2, 2));
+    EXPECT(!book.Update(eurusd, 40, 1.1, 1.1002, 2, 2));
+    BestQuote quote;
+    EXPECT(book.Best(eurusd, quote) && quote.bid == 1.1);
+    EXPECT(!book.Best(usdjpy, quote));
+}
+
+} // namespace
+
+int main() {
+    TestBest();
+    TestTie();
+    TestStale();
+    TestMaxAge();
+    TestRegistry();
+    return FinishTest("ConsolidatedBookTest");
+}
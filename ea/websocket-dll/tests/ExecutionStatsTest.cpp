@@ -0,0 +1,159 @@
+// 約定品質の集計のテスト（HDRヒストグラムと口座 × 通貨ペアの集計）
+//
+//   histogram : 百分位値の相対誤差が有効桁数の範囲に収まり、最小・最大・平均は正確。範囲外の値は上限に丸める
+//   slippage  : 有利方向（負）と不利方向（正）をまとめた順で百分位を求め、平均・最大も符号つきで返す
+//   keys      : 口座 × 通貨ペアと口座全体の両方に集計し、拒否率を求める。Collect で区間をリセットする
+//   capacity  : キーが上限に達したら集計できない発注を数え、記録のないキーは次の区間で再利用する
+
+#include "../ExecutionStats.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool Within(int64_t actual, int64_t expected, double relative) {
+    return std::fabs(static_cast<double>(actual - expected)) <= static_cast<double>(expected) * relative;
+}
+
+void TestHistogram() {
+    HdrHistogram histogram(60LL * 1000 * 1000, 2);
+    EXPECT(histogram.TotalCount() == 0 && histogram.ValueAtPercentile(50.0) == 0);
+    size_t footprint = histogram.FootprintBytes();
+
+    for (int64_t value = 1; value <= 100000; value++) {
+        histogram.Record(value);
+    }
+    EXPECT(histogram.TotalCount() == 100000);
+    EXPECT(histogram.Min() == 1 && histogram.Max() == 100000);
+    EXPECT(std::fabs(histogram.Mean() - 50000.5) < 1e-6);
+    EXPECT(Within(histogram.ValueAtPercentile(50.0), 50000, 0.01));
+    EXPECT(Within(histogram.ValueAtPercentile(90.0), 90000, 0.01));
+    EXPECT(Within(histogram.ValueAtPercentile(99.0), 99000, 0.01));
+    EXPECT(Within(histogram.ValueAtPercentile(100.0), 100000, 0.01));
+    // 小さい値はサブバケットの分解能内なので正確
+    EXPECT(histogram.ValueAtRank(1) == 1 && histogram.ValueAtRank(100) == 100);
+    // 記録件数によらずメモリ使用量は一定
+    EXPECT(histogram.FootprintBytes() == footprint);
+
+    histogram.Reset();
+    histogram.Record(-5);
+    histogram.Record(120LL * 1000 * 1000);
+    EXPECT(histogram.Min() == 0);
+    EXPECT(Within(histogram.Max(), 60LL * 1000 * 1000, 0.01));
+}
+
+CompletedTrade Trade(const std::string& accountId, const std::string& symbol, double slippage, long long latencyUs) {
+    CompletedTrade trade;
+    trade.submission.accountId = accountId;
+    trade.submission.symbol = symbol;
+    trade.slippagePoints = slippage;
+    trade.submitToFillUs = latencyUs;
+    return trade;
+}
+
+CompletedTrade Rejected(const std::string& accountId, const std::string& symbol) {
+    CompletedTrade trade = Trade(accountId, symbol, 0.0, -1);
+    trade.outcome = CompletedTrade::Outcome::Rejected;
+    return trade;
+}
+
+const ExecutionStatsSnapshot* Find(const std::vector<ExecutionStatsSnapshot>& snapshots, const std::string& symbol) {
+    for (const auto& snapshot : snapshots) {
+        if (snapshot.symbol == symbol) {
+            return &snapshot;
+        }
+    }
+    return nullptr;
+}
+
+void TestSlippage() {
+    ExecutionStats stats;
+    // -4.0 〜 +5.0 ポイントの10件（有利4件・0・不利5件）
+    for (int i = -4; i <= 5; i++) {
+        stats.Record(Trade("A", "EURUSD", static_cast<double>(i), 1000 * (i + 5)));
+    }
+
+    std::vector<ExecutionStatsSnapshot> snapshots;
+    stats.Collect(snapshots);
+    const ExecutionStatsSnapshot* eurusd = Find(snapshots, "EURUSD");
+    EXPECT(eurusd != nullptr);
+    if (eurusd == nullptr) {
+        return;
+    }
+    EXPECT(eurusd->fills == 10 && eurusd->rejects == 0);
+    EXPECT(std::fabs(eurusd->slippageMean - 0.5) < 1e-9);
+    EXPECT(eurusd->slippageP50 == 0.0);
+    EXPECT(eurusd->slippageP90 == 4.0);
+    EXPECT(eurusd->slippageMax == 5.0);
+    EXPECT(Within(eurusd->latencyP50Us, 5000, 0.01));
+    EXPECT(Within(eurusd->latencyMaxUs, 10000, 0.01));
+
+    // 有利方向だけの場合、最大は最も不利（絶対値の最小）な値
+    ExecutionStats favorable;
+    favorable.Record(Trade("A", "EURUSD", -1.5, 1000));
+    favorable.Record(Trade("A", "EURUSD", -3.0, 1000));
+    snapshots.clear();
+    favorable.Collect(snapshots);
+    eurusd = Find(snapshots, "EURUSD");
+    EXPECT(eurusd != nullptr && eurusd->slippageMax == -1.5 && eurusd->slippageP50 == -3.0);
+}
+
+void TestKeys() {
+    ExecutionStats stats;
+    stats.Record(Trade("A", "EURUSD", 1.0, 1000));
+    stats.Record(Trade("A", "USDJPY", 2.0, 2000));
+    stats.Record(Rejected("A", "USDJPY"));
+    stats.Record(Rejected("A", "USDJPY"));
+
+    std::vector<ExecutionStatsSnapshot> snapshots;
+    stats.Collect(snapshots);
+    EXPECT(snapshots.size() == 3);
+    const ExecutionStatsSnapshot* usdjpy = Find(snapshots, "USDJPY");
+    const ExecutionStatsSnapshot* account = Find(snapshots, "");
+    EXPECT(usdjpy != nullptr && usdjpy->fills == 1 && usdjpy->rejects == 2);
+    EXPECT(usdjpy != nullptr && std::fabs(usdjpy->rejectRate - 2.0 / 3.0) < 1e-9);
+    EXPECT(account != nullptr && account->accountId == "A" && account->fills == 2 && account->rejects == 2);
+
+    // 記録のない区間は何も返さない
+    snapshots.clear();
+    stats.Collect(snapshots);
+    EXPECT(snapshots.empty());
+
+    stats.Record(Trade("A", "EURUSD", 1.0, 1000));
+    stats.Collect(snapshots);
+    EXPECT(snapshots.size() == 2);
+    EXPECT(Find(snapshots, "EURUSD") != nullptr && Find(snapshots, "EURUSD")->fills == 1);
+}
+
+void TestCapacity() {
+    ExecutionStats stats;
+    // 口座全体の1キー + 通貨ペア (kMaxKeys - 1) キーで満杯
+    for (size_t i = 0; i + 1 < ExecutionStats::kMaxKeys; i++) {
+        stats.Record(Trade("A", "S" + std::to_string(i), 0.0, 1000));
+    }
+    EXPECT(stats.DroppedCount() == 0);
+    stats.Record(Trade("A", "OVER", 0.0, 1000));
+    EXPECT(stats.DroppedCount() == 1);
+
+    // 区間が変われば記録のないキーを再利用できる
+    std::vector<ExecutionStatsSnapshot> snapshots;
+    stats.Collect(snapshots);
+    EXPECT(snapshots.size() == ExecutionStats::kMaxKeys);
+    snapshots.clear();
+    stats.Record(Trade("A", "OVER", 0.0, 1000));
+    EXPECT(stats.DroppedCount() == 1);
+    stats.Collect(snapshots);
+    EXPECT(Find(snapshots, "OVER") != nullptr);
+}
+
+} // namespace
+
+int main() {
+    TestHistogram();
+    TestSlippage();
+    TestKeys();
+    TestCapacity();
+    return FinishTest("ExecutionStatsTest");
+}
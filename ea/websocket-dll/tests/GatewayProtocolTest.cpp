@@ -0,0 +1,60 @@
+// ゲートウェイのエンベロープのテスト
+//
+//   wrap    : 端末のフレームを口座IDつきの ACCOUNT_FRAME に包み、元のフレームを書き換えずに取り出せる
+//   escape  : 口座IDのエスケープと、フレーム内の文字列に含まれる括弧・引用符を取り違えない
+//   invalid : ACCOUNT_FRAME 以外・message がオブジェクトでない・口座IDのないエンベロープは false
+
+#include "../GatewayProtocol.h"
+#include "TestSupport.h"
+#include <string>
+
+namespace {
+
+void TestWrap() {
+    std::string frame = R"({"type":"OPEN","accountId":"A","symbol":"EURUSD","volume":0.1})";
+    std::string envelope = WrapAccountFrame("A", frame);
+    EXPECT(envelope == R"({"type":"ACCOUNT_FRAME","accountId":"A","message":)" + frame + "}");
+
+    std::string accountId;
+    std::string unwrapped;
+    EXPECT(UnwrapAccountFrame(envelope, accountId, unwrapped));
+    EXPECT(accountId == "A" && unwrapped == frame);
+
+    // フィールドの順序が違っても開ける
+    EXPECT(UnwrapAccountFrame(R"({"message":{"type":"PING"},"accountId":"B","type":"ACCOUNT_FRAME"})", accountId,
+                              unwrapped));
+    EXPECT(accountId == "B" && unwrapped == R"({"type":"PING"})");
+
+    // ゲートウェイの口座IDは実在の口座IDと重ならない
+    EXPECT(std::string(kGatewayAccountId).find('@') != std::string::npos);
+}
+
+void TestEscape() {
+    std::string frame = R"({"type":"ERROR","message":"bad } \"value\" {","data":{"list":[1,{"x":"]"}]}})";
+    std::string envelope = WrapAccountFrame("acc\"1", frame);
+
+    std::string accountId;
+    std::string unwrapped;
+    EXPECT(UnwrapAccountFrame(envelope, accountId, unwrapped));
+    EXPECT(accountId == "acc\"1" && unwrapped == frame);
+}
+
+void TestInvalid() {
+    std::string accountId;
+    std::string frame;
+    EXPECT(!UnwrapAccountFrame(R"({"type":"OPEN","accountId":"A","message":{"type":"PING"}})", accountId, frame));
+    EXPECT(!UnwrapAccountFrame(R"({"type":"ACCOUNT_FRAME","accountId":"A","message":"PING"})", accountId, frame));
+    EXPECT(!UnwrapAccountFrame(R"({"type":"ACCOUNT_FRAME","accountId":"A"})", accountId, frame));
+    EXPECT(!UnwrapAccountFrame(R"({"type":"ACCOUNT_FRAME","message":{"type":"PING"}})", accountId, frame));
+    EXPECT(!UnwrapAccountFrame(R"({"type":"ACCOUNT_FRAME","accountId":"","message":{}})", accountId, frame));
+    EXPECT(!UnwrapAccountFrame("", accountId, frame));
+}
+
+} // namespace
+
+int main() {
+    TestWrap();
+    TestEscape();
+    TestInvalid();
+    return FinishTest("GatewayProtocolTest");
+}
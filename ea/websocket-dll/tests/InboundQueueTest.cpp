@@ -0,0 +1,159 @@
+// 受信キューのテスト（優先度・MODIFY のまとめ）
+//
+//   priority      : CLOSE・MODIFY は先に受信した OPEN を追い越し、OPEN はコマンド以外のメッセージを追い越す
+//   fifo          : 同一優先度内は受信順で取り出す
+//   commandOnly   : PopNextCommand はコマンド以外のメッセージをキューに残す
+//   expired       : 滞留中に期限切れとなったコマンドは expired に移し、取り出さない
+//   coalesce      : 同一ポジションへの未取り出しの MODIFY は1件にまとめ、指定のない SL/TP は前の指定を引き継ぐ
+
+#include "../InboundQueue.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::system_clock;
+
+InboundMessage Command(CommandType type, const std::string& commandId) {
+    InboundMessage message;
+    message.isCommand = true;
+    message.command.type = type;
+    message.command.commandId = commandId;
+    message.command.accountId = "A";
+    message.command.symbol = "EURUSD";
+    message.payload = commandId;
+    return message;
+}
+
+InboundMessage Info(const std::string& payload) {
+    InboundMessage message;
+    message.payload = payload;
+    return message;
+}
+
+// 取り出した順の payload（コマンドは commandId）
+std::vector<std::string> Drain(InboundQueue& queue, Clock::time_point now) {
+    std::vector<std::string> order;
+    std::vector<InboundMessage> expired;
+    InboundMessage message;
+    while (queue.PopNext(now, message, expired)) {
+        order.push_back(message.payload);
+    }
+    return order;
+}
+
+void TestPriority() {
+    InboundQueue queue;
+    EXPECT(queue.Push(Info("price")));
+    EXPECT(queue.Push(Command(CommandType::Open, "open")));
+    EXPECT(queue.Push(Command(CommandType::Modify, "modify")));
+    EXPECT(queue.Push(Command(CommandType::Close, "close")));
+    EXPECT(queue.Size() == 4);
+
+    std::vector<std::string> expected = {"modify", "close", "open", "price"};
+    EXPECT(Drain(queue, Clock::now()) == expected);
+    EXPECT(queue.Size() == 0);
+}
+
+void TestFifo() {
+    InboundQueue queue;
+    queue.Push(Command(CommandType::Open, "open1"));
+    queue.Push(Command(CommandType::Close, "close1"));
+    queue.Push(Command(CommandType::Open, "open2"));
+    queue.Push(Command(CommandType::Close, "close2"));
+
+    std::vector<std::string> expected = {"close1", "close2", "open1", "open2"};
+    EXPECT(Drain(queue, Clock::now()) == expected);
+}
+
+void TestCommandOnly() {
+    InboundQueue queue;
+    queue.Push(Info("price"));
+    queue.Push(Command(CommandType::Open, "open"));
+
+    Clock::time_point now = Clock::now();
+    std::vector<InboundMessage> expired;
+    InboundMessage message;
+    EXPECT(queue.PopNextCommand(now, message, expired));
+    EXPECT(message.payload == "open");
+    EXPECT(!queue.PopNextCommand(now, message, expired));
+    EXPECT(queue.Size() == 1);
+
+    EXPECT(queue.PopNext(now, message, expired));
+    EXPECT(message.payload == "price" && !message.isCommand);
+}
+
+void TestExpired() {
+    InboundQueue queue;
+    Clock::time_point now = Clock::now();
+
+    InboundMessage stale = Command(CommandType::Close, "stale");
+    stale.hasDeadline = true;
+    stale.deadline = now - std::chrono::milliseconds(1);
+    queue.Push(stale);
+
+    InboundMessage fresh = Command(CommandType::Open, "fresh");
+    fresh.hasDeadline = true;
+    fresh.deadline = now + std::chrono::seconds(1);
+    queue.Push(fresh);
+
+    std::vector<InboundMessage> expired;
+    InboundMessage message;
+    EXPECT(queue.PopNext(now, message, expired));
+    EXPECT(message.payload == "fresh");
+    EXPECT(expired.size() == 1 && expired[0].payload == "stale");
+    EXPECT(queue.Size() == 0);
+}
+
+InboundMessage Modify(const std::string& commandId, const std::string& positionId, long long stopLoss,
+                      long long takeProfit) {
+    InboundMessage message = Command(CommandType::Modify, commandId);
+    message.command.positionId = positionId;
+    message.command.stopLoss.raw = stopLoss;
+    message.command.stopLoss.present = stopLoss >= 0;
+    message.command.takeProfit.raw = takeProfit;
+    message.command.takeProfit.present = takeProfit >= 0;
+    return message;
+}
+
+void TestCoalesce() {
+    InboundQueue queue;
+    queue.Push(Command(CommandType::Close, "close"));
+    EXPECT(queue.Push(Modify("m1", "p1", 100, 200)));
+    EXPECT(queue.Push(Modify("other", "p2", 300, -1)));
+    // p1 への2件目は1件目を置き換える（TP は指定がないため 200 を引き継ぐ）
+    EXPECT(!queue.Push(Modify("m2", "p1", 110, -1)));
+    EXPECT(queue.Size() == 3);
+    EXPECT(queue.CoalescedModifyCount() == 1);
+
+    // 別口座の同じ positionId はまとめない
+    InboundMessage otherAccount = Modify("m3", "p1", 120, -1);
+    otherAccount.command.accountId = "B";
+    EXPECT(queue.Push(otherAccount));
+
+    std::vector<InboundMessage> expired;
+    InboundMessage message;
+    Clock::time_point now = Clock::now();
+    EXPECT(queue.PopNext(now, message, expired) && message.payload == "close");
+    // まとめた MODIFY は最初の MODIFY の位置で取り出す
+    EXPECT(queue.PopNext(now, message, expired) && message.payload == "m2");
+    EXPECT(message.command.stopLoss.present && message.command.stopLoss.raw == 110);
+    EXPECT(message.command.takeProfit.present && message.command.takeProfit.raw == 200);
+    EXPECT(queue.PopNext(now, message, expired) && message.payload == "other");
+    EXPECT(queue.PopNext(now, message, expired) && message.payload == "m3");
+    EXPECT(message.command.accountId == "B" && !message.command.takeProfit.present);
+    EXPECT(!queue.PopNext(now, message, expired));
+}
+
+} // namespace
+
+int main() {
+    TestPriority();
+    TestFifo();
+    TestCommandOnly();
+    TestExpired();
+    TestCoalesce();
+    return FinishTest("InboundQueueTest");
+}
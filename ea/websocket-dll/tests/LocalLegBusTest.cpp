@@ -0,0 +1,92 @@
+// 同じ端末内のレッグ受け渡しのテスト
+//
+//   route : 対のレッグの口座がこの端末の口座なら Local、それ以外は Upstream
+//   take  : 主レッグの口座・ポジションIDで一度だけ取り出せ、同じキーの再登録は置き換える
+//   stale : kMaxArmedUs を超えて保持した対のレッグだけを DropStale で取り出す
+
+#include "../LocalLegBus.h"
+#include "TestSupport.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+ArmedLeg Armed(const std::string& accountId, const std::string& positionId, const std::string& legAccountId,
+               long long armedAtUs) {
+    ArmedLeg armed;
+    armed.accountId = accountId;
+    armed.positionId = positionId;
+    armed.actionId = "act-" + positionId;
+    armed.leg.accountId = legAccountId;
+    armed.leg.positionId = positionId + "-hedge";
+    armed.leg.symbol = "EURUSD";
+    armed.leg.side = "SELL";
+    armed.leg.volume = 0.1;
+    armed.armedAtUs = armedAtUs;
+    return armed;
+}
+
+void TestRoute() {
+    LocalLegBus bus;
+    bus.AddLocalAccount("A");
+    bus.AddLocalAccount("");
+
+    PairedLeg leg;
+    leg.accountId = "A";
+    EXPECT(bus.Route(leg) == LegRoute::Local);
+    leg.accountId = "B";
+    EXPECT(bus.Route(leg) == LegRoute::Upstream);
+    leg.accountId = "";
+    EXPECT(bus.Route(leg) == LegRoute::Upstream);
+}
+
+void TestTake() {
+    LocalLegBus bus;
+    ArmedLeg taken;
+    EXPECT(!bus.Take("A", "p1", taken));
+
+    bus.Arm(Armed("A", "p1", "B", 0));
+    bus.Arm(Armed("A", "p2", "B", 0));
+    EXPECT(bus.ArmedCount() == 2);
+
+    // 口座とポジションIDの組で引く
+    EXPECT(!bus.Take("B", "p1", taken));
+    EXPECT(!bus.Take("Ap", "1", taken));
+    EXPECT(bus.Take("A", "p1", taken));
+    EXPECT(taken.actionId == "act-p1" && taken.leg.accountId == "B" && taken.leg.positionId == "p1-hedge");
+    EXPECT(!bus.Take("A", "p1", taken));
+
+    // 同じキーの再登録は置き換える
+    ArmedLeg replacement = Armed("A", "p2", "C", 0);
+    bus.Arm(replacement);
+    EXPECT(bus.ArmedCount() == 1);
+    EXPECT(bus.Take("A", "p2", taken) && taken.leg.accountId == "C");
+    EXPECT(bus.ArmedCount() == 0);
+}
+
+void TestStale() {
+    LocalLegBus bus;
+    bus.Arm(Armed("A", "old", "B", 1000));
+    bus.Arm(Armed("A", "new", "B", 2000));
+
+    std::vector<ArmedLeg> expired;
+    bus.DropStale(1000 + LocalLegBus::kMaxArmedUs, expired);
+    EXPECT(expired.empty());
+
+    bus.DropStale(1001 + LocalLegBus::kMaxArmedUs, expired);
+    EXPECT(expired.size() == 1 && expired[0].positionId == "old");
+    EXPECT(bus.ArmedCount() == 1);
+
+    ArmedLeg taken;
+    EXPECT(!bus.Take("A", "old", taken));
+    EXPECT(bus.Take("A", "new", taken));
+}
+
+} // namespace
+
+int main() {
+    TestRoute();
+    TestTake();
+    TestStale();
+    return FinishTest("LocalLegBusTest");
+}
@@ -0,0 +1,158 @@
+// 証拠金維持率モニターのテスト
+//
+//   severity : 維持率が警告・危険・マージンコール・ストップアウト接近の水準以下になった時点で段階を上げて通知し、
+//              回復は水準の (1 + kRecoveryHysteresis) 倍を上回るまで戻さない
+//   hedge    : 両建ての必要証拠金は SYMBOL_MARGIN_HEDGED の比率で求め、決済の確定損益を有効証拠金に加える
+//   specs    : 通貨ペア仕様の版が変わったら必要証拠金を取り直す
+//   account  : 口座情報の通知前と証拠金を使っていない間は通知しない。設定水準 0 は無効
+
+#include "../MarginMonitor.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+bool Near(double actual, double expected) {
+    return std::fabs(actual - expected) < 1e-6;
+}
+
+// 1ロットの必要証拠金 1000、両建ては片側の半分
+SymbolSpec EurUsd(double marginPerLot) {
+    SymbolSpec spec;
+    spec.symbol = "EURUSD";
+    spec.contractSize = 100000.0;
+    spec.marginPerLot = marginPerLot;
+    spec.marginHedged = 50000.0;
+    return spec;
+}
+
+MarginAccountState Account() {
+    MarginAccountState account;
+    account.accountId = "A";
+    account.equity = 10000.0;
+    account.margin = 1000.0;
+    account.marginCallLevel = 100.0;
+    account.stopOutLevel = 50.0;
+    return account;
+}
+
+void TestSeverity() {
+    SymbolSpecTable specs;
+    specs.Load({EurUsd(1000.0)});
+    MarginMonitor monitor(specs);
+    monitor.Seed(1, "EURUSD", true, 1.0);
+
+    MarginAlert alert;
+    EXPECT(!monitor.SetAccount(Account(), 0.0, alert));
+    EXPECT(Near(monitor.GetState().marginLevel, 1000.0));
+
+    // 290% で警告
+    EXPECT(monitor.OnPnL(-7100.0, alert));
+    EXPECT(alert.accountId == "A" && alert.state.severity == MarginSeverity::Warning);
+    EXPECT(alert.previousSeverity == MarginSeverity::Normal && alert.threshold == 300.0);
+    EXPECT(Near(alert.state.equity, 2900.0) && Near(alert.state.marginLevel, 290.0));
+
+    // 305% はヒステリシス（306%）の内側なので戻さない
+    EXPECT(!monitor.OnPnL(-6950.0, alert));
+    EXPECT(monitor.GetState().severity == MarginSeverity::Warning);
+
+    // 310% で回復。水準は直前の段階のもの
+    EXPECT(monitor.OnPnL(-6900.0, alert));
+    EXPECT(alert.state.severity == MarginSeverity::Normal && alert.previousSeverity == MarginSeverity::Warning);
+    EXPECT(alert.threshold == 300.0);
+
+    // 50% はストップアウト水準の kStopOutProximity 倍（60%）以下。途中の段階は飛ばす
+    EXPECT(monitor.OnPnL(-9500.0, alert));
+    EXPECT(alert.state.severity == MarginSeverity::StopOut && alert.previousSeverity == MarginSeverity::Normal);
+    EXPECT(Near(alert.threshold, 50.0 * MarginMonitor::kStopOutProximity));
+    EXPECT(Near(alert.state.equityToStopOut, 500.0 - 1000.0 * 0.5));
+
+    // 100% への回復は 61.2% を超えるのでマージンコールまで戻り、102% 以下なのでそこで止まる
+    EXPECT(monitor.OnPnL(-9000.0, alert));
+    EXPECT(alert.state.severity == MarginSeverity::MarginCall && alert.previousSeverity == MarginSeverity::StopOut);
+    EXPECT(!monitor.OnPnL(-8990.0, alert));
+}
+
+void TestHedge() {
+    SymbolSpecTable specs;
+    specs.Load({EurUsd(1000.0)});
+    MarginMonitor monitor(specs);
+    monitor.Seed(1, "EURUSD", true, 1.0);
+    MarginAlert alert;
+    monitor.SetAccount(Account(), 0.0, alert);
+
+    // 同量の売りで両建て: 1000 × 1 ロット × 0.5
+    monitor.OnDeal(2, "EURUSD", false, 0, 1.0, 0.0, 0.0, alert);
+    MarginState state = monitor.GetState();
+    EXPECT(Near(state.margin, 500.0));
+    EXPECT(Near(state.marginLevel, 2000.0));
+
+    // 売りの決済で確定損益 +20 を加える。未決済の買いだけが残る
+    monitor.OnDeal(2, "EURUSD", true, 1, 1.0, 20.0, 0.0, alert);
+    state = monitor.GetState();
+    EXPECT(Near(state.margin, 1000.0) && Near(state.equity, 10020.0));
+    EXPECT(Near(state.freeMargin, 9020.0));
+
+    // 全決済で証拠金は 0、維持率も 0
+    monitor.OnDeal(1, "EURUSD", false, 1, 1.0, -5.0, 0.0, alert);
+    state = monitor.GetState();
+    EXPECT(state.margin == 0.0 && state.marginLevel == 0.0 && Near(state.equity, 10015.0));
+
+    // 未知の DEAL_ENTRY は無視する
+    EXPECT(!monitor.OnDeal(3, "EURUSD", true, 9, 1.0, 0.0, 0.0, alert));
+}
+
+void TestSpecs() {
+    SymbolSpecTable specs;
+    specs.Load({EurUsd(1000.0)});
+    MarginMonitor monitor(specs);
+    monitor.Seed(1, "EURUSD", true, 1.0);
+    MarginAlert alert;
+    monitor.SetAccount(Account(), 0.0, alert);
+
+    // 1ロットの必要証拠金が倍になると、次の評価で推定値に反映される
+    specs.Load({EurUsd(2000.0)});
+    monitor.OnPnL(0.0, alert);
+    EXPECT(Near(monitor.GetState().margin, 2000.0));
+
+    // 仕様のない通貨ペアは必要証拠金 0 として扱う
+    monitor.OnDeal(2, "USDJPY", true, 0, 1.0, 0.0, 0.0, alert);
+    EXPECT(Near(monitor.GetState().margin, 2000.0));
+}
+
+void TestAccount() {
+    SymbolSpecTable specs;
+    specs.Load({EurUsd(1000.0)});
+    MarginMonitor monitor(specs);
+    MarginAlert alert;
+
+    // 口座情報の通知前
+    EXPECT(!monitor.OnDeal(1, "EURUSD", true, 0, 1.0, 0.0, -9900.0, alert));
+    EXPECT(!monitor.GetState().hasAccount);
+
+    monitor.ResetPositions();
+    MarginAccountState account = Account();
+    account.margin = 0.0;
+    EXPECT(!monitor.SetAccount(account, 0.0, alert));
+    EXPECT(!monitor.OnPnL(-9999.0, alert));
+    EXPECT(monitor.GetState().hasAccount && monitor.GetState().severity == MarginSeverity::Normal);
+
+    // 設定水準を無効にするとブローカーの水準だけで判定する
+    monitor.SetThresholds(0.0, 0.0);
+    monitor.Seed(1, "EURUSD", true, 1.0);
+    account.margin = 1000.0;
+    EXPECT(!monitor.SetAccount(account, 0.0, alert));
+    EXPECT(!monitor.OnPnL(-8900.0, alert));
+    EXPECT(monitor.OnPnL(-9000.0, alert) && alert.state.severity == MarginSeverity::MarginCall);
+}
+
+} // namespace
+
+int main() {
+    TestSeverity();
+    TestHedge();
+    TestSpecs();
+    TestAccount();
+    return FinishTest("MarginMonitorTest");
+}
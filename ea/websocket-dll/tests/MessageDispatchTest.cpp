@@ -0,0 +1,80 @@
+// 受信フレームの種別判定のテスト（完全ハッシュ表）
+//
+//   lookup   : 表のすべての種別名を引け、近い綴り（大文字小文字違い・前後の欠け・余分な文字）は Unknown
+//   classify : type / event の別名と timestamp を取り出し、JSON として不正なフレームは Unknown
+//   legacy   : レガシー形式は command / action からコマンド種別を解決し、コマンド以外の値は Unknown
+
+#include "../MessageDispatch.h"
+#include "TestSupport.h"
+#include <string>
+
+namespace {
+
+void TestLookup() {
+    EXPECT(LookupInboundKind("OPEN") == InboundKind::Open);
+    EXPECT(LookupInboundKind("CLOSE") == InboundKind::Close);
+    EXPECT(LookupInboundKind("MODIFY") == InboundKind::Modify);
+    EXPECT(LookupInboundKind("command") == InboundKind::LegacyCommand);
+    EXPECT(LookupInboundKind("RESEND_FROM") == InboundKind::ResendFrom);
+    EXPECT(LookupInboundKind("PING") == InboundKind::Ping);
+    EXPECT(LookupInboundKind("PONG") == InboundKind::Pong);
+    EXPECT(LookupInboundKind("INFO") == InboundKind::Info);
+    EXPECT(LookupInboundKind("ERROR") == InboundKind::Error);
+    EXPECT(LookupInboundKind("PRICE_ALERT_SET") == InboundKind::PriceAlertSet);
+    EXPECT(LookupInboundKind("PRICE_ALERT_CANCEL") == InboundKind::PriceAlertCancel);
+    EXPECT(LookupInboundKind("PRICE_UPDATE") == InboundKind::PriceUpdate);
+    EXPECT(LookupInboundKind("HEARTBEAT_ACK") == InboundKind::HeartbeatAck);
+    EXPECT(LookupInboundKind("AUTH_SUCCESS") == InboundKind::AuthSuccess);
+    EXPECT(LookupInboundKind("open") == InboundKind::Open);
+    EXPECT(LookupInboundKind("close") == InboundKind::Close);
+    EXPECT(LookupInboundKind("modify") == InboundKind::Modify);
+    EXPECT(LookupInboundKind("modify_position") == InboundKind::Modify);
+
+    EXPECT(LookupInboundKind("") == InboundKind::Unknown);
+    EXPECT(LookupInboundKind("Open") == InboundKind::Unknown);
+    EXPECT(LookupInboundKind("OPE") == InboundKind::Unknown);
+    EXPECT(LookupInboundKind("OPENX") == InboundKind::Unknown);
+    EXPECT(LookupInboundKind("PRICE_ALERT") == InboundKind::Unknown);
+    EXPECT(LookupInboundKind("HEARTBEAT") == InboundKind::Unknown);
+}
+
+void TestClassify() {
+    MessageEnvelope envelope;
+    EXPECT(ClassifyInbound(R"({"type":"PING","timestamp":"2024-06-10T06:13:20Z"})", envelope) == InboundKind::Ping);
+    EXPECT(envelope.type == "PING" && envelope.timestamp == "2024-06-10T06:13:20Z");
+
+    // timestamp は省略できる。type の代わりに event でもよい
+    envelope = MessageEnvelope();
+    EXPECT(ClassifyInbound(R"({"event":"INFO","message":"hello"})", envelope) == InboundKind::Info);
+    EXPECT(envelope.timestamp.empty());
+
+    // 他のフィールドが先にあっても読み飛ばす
+    EXPECT(ClassifyInbound(R"({"data":{"nested":[1,2,{"type":"PING"}]},"type":"CLOSE"})", envelope) ==
+           InboundKind::Close);
+
+    EXPECT(ClassifyInbound(R"({"type":"SOMETHING_NEW"})", envelope) == InboundKind::Unknown);
+    EXPECT(ClassifyInbound(R"({"message":"no type"})", envelope) == InboundKind::Unknown);
+    EXPECT(ClassifyInbound("not json", envelope) == InboundKind::Unknown);
+    EXPECT(ClassifyInbound("", envelope) == InboundKind::Unknown);
+}
+
+void TestLegacy() {
+    MessageEnvelope envelope;
+    EXPECT(ClassifyInbound(R"({"type":"command","command":"open","accountId":"A"})", envelope) == InboundKind::Open);
+    EXPECT(ClassifyInbound(R"({"type":"command","action":"modify_position"})", envelope) == InboundKind::Modify);
+    EXPECT(ClassifyInbound(R"({"type":"command","action":"close"})", envelope) == InboundKind::Close);
+
+    // コマンド以外の種別名・指定なしは受け付けない
+    EXPECT(ClassifyInbound(R"({"type":"command","command":"PING"})", envelope) == InboundKind::Unknown);
+    EXPECT(ClassifyInbound(R"({"type":"command","command":"command"})", envelope) == InboundKind::Unknown);
+    EXPECT(ClassifyInbound(R"({"type":"command"})", envelope) == InboundKind::Unknown);
+}
+
+} // namespace
+
+int main() {
+    TestLookup();
+    TestClassify();
+    TestLegacy();
+    return FinishTest("MessageDispatchTest");
+}
@@ -0,0 +1,180 @@
+// スキーマから生成するエンコーダー・デコーダーのテスト
+//
+//   json      : 全種類のフィールド（文字列・数値・整数・真偽値・固定小数点・入れ子）を JSON で往復できる
+//   optional  : 任意フィールドは既定値なら省略し、入れ子は全フィールドが既定値の場合に省略する
+//   alias     : 受信時は別名・文字列で届いた数値も受け付け、未知のフィールドは値ごと読み飛ばす
+//   escape    : 文字列のエスケープ（引用符・バックスラッシュ・改行・制御文字）を往復できる
+//   invalid   : 型の合わない値・閉じていないオブジェクトは false
+//   binary    : バイナリ形式で往復でき、途中で切れたデータは false
+//   fixed     : 価格の10進表記を丸め込みなしで固定小数点にし、同じ表記に戻せる
+
+#include "../MessageSchema.h"
+#include "../WireMessages.h"
+#include "TestSupport.h"
+#include <string>
+
+namespace {
+
+struct Inner {
+    static constexpr const char* kTsName = "Inner";
+
+    std::string name;
+    long long count = 0;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeOptionalField("name", &Inner::name),
+        schema::MakeOptionalField("count", &Inner::count));
+};
+
+struct Sample {
+    static constexpr const char* kTsName = "Sample";
+
+    std::string id;
+    double ratio = 0.0;
+    long long ticket = 0;
+    bool urgent = false;
+    schema::FixedPrice price;
+    Inner inner;
+    std::string note;
+
+    static constexpr auto kFields = std::make_tuple(
+        schema::MakeField("id", &Sample::id, "sample_id"),
+        schema::MakeField("ratio", &Sample::ratio),
+        schema::MakeOptionalField("ticket", &Sample::ticket),
+        schema::MakeOptionalField("urgent", &Sample::urgent),
+        schema::MakeOptionalField("price", &Sample::price),
+        schema::MakeOptionalField("inner", &Sample::inner),
+        schema::MakeOptionalField("note", &Sample::note));
+};
+
+Sample Full() {
+    Sample sample;
+    sample.id = "s1";
+    sample.ratio = 0.25;
+    sample.ticket = 1234567890123LL;
+    sample.urgent = true;
+    sample.price.raw = 14912500000LL;
+    sample.price.present = true;
+    sample.inner.name = "leg";
+    sample.inner.count = 3;
+    sample.note = "ok";
+    return sample;
+}
+
+bool SameSample(const Sample& a, const Sample& b) {
+    return a.id == b.id && a.ratio == b.ratio && a.ticket == b.ticket && a.urgent == b.urgent &&
+           a.price.raw == b.price.raw && a.price.present == b.price.present && a.inner.name == b.inner.name &&
+           a.inner.count == b.inner.count && a.note == b.note;
+}
+
+void TestJson() {
+    std::string json = schema::ToJson(Full());
+    EXPECT(json == R"({"id":"s1","ratio":0.25,"ticket":1234567890123,"urgent":true,"price":149.125,)"
+                   R"("inner":{"name":"leg","count":3},"note":"ok"})");
+
+    Sample decoded;
+    EXPECT(schema::DecodeJson(json, decoded));
+    EXPECT(SameSample(decoded, Full()));
+}
+
+void TestOptional() {
+    Sample sample;
+    sample.id = "s2";
+    EXPECT(schema::ToJson(sample) == R"({"id":"s2","ratio":0})");
+
+    sample.inner.count = 1;
+    EXPECT(schema::ToJson(sample) == R"({"id":"s2","ratio":0,"inner":{"count":1}})");
+
+    // 0 の価格も指定ありなら出力する（SL / TP の解除）
+    sample = Sample();
+    sample.price.present = true;
+    EXPECT(schema::ToJson(sample) == R"({"id":"","ratio":0,"price":0})");
+}
+
+void TestAlias() {
+    Sample decoded;
+    EXPECT(schema::DecodeJson(R"({"extra":{"a":[1,"x",null,true]},"sample_id":"s3","ratio":1e-2,"more":false})",
+                              decoded));
+    EXPECT(decoded.id == "s3" && decoded.ratio == 0.01);
+    EXPECT(!decoded.price.present);
+
+    // 数値は文字列で届いても受け付ける（MQL 側の送信形式）
+    EXPECT(schema::DecodeJson(R"({"id":"s3","ratio":"0.5","price":"1.25"})", decoded));
+    EXPECT(decoded.ratio == 0.5 && decoded.price.present && decoded.price.raw == 125000000LL);
+}
+
+void TestEscape() {
+    Sample sample;
+    sample.id = "a\"b\\c\nd\te\x01";
+    std::string json = schema::ToJson(sample);
+    EXPECT(json.find("\\u0001") != std::string::npos);
+
+    Sample decoded;
+    EXPECT(schema::DecodeJson(json, decoded));
+    EXPECT(decoded.id == sample.id);
+}
+
+void TestInvalid() {
+    Sample decoded;
+    EXPECT(!schema::DecodeJson(R"({"id":123})", decoded));
+    EXPECT(!schema::DecodeJson(R"({"ratio":true})", decoded));
+    EXPECT(!schema::DecodeJson(R"({"price":"abc"})", decoded));
+    EXPECT(!schema::DecodeJson(R"({"id":"s4")", decoded));
+    EXPECT(!schema::DecodeJson(R"(["id"])", decoded));
+    EXPECT(!schema::DecodeJson("", decoded));
+}
+
+void TestBinary() {
+    std::string data;
+    schema::EncodeBinary(Full(), data);
+    Sample decoded;
+    EXPECT(schema::DecodeBinary(data, decoded));
+    EXPECT(SameSample(decoded, Full()));
+
+    EXPECT(!schema::DecodeBinary(std::string_view(data.data(), data.size() - 1), decoded));
+    EXPECT(!schema::DecodeBinary(std::string_view(), decoded));
+
+    // 実際のフレーム（MODIFY コマンド）
+    CommandFrame frame;
+    EXPECT(schema::DecodeJson(R"({"type":"MODIFY","accountId":"A","positionId":"p1","ticket":5,"sl":1.5,)"
+                              R"("timestamp":"2024-06-10T06:13:20Z"})",
+                              frame));
+    std::string binary;
+    schema::EncodeBinary(frame, binary);
+    CommandFrame copy;
+    EXPECT(schema::DecodeBinary(binary, copy));
+    EXPECT(copy.type == "MODIFY" && copy.positionId == "p1" && copy.ticket == 5);
+    EXPECT(copy.stopLoss.present && copy.stopLoss.raw == 150000000LL && !copy.takeProfit.present);
+    EXPECT(schema::ToJson(copy) == schema::ToJson(frame));
+}
+
+void TestFixed() {
+    long long raw = 0;
+    EXPECT(schema::ParseFixedPrice("149.125", raw) && raw == 14912500000LL);
+    EXPECT(schema::ParseFixedPrice("-0.5", raw) && raw == -50000000LL);
+    EXPECT(schema::ParseFixedPrice("1.123456785", raw) && raw == 112345679LL);
+    EXPECT(schema::ParseFixedPrice("1e-3", raw) && raw == 100000LL);
+    EXPECT(!schema::ParseFixedPrice("abc", raw));
+
+    // double では誤差が出る値も10進表記のまま往復する
+    EXPECT(schema::ParseFixedPrice("1.1", raw));
+    std::string text;
+    schema::AppendFixedPrice(text, raw);
+    EXPECT(text == "1.1");
+    text.clear();
+    schema::AppendFixedPrice(text, -12345678901LL);
+    EXPECT(text == "-123.45678901");
+}
+
+} // namespace
+
+int main() {
+    TestJson();
+    TestOptional();
+    TestAlias();
+    TestEscape();
+    TestInvalid();
+    TestBinary();
+    TestFixed();
+    return FinishTest("MessageSchemaTest");
+}
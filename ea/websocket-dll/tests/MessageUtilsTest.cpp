@@ -0,0 +1,91 @@
+// メッセージ補助関数のテスト（時刻文字列の解析は不正な値で有効期限・実行予定時刻を誤らないこと、種別の判定は送信バッチの待機を決めること）
+//
+//   valid      : UTC・オフセット付き・秒の小数・うるう日を解析する
+//   outOfRange : 月・日・時・分・秒・オフセットが範囲外の値は正規化せずに不正とする
+//   roundTrip  : FormatIsoTimestamp の出力を同じ時刻に戻せる
+//   urgent     : 取引イベント・コマンド受領通知・期限切れ通知は送信バッチを待たず、価格・状態の通知は待つ
+//   type       : 種別は type → event → command の順に取り出す
+
+#include "../MessageUtils.h"
+#include "TestSupport.h"
+#include <chrono>
+
+namespace {
+
+using Clock = std::chrono::system_clock;
+
+long long EpochMicros(const char* text) {
+    Clock::time_point time;
+    if (!ParseIsoTimestamp(text, time)) {
+        return -1;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+bool Parses(const char* text) {
+    Clock::time_point time;
+    return ParseIsoTimestamp(text, time);
+}
+
+void TestValid() {
+    EXPECT(EpochMicros("1970-01-01T00:00:00Z") == 0);
+    EXPECT(EpochMicros("2024-06-10T06:13:20.123Z") == 1717999999LL * 1000000 + 1123000);
+    EXPECT(EpochMicros("2024-06-10T15:13:20.123+09:00") == EpochMicros("2024-06-10T06:13:20.123Z"));
+    EXPECT(EpochMicros("2024-06-10T01:13:20-05:00") == EpochMicros("2024-06-10T06:13:20Z"));
+    EXPECT(EpochMicros("2024-06-10 06:13:20.123456789+00:00") == EpochMicros("2024-06-10T06:13:20.123456Z"));
+    EXPECT(Parses("2024-02-29T00:00:00Z"));
+    EXPECT(Parses("2000-02-29T00:00:00Z"));
+    EXPECT(Parses("2016-12-31T23:59:60Z"));
+}
+
+void TestOutOfRange() {
+    EXPECT(!Parses("2024-13-45T00:00:00Z"));
+    EXPECT(!Parses("2024-00-10T00:00:00Z"));
+    EXPECT(!Parses("2024-06-00T00:00:00Z"));
+    EXPECT(!Parses("2024-06-31T00:00:00Z"));
+    EXPECT(!Parses("2023-02-29T00:00:00Z"));
+    EXPECT(!Parses("1900-02-29T00:00:00Z"));
+    EXPECT(!Parses("2024-06-10T24:00:00Z"));
+    EXPECT(!Parses("2024-06-10T06:60:00Z"));
+    EXPECT(!Parses("2024-06-10T06:13:61Z"));
+    EXPECT(!Parses("2024-06-10T06:13:20+24:00"));
+    EXPECT(!Parses("2024-06-10T06:13:20+09:60"));
+    EXPECT(!Parses("2024-06-10T06:13:20+0900"));
+    EXPECT(!Parses("2024-06-10"));
+    EXPECT(!Parses(""));
+}
+
+void TestRoundTrip() {
+    Clock::time_point now = Clock::now();
+    Clock::time_point parsed;
+    EXPECT(ParseIsoTimestamp(FormatIsoTimestamp(now), parsed));
+    EXPECT(std::chrono::duration_cast<std::chrono::milliseconds>(parsed.time_since_epoch()) ==
+           std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()));
+}
+
+void TestUrgent() {
+    EXPECT(IsUrgentMessageType("OPENED") && IsUrgentMessageType("CLOSED") && IsUrgentMessageType("STOPPED"));
+    EXPECT(IsUrgentMessageType("COMMAND_ACK") && IsUrgentMessageType("COMMAND_EXPIRED"));
+    EXPECT(IsUrgentMessageType("COMMAND_REJECTED") && IsUrgentMessageType("MARGIN_WARNING"));
+    EXPECT(!IsUrgentMessageType("PRICE_STATS") && !IsUrgentMessageType("PNL_UPDATE"));
+    EXPECT(!IsUrgentMessageType("EXECUTION_STATS") && !IsUrgentMessageType(""));
+    EXPECT(IsTradeEventType("STOPPED") && !IsTradeEventType("COMMAND_ACK"));
+}
+
+void TestType() {
+    EXPECT(ExtractMessageType(R"({"type":"OPENED","event":"X"})") == "OPENED");
+    EXPECT(ExtractMessageType(R"({"event":"INFO","command":"open"})") == "INFO");
+    EXPECT(ExtractMessageType(R"({"command":"open"})") == "open");
+    EXPECT(ExtractMessageType(R"({"message":"none"})").empty());
+}
+
+} // namespace
+
+int main() {
+    TestValid();
+    TestOutOfRange();
+    TestRoundTrip();
+    TestUrgent();
+    TestType();
+    return FinishTest("MessageUtilsTest");
+}
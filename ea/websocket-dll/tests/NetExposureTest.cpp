@@ -0,0 +1,133 @@
+// ネットエクスポージャーのテスト
+//
+//   open    : 新規約定で買い・売りの保有量と想定元本（ロット × 建値）を加算し、口座全体のグロス・ネット・ヘッジ比率を返す
+//   close   : 決済約定は反対方向の保有を減らし、想定元本は平均建値で減らす。決済しすぎた分は無視する
+//   inout   : ドテンは反対方向を決済しきった残りを新規として加算する
+//   summary : 口座全体の差分更新が通貨ペアごとの集計から求め直した値と一致し、保有のない通貨ペアは Snapshot に出ない
+
+#include "../NetExposure.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool Near(double actual, double expected) {
+    return std::fabs(actual - expected) < 1e-9;
+}
+
+void TestOpen() {
+    NetExposure exposure;
+    ExposureSummary summary = exposure.Summary();
+    EXPECT(summary.grossVolume == 0.0 && summary.netVolume == 0.0 && summary.hedgeRatio == 1.0);
+
+    exposure.OnDeal("EURUSD", true, DealEntry::In, 1.0, 1.10);
+    exposure.OnDeal("EURUSD", true, DealEntry::In, 1.0, 1.20);
+    exposure.Seed("EURUSD", false, 0.5, 1.15);
+
+    SymbolExposure eurusd;
+    EXPECT(exposure.Get("EURUSD", eurusd));
+    EXPECT(eurusd.symbol == "EURUSD");
+    EXPECT(Near(eurusd.longVolume, 2.0) && Near(eurusd.longNotional, 2.30));
+    EXPECT(Near(eurusd.shortVolume, 0.5) && Near(eurusd.shortNotional, 0.575));
+
+    summary = exposure.Summary();
+    EXPECT(Near(summary.grossVolume, 2.5) && Near(summary.netVolume, 1.5));
+    EXPECT(Near(summary.hedgeRatio, 1.0 - 1.5 / 2.5));
+
+    // 不正な約定は無視する
+    exposure.OnDeal("", true, DealEntry::In, 1.0, 1.0);
+    exposure.OnDeal("EURUSD", true, DealEntry::In, 0.0, 1.0);
+    EXPECT(Near(exposure.Summary().grossVolume, 2.5));
+    EXPECT(!exposure.Get("USDJPY", eurusd));
+}
+
+void TestClose() {
+    NetExposure exposure;
+    exposure.OnDeal("EURUSD", true, DealEntry::In, 1.0, 1.10);
+    exposure.OnDeal("EURUSD", true, DealEntry::In, 1.0, 1.20);
+
+    // 売り約定の決済は買いポジションを平均建値 1.15 で減らす
+    exposure.OnDeal("EURUSD", false, DealEntry::Out, 0.5, 1.30);
+    SymbolExposure eurusd;
+    EXPECT(exposure.Get("EURUSD", eurusd));
+    EXPECT(Near(eurusd.longVolume, 1.5) && Near(eurusd.longNotional, 1.5 * 1.15));
+    EXPECT(eurusd.shortVolume == 0.0);
+
+    // 保有量を超える決済は保有量までで止まり、売りは建たない
+    exposure.OnDeal("EURUSD", false, DealEntry::OutBy, 3.0, 1.30);
+    EXPECT(exposure.Get("EURUSD", eurusd));
+    EXPECT(eurusd.longVolume == 0.0 && eurusd.longNotional == 0.0 && eurusd.shortVolume == 0.0);
+    ExposureSummary summary = exposure.Summary();
+    EXPECT(summary.grossVolume == 0.0 && summary.netVolume == 0.0 && summary.hedgeRatio == 1.0);
+}
+
+void TestInOut() {
+    NetExposure exposure;
+    exposure.OnDeal("USDJPY", true, DealEntry::In, 1.0, 150.0);
+    exposure.OnDeal("USDJPY", false, DealEntry::InOut, 1.5, 151.0);
+
+    SymbolExposure usdjpy;
+    EXPECT(exposure.Get("USDJPY", usdjpy));
+    EXPECT(usdjpy.longVolume == 0.0 && usdjpy.longNotional == 0.0);
+    EXPECT(Near(usdjpy.shortVolume, 0.5) && Near(usdjpy.shortNotional, 0.5 * 151.0));
+
+    ExposureSummary summary = exposure.Summary();
+    EXPECT(Near(summary.grossVolume, 0.5) && Near(summary.netVolume, 0.5) && Near(summary.hedgeRatio, 0.0));
+
+    // 反対方向を決済しきらない場合は新規を建てない
+    exposure.OnDeal("USDJPY", true, DealEntry::InOut, 0.2, 152.0);
+    EXPECT(exposure.Get("USDJPY", usdjpy));
+    EXPECT(usdjpy.longVolume == 0.0 && Near(usdjpy.shortVolume, 0.3));
+}
+
+void TestSummary() {
+    NetExposure exposure;
+    // 再現可能な約定列で差分更新の累積誤差を確認する
+    const char* symbols[] = {"EURUSD", "USDJPY", "GBPUSD"};
+    unsigned int state = 7;
+    for (int i = 0; i < 5000; i++) {
+        state = state * 1103515245u + 12345u;
+        const char* symbol = symbols[(state >> 8) % 3];
+        bool isBuy = ((state >> 12) & 1) != 0;
+        DealEntry entry = static_cast<DealEntry>((state >> 16) % 4);
+        double volume = 0.01 * static_cast<double>(1 + (state >> 20) % 100);
+        exposure.OnDeal(symbol, isBuy, entry, volume, 1.0 + static_cast<double>(i % 10) * 0.01);
+    }
+
+    std::vector<SymbolExposure> held;
+    ExposureSummary summary = exposure.Snapshot(held);
+    double gross = 0.0;
+    double net = 0.0;
+    for (const auto& symbol : held) {
+        gross += symbol.longVolume + symbol.shortVolume;
+        net += std::fabs(symbol.longVolume - symbol.shortVolume);
+    }
+    EXPECT(std::fabs(summary.grossVolume - gross) < 1e-6);
+    EXPECT(std::fabs(summary.netVolume - net) < 1e-6);
+
+    // 保有のなくなった通貨ペアは Snapshot に含めない
+    NetExposure flat;
+    flat.OnDeal("EURUSD", true, DealEntry::In, 1.0, 1.1);
+    flat.OnDeal("EURUSD", false, DealEntry::Out, 1.0, 1.1);
+    flat.OnDeal("USDJPY", true, DealEntry::In, 1.0, 150.0);
+    held.clear();
+    flat.Snapshot(held);
+    EXPECT(held.size() == 1 && held[0].symbol == "USDJPY");
+
+    flat.Reset();
+    held.clear();
+    summary = flat.Snapshot(held);
+    EXPECT(held.empty() && summary.grossVolume == 0.0);
+}
+
+} // namespace
+
+int main() {
+    TestOpen();
+    TestClose();
+    TestInOut();
+    TestSummary();
+    return FinishTest("NetExposureTest");
+}
@@ -0,0 +1,155 @@
+// 評価損益エンジンのテスト（口座通貨への換算）
+//
+//   direct   : 決済通貨/口座通貨 の通貨ペア（USDJPY で USD → JPY）の仲値で換算する
+//   inverse  : 口座通貨/決済通貨 の通貨ペア（EURJPY で JPY → EUR）は 1 / 仲値で換算する
+//   pivot    : 直接の通貨ペアがなければ USD 経由の2本（GBPUSD × USDJPY）で換算する
+//   missing  : 換算レートのティックが届くまでは換算せず unconverted に数える
+//   realized : 決済の確定損益は有効証拠金に加え、SetAccount で 0 に戻る
+
+#include "../PnLEngine.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool Near(double a, double b) {
+    return std::fabs(a - b) < 1e-6;
+}
+
+SymbolSpec Spec(const std::string& symbol, const std::string& base, const std::string& profit) {
+    SymbolSpec spec;
+    spec.symbol = symbol;
+    spec.contractSize = 100000.0;
+    spec.baseCurrency = base;
+    spec.profitCurrency = profit;
+    spec.marginCurrency = base;
+    return spec;
+}
+
+void LoadSpecs(SymbolSpecTable& specs) {
+    specs.Load({Spec("EURUSD", "EUR", "USD"), Spec("USDJPY", "USD", "JPY"), Spec("EURJPY", "EUR", "JPY"),
+                Spec("GBPUSD", "GBP", "USD"), Spec("EURGBP", "EUR", "GBP")});
+}
+
+void TestDirect() {
+    SymbolSpecTable specs;
+    LoadSpecs(specs);
+    PnLEngine engine(specs);
+    engine.SetAccount("A", "JPY", 1000000.0, 0.0);
+
+    // EURUSD 買い 1ロット @1.1000 → bid 1.1010 で 100 USD
+    engine.OnDeal(1, "EURUSD", true, 0, 1.0, 1.1000, 0.0);
+    engine.OnTick("EURUSD", 1.1010, 1.1012);
+    engine.OnTick("USDJPY", 149.99, 150.01);
+
+    PositionPnL position;
+    EXPECT(engine.GetPosition(1, position));
+    EXPECT(position.converted);
+    EXPECT(Near(position.profitCurrencyPnl, 100.0));
+    EXPECT(Near(position.conversionRate, 150.0));
+    EXPECT(Near(position.pnl, 15000.0));
+    EXPECT(Near(engine.FloatingPnl(), 15000.0));
+
+    // 換算レートのティックだけでも口座通貨建ての損益は変わる
+    EXPECT(engine.OnTick("USDJPY", 159.99, 160.01));
+    EXPECT(Near(engine.FloatingPnl(), 16000.0));
+}
+
+void TestInverse() {
+    SymbolSpecTable specs;
+    LoadSpecs(specs);
+    PnLEngine engine(specs);
+    engine.SetAccount("A", "EUR", 10000.0, 0.0);
+
+    // USDJPY 売り 1ロット @150.00 → ask 149.00 で 100000 JPY
+    engine.OnDeal(1, "USDJPY", false, 0, 1.0, 150.00, 0.0);
+    engine.OnTick("USDJPY", 148.98, 149.00);
+    engine.OnTick("EURJPY", 159.99, 160.01);
+
+    PositionPnL position;
+    EXPECT(engine.GetPosition(1, position));
+    EXPECT(Near(position.currentPrice, 149.00));
+    EXPECT(Near(position.profitCurrencyPnl, 100000.0));
+    EXPECT(Near(position.conversionRate, 1.0 / 160.0));
+    EXPECT(Near(engine.FloatingPnl(), 625.0));
+}
+
+void TestPivot() {
+    SymbolSpecTable specs;
+    LoadSpecs(specs);
+    PnLEngine engine(specs);
+    engine.SetAccount("A", "JPY", 1000000.0, 0.0);
+
+    // EURGBP 売り 1ロット @0.8600 → ask 0.8590 で 100 GBP。GBPJPY はないため GBP → USD → JPY
+    engine.OnDeal(1, "EURGBP", false, 0, 1.0, 0.8600, 0.0);
+    engine.OnTick("EURGBP", 0.8588, 0.8590);
+    engine.OnTick("GBPUSD", 1.2499, 1.2501);
+    engine.OnTick("USDJPY", 149.99, 150.01);
+
+    PositionPnL position;
+    EXPECT(engine.GetPosition(1, position));
+    EXPECT(position.converted);
+    EXPECT(Near(position.conversionRate, 1.25 * 150.0));
+    EXPECT(Near(engine.FloatingPnl(), 100.0 * 1.25 * 150.0));
+
+    std::vector<std::string> required;
+    engine.RequiredSymbols(required);
+    EXPECT(required.size() == 3);
+}
+
+void TestMissing() {
+    SymbolSpecTable specs;
+    LoadSpecs(specs);
+    PnLEngine engine(specs);
+    engine.SetAccount("A", "JPY", 1000000.0, 0.0);
+
+    engine.OnDeal(1, "EURUSD", true, 0, 1.0, 1.1000, 0.0);
+    engine.OnTick("EURUSD", 1.1010, 1.1012);
+
+    PnLSummary summary = engine.GetSummary();
+    EXPECT(summary.positions == 1 && summary.unconverted == 1);
+    EXPECT(summary.floatingPnl == 0.0);
+
+    PositionPnL position;
+    EXPECT(engine.GetPosition(1, position));
+    EXPECT(!position.converted && Near(position.profitCurrencyPnl, 100.0));
+
+    engine.OnTick("USDJPY", 149.99, 150.01);
+    summary = engine.GetSummary();
+    EXPECT(summary.unconverted == 0 && Near(summary.floatingPnl, 15000.0));
+}
+
+void TestRealized() {
+    SymbolSpecTable specs;
+    LoadSpecs(specs);
+    PnLEngine engine(specs);
+    engine.SetAccount("A", "USD", 10000.0, 500.0);
+
+    engine.OnDeal(1, "EURUSD", true, 0, 1.0, 1.1000, 0.0);
+    engine.OnTick("EURUSD", 1.1010, 1.1012);
+    EXPECT(Near(engine.FloatingPnl(), 100.0));
+
+    // 半分を決済して 50 USD を確定
+    engine.OnDeal(1, "EURUSD", false, 1, 0.5, 1.1010, 50.0);
+    PnLSummary summary = engine.GetSummary();
+    EXPECT(Near(summary.floatingPnl, 50.0) && Near(summary.realized, 50.0));
+    EXPECT(Near(summary.equity, 10000.0 + 500.0 + 50.0 + 50.0));
+
+    // 口座情報（確定損益を反映した残高）で積算を戻す
+    engine.SetAccount("A", "USD", 10050.0, 500.0);
+    summary = engine.GetSummary();
+    EXPECT(summary.realized == 0.0 && Near(summary.equity, 10050.0 + 500.0 + 50.0));
+}
+
+} // namespace
+
+int main() {
+    TestDirect();
+    TestInverse();
+    TestPivot();
+    TestMissing();
+    TestRealized();
+    return FinishTest("PnLEngineTest");
+}
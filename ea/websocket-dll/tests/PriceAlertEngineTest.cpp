@@ -0,0 +1,149 @@
+// 価格アラートのテスト（通貨ペアごとの閾値インデックス）
+//
+//   cross     : 上抜けは水準以上、下抜けは水準以下で発火し、一度発火したアラートは削除される
+//   order     : 1ティックで複数の水準を越えたら直前の価格に近い水準から、同一水準は登録順に通知する
+//   undecided : 方向未指定のアラートは直前の bid、ティック前なら最初のティックとの比較で方向を決め、そのティックでは発火しない
+//   replace   : 同じ alertId の登録は置き換え、Remove で取り消せる
+//   invalid   : 空の ID・通貨ペアと 0 以下の水準は登録できず、他の通貨ペアのティックでは発火しない
+
+#include "../PriceAlertEngine.h"
+#include "TestSupport.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr long long kScale = 100000000LL;
+
+long long Fixed(double price) {
+    return static_cast<long long>(price * static_cast<double>(kScale) + 0.5);
+}
+
+void TestCross() {
+    PriceAlertEngine engine;
+    EXPECT(engine.Add("up", "EURUSD", Fixed(1.1050), true, AlertDirection::Above));
+    EXPECT(engine.Add("down", "EURUSD", Fixed(1.0950), true, AlertDirection::Below));
+    EXPECT(engine.Count() == 2);
+
+    std::vector<TriggeredAlert> triggered;
+    engine.OnTick("EURUSD", Fixed(1.1049), triggered);
+    EXPECT(triggered.empty());
+
+    // 水準ちょうどで発火する
+    engine.OnTick("EURUSD", Fixed(1.1050), triggered);
+    EXPECT(triggered.size() == 1);
+    if (triggered.size() == 1) {
+        EXPECT(triggered[0].alertId == "up" && triggered[0].symbol == "EURUSD");
+        EXPECT(triggered[0].direction == AlertDirection::Above);
+        EXPECT(triggered[0].level == Fixed(1.1050) && triggered[0].price == Fixed(1.1050));
+    }
+    EXPECT(engine.Count() == 1);
+
+    // 一度発火したアラートは再び発火しない
+    triggered.clear();
+    engine.OnTick("EURUSD", Fixed(1.1100), triggered);
+    EXPECT(triggered.empty());
+
+    engine.OnTick("EURUSD", Fixed(1.0900), triggered);
+    EXPECT(triggered.size() == 1 && triggered[0].alertId == "down" && triggered[0].direction == AlertDirection::Below);
+    EXPECT(engine.Count() == 0);
+}
+
+void TestOrder() {
+    PriceAlertEngine engine;
+    EXPECT(engine.Add("a3", "USDJPY", Fixed(151.0), true, AlertDirection::Above));
+    EXPECT(engine.Add("a1", "USDJPY", Fixed(150.2), true, AlertDirection::Above));
+    EXPECT(engine.Add("a2", "USDJPY", Fixed(150.5), true, AlertDirection::Above));
+    EXPECT(engine.Add("a2b", "USDJPY", Fixed(150.5), true, AlertDirection::Above));
+    EXPECT(engine.Add("far", "USDJPY", Fixed(152.0), true, AlertDirection::Above));
+
+    std::vector<TriggeredAlert> triggered;
+    engine.OnTick("USDJPY", Fixed(151.0), triggered);
+    EXPECT(triggered.size() == 4);
+    if (triggered.size() == 4) {
+        EXPECT(triggered[0].alertId == "a1");
+        EXPECT(triggered[1].alertId == "a2" && triggered[2].alertId == "a2b");
+        EXPECT(triggered[3].alertId == "a3");
+    }
+    EXPECT(engine.Count() == 1);
+
+    // 下抜けは高い水準から
+    EXPECT(engine.Add("b1", "USDJPY", Fixed(149.0), true, AlertDirection::Below));
+    EXPECT(engine.Add("b2", "USDJPY", Fixed(150.0), true, AlertDirection::Below));
+    triggered.clear();
+    engine.OnTick("USDJPY", Fixed(148.0), triggered);
+    EXPECT(triggered.size() == 2 && triggered[0].alertId == "b2" && triggered[1].alertId == "b1");
+}
+
+void TestUndecided() {
+    PriceAlertEngine engine;
+    std::vector<TriggeredAlert> triggered;
+
+    // ティック前の登録は最初のティックで方向を決め、そのティックでは発火しない
+    EXPECT(engine.Add("hi", "EURUSD", Fixed(1.2000), false, AlertDirection::Above));
+    EXPECT(engine.Add("lo", "EURUSD", Fixed(1.0000), false, AlertDirection::Above));
+    engine.OnTick("EURUSD", Fixed(1.1000), triggered);
+    EXPECT(triggered.empty());
+    EXPECT(engine.Count() == 2);
+
+    engine.OnTick("EURUSD", Fixed(0.9999), triggered);
+    EXPECT(triggered.size() == 1 && triggered[0].alertId == "lo" && triggered[0].direction == AlertDirection::Below);
+    triggered.clear();
+    engine.OnTick("EURUSD", Fixed(1.2000), triggered);
+    EXPECT(triggered.size() == 1 && triggered[0].alertId == "hi" && triggered[0].direction == AlertDirection::Above);
+
+    // ティック後の登録は直前の bid と比べる。同じ水準は到達済みとして次のティックで発火する
+    triggered.clear();
+    EXPECT(engine.Add("same", "EURUSD", Fixed(1.2000), false, AlertDirection::Below));
+    engine.OnTick("EURUSD", Fixed(1.2000), triggered);
+    EXPECT(triggered.size() == 1 && triggered[0].alertId == "same" && triggered[0].direction == AlertDirection::Above);
+}
+
+void TestReplace() {
+    PriceAlertEngine engine;
+    std::vector<TriggeredAlert> triggered;
+    EXPECT(engine.Add("x", "EURUSD", Fixed(1.1000), true, AlertDirection::Above));
+    EXPECT(engine.Add("x", "EURUSD", Fixed(1.2000), true, AlertDirection::Above));
+    EXPECT(engine.Count() == 1);
+
+    engine.OnTick("EURUSD", Fixed(1.1500), triggered);
+    EXPECT(triggered.empty());
+    engine.OnTick("EURUSD", Fixed(1.2000), triggered);
+    EXPECT(triggered.size() == 1 && triggered[0].level == Fixed(1.2000));
+
+    EXPECT(engine.Add("y", "EURUSD", Fixed(1.0000), true, AlertDirection::Below));
+    EXPECT(engine.Add("pending", "GBPUSD", Fixed(1.3000), false, AlertDirection::Above));
+    EXPECT(engine.Remove("y") && engine.Remove("pending"));
+    EXPECT(!engine.Remove("y"));
+    EXPECT(engine.Count() == 0);
+
+    triggered.clear();
+    engine.OnTick("EURUSD", Fixed(0.9000), triggered);
+    engine.OnTick("GBPUSD", Fixed(1.2000), triggered);
+    engine.OnTick("GBPUSD", Fixed(1.4000), triggered);
+    EXPECT(triggered.empty());
+}
+
+void TestInvalid() {
+    PriceAlertEngine engine;
+    EXPECT(!engine.Add("", "EURUSD", Fixed(1.1), true, AlertDirection::Above));
+    EXPECT(!engine.Add("x", "", Fixed(1.1), true, AlertDirection::Above));
+    EXPECT(!engine.Add("x", "EURUSD", 0, true, AlertDirection::Above));
+    EXPECT(engine.Count() == 0);
+
+    EXPECT(engine.Add("x", "EURUSD", Fixed(1.1), true, AlertDirection::Above));
+    std::vector<TriggeredAlert> triggered;
+    engine.OnTick("USDJPY", Fixed(150.0), triggered);
+    EXPECT(triggered.empty() && engine.Count() == 1);
+}
+
+} // namespace
+
+int main() {
+    TestCross();
+    TestOrder();
+    TestUndecided();
+    TestReplace();
+    TestInvalid();
+    return FinishTest("PriceAlertEngineTest");
+}
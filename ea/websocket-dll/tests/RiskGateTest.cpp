@@ -0,0 +1,183 @@
+// 発注前リスクチェックのテスト
+//
+//   volume      : 0 以下・仕様の最小 / 最大ロット・刻みに合わないロットと maxLot 超えを止める
+//   reservation : 約定前の OPEN を予約として保有量に加え、Release で解放する（他の key では解放しない）
+//   expiry      : 解放されない予約は kReservationTtlMs で失効する
+//   reduce      : 通貨ペアの上限は偏りを増やす注文だけを止め、反対売買は通す
+//   rate        : 直近1秒間に通した OPEN の数が maxOrdersPerSecond に達したら止める
+//   margin      : 発注後の推定証拠金維持率が minMarginLevel を下回る注文を止める
+
+#include "../RiskGate.h"
+#include "TestSupport.h"
+#include <string>
+
+namespace {
+
+const long long kSecond = 1000000;
+
+RiskOrder Order(int direction, double volume, const std::string& key = "") {
+    RiskOrder order;
+    order.symbol = "EURUSD";
+    order.direction = direction;
+    order.volume = volume;
+    order.key = key;
+    return order;
+}
+
+SymbolSpec Spec() {
+    SymbolSpec spec;
+    spec.symbol = "EURUSD";
+    spec.contractSize = 100000.0;
+    spec.volumeMin = 0.01;
+    spec.volumeStep = 0.01;
+    spec.volumeMax = 50.0;
+    spec.marginPerLot = 1000.0;
+    spec.marginHedged = 50000.0;
+    return spec;
+}
+
+// RiskGate が参照するモジュール一式
+struct Fixture {
+    NetExposure exposure;
+    SymbolSpecTable specs;
+    MarginMonitor margin{specs};
+    RiskGate gate{exposure, margin, specs};
+
+    Fixture() { specs.Load({Spec()}); }
+};
+
+void TestVolume() {
+    Fixture f;
+    RiskLimits limits;
+    limits.maxLot = 5.0;
+    f.gate.SetLimits(limits);
+
+    RiskDecision decision;
+    EXPECT(!f.gate.Check(Order(1, 0.0), 1, decision) && decision.reason == RiskRejectReason::InvalidVolume);
+    EXPECT(!f.gate.Check(Order(1, 0.005), 1, decision) && decision.reason == RiskRejectReason::InvalidVolume);
+    EXPECT(decision.limit == 0.01);
+    EXPECT(!f.gate.Check(Order(1, 0.015), 1, decision) && decision.reason == RiskRejectReason::InvalidVolume);
+    EXPECT(!f.gate.Check(Order(1, 60.0), 1, decision) && decision.reason == RiskRejectReason::InvalidVolume);
+    EXPECT(!f.gate.Check(Order(1, 6.0), 1, decision) && decision.reason == RiskRejectReason::MaxLot);
+    EXPECT(decision.limit == 5.0 && decision.value == 6.0);
+    EXPECT(!f.gate.Check(Order(0, 1.0), 1, decision) && decision.reason == RiskRejectReason::InvalidOrder);
+    EXPECT(f.gate.Check(Order(1, 5.0), 1, decision) && decision.reason == RiskRejectReason::None);
+    EXPECT(f.gate.RejectedCount() == 6);
+    EXPECT(std::string(RiskGate::ReasonName(RiskRejectReason::MaxLot)) == "MAX_LOT");
+}
+
+void TestReservation() {
+    Fixture f;
+    RiskLimits limits;
+    limits.maxSymbolVolume = 1.0;
+    limits.maxAccountVolume = 2.0;
+    f.gate.SetLimits(limits);
+
+    // 約定済み 0.5 ロット + 予約 0.5 ロットで上限に達する
+    f.exposure.OnDeal("EURUSD", true, DealEntry::In, 0.5, 1.1);
+    RiskDecision decision;
+    EXPECT(f.gate.Check(Order(1, 0.5, "p1"), 1, decision));
+    EXPECT(!f.gate.Check(Order(1, 0.1, "p2"), 2, decision));
+    EXPECT(decision.reason == RiskRejectReason::SymbolExposure && decision.limit == 1.0);
+
+    // 他の key の約定では解放しない
+    f.gate.Release("other");
+    EXPECT(!f.gate.Check(Order(1, 0.1, "p2"), 3, decision));
+
+    // p1 が拒否された（約定しなかった）ので予約を解放する
+    f.gate.Release("p1");
+    EXPECT(f.gate.Check(Order(1, 0.5, "p2"), 4, decision));
+
+    // 口座全体の上限は予約も含めて数える（約定 0.5 + 予約 0.5 + 売り 1.5。売りは偏りを減らすため通貨ペアの上限には掛からない）
+    EXPECT(!f.gate.Check(Order(-1, 1.5, "p3"), 5, decision));
+    EXPECT(decision.reason == RiskRejectReason::AccountExposure && decision.value == 2.5);
+}
+
+void TestExpiry() {
+    Fixture f;
+    RiskLimits limits;
+    limits.maxSymbolVolume = 1.0;
+    f.gate.SetLimits(limits);
+
+    RiskDecision decision;
+    EXPECT(f.gate.Check(Order(1, 1.0, "p1"), kSecond, decision));
+    EXPECT(!f.gate.Check(Order(1, 0.1, "p2"), 2 * kSecond, decision));
+
+    long long expiresUs = kSecond + RiskGate::kReservationTtlMs * 1000;
+    EXPECT(!f.gate.Check(Order(1, 0.1, "p2"), expiresUs - 1, decision));
+    EXPECT(f.gate.Check(Order(1, 0.1, "p2"), expiresUs, decision));
+}
+
+void TestReduce() {
+    Fixture f;
+    RiskLimits limits;
+    limits.maxSymbolVolume = 1.0;
+    f.gate.SetLimits(limits);
+
+    // 上限を超えて保有している状態でも、偏りを減らす売りは通す
+    f.exposure.OnDeal("EURUSD", true, DealEntry::In, 2.0, 1.1);
+    RiskDecision decision;
+    EXPECT(!f.gate.Check(Order(1, 0.1), 1, decision) && decision.reason == RiskRejectReason::SymbolExposure);
+    EXPECT(f.gate.Check(Order(-1, 1.0), 2, decision));
+    // 売りすぎて反対側に上限を超える場合は止める
+    EXPECT(!f.gate.Check(Order(-1, 2.5), 3, decision) && decision.reason == RiskRejectReason::SymbolExposure);
+    EXPECT(decision.value == 1.5);
+}
+
+void TestRate() {
+    Fixture f;
+    RiskLimits limits;
+    limits.maxOrdersPerSecond = 2;
+    f.gate.SetLimits(limits);
+
+    RiskDecision decision;
+    EXPECT(f.gate.Check(Order(1, 0.1), kSecond, decision));
+    EXPECT(f.gate.Check(Order(1, 0.1), kSecond + 100, decision));
+    EXPECT(!f.gate.Check(Order(1, 0.1), kSecond + 200, decision) && decision.reason == RiskRejectReason::OrderRate);
+    // 止めた注文は数えないため、最初の注文から1秒経てば通る
+    EXPECT(!f.gate.Check(Order(1, 0.1), 2 * kSecond - 1, decision));
+    EXPECT(f.gate.Check(Order(1, 0.1), 2 * kSecond, decision));
+    EXPECT(!f.gate.Check(Order(1, 0.1), 2 * kSecond + 1, decision));
+}
+
+void TestMargin() {
+    Fixture f;
+    RiskLimits limits;
+    limits.minMarginLevel = 600.0;
+    f.gate.SetLimits(limits);
+
+    // 口座情報の通知前は維持率を確認しない
+    RiskDecision decision;
+    EXPECT(f.gate.Check(Order(1, 1.0, "p1"), 1, decision));
+    f.gate.Release("p1");
+
+    // 1ロットの買いを保有し、必要証拠金 1000（維持率 1000%）
+    f.exposure.OnDeal("EURUSD", true, DealEntry::In, 1.0, 1.1);
+    f.margin.Seed(1, "EURUSD", true, 1.0);
+    MarginAccountState account;
+    account.accountId = "A";
+    account.equity = 10000.0;
+    account.margin = 1000.0;
+    MarginAlert alert;
+    f.margin.SetAccount(account, 0.0, alert);
+
+    // さらに1ロットの買いで必要証拠金 2000、維持率 500% になる
+    EXPECT(!f.gate.Check(Order(1, 1.0), 2, decision) && decision.reason == RiskRejectReason::MarginHeadroom);
+    EXPECT(decision.limit == 600.0 && decision.value == 500.0);
+    // 0.5ロットなら 1500 で 666%
+    EXPECT(f.gate.Check(Order(1, 0.5), 3, decision));
+    // 売りは両建て証拠金（1ロットあたり 500）で計算し、必要証拠金が減るため通す
+    EXPECT(f.gate.Check(Order(-1, 1.5), 4, decision));
+}
+
+} // namespace
+
+int main() {
+    TestVolume();
+    TestReservation();
+    TestExpiry();
+    TestReduce();
+    TestRate();
+    TestMargin();
+    return FinishTest("RiskGateTest");
+}
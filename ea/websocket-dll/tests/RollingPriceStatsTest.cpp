@@ -0,0 +1,157 @@
+// ストリーミング価格統計のテスト
+//
+//   window    : 窓が一巡した後も、高値・安値・平均・スプレッドの最小 / 最大・ボラティリティ（長短）が
+//               窓内のティックから直接求めた値と一致する
+//   ewma      : 仲値の EWMA はティック間隔に応じて 1 - exp(-経過 / 時定数) だけ近づく
+//   tickRate  : 窓内の最古ティックから最新ティックまでの経過時間で求める
+//   duplicate : 同じティック時刻の重複通知は数えない
+//   collect   : CollectUpdated は前回以降にティックのあった通貨ペアだけを返す
+
+#include "../RollingPriceStats.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool Near(double actual, double expected, double tolerance) {
+    return std::fabs(actual - expected) <= tolerance;
+}
+
+// 母標準偏差（RollingPriceStats と同じ定義）
+double StdDev(const std::vector<double>& values) {
+    if (values.size() < 2) {
+        return 0.0;
+    }
+    double mean = 0.0;
+    for (double value : values) {
+        mean += value;
+    }
+    mean /= static_cast<double>(values.size());
+    double sum = 0.0;
+    for (double value : values) {
+        sum += (value - mean) * (value - mean);
+    }
+    return std::sqrt(sum / static_cast<double>(values.size()));
+}
+
+void TestWindow() {
+    RollingPriceStats stats;
+    std::vector<double> mids;
+    std::vector<double> spreads;
+
+    // 乱数の代わりに線形合同法で再現可能なランダムウォークを作る
+    unsigned int state = 12345;
+    double mid = 1.1;
+    size_t total = RollingPriceStats::kWindowTicks * 3 + 7;
+    for (size_t i = 0; i < total; i++) {
+        state = state * 1103515245u + 12345u;
+        double step = (static_cast<double>((state >> 16) & 0x7FFF) / 32767.0 - 0.5) * 0.0004;
+        mid += step;
+        double spread = 0.00001 * static_cast<double>(5 + (state >> 8) % 20);
+        double bid = mid - spread / 2.0;
+        double ask = mid + spread / 2.0;
+        stats.OnTick("EURUSD", bid, ask, static_cast<long long>(i + 1), static_cast<long long>(i) * 10);
+        mids.push_back((bid + ask) / 2.0);
+        spreads.push_back(ask - bid);
+    }
+
+    PriceStatsSnapshot snapshot;
+    EXPECT(stats.GetStats("EURUSD", snapshot));
+    EXPECT(snapshot.ticks == static_cast<long long>(RollingPriceStats::kWindowTicks));
+
+    std::vector<double> windowMids(mids.end() - RollingPriceStats::kWindowTicks, mids.end());
+    std::vector<double> windowSpreads(spreads.end() - RollingPriceStats::kWindowTicks, spreads.end());
+    double sum = 0.0;
+    double spreadSum = 0.0;
+    for (size_t i = 0; i < windowMids.size(); i++) {
+        sum += windowMids[i];
+        spreadSum += windowSpreads[i];
+    }
+    EXPECT(Near(snapshot.mean, sum / static_cast<double>(windowMids.size()), 1e-9));
+    EXPECT(snapshot.high == *std::max_element(windowMids.begin(), windowMids.end()));
+    EXPECT(snapshot.low == *std::min_element(windowMids.begin(), windowMids.end()));
+    EXPECT(Near(snapshot.spreadMean, spreadSum / static_cast<double>(windowSpreads.size()), 1e-12));
+    EXPECT(snapshot.spreadMax == *std::max_element(windowSpreads.begin(), windowSpreads.end()));
+    EXPECT(snapshot.spreadMin == *std::min_element(windowSpreads.begin(), windowSpreads.end()));
+
+    // 窓内の各ティックの直前のティックからの対数リターン（長い窓は kWindowTicks 個、短い窓は直近 kShortWindowTicks 個）
+    std::vector<double> returns;
+    for (size_t i = mids.size() - RollingPriceStats::kWindowTicks; i < mids.size(); i++) {
+        returns.push_back(std::log(mids[i] / mids[i - 1]));
+    }
+    std::vector<double> shortReturns(returns.end() - RollingPriceStats::kShortWindowTicks, returns.end());
+    EXPECT(Near(snapshot.volatility, StdDev(returns), StdDev(returns) * 1e-6));
+    EXPECT(Near(snapshot.shortVolatility, StdDev(shortReturns), StdDev(shortReturns) * 1e-6));
+}
+
+void TestEwma() {
+    RollingPriceStats stats;
+    stats.OnTick("EURUSD", 1.0999, 1.1001, 0, 0);
+    PriceStatsSnapshot snapshot;
+    EXPECT(stats.GetStats("EURUSD", snapshot) && Near(snapshot.ewma, 1.1, 1e-12));
+
+    // 時定数と同じ時間が経てば差の 1 - e^-1 だけ近づく
+    stats.OnTick("EURUSD", 1.1999, 1.2001, 0, RollingPriceStats::kEwmaTimeConstantMs);
+    EXPECT(stats.GetStats("EURUSD", snapshot));
+    EXPECT(Near(snapshot.ewma, 1.1 + 0.1 * (1.0 - std::exp(-1.0)), 1e-12));
+
+    // 同じ時刻のティックでは動かない
+    double before = snapshot.ewma;
+    stats.OnTick("EURUSD", 1.2999, 1.3001, 0, RollingPriceStats::kEwmaTimeConstantMs);
+    EXPECT(stats.GetStats("EURUSD", snapshot) && snapshot.ewma == before);
+    EXPECT(Near(snapshot.mid, 1.3, 1e-12));
+}
+
+void TestTickRate() {
+    RollingPriceStats stats;
+    for (int i = 0; i < 11; i++) {
+        stats.OnTick("EURUSD", 1.1, 1.1002, 0, 1000 + i * 100);
+    }
+    PriceStatsSnapshot snapshot;
+    EXPECT(stats.GetStats("EURUSD", snapshot));
+    EXPECT(Near(snapshot.tickRate, 10.0, 1e-9));
+}
+
+void TestDuplicate() {
+    RollingPriceStats stats;
+    stats.OnTick("EURUSD", 1.1, 1.1002, 500, 0);
+    stats.OnTick("EURUSD", 1.2, 1.2002, 500, 10);
+    PriceStatsSnapshot snapshot;
+    EXPECT(stats.GetStats("EURUSD", snapshot));
+    EXPECT(snapshot.ticks == 1 && snapshot.bid == 1.1 && snapshot.lastTickMsc == 500);
+
+    EXPECT(!stats.OnTick("EURUSD", 0.0, 1.1, 501, 20));
+    EXPECT(!stats.GetStats("USDJPY", snapshot));
+}
+
+void TestCollect() {
+    RollingPriceStats stats;
+    stats.OnTick("EURUSD", 1.1, 1.1002, 0, 0);
+    stats.OnTick("USDJPY", 150.0, 150.02, 0, 0);
+
+    std::vector<PriceStatsSnapshot> snapshots;
+    stats.CollectUpdated(snapshots);
+    EXPECT(snapshots.size() == 2);
+
+    snapshots.clear();
+    stats.CollectUpdated(snapshots);
+    EXPECT(snapshots.empty());
+
+    stats.OnTick("USDJPY", 150.01, 150.03, 0, 10);
+    stats.CollectUpdated(snapshots);
+    EXPECT(snapshots.size() == 1 && snapshots[0].symbol == "USDJPY" && snapshots[0].ticks == 2);
+}
+
+} // namespace
+
+int main() {
+    TestWindow();
+    TestEwma();
+    TestTickRate();
+    TestDuplicate();
+    TestCollect();
+    return FinishTest("RollingPriceStatsTest");
+}
@@ -0,0 +1,377 @@
+// 共有メモリバスのテスト（fork で模擬EAを起動するため POSIX のみ）
+//
+//   delivery   : 模擬EA 4 プロセスが互いに連番つきメッセージを送り合い、欠落・重複・順序違いがないこと
+//   reassembly : 模擬EA 2 プロセスが同じ受信側へ複数断片のフレームを同時に送り、送信元ごとに組み立て直せること
+//                （受信リングが満杯のまま送信を諦めたフレームは送り直し、受信側が途中の分を捨てること）
+//   staleSlot  : 参加枠が埋まっている間は参加できず、ハートビートが kStaleUs より古い枠は再利用できること
+//   joinedAt   : 再利用した枠では、参加前に前の参加者宛てに送られたメッセージを読み捨てること
+//
+// 失敗があれば終了コード 1 を返す（ctest に登録）
+
+#include "../BusFrameLink.h"
+#include "../SharedBus.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+
+int main() {
+    std::printf("SharedBusTest is POSIX only\n");
+    return 0;
+}
+
+#else
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+int g_failures = 0;
+
+#define EXPECT(condition)                                                            \
+    do {                                                                             \
+        if (!(condition)) {                                                          \
+            std::printf("  FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);     \
+            g_failures++;                                                            \
+        }                                                                            \
+    } while (0)
+
+const long long kTimeoutUs = 30LL * 1000 * 1000;
+const int kChildFailed = 255;
+
+long long NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string BusName(const char* test) {
+    return std::string("HedgeSystemBusTest-") + test + "-" + std::to_string(getpid());
+}
+
+// 全員が参加するまで待つ（参加前に送ったメッセージは相手が読み捨てるため）
+bool WaitForParticipants(SharedBus& bus, size_t participants) {
+    long long deadlineUs = NowUs() + kTimeoutUs;
+    std::vector<BusParticipant> joined;
+    while (NowUs() < deadlineUs) {
+        bus.Heartbeat(NowUs());
+        bus.Participants(NowUs(), joined);
+        if (joined.size() >= participants) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+// fork した子プロセスで run を実行し、全員の終了コードが 0 なら true
+template <typename Run>
+bool RunProcesses(int count, Run run) {
+    std::vector<pid_t> children;
+    for (int i = 0; i < count; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            std::_Exit(run(i));
+        }
+        if (pid < 0) {
+            std::printf("  fork failed\n");
+            return false;
+        }
+        children.push_back(pid);
+    }
+
+    bool ok = true;
+    for (pid_t child : children) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    return ok;
+}
+
+struct SeqPayload {
+    int32_t sender;
+    uint32_t reserved;
+    uint64_t seq;
+};
+
+// 1プロセス分の模擬EA: 他の全員へ messages 件ずつ送りながら、自分宛てを連番で検証する
+int DeliveryProcess(const std::string& name, int self, int participants, uint64_t messages) {
+    SharedBus bus;
+    if (!bus.Open(name) || bus.Join("sim-" + std::to_string(self), SharedBus::CurrentProcessId(), NowUs()) < 0 ||
+        !WaitForParticipants(bus, static_cast<size_t>(participants))) {
+        std::printf("  sim-%d failed to join\n", self);
+        return 1;
+    }
+
+    std::vector<int> targets;
+    std::vector<BusParticipant> joined;
+    bus.Participants(NowUs(), joined);
+    for (const auto& participant : joined) {
+        if (participant.index != bus.Self()) {
+            targets.push_back(participant.index);
+        }
+    }
+
+    std::vector<uint64_t> expected(SharedBus::kMaxParticipants, 0);
+    uint64_t received = 0;
+    uint64_t total = messages * static_cast<uint64_t>(targets.size());
+    int errors = 0;
+
+    auto drain = [&]() {
+        BusMessage message;
+        while (bus.Receive(message)) {
+            SeqPayload payload;
+            std::memcpy(&payload, message.payload, sizeof(payload));
+            uint64_t& next = expected[static_cast<size_t>(message.from)];
+            if (payload.seq != next) {
+                if (errors++ < 5) {
+                    std::printf("  sim-%d from %d: expected seq %llu, got %llu\n", self, message.from,
+                                static_cast<unsigned long long>(next), static_cast<unsigned long long>(payload.seq));
+                }
+            }
+            next = payload.seq + 1;
+            received++;
+        }
+    };
+
+    long long deadlineUs = NowUs() + kTimeoutUs;
+    for (uint64_t seq = 0; seq < messages; seq++) {
+        for (int target : targets) {
+            SeqPayload payload{self, 0, seq};
+            // 相手のリングが満杯なら自分の受信を進めて待つ（全員が送信だけで詰まらないように）
+            while (!bus.Send(target, BusMessageKind::Command, &payload, sizeof(payload), NowUs())) {
+                drain();
+                if (NowUs() > deadlineUs) {
+                    std::printf("  sim-%d timed out sending\n", self);
+                    return 1;
+                }
+            }
+        }
+        drain();
+    }
+    while (received < total && NowUs() < deadlineUs) {
+        drain();
+        bus.Heartbeat(NowUs());
+    }
+
+    if (received != total) {
+        std::printf("  sim-%d received %llu of %llu\n", self, static_cast<unsigned long long>(received),
+                    static_cast<unsigned long long>(total));
+        return 1;
+    }
+    // 全員が受け取り終えるまで参加を続ける（先に抜けると相手の送信先が消える）
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    return errors == 0 ? 0 : 1;
+}
+
+void TestDelivery() {
+    std::printf("delivery\n");
+    const int participants = 4;
+    const uint64_t messages = 20000;
+    std::string name = BusName("delivery");
+    SharedBus::Remove(name);
+
+    EXPECT(RunProcesses(participants, [&](int self) {
+        return DeliveryProcess(name, self, participants, messages);
+    }));
+    SharedBus::Remove(name);
+}
+
+std::string MakeFrame(int sender, int index, size_t size) {
+    std::string frame = "{\"sender\":" + std::to_string(sender) + ",\"index\":" + std::to_string(index) + ",\"pad\":\"";
+    for (size_t i = frame.size(); i + 2 < size; i++) {
+        frame.push_back(static_cast<char>('a' + (i * 7 + static_cast<size_t>(sender) + static_cast<size_t>(index)) % 26));
+    }
+    frame += "\"}";
+    return frame;
+}
+
+void TestReassembly() {
+    std::printf("reassembly\n");
+    const int senders = 2;
+    const int frames = 300;
+    std::string name = BusName("reassembly");
+    SharedBus::Remove(name);
+
+    SharedBus receiver;
+    EXPECT(receiver.Open(name));
+    EXPECT(receiver.Join("receiver", SharedBus::CurrentProcessId(), NowUs()) >= 0);
+    int receiverIndex = receiver.Self();
+    BusFrameLink link(receiver);
+
+    std::vector<pid_t> children;
+    for (int sender = 0; sender < senders; sender++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            SharedBus bus;
+            if (!bus.Open(name) || bus.Join("sender-" + std::to_string(sender), SharedBus::CurrentProcessId(), NowUs()) < 0) {
+                std::fprintf(stderr, "  sender-%d failed to join\n", sender);
+                std::_Exit(1);
+            }
+            BusFrameLink out(bus);
+            int resent = 0;
+            long long deadlineUs = NowUs() + kTimeoutUs;
+            for (int i = 0; i < frames; i++) {
+                // 1断片に収まるフレームと、断片に分かれるフレームを交互に送る。受信側が止まっていて
+                // 送信を諦めた場合（CPU が少ない環境で起こる）はフレームの先頭から送り直す
+                size_t size = i % 3 == 0 ? 64 : 2000 + static_cast<size_t>(i) * 13;
+                while (!out.Send(receiverIndex, MakeFrame(sender, i, size), NowUs())) {
+                    resent++;
+                    if (NowUs() > deadlineUs) {
+                        std::fprintf(stderr, "  sender-%d failed to send frame %d\n", sender, i);
+                        std::_Exit(kChildFailed);
+                    }
+                }
+            }
+            // 送り直した回数を終了コードで返す
+            std::_Exit(std::min(resent, kChildFailed - 1));
+        }
+        children.push_back(pid);
+    }
+
+    std::vector<int> nextIndex(SharedBus::kMaxParticipants, 0);
+    int completed = 0;
+    int mismatched = 0;
+    long long deadlineUs = NowUs() + kTimeoutUs;
+    BusMessage message;
+    std::string frame;
+    while (completed < senders * frames && NowUs() < deadlineUs) {
+        if (!receiver.Receive(message)) {
+            continue;
+        }
+        if (!link.Accept(message, frame)) {
+            continue;
+        }
+        int sender = frame[10] - '0';
+        size_t from = static_cast<size_t>(message.from);
+        int index = nextIndex[from]++;
+        size_t size = index % 3 == 0 ? 64 : 2000 + static_cast<size_t>(index) * 13;
+        if (frame != MakeFrame(sender, index, size)) {
+            mismatched++;
+        }
+        completed++;
+    }
+
+    bool childrenOk = true;
+    long long resent = 0;
+    for (pid_t child : children) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        childrenOk = childrenOk && WIFEXITED(status) && WEXITSTATUS(status) != kChildFailed;
+        resent += WIFEXITED(status) ? WEXITSTATUS(status) : 0;
+    }
+    EXPECT(childrenOk);
+    EXPECT(completed == senders * frames);
+    EXPECT(mismatched == 0);
+    // 組み立て途中で捨てたフレームは、送信側が諦めて送り直したものだけ
+    EXPECT(link.DroppedFrames() <= resent);
+
+    receiver.Close();
+    SharedBus::Remove(name);
+}
+
+void TestStaleSlotReuse() {
+    std::printf("staleSlot\n");
+    std::string name = BusName("stale");
+    SharedBus::Remove(name);
+    const long long startUs = 1000000;
+
+    std::vector<std::unique_ptr<SharedBus>> members;
+    for (size_t i = 0; i < SharedBus::kMaxParticipants; i++) {
+        members.emplace_back(new SharedBus());
+        EXPECT(members.back()->Open(name));
+        EXPECT(members.back()->Join("member-" + std::to_string(i), 100 + static_cast<uint32_t>(i), startUs) ==
+               static_cast<int>(i));
+    }
+
+    // 全枠が新しい間は参加できない
+    SharedBus late;
+    EXPECT(late.Open(name));
+    EXPECT(late.Join("late", 200, startUs + SharedBus::kStaleUs) < 0);
+
+    // 5番以外のハートビートを更新し、5番だけを kStaleUs より古くする
+    long long laterUs = startUs + SharedBus::kStaleUs + 1;
+    for (size_t i = 0; i < members.size(); i++) {
+        if (i != 5) {
+            members[i]->Heartbeat(laterUs);
+        }
+    }
+    EXPECT(late.Join("late", 200, laterUs) == 5);
+
+    BusParticipant participant;
+    EXPECT(late.ParticipantAt(5, laterUs, participant));
+    EXPECT(participant.accountId == "late");
+    EXPECT(participant.pid == 200u);
+
+    late.Close();
+    for (auto& member : members) {
+        member->Close();
+    }
+    SharedBus::Remove(name);
+}
+
+void TestDropBeforeJoin() {
+    std::printf("joinedAt\n");
+    std::string name = BusName("joined");
+    SharedBus::Remove(name);
+    const long long startUs = 1000000;
+
+    SharedBus sender;
+    SharedBus previous;
+    EXPECT(sender.Open(name));
+    EXPECT(previous.Open(name));
+    EXPECT(sender.Join("sender", 1, startUs) == 0);
+    EXPECT(previous.Join("previous", 2, startUs) == 1);
+
+    // 前の参加者宛てに送られたまま読まれなかったメッセージ
+    uint64_t value = 1;
+    EXPECT(sender.Send(1, BusMessageKind::Command, &value, sizeof(value), startUs + 10));
+    EXPECT(sender.Send(1, BusMessageKind::Command, &value, sizeof(value), startUs + 20));
+    previous.Leave();
+
+    SharedBus next;
+    EXPECT(next.Open(name));
+    EXPECT(next.Join("next", 3, startUs + 30) == 1);
+
+    BusMessage message;
+    EXPECT(!next.Receive(message));
+    EXPECT(next.Counters().received == 0);
+
+    value = 2;
+    EXPECT(sender.Send(1, BusMessageKind::Command, &value, sizeof(value), startUs + 40));
+    EXPECT(next.Receive(message));
+    uint64_t received = 0;
+    std::memcpy(&received, message.payload, sizeof(received));
+    EXPECT(received == 2);
+    EXPECT(message.from == 0);
+
+    next.Close();
+    previous.Close();
+    sender.Close();
+    SharedBus::Remove(name);
+}
+
+} // namespace
+
+int main() {
+    TestDelivery();
+    TestReassembly();
+    TestStaleSlotReuse();
+    TestDropBeforeJoin();
+
+    if (g_failures > 0) {
+        std::printf("SharedBusTest: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("SharedBusTest: passed\n");
+    return 0;
+}
+
+#endif
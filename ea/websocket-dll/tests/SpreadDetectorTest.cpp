@@ -0,0 +1,168 @@
+// 口座間スプレッドの機会検出のテスト
+//
+//   hysteresis  : entry 以上で OPEN、exit 以上の間は維持、exit を下回って CLOSED を1回ずつ
+//   persistence : minPersistUs 続くまで OPEN しない（気配が届かない組は Sweep で到達を判定する）
+//   costs       : 手数料・スワップを控除した正味スプレッドで判定する
+//   staleQuote  : 同じ口座でティック時刻が戻った気配は捨て、古い価格で組を評価しない
+//   sweep       : OnQuote は他の通貨ペアの組を判定せず、気配の期限切れは Sweep で CLOSED にする
+//   sequence    : 通知の sequence は増え続け、Reset でも戻らない
+
+#include "../SpreadDetector.h"
+#include "TestSupport.h"
+#include <vector>
+
+namespace {
+
+const long long kMs = 1000;
+
+SpreadRule Rule(double entry, double exit, long long minPersistUs = 0) {
+    SpreadRule rule;
+    rule.entry = entry;
+    rule.exit = exit;
+    rule.minPersistUs = minPersistUs;
+    rule.maxQuoteAgeUs = 1000 * kMs;
+    return rule;
+}
+
+void TestHysteresis() {
+    SpreadDetector detector;
+    EXPECT(detector.SetRule("", Rule(0.0002, 0.00005)));
+    std::vector<SpreadOpportunity> events;
+
+    // A の bid が B の ask を 0.0003 上回る → A で売り B で買う組が OPEN
+    EXPECT(detector.OnQuote("EURUSD", "A", 1.1003, 1.1004, 1, 1 * kMs, events) == 0);
+    EXPECT(detector.OnQuote("EURUSD", "B", 1.0999, 1.1000, 1, 2 * kMs, events) == 1);
+    EXPECT(events.size() == 1 && events[0].state == OpportunityState::Open);
+    EXPECT(detector.BrokerName(events[0].sellBroker) == "A" && detector.BrokerName(events[0].buyBroker) == "B");
+    EXPECT(events[0].threshold == 0.0002);
+    EXPECT(detector.OpenCount() == 1);
+
+    // entry を下回っても exit 以上なら維持（通知なし）
+    events.clear();
+    EXPECT(detector.OnQuote("EURUSD", "A", 1.1001, 1.1002, 2, 3 * kMs, events) == 0);
+    EXPECT(detector.OpenCount() == 1);
+
+    // exit を下回って CLOSED。peakNetSpread は OPEN 以降の最大値
+    EXPECT(detector.OnQuote("EURUSD", "A", 1.10003, 1.1001, 3, 4 * kMs, events) == 1);
+    EXPECT(events.size() == 1 && events[0].state == OpportunityState::Closed);
+    EXPECT(events[0].threshold == 0.00005);
+    EXPECT(events[0].peakNetSpread > 0.00029 && events[0].peakNetSpread < 0.00031);
+    EXPECT(detector.OpenCount() == 0);
+}
+
+void TestPersistence() {
+    SpreadDetector detector;
+    EXPECT(detector.SetRule("", Rule(0.0002, 0.00005, 100 * kMs)));
+    std::vector<SpreadOpportunity> events;
+
+    EXPECT(detector.OnQuote("EURUSD", "A", 1.1003, 1.1004, 1, 1 * kMs, events) == 0);
+    EXPECT(detector.OnQuote("EURUSD", "B", 1.0999, 1.1000, 1, 2 * kMs, events) == 0);
+
+    // 持続時間に届く前の判定では通知しない
+    EXPECT(detector.Sweep(50 * kMs, events) == 0);
+
+    // 気配が届かなくても Sweep で持続時間の到達を判定する
+    EXPECT(detector.Sweep(102 * kMs, events) == 1);
+    EXPECT(events.size() == 1 && events[0].state == OpportunityState::Open);
+    EXPECT(events[0].startedUs == 2 * kMs);
+
+    // entry を下回ると持続時間は数え直し
+    SpreadDetector restart;
+    EXPECT(restart.SetRule("", Rule(0.0002, 0.00005, 100 * kMs)));
+    events.clear();
+    restart.OnQuote("EURUSD", "A", 1.1003, 1.1004, 1, 1 * kMs, events);
+    restart.OnQuote("EURUSD", "B", 1.0999, 1.1000, 1, 2 * kMs, events);
+    restart.OnQuote("EURUSD", "A", 1.1000, 1.1001, 2, 60 * kMs, events);
+    restart.OnQuote("EURUSD", "A", 1.1003, 1.1004, 3, 80 * kMs, events);
+    EXPECT(restart.Sweep(150 * kMs, events) == 0);
+    EXPECT(restart.Sweep(180 * kMs, events) == 1);
+}
+
+void TestCosts() {
+    SpreadDetector detector;
+    EXPECT(detector.SetRule("", Rule(0.0002, 0.00005)));
+    SpreadCost cost;
+    cost.commission = 0.00006;
+    EXPECT(detector.SetCost("A", "", cost));
+    EXPECT(detector.SetCost("B", "EURUSD", cost));
+    std::vector<SpreadOpportunity> events;
+
+    // 総スプレッド 0.0003 - 手数料 0.00012 = 0.00018 < entry
+    detector.OnQuote("EURUSD", "A", 1.1003, 1.1004, 1, 1 * kMs, events);
+    EXPECT(detector.OnQuote("EURUSD", "B", 1.0999, 1.1000, 1, 2 * kMs, events) == 0);
+
+    // 総スプレッド 0.00033 なら正味 0.00021
+    EXPECT(detector.OnQuote("EURUSD", "A", 1.10033, 1.1004, 2, 3 * kMs, events) == 1);
+    EXPECT(events.size() == 1);
+    EXPECT(events[0].grossSpread > 0.000329 && events[0].grossSpread < 0.000331);
+    EXPECT(events[0].netSpread > 0.000209 && events[0].netSpread < 0.000211);
+}
+
+void TestStaleQuote() {
+    SpreadDetector detector;
+    EXPECT(detector.SetRule("", Rule(0.0002, 0.00005)));
+    std::vector<SpreadOpportunity> events;
+
+    detector.OnQuote("EURUSD", "B", 1.0999, 1.1000, 100, 1 * kMs, events);
+    EXPECT(detector.OnQuote("EURUSD", "A", 1.1003, 1.1004, 200, 2 * kMs, events) == 1);
+
+    // 別のスレッドで追い越された古い気配（ティック時刻 150）は、exit を下回る価格でも捨てる
+    events.clear();
+    EXPECT(detector.OnQuote("EURUSD", "A", 1.0999, 1.1000, 150, 3 * kMs, events) == 0);
+    EXPECT(events.empty());
+    EXPECT(detector.OpenCount() == 1);
+
+    // 同じティック時刻・ティック時刻不明（0）の気配は受け付ける
+    EXPECT(detector.OnQuote("EURUSD", "A", 1.1003, 1.1004, 200, 4 * kMs, events) == 0);
+    EXPECT(detector.OnQuote("EURUSD", "A", 1.0999, 1.1000, 0, 5 * kMs, events) == 1);
+    EXPECT(events.size() == 1 && events[0].state == OpportunityState::Closed);
+}
+
+void TestSweep() {
+    SpreadDetector detector;
+    EXPECT(detector.SetRule("", Rule(0.0002, 0.00005)));
+    std::vector<SpreadOpportunity> events;
+
+    detector.OnQuote("EURUSD", "A", 1.1003, 1.1004, 1, 1 * kMs, events);
+    EXPECT(detector.OnQuote("EURUSD", "B", 1.0999, 1.1000, 1, 2 * kMs, events) == 1);
+
+    // 有効期間を過ぎても、別の通貨ペアの気配では EURUSD の組を判定しない
+    events.clear();
+    EXPECT(detector.OnQuote("GBPUSD", "A", 1.3000, 1.3001, 1, 2000 * kMs, events) == 0);
+    EXPECT(events.empty());
+    EXPECT(detector.OpenCount() == 1);
+
+    EXPECT(detector.Sweep(2000 * kMs, events) == 1);
+    EXPECT(events.size() == 1 && events[0].state == OpportunityState::Closed);
+    EXPECT(detector.OpenCount() == 0);
+}
+
+void TestSequence() {
+    SpreadDetector detector;
+    EXPECT(detector.SetRule("", Rule(0.0002, 0.00005)));
+    std::vector<SpreadOpportunity> events;
+
+    detector.OnQuote("EURUSD", "A", 1.1003, 1.1004, 1, 1 * kMs, events);
+    detector.OnQuote("EURUSD", "B", 1.0999, 1.1000, 1, 2 * kMs, events);
+    detector.OnQuote("EURUSD", "A", 1.0999, 1.1000, 2, 3 * kMs, events);
+    EXPECT(events.size() == 2);
+    EXPECT(events[0].sequence == 1 && events[1].sequence == 2);
+
+    detector.Reset();
+    events.clear();
+    detector.OnQuote("EURUSD", "A", 1.1003, 1.1004, 3, 4 * kMs, events);
+    detector.OnQuote("EURUSD", "B", 1.0999, 1.1000, 3, 5 * kMs, events);
+    EXPECT(events.size() == 1 && events[0].sequence == 3);
+}
+
+} // namespace
+
+int main() {
+    TestHysteresis();
+    TestPersistence();
+    TestCosts();
+    TestStaleQuote();
+    TestSweep();
+    TestSequence();
+    return FinishTest("SpreadDetectorTest");
+}
@@ -0,0 +1,127 @@
+// スプレッド追跡のテスト（DDSketch と時間窓のスロット）
+//
+//   sketch    : 分位点の相対誤差が kRelativeAccuracy 以内に収まり、スケッチのマージは一括で追加した場合と同じ
+//   stats     : ティックの (ask - bid) / point を記録し、件数・平均・最小・最大・分位点を返す
+//   duplicate : 同じティック時刻の重複通知は数えない（0 の場合は判定しない）
+//   window    : 時間窓を過ぎたスロットは集計から外れ、再利用時に古い記録を捨てる
+//   invalid   : 価格・ポイントが不正なティックと未登録の通貨ペアは false
+
+#include "../SpreadTracker.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <string>
+
+namespace {
+
+bool Near(double actual, double expected, double relative) {
+    return std::fabs(actual - expected) <= std::fabs(expected) * relative + 1e-12;
+}
+
+void TestSketch() {
+    DDSketch sketch(0.01, 0.1, 100000.0);
+    DDSketch first(0.01, 0.1, 100000.0);
+    DDSketch second(0.01, 0.1, 100000.0);
+    for (int i = 1; i <= 1000; i++) {
+        double value = static_cast<double>(i) / 10.0;
+        sketch.Add(value);
+        (i % 2 == 0 ? first : second).Add(value);
+    }
+    EXPECT(sketch.Count() == 1000);
+    EXPECT(Near(sketch.Quantile(0.5), 50.0, 0.011));
+    EXPECT(Near(sketch.Quantile(0.9), 90.0, 0.011));
+    EXPECT(Near(sketch.Quantile(0.99), 99.0, 0.011));
+    EXPECT(sketch.Min() == 0.1 && sketch.Max() == 100.0);
+
+    first.Merge(second);
+    EXPECT(first.Count() == sketch.Count());
+    EXPECT(first.Quantile(0.5) == sketch.Quantile(0.5) && first.Quantile(0.99) == sketch.Quantile(0.99));
+    EXPECT(Near(first.Mean(), sketch.Mean(), 1e-12));
+
+    sketch.Clear();
+    EXPECT(sketch.Count() == 0 && sketch.Quantile(0.5) == 0.0);
+}
+
+void TestStats() {
+    SpreadTracker tracker;
+    // EURUSD（point 0.00001）で 10〜19 ポイントのスプレッド
+    for (int i = 0; i < 10; i++) {
+        double spread = (10 + i) * 0.00001;
+        EXPECT(tracker.OnTick("EURUSD", 1.1, 1.1 + spread, 0.00001, 1000 + i, 1000 + i));
+    }
+
+    SpreadStats stats;
+    EXPECT(tracker.GetStats("EURUSD", 2000, stats));
+    EXPECT(stats.count == 10);
+    EXPECT(stats.windowMs == SpreadTracker::kDefaultWindowMs);
+    EXPECT(Near(stats.current, 19.0, 1e-6));
+    EXPECT(Near(stats.mean, 14.5, 1e-6));
+    EXPECT(Near(stats.min, 10.0, 1e-6) && Near(stats.max, 19.0, 1e-6));
+    // 分位点は小さい方から quantile × (件数 - 1) 番目（0始まり、切り捨て）の値
+    EXPECT(Near(stats.p50, 14.0, SpreadTracker::kRelativeAccuracy + 1e-6));
+    EXPECT(Near(stats.p90, 18.0, SpreadTracker::kRelativeAccuracy + 1e-6));
+    EXPECT(Near(stats.p99, 18.0, SpreadTracker::kRelativeAccuracy + 1e-6));
+}
+
+void TestDuplicate() {
+    SpreadTracker tracker;
+    tracker.OnTick("EURUSD", 1.1, 1.1001, 0.00001, 5000, 1000);
+    tracker.OnTick("EURUSD", 1.1, 1.1001, 0.00001, 5000, 1001);
+    tracker.OnTick("EURUSD", 1.1, 1.1001, 0.00001, 0, 1002);
+    tracker.OnTick("EURUSD", 1.1, 1.1001, 0.00001, 0, 1003);
+
+    SpreadStats stats;
+    EXPECT(tracker.GetStats("EURUSD", 1003, stats));
+    EXPECT(stats.count == 3);
+}
+
+void TestWindow() {
+    SpreadTracker tracker;
+    tracker.SetWindow(10000);    // スロット 1 秒 × 10
+    tracker.OnTick("EURUSD", 1.1, 1.1010, 0.00001, 0, 500);       // 100 ポイント（区間 0）
+    tracker.OnTick("EURUSD", 1.1, 1.1001, 0.00001, 0, 5500);      // 10 ポイント（区間 5）
+
+    SpreadStats stats;
+    EXPECT(tracker.GetStats("EURUSD", 9999, stats));
+    EXPECT(stats.count == 2 && stats.windowMs == 10000);
+
+    // 区間 0 は窓から外れる
+    EXPECT(tracker.GetStats("EURUSD", 10000, stats));
+    EXPECT(stats.count == 1 && Near(stats.max, 10.0, 1e-6));
+
+    // 区間 10 は区間 0 と同じスロットを使い、古い記録を捨てる
+    tracker.OnTick("EURUSD", 1.1, 1.1002, 0.00001, 0, 10500);
+    EXPECT(tracker.GetStats("EURUSD", 10500, stats));
+    EXPECT(stats.count == 2 && Near(stats.max, 20.0, 1e-6));
+
+    // 窓の変更で記録は破棄される
+    tracker.SetWindow(60000);
+    EXPECT(tracker.GetStats("EURUSD", 10500, stats));
+    EXPECT(stats.count == 0);
+}
+
+void TestInvalid() {
+    SpreadTracker tracker;
+    SpreadStats stats;
+    EXPECT(!tracker.GetStats("EURUSD", 0, stats));
+    EXPECT(!tracker.OnTick("", 1.1, 1.1001, 0.00001, 0, 0));
+    EXPECT(!tracker.OnTick("EURUSD", 0.0, 1.1001, 0.00001, 0, 0));
+    EXPECT(!tracker.OnTick("EURUSD", 1.1, 1.1001, 0.0, 0, 0));
+    EXPECT(!tracker.GetStats("EURUSD", 0, stats));
+
+    // 通貨ペア数の上限
+    for (size_t i = 0; i < SpreadTracker::kMaxSymbols; i++) {
+        EXPECT(tracker.OnTick("S" + std::to_string(i), 1.1, 1.1001, 0.00001, 0, 0));
+    }
+    EXPECT(!tracker.OnTick("OVER", 1.1, 1.1001, 0.00001, 0, 0));
+}
+
+} // namespace
+
+int main() {
+    TestSketch();
+    TestStats();
+    TestDuplicate();
+    TestWindow();
+    TestInvalid();
+    return FinishTest("SpreadTrackerTest");
+}
@@ -0,0 +1,121 @@
+// 通貨ペア仕様テーブルのテスト（RCU による差し替え）
+//
+//   load     : 一括登録ごとに版を上げ、含まれない通貨ペアは保持する。内容に変化がなければ版を上げない
+//   collect  : CollectSince は指定した版より後に登録・変更された仕様だけを返す
+//   readers  : 書き込み中も読み取り側は一貫した（いずれかの版の）仕様を読める
+//   limits   : 空の通貨ペア名は無視し、kMaxSymbols を超える新規登録は受け付けない
+
+#include "../SymbolSpecTable.h"
+#include "TestSupport.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+SymbolSpec Spec(const std::string& symbol, int digits, double marginPerLot = 1000.0) {
+    SymbolSpec spec;
+    spec.symbol = symbol;
+    spec.digits = digits;
+    spec.marginPerLot = marginPerLot;
+    return spec;
+}
+
+void TestLoad() {
+    SymbolSpecTable table;
+    SymbolSpec spec;
+    EXPECT(table.Version() == 0 && !table.Find("EURUSD", spec));
+
+    EXPECT(table.Load({Spec("EURUSD", 5), Spec("USDJPY", 3)}));
+    EXPECT(table.Version() == 1);
+    EXPECT(table.Find("EURUSD", spec) && spec.digits == 5 && spec.updatedVersion == 1);
+
+    // 同じ内容の再登録では版を上げない
+    EXPECT(!table.Load({Spec("EURUSD", 5)}));
+    EXPECT(table.Version() == 1);
+
+    // 変更した通貨ペアだけ updatedVersion が進み、含まれない通貨ペアは残る
+    EXPECT(table.Load({Spec("EURUSD", 5, 2000.0)}));
+    EXPECT(table.Version() == 2);
+    EXPECT(table.Find("EURUSD", spec) && spec.marginPerLot == 2000.0 && spec.updatedVersion == 2);
+    EXPECT(table.Find("USDJPY", spec) && spec.updatedVersion == 1);
+}
+
+void TestCollect() {
+    SymbolSpecTable table;
+    std::vector<SymbolSpec> specs;
+    table.CollectSince(0, specs);
+    EXPECT(specs.empty());
+
+    table.Load({Spec("EURUSD", 5), Spec("USDJPY", 3)});
+    table.Load({Spec("GBPUSD", 5)});
+    table.CollectSince(0, specs);
+    EXPECT(specs.size() == 3);
+
+    specs.clear();
+    table.CollectSince(1, specs);
+    EXPECT(specs.size() == 1 && specs[0].symbol == "GBPUSD");
+
+    specs.clear();
+    table.CollectSince(table.Version(), specs);
+    EXPECT(specs.empty());
+}
+
+void TestReaders() {
+    SymbolSpecTable table;
+    table.Load({Spec("EURUSD", 0, 0.0)});
+
+    // 書き込み側は digits と marginPerLot を同じ値にそろえて更新する
+    std::atomic<bool> stop(false);
+    std::atomic<int> mismatches(0);
+    std::thread reader([&]() {
+        uint64_t lastVersion = 0;
+        while (!stop.load()) {
+            uint64_t version = table.Version();
+            SymbolSpec spec;
+            if (!table.Find("EURUSD", spec) || spec.marginPerLot != static_cast<double>(spec.digits)) {
+                mismatches++;
+            }
+            if (version < lastVersion) {
+                mismatches++;
+            }
+            lastVersion = version;
+        }
+    });
+    for (int i = 1; i <= 2000; i++) {
+        table.Load({Spec("EURUSD", i, static_cast<double>(i))});
+    }
+    stop = true;
+    reader.join();
+    EXPECT(mismatches.load() == 0);
+    EXPECT(table.Version() == 2001);
+}
+
+void TestLimits() {
+    SymbolSpecTable table;
+    EXPECT(!table.Load({Spec("", 5)}));
+    EXPECT(table.Version() == 0);
+
+    std::vector<SymbolSpec> specs;
+    for (size_t i = 0; i < SymbolSpecTable::kMaxSymbols; i++) {
+        specs.push_back(Spec("S" + std::to_string(i), 5));
+    }
+    EXPECT(table.Load(specs));
+    EXPECT(!table.Load({Spec("OVER", 5)}));
+
+    // 既存の通貨ペアの変更は上限に達していても受け付ける
+    EXPECT(table.Load({Spec("S0", 3)}));
+    SymbolSpec spec;
+    EXPECT(!table.Find("OVER", spec) && table.Find("S0", spec) && spec.digits == 3);
+}
+
+} // namespace
+
+int main() {
+    TestLoad();
+    TestCollect();
+    TestReaders();
+    TestLimits();
+    return FinishTest("SymbolSpecTableTest");
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+// 単体テストの共通部品（1テスト1実行ファイル。失敗があれば終了コード 1 を返して ctest に知らせる）
+
+#include <cstdio>
+
+inline int g_failures = 0;
+
+#define EXPECT(condition)                                                            \
+    do {                                                                             \
+        if (!(condition)) {                                                          \
+            std::printf("  FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);     \
+            g_failures++;                                                            \
+        }                                                                            \
+    } while (0)
+
+// main の最後に呼び出す
+inline int FinishTest(const char* name) {
+    if (g_failures > 0) {
+        std::printf("%s: %d failure(s)\n", name, g_failures);
+        return 1;
+    }
+    std::printf("%s: passed\n", name);
+    return 0;
+}
+
+#endif // TESTSUPPORT_H
@@ -0,0 +1,181 @@
+// 発注結果と約定の突き合わせのテスト
+//
+//   fill      : 同期送信の発注結果（注文チケットあり）と約定から実約定価格・スリッページ・遅延を求める
+//   async     : 非同期送信で request_id → 注文チケットの順に判明し、約定が発注結果より先に届いても突き合わせる
+//   partial   : 部分約定は残りの約定を待ち、出来高加重平均で約定価格を求める。期限切れは約定済みの分で確定する
+//   rejected  : 失敗のリターンコードは Rejected で完了する。コマンド由来でない発注結果は対象外
+//   orphans   : 保留する約定は kMaxOrphanDeals 件までで、超えた分は古いものから破棄して数える
+
+#include "../TradeCorrelator.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const long long kMs = 1000;
+
+bool Near(double a, double b) {
+    return std::fabs(a - b) < 1e-9;
+}
+
+TradeSubmission Submission(uint32_t requestId, uint64_t order, int retcode) {
+    TradeSubmission submission;
+    submission.action = TradeAction::Open;
+    submission.isBuy = true;
+    submission.requestId = requestId;
+    submission.retcode = retcode;
+    submission.order = order;
+    submission.requestedPrice = 1.10000;
+    submission.requestedVolume = 1.0;
+    submission.point = 0.00001;
+    submission.commandReceivedAtUs = 1000 * kMs;
+    submission.accountId = "A";
+    submission.positionId = "p1";
+    submission.symbol = "EURUSD";
+    return submission;
+}
+
+DealFill Deal(uint64_t deal, uint64_t order, double price, double volume) {
+    DealFill fill;
+    fill.deal = deal;
+    fill.order = order;
+    fill.position = 900;
+    fill.price = price;
+    fill.volume = volume;
+    fill.symbol = "EURUSD";
+    return fill;
+}
+
+void TestFill() {
+    TradeCorrelator correlator;
+    std::vector<CompletedTrade> completed;
+    correlator.OnResult(Submission(1, 500, 10009), 1010 * kMs, completed);
+    EXPECT(completed.empty());
+    EXPECT(correlator.PendingCount() == 1);
+
+    correlator.OnDeal(Deal(1, 500, 1.10003, 1.0), 1015 * kMs, completed);
+    EXPECT(completed.size() == 1);
+    const CompletedTrade& trade = completed[0];
+    EXPECT(trade.outcome == CompletedTrade::Outcome::Filled);
+    EXPECT(trade.submission.positionId == "p1");
+    EXPECT(trade.positionTicket == 900);
+    EXPECT(Near(trade.fillPrice, 1.10003) && Near(trade.filledVolume, 1.0));
+    // 買いで気配より 3 ポイント高く約定した（不利方向は正）
+    EXPECT(Near(trade.slippagePoints, 3.0));
+    EXPECT(trade.fillLatencyUs == 15 * kMs);
+    EXPECT(trade.submitToFillUs == 5 * kMs);
+    EXPECT(correlator.PendingCount() == 0);
+}
+
+void TestAsync() {
+    TradeCorrelator correlator;
+    std::vector<CompletedTrade> completed;
+
+    // OrderSendAsync 直後は request_id のみ
+    TradeSubmission sent = Submission(7, 0, 0);
+    sent.isBuy = false;
+    correlator.OnResult(sent, 1010 * kMs, completed);
+
+    // 約定が TRADE_TRANSACTION_REQUEST より先に届く
+    correlator.OnDeal(Deal(1, 600, 1.09998, 1.0), 1012 * kMs, completed);
+    EXPECT(completed.empty());
+
+    // TRADE_TRANSACTION_REQUEST（positionId は渡されない）で注文チケットが判明し、保留中の約定を適用する
+    TradeSubmission request;
+    request.requestId = 7;
+    request.order = 600;
+    request.retcode = 10009;
+    correlator.OnResult(request, 1013 * kMs, completed);
+    EXPECT(completed.size() == 1);
+    EXPECT(completed[0].submission.order == 600 && completed[0].submission.positionId == "p1");
+    // 売りで気配より 2 ポイント安く約定した
+    EXPECT(Near(completed[0].slippagePoints, 2.0));
+    EXPECT(correlator.PendingCount() == 0);
+}
+
+void TestPartial() {
+    TradeCorrelator correlator;
+    std::vector<CompletedTrade> completed;
+    correlator.OnResult(Submission(1, 500, 10010), 1010 * kMs, completed);
+    correlator.OnDeal(Deal(1, 500, 1.10000, 0.4), 1011 * kMs, completed);
+    EXPECT(completed.empty());
+    correlator.OnDeal(Deal(2, 500, 1.10010, 0.6), 1012 * kMs, completed);
+    EXPECT(completed.size() == 1);
+    EXPECT(Near(completed[0].fillPrice, 1.10006) && Near(completed[0].filledVolume, 1.0));
+
+    // 残りが約定しないまま期限を迎えた場合は約定済みの分で確定する
+    completed.clear();
+    TradeSubmission second = Submission(2, 501, 10010);
+    second.positionId = "p2";
+    correlator.OnResult(second, 2000 * kMs, completed);
+    correlator.OnDeal(Deal(3, 501, 1.10000, 0.3), 2001 * kMs, completed);
+    EXPECT(completed.empty());
+    correlator.OnDeal(Deal(4, 999, 1.0, 0.1), 2000 * kMs + TradeCorrelator::kMaxPendingUs + 1, completed);
+    EXPECT(completed.size() == 1);
+    EXPECT(completed[0].submission.positionId == "p2" && Near(completed[0].filledVolume, 0.3));
+    EXPECT(correlator.PendingCount() == 0);
+}
+
+void TestRejected() {
+    TradeCorrelator correlator;
+    std::vector<CompletedTrade> completed;
+    correlator.OnResult(Submission(1, 0, 10019), 1010 * kMs, completed);
+    EXPECT(completed.size() == 1);
+    EXPECT(completed[0].outcome == CompletedTrade::Outcome::Rejected);
+    EXPECT(completed[0].fillLatencyUs == -1);
+    EXPECT(correlator.PendingCount() == 0);
+
+    // 非同期送信の結果が後から失敗で届いた場合
+    completed.clear();
+    correlator.OnResult(Submission(2, 0, 0), 1020 * kMs, completed);
+    TradeSubmission failed;
+    failed.requestId = 2;
+    failed.retcode = 10006;
+    correlator.OnResult(failed, 1021 * kMs, completed);
+    EXPECT(completed.size() == 1 && completed[0].outcome == CompletedTrade::Outcome::Rejected);
+    EXPECT(completed[0].submission.retcode == 10006);
+
+    // 手動発注等（positionId なし）は保持しない
+    completed.clear();
+    TradeSubmission manual = Submission(3, 700, 10009);
+    manual.positionId.clear();
+    correlator.OnResult(manual, 1030 * kMs, completed);
+    EXPECT(completed.empty() && correlator.PendingCount() == 0);
+
+    EXPECT(TradeCorrelator::IsSuccessRetcode(0) && TradeCorrelator::IsSuccessRetcode(10009));
+    EXPECT(!TradeCorrelator::IsSuccessRetcode(10019));
+}
+
+void TestOrphans() {
+    TradeCorrelator correlator;
+    std::vector<CompletedTrade> completed;
+
+    // 対象外の約定が集中しても保留は上限まで。最初の約定から順に破棄される
+    size_t total = TradeCorrelator::kMaxOrphanDeals + 10;
+    for (size_t i = 0; i < total; i++) {
+        correlator.OnDeal(Deal(i + 1, 1000 + i, 1.1, 1.0), 1000 * kMs, completed);
+    }
+    EXPECT(correlator.DroppedOrphanCount() == 10);
+
+    // 破棄された約定の注文は突き合わせられない
+    correlator.OnResult(Submission(1, 1000, 10009), 1001 * kMs, completed);
+    EXPECT(completed.empty() && correlator.PendingCount() == 1);
+
+    // 残っている約定の注文は突き合わせられる
+    TradeSubmission kept = Submission(2, 1000 + total - 1, 10009);
+    kept.positionId = "p2";
+    correlator.OnResult(kept, 1002 * kMs, completed);
+    EXPECT(completed.size() == 1 && completed[0].submission.positionId == "p2");
+}
+
+} // namespace
+
+int main() {
+    TestFill();
+    TestAsync();
+    TestPartial();
+    TestRejected();
+    TestOrphans();
+    return FinishTest("TradeCorrelatorTest");
+}
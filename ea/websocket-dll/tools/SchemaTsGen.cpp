@@ -0,0 +1,29 @@
+// WireMessages.h のスキーマから TypeScript 型定義を生成するツール
+//
+// 使い方:
+//   SchemaTsGen [出力ファイル]   （省略時は標準出力）
+//
+// 通常は CMake の generate_ts_schema ターゲットから
+// packages/shared-types/src/websocket-frames.generated.ts に出力する。
+
+#include "../WireMessages.h"
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    std::ofstream file;
+    if (argc > 1) {
+        file.open(argv[1], std::ios::out | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Failed to open " << argv[1] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = argc > 1 ? static_cast<std::ostream&>(file) : std::cout;
+
+    out << "// このファイルは ea/websocket-dll/tools/SchemaTsGen により WireMessages.h から生成されています。\n";
+    out << "// 直接編集せず、スキーマを変更した上で generate_ts_schema ターゲットを実行してください。\n\n";
+    schema::EmitTypeScriptAll(out, static_cast<WireMessageRegistry*>(nullptr));
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+// 口座間スプレッドの機会検出を DLL の外で動かすツール
+//
+// 標準入力の気配（1行1件の CSV）を SpreadDetector に流し、状態が変わった組を
+// DLL と同じ OPPORTUNITY フレーム（JSON）として1行ずつ標準出力に書く。
+// 記録した気配の再生や、判定条件・費用の調整に使う。
+//
+// 使い方:
+//   SpreadScan [設定ファイル] < quotes.csv
+//
+// 気配: timeUs,accountId,symbol,bid,ask   （timeUs は UNIXエポックからのマイクロ秒、時刻順）
+// 設定（1行1件、# 以降はコメント。通貨ペアの * は既定値）:
+//   rule <symbol|*> <entry> <exit> <minPersistMs> <maxQuoteAgeMs> <holdingDays>
+//   cost <accountId> <symbol|*> <commission> <swapLong> <swapShort>
+
+#include "../MessageUtils.h"
+#include "../SpreadDetector.h"
+#include "../WireMessages.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string SymbolArgument(const std::string& value) {
+    return value == "*" ? std::string() : value;
+}
+
+bool LoadConfig(const char* path, SpreadDetector& detector) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int number = 0;
+    while (std::getline(file, line)) {
+        number++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::istringstream fields(line);
+        std::string kind;
+        if (!(fields >> kind)) {
+            continue;
+        }
+
+        bool ok = false;
+        if (kind == "rule") {
+            std::string symbol;
+            SpreadRule rule;
+            long long minPersistMs = 0;
+            long long maxQuoteAgeMs = 0;
+            if (fields >> symbol >> rule.entry >> rule.exit >> minPersistMs >> maxQuoteAgeMs >> rule.holdingDays) {
+                rule.minPersistUs = minPersistMs * 1000;
+                rule.maxQuoteAgeUs = maxQuoteAgeMs * 1000;
+                ok = detector.SetRule(SymbolArgument(symbol), rule);
+            }
+        } else if (kind == "cost") {
+            std::string accountId;
+            std::string symbol;
+            SpreadCost cost;
+            if (fields >> accountId >> symbol >> cost.commission >> cost.swapLong >> cost.swapShort) {
+                ok = detector.SetCost(accountId, SymbolArgument(symbol), cost);
+            }
+        }
+        if (!ok) {
+            std::cerr << path << ":" << number << ": invalid line" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// timeUs,accountId,symbol,bid,ask
+bool ParseQuote(const std::string& line, long long& timeUs, std::string& accountId, std::string& symbol,
+                double& bid, double& ask) {
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+        fields.push_back(field);
+    }
+    if (fields.size() != 5) {
+        return false;
+    }
+    try {
+        timeUs = std::stoll(fields[0]);
+        bid = std::stod(fields[3]);
+        ask = std::stod(fields[4]);
+    } catch (...) {
+        return false;
+    }
+    accountId = fields[1];
+    symbol = fields[2];
+    return true;
+}
+
+void Print(const SpreadDetector& detector, const std::vector<SpreadOpportunity>& events) {
+    for (const auto& event : events) {
+        OpportunityFrame frame;
+        frame.timestamp = FormatIsoTimestamp(std::chrono::system_clock::time_point(std::chrono::microseconds(event.atUs)));
+        frame.state = event.state == OpportunityState::Open ? "OPEN" : "CLOSED";
+        frame.symbol = detector.SymbolName(event.symbol);
+        frame.sellAccountId = detector.BrokerName(event.sellBroker);
+        frame.buyAccountId = detector.BrokerName(event.buyBroker);
+        frame.sellBid = event.sellBid;
+        frame.buyAsk = event.buyAsk;
+        frame.grossSpread = event.grossSpread;
+        frame.netSpread = event.netSpread;
+        frame.peakNetSpread = event.peakNetSpread;
+        frame.threshold = event.threshold;
+        frame.durationMs = (event.atUs - event.startedUs) / 1000;
+        frame.sequence = static_cast<long long>(event.sequence);
+        std::cout << schema::ToJson(frame) << '\n';
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SpreadDetector detector;
+    if (argc > 1 && !LoadConfig(argv[1], detector)) {
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::vector<SpreadOpportunity> events;
+    std::string line;
+    std::string accountId;
+    std::string symbol;
+    long long quotes = 0;
+    long long rejected = 0;
+    long long opened = 0;
+    long long lastSweepUs = 0;
+    while (std::getline(std::cin, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        long long timeUs = 0;
+        double bid = 0.0;
+        double ask = 0.0;
+        if (!ParseQuote(line, timeUs, accountId, symbol, bid, ask)) {
+            rejected++;
+            continue;
+        }
+
+        quotes++;
+        // DLL のタイマーと同じく、気配の時刻で kSweepIntervalUs ごとに気配の届かない組を判定する
+        if (timeUs - lastSweepUs >= SpreadDetector::kSweepIntervalUs) {
+            detector.Sweep(timeUs, events);
+            lastSweepUs = timeUs;
+        }
+        detector.OnQuote(symbol, accountId, bid, ask, timeUs / 1000, timeUs, events);
+        if (!events.empty()) {
+            for (const auto& event : events) {
+                opened += event.state == OpportunityState::Open ? 1 : 0;
+            }
+            Print(detector, events);
+            events.clear();
+        }
+    }
+
+    std::cerr << "quotes=" << quotes << " rejected=" << rejected << " symbols=" << detector.SymbolCount()
+              << " accounts=" << detector.BrokerCount() << " opened=" << opened
+              << " stillOpen=" << detector.OpenCount() << std::endl;
+    return 0;
+}
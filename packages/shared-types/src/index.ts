@@ -318,4 +318,9 @@ export interface PriceUpdateEvent {
 }
 
 export type WSCommand = OpenCommand | CloseCommand;
-export type WSEvent = OpenedEvent | ClosedEvent | StoppedEvent | AccountUpdateEvent | PriceUpdateEvent;
\ No newline at end of file
+export type WSEvent = OpenedEvent | ClosedEvent | StoppedEvent | AccountUpdateEvent | PriceUpdateEvent;
+// =============================================================================
+// EA DLL Wire Frames（ea/websocket-dll/WireMessages.h から生成）
+// =============================================================================
+
+export * from './websocket-frames.generated';
@@ -0,0 +1,356 @@
+// このファイルは ea/websocket-dll/tools/SchemaTsGen により WireMessages.h から生成されています。
+// 直接編集せず、スキーマを変更した上で generate_ts_schema ターゲットを実行してください。
+
+export interface CommandMetadataFrame {
+  timestamp: string;
+  ttlMs?: number;
+  executeAt?: string;
+  executionType?: string;
+  strategyId?: string;
+}
+
+export interface PairedLegFrame {
+  commandId?: string;
+  accountId: string;
+  positionId: string;
+  actionId?: string;
+  symbol: string;
+  side: string;
+  volume: number;
+  ttlMs?: number;
+}
+
+export interface CommandFrame {
+  type: 'OPEN' | 'CLOSE' | 'MODIFY';
+  command?: string;
+  commandId?: string;
+  accountId: string;
+  positionId: string;
+  actionId?: string;
+  symbol?: string;
+  side?: string;
+  volume?: number;
+  trailWidth?: number;
+  ticket?: number;
+  stopLoss?: number;
+  takeProfit?: number;
+  ttlMs?: number;
+  executeAt?: string;
+  timestamp: string;
+  metadata?: CommandMetadataFrame;
+  pairedLeg?: PairedLegFrame;
+}
+
+export interface ResendFromFrame {
+  type: 'RESEND_FROM';
+  seq: number;
+}
+
+export interface PriceAlertSetFrame {
+  type: 'PRICE_ALERT_SET';
+  alertId: string;
+  symbol: string;
+  level: number;
+  direction?: string;
+  timestamp?: string;
+}
+
+export interface PriceAlertCancelFrame {
+  type: 'PRICE_ALERT_CANCEL';
+  alertId: string;
+  timestamp?: string;
+}
+
+export interface PriceUpdateFrame {
+  type: 'PRICE_UPDATE';
+  accountId: string;
+  symbol: string;
+  bid: number;
+  ask: number;
+  timeMsc?: number;
+  timestamp?: string;
+}
+
+export interface StreamResumeFrame {
+  type: 'STREAM_RESUME';
+  accountId: string;
+  oldestSeq: number;
+  lastSeq: number;
+}
+
+export interface ResendUnavailableFrame {
+  type: 'RESEND_UNAVAILABLE';
+  requestedSeq: number;
+  oldestSeq: number;
+  lastSeq: number;
+}
+
+export interface CommandAckFrame {
+  type: 'COMMAND_ACK';
+  timestamp: string;
+  commandType: string;
+  commandId?: string;
+  accountId: string;
+  positionId: string;
+  actionId: string;
+  commandTimestamp?: string;
+  receivedAtUs: number;
+  queueDepth: number;
+}
+
+export interface CommandExpiredFrame {
+  type: 'COMMAND_EXPIRED';
+  timestamp: string;
+  commandType: string;
+  commandId?: string;
+  accountId: string;
+  positionId: string;
+  actionId: string;
+  commandTimestamp?: string;
+  ageMs: number;
+  ttlMs: number;
+  stage: string;
+}
+
+export interface CommandRejectedFrame {
+  type: 'COMMAND_REJECTED';
+  timestamp: string;
+  commandType: string;
+  commandId?: string;
+  accountId: string;
+  positionId: string;
+  actionId: string;
+  symbol: string;
+  volume: number;
+  reason: string;
+  limit: number;
+  value: number;
+}
+
+export interface CommandReleasedFrame {
+  type: 'COMMAND_RELEASED';
+  timestamp: string;
+  commandType: string;
+  commandId?: string;
+  accountId: string;
+  positionId: string;
+  actionId: string;
+  executeAt: string;
+  releasedAt: string;
+  skewUs: number;
+  clockOffsetUs: number;
+  scheduledUs: number;
+}
+
+export interface LegDispatchedFrame {
+  type: 'LEG_DISPATCHED';
+  timestamp: string;
+  accountId: string;
+  positionId: string;
+  actionId: string;
+  route: string;
+  reason?: string;
+  dispatchUs: number;
+  leg: PairedLegFrame;
+}
+
+export interface OpenedEventFrame {
+  type: 'OPENED';
+  timestamp: string;
+  accountId: string;
+  positionId: string;
+  actionId?: string;
+  orderId: number;
+  price: number;
+  time: string;
+  mtTicket?: string;
+  symbol?: string;
+  volume?: number;
+  requestedPrice?: number;
+  slippagePoints?: number;
+  fillLatencyUs?: number;
+  submitToFillUs?: number;
+}
+
+export interface ClosedEventFrame {
+  type: 'CLOSED';
+  timestamp: string;
+  accountId: string;
+  positionId: string;
+  actionId?: string;
+  price: number;
+  profit: number;
+  time: string;
+  mtTicket?: string;
+  symbol?: string;
+  volume?: number;
+  requestedPrice?: number;
+  slippagePoints?: number;
+  fillLatencyUs?: number;
+  submitToFillUs?: number;
+}
+
+export interface StoppedEventFrame {
+  type: 'STOPPED';
+  timestamp: string;
+  accountId: string;
+  positionId: string;
+  actionId?: string;
+  price: number;
+  time: string;
+  reason: string;
+}
+
+export interface ErrorEventFrame {
+  type: 'ERROR';
+  timestamp: string;
+  accountId?: string;
+  positionId?: string;
+  actionId?: string;
+  message: string;
+  errorCode?: string;
+}
+
+export interface ExecutionStatsFrame {
+  type: 'EXECUTION_STATS';
+  timestamp: string;
+  accountId: string;
+  symbol?: string;
+  intervalMs: number;
+  fills: number;
+  rejects: number;
+  rejectRate: number;
+  slippageMean: number;
+  slippageP50: number;
+  slippageP90: number;
+  slippageP99: number;
+  slippageMax: number;
+  latencyP50Us: number;
+  latencyP90Us: number;
+  latencyP99Us: number;
+  latencyMaxUs: number;
+}
+
+export interface PriceStatsFrame {
+  type: 'PRICE_STATS';
+  timestamp: string;
+  symbol: string;
+  ticks: number;
+  bid: number;
+  ask: number;
+  ewma: number;
+  mean: number;
+  high: number;
+  low: number;
+  spreadMean: number;
+  spreadMin: number;
+  spreadMax: number;
+  volatility: number;
+  shortVolatility: number;
+  tickRate: number;
+}
+
+export interface PriceAlertFrame {
+  type: 'PRICE_ALERT';
+  timestamp: string;
+  alertId: string;
+  symbol: string;
+  direction: string;
+  level: number;
+  price: number;
+  tickTimeMsc?: number;
+}
+
+export interface OpportunityFrame {
+  type: 'OPPORTUNITY';
+  timestamp: string;
+  state: string;
+  symbol: string;
+  sellAccountId: string;
+  buyAccountId: string;
+  sellBid: number;
+  buyAsk: number;
+  grossSpread: number;
+  netSpread: number;
+  peakNetSpread: number;
+  threshold: number;
+  durationMs: number;
+  sequence: number;
+}
+
+export interface MarginWarningFrame {
+  type: 'MARGIN_WARNING';
+  timestamp: string;
+  accountId: string;
+  severity: string;
+  previousSeverity: string;
+  marginLevel: number;
+  threshold: number;
+  equity: number;
+  margin: number;
+  freeMargin: number;
+  stopOutLevel: number;
+  equityToStopOut: number;
+}
+
+export interface SymbolSpecsFrame {
+  type: 'SYMBOL_SPECS';
+  timestamp: string;
+  accountId: string;
+  version: number;
+  full: boolean;
+}
+
+export interface SymbolSpecEntryFrame {
+  symbol: string;
+  digits: number;
+  point: number;
+  tickSize: number;
+  tickValue: number;
+  contractSize: number;
+  volumeMin: number;
+  volumeStep: number;
+  volumeMax: number;
+  marginPerLot: number;
+  marginHedged: number;
+  baseCurrency?: string;
+  profitCurrency?: string;
+  marginCurrency?: string;
+}
+
+export interface ExposureSummaryFrame {
+  grossVolume: number;
+  netVolume: number;
+  hedgeRatio: number;
+}
+
+export interface ExposureSymbolFrame {
+  symbol: string;
+  longVolume: number;
+  shortVolume: number;
+  netVolume: number;
+  longNotional: number;
+  shortNotional: number;
+}
+
+export interface PnLUpdateFrame {
+  type: 'PNL_UPDATE';
+  timestamp: string;
+  accountId: string;
+  currency: string;
+  balance: number;
+  equity: number;
+  floatingPnl: number;
+  swap: number;
+  unconverted: number;
+}
+
+export interface PositionPnLFrame {
+  ticket: number;
+  symbol: string;
+  volume: number;
+  currentPrice: number;
+  pnl: number;
+  swap: number;
+  converted: boolean;
+}